@@ -145,7 +145,7 @@ namespace crow
             req_.middleware_container = static_cast<void*>(middlewares_);
             req_.io_context = &adaptor_.get_io_context();
 
-            req_.remote_ip_address = adaptor_.remote_endpoint().address().to_string();
+            req_.remote_ip_address = adaptor_.address();
 
             add_keep_alive_ = req_.keep_alive;
             close_connection_ = req_.close_connection;
@@ -195,7 +195,10 @@ namespace crow
                 if (!res.completed_)
                 {
                     res.complete_request_handler_ = [self] {
-                        self->complete_request();
+                        // complete_request() clears this handler; when the response is ended
+                        // asynchronously it holds the last reference to the connection
+                        auto keep_alive = self;
+                        keep_alive->complete_request();
                     };
                     need_to_call_after_handlers_ = true;
                     handler_->handle(req_, res, routing_handle_result_);
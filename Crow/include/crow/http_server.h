@@ -38,12 +38,37 @@ namespace crow // NOTE: Already documented in "crow/app.h"
 #endif
     using tcp = asio::ip::tcp;
 
+    namespace detail
+    {
+        inline uint16_t endpoint_port(const tcp::endpoint& endpoint)
+        {
+            return endpoint.port();
+        }
+
+        inline std::string endpoint_url(const tcp::endpoint& endpoint, bool ssl)
+        {
+            return (ssl ? "https://" : "http://") + endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
+        }
+
+#ifdef CROW_HAS_LOCAL_SOCKETS
+        inline uint16_t endpoint_port(const stream_protocol::endpoint&)
+        {
+            return 0;
+        }
+
+        inline std::string endpoint_url(const stream_protocol::endpoint& endpoint, bool)
+        {
+            return "unix:" + endpoint.path();
+        }
+#endif
+    } // namespace detail
+
     template<typename Handler, typename Adaptor = SocketAdaptor, typename... Middlewares>
     class Server
     {
     public:
       Server(Handler* handler,
-             const tcp::endpoint& endpoint,
+             const typename Adaptor::endpoint& endpoint,
              std::string server_name = std::string("Crow/") + VERSION,
              std::tuple<Middlewares...>* middlewares = nullptr,
              uint16_t concurrency = 1,
@@ -61,6 +86,27 @@ namespace crow // NOTE: Already documented in "crow/app.h"
           adaptor_ctx_(adaptor_ctx)
         {}
 
+      /// Serves on a socket that is already bound and listening, e.g. one whose permissions had to be set before bind().
+      Server(Handler* handler,
+             const typename Adaptor::acceptor::protocol_type& protocol,
+             typename Adaptor::acceptor::native_handle_type native_acceptor,
+             std::string server_name = std::string("Crow/") + VERSION,
+             std::tuple<Middlewares...>* middlewares = nullptr,
+             uint16_t concurrency = 1,
+             uint8_t timeout = 5,
+             typename Adaptor::context* adaptor_ctx = nullptr):
+          acceptor_(io_context_, protocol, native_acceptor),
+          signals_(io_context_),
+          tick_timer_(io_context_),
+          handler_(handler),
+          concurrency_(concurrency),
+          timeout_(timeout),
+          server_name_(server_name),
+          task_queue_length_pool_(concurrency_ - 1),
+          middlewares_(middlewares),
+          adaptor_ctx_(adaptor_ctx)
+        {}
+
         void set_tick_function(std::chrono::milliseconds d, std::function<void()> f)
         {
             tick_interval_ = d;
@@ -154,12 +200,14 @@ namespace crow // NOTE: Already documented in "crow/app.h"
                   });
             }
 
-            handler_->port(acceptor_.local_endpoint().port());
+            // a unix socket has no port to report
+            if (port() != 0)
+                handler_->port(port());
 
 
             CROW_LOG_INFO << server_name_
-                          << " server is running at " << (handler_->ssl_used() ? "https://" : "http://")
-                          << acceptor_.local_endpoint().address() << ":" << acceptor_.local_endpoint().port() << " using " << concurrency_ << " threads";
+                          << " server is running at " << detail::endpoint_url(acceptor_.local_endpoint(), handler_->ssl_used())
+                          << " using " << concurrency_ << " threads";
             CROW_LOG_INFO << "Call `app.loglevel(crow::LogLevel::Warning)` to hide Info level logs.";
 
             signals_.async_wait(
@@ -198,7 +246,7 @@ namespace crow // NOTE: Already documented in "crow/app.h"
         }
 
         uint16_t port() const {
-            return acceptor_.local_endpoint().port();
+            return detail::endpoint_port(acceptor_.local_endpoint());
         }
 
         /// Wait until the server has properly started or until timeout
@@ -285,7 +333,7 @@ namespace crow // NOTE: Already documented in "crow/app.h"
         asio::io_context io_context_;
         std::vector<detail::task_timer*> task_timer_pool_;
         std::vector<std::function<std::string()>> get_cached_date_str_pool_;
-        tcp::acceptor acceptor_;
+        typename Adaptor::acceptor acceptor_;
         bool shutting_down_ = false;
         bool server_started_{false};
         std::condition_variable cv_started_;
@@ -18,6 +18,10 @@
 #endif
 #include "crow/settings.h"
 
+#if defined(ASIO_HAS_LOCAL_SOCKETS) || defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#define CROW_HAS_LOCAL_SOCKETS
+#endif
+
 #if (CROW_USE_BOOST && BOOST_VERSION >= 107000) || (ASIO_VERSION >= 101300)
 #define GET_IO_CONTEXT(s) ((asio::io_context&)(s).get_executor().context())
 #else
@@ -38,6 +42,8 @@ namespace crow
     struct SocketAdaptor
     {
         using context = void;
+        using endpoint = tcp::endpoint;
+        using acceptor = tcp::acceptor;
         SocketAdaptor(asio::io_context& io_context, context*):
           socket_(io_context)
         {}
@@ -64,6 +70,12 @@ namespace crow
             return socket_.remote_endpoint();
         }
 
+        /// The peer's IP address.
+        std::string address()
+        {
+            return socket_.remote_endpoint().address().to_string();
+        }
+
         bool is_open()
         {
             return socket_.is_open();
@@ -102,10 +114,91 @@ namespace crow
         tcp::socket socket_;
     };
 
+#ifdef CROW_HAS_LOCAL_SOCKETS
+    using stream_protocol = asio::local::stream_protocol;
+
+    /// A wrapper for a unix domain socket, serving the same routes to local clients.
+    struct UnixSocketAdaptor
+    {
+        using context = void;
+        using endpoint = stream_protocol::endpoint;
+        using acceptor = stream_protocol::acceptor;
+        UnixSocketAdaptor(asio::io_context& io_context, context*):
+          socket_(io_context)
+        {}
+
+        asio::io_context& get_io_context()
+        {
+            return GET_IO_CONTEXT(socket_);
+        }
+
+        stream_protocol::socket& raw_socket()
+        {
+            return socket_;
+        }
+
+        stream_protocol::socket& socket()
+        {
+            return socket_;
+        }
+
+        stream_protocol::endpoint remote_endpoint()
+        {
+            return socket_.local_endpoint();
+        }
+
+        /// Unix peers have no address, the path of the socket they connected to stands in for it.
+        std::string address()
+        {
+            error_code ec;
+            return socket_.local_endpoint(ec).path();
+        }
+
+        bool is_open()
+        {
+            return socket_.is_open();
+        }
+
+        void close()
+        {
+            error_code ec;
+            socket_.close(ec);
+        }
+
+        void shutdown_readwrite()
+        {
+            error_code ec;
+            socket_.shutdown(asio::socket_base::shutdown_type::shutdown_both, ec);
+        }
+
+        void shutdown_write()
+        {
+            error_code ec;
+            socket_.shutdown(asio::socket_base::shutdown_type::shutdown_send, ec);
+        }
+
+        void shutdown_read()
+        {
+            error_code ec;
+            socket_.shutdown(asio::socket_base::shutdown_type::shutdown_receive, ec);
+        }
+
+        template<typename F>
+        void start(F f)
+        {
+            f(error_code());
+        }
+
+        stream_protocol::socket socket_;
+    };
+#endif
+
 #ifdef CROW_ENABLE_SSL
     struct SSLAdaptor
     {
         using context = asio::ssl::context;
+        using endpoint = tcp::endpoint;
+        using acceptor = tcp::acceptor;
         using ssl_socket_t = asio::ssl::stream<tcp::socket>;
         SSLAdaptor(asio::io_context& io_context, context* ctx):
           ssl_socket_(new ssl_socket_t(io_context, *ctx))
@@ -127,6 +220,11 @@ namespace crow
             return raw_socket().remote_endpoint();
         }
 
+        std::string address()
+        {
+            return raw_socket().remote_endpoint().address().to_string();
+        }
+
         bool is_open()
         {
             return ssl_socket_ ? raw_socket().is_open() : false;
@@ -1,5 +1,6 @@
 #pragma once
 #include <array>
+#include <atomic>
 #include "crow/logging.h"
 #include "crow/socket_adaptors.h"
 #include "crow/http_request.h"
@@ -67,6 +68,8 @@ namespace crow // NOTE: Already documented in "crow/app.h"
             virtual void close(std::string const& msg = "quit", uint16_t status_code = CloseStatusCode::NormalClosure) = 0;
             virtual std::string get_remote_ip() = 0;
             virtual std::string get_subprotocol() const = 0;
+            /// Payload bytes passed to send_* that the socket has not taken yet.
+            virtual size_t pending_bytes() const { return 0; }
             virtual ~connection() = default;
 
             void userdata(void* u) { userdata_ = u; }
@@ -279,7 +282,7 @@ namespace crow // NOTE: Already documented in "crow/app.h"
 
             std::string get_remote_ip() override
             {
-                return adaptor_.remote_endpoint().address().to_string();
+                return adaptor_.address();
             }
 
             void set_max_payload_size(uint64_t payload)
@@ -293,6 +296,11 @@ namespace crow // NOTE: Already documented in "crow/app.h"
                 return subprotocol_;
             }
 
+            size_t pending_bytes() const override
+            {
+                return pending_bytes_;
+            }
+
         protected:
             /// Generate the websocket headers using an opcode and the message size (in bytes).
             std::string build_header(int opcode, size_t size)
@@ -720,6 +728,8 @@ namespace crow // NOTE: Already documented in "crow/app.h"
                 if (sending_buffers_.empty())
                 {
                     sending_buffers_.swap(write_buffers_);
+                    sending_payload_bytes_ = write_payload_bytes_;
+                    write_payload_bytes_ = 0;
                     std::vector<asio::const_buffer> buffers;
                     buffers.reserve(sending_buffers_.size());
                     for (auto& s : sending_buffers_)
@@ -732,6 +742,8 @@ namespace crow // NOTE: Already documented in "crow/app.h"
                       [&, watch](const error_code& ec, std::size_t /*bytes_transferred*/) {
                           if (!ec && !close_connection_)
                           {
+                              pending_bytes_ -= sending_payload_bytes_;
+                              sending_payload_bytes_ = 0;
                               sending_buffers_.clear();
                               if (!write_buffers_.empty())
                                   do_write();
@@ -780,6 +792,7 @@ namespace crow // NOTE: Already documented in "crow/app.h"
             void send_data_impl(SendMessageType* s)
             {
                 auto header = build_header(s->opcode, s->payload.size());
+                write_payload_bytes_ += s->payload.size();
                 write_buffers_.emplace_back(std::move(header));
                 write_buffers_.emplace_back(std::move(s->payload));
                 do_write();
@@ -787,6 +800,7 @@ namespace crow // NOTE: Already documented in "crow/app.h"
 
             void send_data(int opcode, std::string&& msg)
             {
+                pending_bytes_ += msg.size();
                 SendMessageType event_arg{
                   std::move(msg),
                   this,
@@ -801,6 +815,11 @@ namespace crow // NOTE: Already documented in "crow/app.h"
 
             std::vector<std::string> sending_buffers_;
             std::vector<std::string> write_buffers_;
+            // payload bytes queued by send_data until async_write completes; the two parts are only
+            // touched on the io thread
+            std::atomic<size_t> pending_bytes_{0};
+            size_t sending_payload_bytes_{0};
+            size_t write_payload_bytes_{0};
 
             std::array<char, 4096> buffer_;
             bool is_binary_;
@@ -0,0 +1,162 @@
+#include "AdmissionControl.h"
+#include "JsonWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+AdmissionControl::AdmissionControl(size_t reservedThreads)
+    : reserved_threads_(std::max<size_t>(reservedThreads, 1))
+{
+}
+
+void AdmissionControl::addLane(const std::string& name, size_t limit, size_t maxQueue)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto lane = std::make_unique<Lane>();
+    lane->limit = std::max<size_t>(limit, 1);
+    lane->max_queue = maxQueue;
+    lanes_[name] = std::move(lane);
+}
+
+size_t AdmissionControl::workerThreads()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t threads = reserved_threads_;
+    for (const auto& [name, lane] : lanes_) {
+        threads += lane->limit + lane->max_queue;
+    }
+    return threads;
+}
+
+size_t AdmissionControl::retryAfterSeconds(const Lane& lane) const
+{
+    // the queue ahead drains `limit` requests per average run
+    const double seconds = lane.run_ms_average / 1000.0 * static_cast<double>(lane.queued + 1) / static_cast<double>(lane.limit);
+    return std::max<size_t>(1, static_cast<size_t>(std::ceil(seconds)));
+}
+
+crow::response AdmissionControl::run(const std::string& laneName, const std::function<crow::response()>& handler)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = lanes_.find(laneName);
+    if (it == lanes_.end()) {
+        lock.unlock();
+        return handler();
+    }
+    Lane& lane = *it->second;
+
+    const bool must_wait = lane.active >= lane.limit || lane.queued > 0;
+    if (must_wait && lane.queued >= lane.max_queue) {
+        lane.rejected++;
+        const size_t retry_after = retryAfterSeconds(lane);
+        lock.unlock();
+        crow::logger(crow::LogLevel::Warning) << "Rejected request in lane '" << laneName << "', retry after " << retry_after << " s";
+        JsonWriter json;
+        json.beginObject()
+            .field("success", false)
+            .field("error", "Too many " + laneName + " operations in progress, retry later")
+            .field("lane", laneName)
+            .field("retry_after", retry_after)
+            .endObject();
+        crow::response res = json.response(429);
+        res.set_header("Retry-After", std::to_string(retry_after));
+        return res;
+    }
+
+    const auto arrived = std::chrono::steady_clock::now();
+    const uint64_t ticket = lane.next_ticket++;
+    lane.queued++;
+    lane.cv.wait(lock, [&lane, ticket]() { return lane.next_admitted == ticket && lane.active < lane.limit; });
+    lane.queued--;
+    lane.next_admitted++;
+    lane.active++;
+    lane.admitted++;
+    const double waited = millisecondsSince(arrived);
+    lane.wait_ms_total += waited;
+    lane.wait_ms_max = std::max(lane.wait_ms_max, waited);
+    // the next ticket may fit into a slot that is still free
+    lane.cv.notify_all();
+    lock.unlock();
+
+    const auto started = std::chrono::steady_clock::now();
+    auto release = [this, &lane, started]() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        const double ran = millisecondsSince(started);
+        lane.run_ms_average = lane.run_ms_average == 0 ? ran : lane.run_ms_average * 0.8 + ran * 0.2;
+        lane.active--;
+        lane.cv.notify_all();
+    };
+    try {
+        crow::response res = handler();
+        release();
+        return res;
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+std::vector<AdmissionControl::LaneStats> AdmissionControl::stats()
+{
+    std::vector<LaneStats> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [name, lane] : lanes_) {
+        LaneStats s;
+        s.name = name;
+        s.limit = lane->limit;
+        s.max_queue = lane->max_queue;
+        s.active = lane->active;
+        s.queued = lane->queued;
+        s.admitted = lane->admitted;
+        s.rejected = lane->rejected;
+        s.average_wait_ms = lane->admitted ? lane->wait_ms_total / static_cast<double>(lane->admitted) : 0;
+        s.max_wait_ms = lane->wait_ms_max;
+        s.average_run_ms = lane->run_ms_average;
+        result.push_back(s);
+    }
+    return result;
+}
+
+void AdmissionControl::registerRestEndpoints(crow::SimpleApp& app)
+{
+    CROW_ROUTE(app, "/api/admission").methods("GET"_method)([this]()
+    {
+        return handleGetAdmission();
+    });
+}
+
+crow::response AdmissionControl::handleGetAdmission()
+{
+    const size_t worker_threads = workerThreads();
+    JsonWriter json;
+    json.beginObject()
+        .field("success", true)
+        .field("worker_threads", worker_threads)
+        .field("reserved_threads", reserved_threads_)
+        .key("lanes").beginArray();
+    for (const LaneStats& lane : stats()) {
+        json.beginObject()
+            .field("name", lane.name)
+            .field("limit", lane.limit)
+            .field("max_queue", lane.max_queue)
+            .field("active", lane.active)
+            .field("queued", lane.queued)
+            .field("admitted", lane.admitted)
+            .field("rejected", lane.rejected)
+            .field("average_wait_ms", lane.average_wait_ms)
+            .field("max_wait_ms", lane.max_wait_ms)
+            .field("average_run_ms", lane.average_run_ms)
+            .endObject();
+    }
+    json.endArray().endObject();
+    return json.response(200);
+}
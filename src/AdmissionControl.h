@@ -0,0 +1,104 @@
+#ifndef ADMISSIONCONTROL_H
+#define ADMISSIONCONTROL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <crow.h>
+
+/**
+ * @brief Limits how many slow requests of each kind run at once, so they cannot take every server thread.
+ *
+ * Slow endpoints (image builds, saves and loads, project loads, compose up/down, ...) run through a
+ * named lane: at most `limit` of a lane's requests run at once, up to `maxQueue` more wait for a
+ * slot in arrival order, and further requests are answered right away with 429 and a Retry-After
+ * estimated from the lane's recent run times.
+ *
+ * Waiting requests still hold a thread, so the BlockingExecutor handlers run on is given
+ * workerThreads() threads: every lane's running and queued requests plus `reservedThreads` that only
+ * ever serve the cheap endpoints. GET /api/admission reports each lane's state:
+ *
+ *     {"success": true, "worker_threads": 20, "reserved_threads": 4, "lanes": [
+ *         {"name": "heavy", "limit": 2, "max_queue": 4, "active": 1, "queued": 0, "admitted": 12,
+ *          "rejected": 0, "average_wait_ms": 3.5, "max_wait_ms": 41, "average_run_ms": 5230}]}
+ */
+class AdmissionControl {
+public:
+    // lanes the managers route their slow endpoints through
+    static constexpr const char* HEAVY_LANE = "heavy";          // image build/save/load, prune, install, project load
+    static constexpr const char* PROJECTS_LANE = "projects";    // compose up/down/restart, project removal
+
+    struct LaneStats {
+        std::string name;
+        size_t limit = 0;
+        size_t max_queue = 0;
+        size_t active = 0;
+        size_t queued = 0;
+        uint64_t admitted = 0;
+        uint64_t rejected = 0;
+        double average_wait_ms = 0;
+        double max_wait_ms = 0;
+        double average_run_ms = 0;
+    };
+
+    /**
+     * @param reservedThreads handler threads kept free of lane requests
+     */
+    explicit AdmissionControl(size_t reservedThreads);
+
+    AdmissionControl(const AdmissionControl&) = delete;
+    AdmissionControl& operator=(const AdmissionControl&) = delete;
+
+    /**
+     * @brief declares a lane, before the server starts
+     */
+    void addLane(const std::string& name, size_t limit, size_t maxQueue);
+
+    /**
+     * @brief runs handler once the lane has a free slot, or returns 429 if its queue is full
+     *
+     * Handlers of unknown lanes run right away.
+     */
+    crow::response run(const std::string& lane, const std::function<crow::response()>& handler);
+
+    size_t reservedThreads() const { return reserved_threads_; }
+
+    /**
+     * @brief handler threads needed so that reservedThreads() stay free: reserved + every lane's limit and queue
+     */
+    size_t workerThreads();
+
+    std::vector<LaneStats> stats();
+
+    void registerRestEndpoints(crow::SimpleApp& app);
+
+private:
+    struct Lane {
+        size_t limit = 1;
+        size_t max_queue = 0;
+        size_t active = 0;
+        size_t queued = 0;
+        uint64_t next_ticket = 0;       // given to the next arriving request
+        uint64_t next_admitted = 0;     // ticket allowed to start next, keeps arrival order
+        uint64_t admitted = 0;
+        uint64_t rejected = 0;
+        double wait_ms_total = 0;
+        double wait_ms_max = 0;
+        double run_ms_average = 0;      // moving average
+        std::condition_variable cv;
+    };
+
+    size_t retryAfterSeconds(const Lane& lane) const;
+    crow::response handleGetAdmission();
+
+    const size_t reserved_threads_;
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Lane>> lanes_;
+};
+
+#endif // ADMISSIONCONTROL_H
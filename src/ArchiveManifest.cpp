@@ -0,0 +1,237 @@
+#include "ArchiveManifest.h"
+#include "json11.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+struct CrcTable {
+    uint32_t values[256] = {};
+    constexpr CrcTable()
+    {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            values[i] = c;
+        }
+    }
+};
+
+constexpr CrcTable CRC_TABLE;
+
+std::string trim(const std::string& text)
+{
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string normalizePath(std::string path)
+{
+    std::replace(path.begin(), path.end(), '\\', '/');
+    while (path.rfind("./", 0) == 0) {
+        path.erase(0, 2);
+    }
+    while (!path.empty() && path.back() == '/') {
+        path.pop_back();
+    }
+    return path;
+}
+
+bool unknownContent(const ArchiveEntry& entry)
+{
+    return entry.crc.empty() && entry.size > 0;
+}
+
+} // namespace
+
+bool ManifestDiff::touches(const std::string& path) const
+{
+    const std::string prefix = normalizePath(path);
+    if (prefix.empty()) {
+        return !empty();
+    }
+    auto under = [&prefix](const std::string& entry) {
+        return entry == prefix || (entry.size() > prefix.size() && entry.compare(0, prefix.size(), prefix) == 0 && entry[prefix.size()] == '/');
+    };
+    return std::any_of(added.begin(), added.end(), under) || std::any_of(changed.begin(), changed.end(), under)
+        || std::any_of(removed.begin(), removed.end(), under);
+}
+
+uint32_t ArchiveManifest::crc32(const void* data, size_t size, uint32_t crc)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = CRC_TABLE.values[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+std::string ArchiveManifest::formatCrc(uint32_t crc)
+{
+    char text[9];
+    std::snprintf(text, sizeof(text), "%08X", crc);
+    return text;
+}
+
+ArchiveManifest ArchiveManifest::parseSltListing(const std::string& output)
+{
+    ArchiveManifest manifest;
+    std::istringstream iss(output);
+    std::string line;
+    bool in_entries = false;
+    ArchiveEntry entry;
+    bool has_entry = false;
+
+    auto flush = [&]() {
+        if (has_entry && !entry.path.empty()) {
+            manifest.entries[entry.path] = entry;
+        }
+        entry = ArchiveEntry();
+        has_entry = false;
+    };
+
+    while (std::getline(iss, line)) {
+        if (!in_entries) {
+            // the archive's own properties come before the dashes
+            in_entries = line.rfind("----------", 0) == 0;
+            continue;
+        }
+        const size_t eq = line.find(" = ");
+        if (eq == std::string::npos) {
+            if (trim(line).empty()) {
+                flush();
+            }
+            continue;
+        }
+        const std::string key = line.substr(0, eq);
+        const std::string value = trim(line.substr(eq + 3));
+        if (key == "Path") {
+            flush();
+            entry.path = normalizePath(value);
+            has_entry = true;
+        } else if (key == "Size") {
+            entry.size = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "CRC") {
+            entry.crc = value;
+        } else if (key == "Encrypted") {
+            entry.encrypted = value == "+";
+        } else if (key == "Folder") {
+            entry.is_directory = value == "+";
+        } else if (key == "Attributes") {
+            entry.is_directory = entry.is_directory || (!value.empty() && value[0] == 'D');
+        }
+    }
+    flush();
+    return manifest;
+}
+
+ArchiveManifest ArchiveManifest::fromDirectory(const std::string& root, const ArchiveManifest& paths)
+{
+    namespace fs = std::filesystem;
+    ArchiveManifest manifest;
+    std::vector<char> buffer(1 << 20);
+    for (const auto& [path, wanted] : paths.entries) {
+        const fs::path full = fs::path(root) / path;
+        std::error_code ec;
+        const fs::file_status status = fs::status(full, ec);
+        if (ec || !fs::exists(status)) {
+            continue;
+        }
+        ArchiveEntry entry;
+        entry.path = path;
+        entry.is_directory = fs::is_directory(status);
+        if (!entry.is_directory) {
+            std::ifstream file(full, std::ios::binary);
+            if (!file) {
+                continue;
+            }
+            uint32_t crc = 0;
+            while (file) {
+                file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                const std::streamsize got = file.gcount();
+                crc = crc32(buffer.data(), static_cast<size_t>(got), crc);
+                entry.size += static_cast<uint64_t>(got);
+            }
+            // 7z lists no CRC for empty files
+            entry.crc = entry.size > 0 ? formatCrc(crc) : "";
+        }
+        manifest.entries[path] = entry;
+    }
+    return manifest;
+}
+
+ManifestDiff ArchiveManifest::diff(const ArchiveManifest& next) const
+{
+    ManifestDiff result;
+    for (const auto& [path, entry] : next.entries) {
+        auto it = entries.find(path);
+        if (it == entries.end()) {
+            if (!entry.is_directory) {
+                result.added.push_back(path);
+            }
+            continue;
+        }
+        if (entry.is_directory) {
+            continue;
+        }
+        const ArchiveEntry& current = it->second;
+        if (current.is_directory || current.size != entry.size || current.crc != entry.crc
+            || unknownContent(current) || unknownContent(entry)) {
+            result.changed.push_back(path);
+        } else {
+            result.unchanged++;
+        }
+    }
+    for (const auto& [path, entry] : entries) {
+        auto it = next.entries.find(path);
+        if (entry.is_directory && it == next.entries.end()) {
+            result.removed_directories.push_back(path);
+        } else if (!entry.is_directory && (it == next.entries.end() || it->second.is_directory)) {
+            result.removed.push_back(path);
+        }
+    }
+    // a directory sorts before its content, so the reverse order removes children first
+    std::sort(result.removed_directories.rbegin(), result.removed_directories.rend());
+    return result;
+}
+
+std::string ArchiveManifest::toJson() const
+{
+    json11::Json::array items;
+    for (const auto& [path, entry] : entries) {
+        items.push_back(json11::Json::object{
+            {"path", entry.path},
+            {"size", static_cast<double>(entry.size)},
+            {"crc", entry.crc},
+            {"directory", entry.is_directory}});
+    }
+    return json11::Json(items).dump();
+}
+
+ArchiveManifest ArchiveManifest::fromJson(const std::string& json)
+{
+    ArchiveManifest manifest;
+    std::string error;
+    auto parsed = json11::Json::parse(json, error);
+    for (const auto& item : parsed.array_items()) {
+        ArchiveEntry entry;
+        entry.path = item["path"].string_value();
+        entry.size = static_cast<uint64_t>(item["size"].number_value());
+        entry.crc = item["crc"].string_value();
+        entry.is_directory = item["directory"].bool_value();
+        if (!entry.path.empty()) {
+            manifest.entries[entry.path] = entry;
+        }
+    }
+    return manifest;
+}
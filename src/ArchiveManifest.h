@@ -0,0 +1,77 @@
+#ifndef ARCHIVEMANIFEST_H
+#define ARCHIVEMANIFEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One file or directory of an archive, as `7z l -slt` lists it.
+ */
+struct ArchiveEntry {
+    std::string path;               // relative, '/' separated
+    uint64_t size = 0;
+    std::string crc;                // CRC32 as 8 upper case hex digits like 7z prints it, empty if unknown
+    bool is_directory = false;
+    bool encrypted = false;         // listing only, not kept in the JSON form
+};
+
+/**
+ * @brief What turns one manifest into another.
+ */
+struct ManifestDiff {
+    std::vector<std::string> added;
+    std::vector<std::string> changed;
+    std::vector<std::string> removed;                   // files
+    std::vector<std::string> removed_directories;       // deepest first
+    size_t unchanged = 0;
+
+    bool empty() const { return added.empty() && changed.empty() && removed.empty() && removed_directories.empty(); }
+    /**
+     * @brief true if path, or anything below it, was added, changed or removed
+     */
+    bool touches(const std::string& path) const;
+};
+
+/**
+ * @brief Sizes and CRCs of every entry of a project archive.
+ *
+ * The manifest of the archive a project was extracted from is kept with the project, so a newer
+ * archive can be compared entry by entry without extracting it: only entries whose size or CRC
+ * differ are extracted again.
+ */
+struct ArchiveManifest {
+    std::map<std::string, ArchiveEntry> entries;
+
+    /**
+     * @brief parses the output of `7z l -slt`
+     */
+    static ArchiveManifest parseSltListing(const std::string& output);
+
+    /**
+     * @brief manifest of an extracted directory, for the paths listed in `paths` only
+     *
+     * Used for projects extracted before manifests were kept: files the project created itself
+     * cannot be told apart from removed archive entries, so only entries of `paths` are looked at.
+     */
+    static ArchiveManifest fromDirectory(const std::string& root, const ArchiveManifest& paths);
+
+    /**
+     * @brief entries to add, extract again and delete so that this manifest becomes `next`
+     *
+     * An entry whose CRC is unknown on either side counts as changed unless it is empty.
+     */
+    ManifestDiff diff(const ArchiveManifest& next) const;
+
+    bool contains(const std::string& path) const { return entries.count(path) > 0; }
+
+    std::string toJson() const;
+    static ArchiveManifest fromJson(const std::string& json);
+
+    static uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+    static std::string formatCrc(uint32_t crc);
+};
+
+#endif // ARCHIVEMANIFEST_H
@@ -0,0 +1,255 @@
+#include "BatchManager.h"
+#include "JsonWriter.h"
+#include "json11.hpp"
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+namespace {
+
+// batches waiting for a worker at once, each queueing at most `concurrency` sub-requests
+constexpr size_t MAX_QUEUED_SUBREQUESTS = 256;
+
+const std::vector<std::pair<const char*, crow::HTTPMethod>> METHODS = {
+    {"GET", crow::HTTPMethod::Get},
+    {"HEAD", crow::HTTPMethod::Head},
+    {"POST", crow::HTTPMethod::Post},
+    {"PUT", crow::HTTPMethod::Put},
+    {"PATCH", crow::HTTPMethod::Patch},
+    {"DELETE", crow::HTTPMethod::Delete},
+};
+
+std::string errorBody(const std::string& error)
+{
+    JsonWriter json;
+    json.beginObject().field("success", false).field("error", error).endObject();
+    return json.release();
+}
+
+InProcessResponse errorResult(int code, const std::string& error)
+{
+    InProcessResponse result;
+    result.code = code;
+    result.body = errorBody(error);
+    result.content_type = "application/json";
+    return result;
+}
+
+long long millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+struct BatchManager::Batch {
+    std::vector<SubRequest> requests;
+    std::vector<InProcessResponse> results;
+    std::vector<size_t> runnable;       // indexes of the valid sub-requests
+    size_t concurrency = 1;
+    size_t next = 0;                    // position in runnable of the next sub-request to start
+    size_t pending = 0;                 // runnable sub-requests not answered yet
+    std::chrono::steady_clock::time_point started;
+    asio::io_context* io_context = nullptr;
+    crow::response* res = nullptr;
+    std::mutex mutex;
+};
+
+BatchManager::BatchManager(crow::SimpleApp& app, size_t workers, size_t maxRequests)
+    : app_(app)
+    , executor_("batch", std::max<size_t>(workers, 1), MAX_QUEUED_SUBREQUESTS)
+    , max_requests_(std::max<size_t>(maxRequests, 1))
+{
+}
+
+void BatchManager::registerRestEndpoints(crow::SimpleApp& app)
+{
+    CROW_ROUTE(app, "/api/batch").methods("POST"_method)
+    ([this](const crow::request& req, crow::response& res) {
+        handleBatch(req, res);
+    });
+}
+
+void BatchManager::handleBatch(const crow::request& req, crow::response& res)
+{
+    auto reject = [&res](const std::string& error) {
+        res.code = 400;
+        res.body = errorBody(error);
+        res.set_header("Content-Type", "application/json");
+        res.end();
+    };
+
+    std::string parse_error;
+    json11::Json body = json11::Json::parse(req.body, parse_error);
+    if (!parse_error.empty()) {
+        reject("Invalid JSON: " + parse_error);
+        return;
+    }
+    const json11::Json& items = body.is_array() ? body : body["requests"];
+    if (!items.is_array() || items.array_items().empty()) {
+        reject("Expected a non-empty array of requests");
+        return;
+    }
+    if (items.array_items().size() > max_requests_) {
+        reject("A batch may hold at most " + std::to_string(max_requests_) + " requests");
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->started = std::chrono::steady_clock::now();
+    batch->io_context = req.io_context;
+    batch->res = &res;
+    batch->concurrency = executor_.workers();
+    if (body["concurrency"].is_number()) {
+        batch->concurrency = std::clamp<size_t>(static_cast<size_t>(std::max(1, body["concurrency"].int_value())), 1, executor_.workers());
+    }
+
+    const auto& list = items.array_items();
+    batch->requests.resize(list.size());
+    batch->results.resize(list.size());
+    for (size_t i = 0; i < list.size(); i++) {
+        const json11::Json& item = list[i];
+        SubRequest& sub = batch->requests[i];
+
+        sub.method_name = item["method"].is_string() ? item["method"].string_value() : "GET";
+        std::transform(sub.method_name.begin(), sub.method_name.end(), sub.method_name.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        sub.path = item["path"].string_value();
+
+        auto method = std::find_if(METHODS.begin(), METHODS.end(),
+                                   [&sub](const auto& entry) { return sub.method_name == entry.first; });
+        if (!item.is_object()) {
+            sub.error = "Request must be an object";
+        } else if (method == METHODS.end()) {
+            sub.error = "Unsupported method: " + sub.method_name;
+        } else if (sub.path.rfind("/api/", 0) != 0) {
+            sub.error = "Path must start with /api/";
+        } else if (sub.path.rfind("/api/batch", 0) == 0) {
+            sub.error = "Batches cannot be nested";
+        }
+        if (!sub.error.empty()) {
+            batch->results[i] = errorResult(400, sub.error);
+            continue;
+        }
+        sub.method = method->second;
+
+        const json11::Json& sub_body = item["body"];
+        if (sub_body.is_string()) {
+            sub.body = sub_body.string_value();
+        } else if (!sub_body.is_null()) {
+            sub.body = sub_body.dump();
+            sub.headers.emplace_back("Content-Type", "application/json");
+        }
+        for (const auto& [name, value] : item["headers"].object_items()) {
+            if (value.is_string()) {
+                sub.headers.emplace_back(name, value.string_value());
+            }
+        }
+        batch->runnable.push_back(i);
+    }
+
+    batch->pending = batch->runnable.size();
+    if (batch->pending == 0) {
+        res = render(*batch);
+        res.end();
+        return;
+    }
+    for (size_t i = 0; i < batch->concurrency; i++) {
+        runNext(batch);
+    }
+}
+
+void BatchManager::runNext(const std::shared_ptr<Batch>& batch)
+{
+    for (;;) {
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            if (batch->next >= batch->runnable.size()) {
+                return;
+            }
+            index = batch->runnable[batch->next++];
+        }
+        try {
+            executor_.submit([this, batch, index]() {
+                const SubRequest& sub = batch->requests[index];
+                InProcessResponse result;
+                try {
+                    result = dispatchInProcess(app_, sub.method, sub.path, sub.body, sub.headers);
+                } catch (const std::exception& e) {
+                    result = errorResult(500, e.what());
+                }
+                finish(batch, index, std::move(result));
+                runNext(batch);
+            });
+            return;
+        } catch (const std::runtime_error&) {
+            // executor full: answer this sub-request and try the next one
+            InProcessResponse busy = errorResult(503, "Server is busy, retry later");
+            finish(batch, index, std::move(busy));
+        }
+    }
+}
+
+void BatchManager::finish(const std::shared_ptr<Batch>& batch, size_t index, InProcessResponse result)
+{
+    {
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        batch->results[index] = std::move(result);
+        if (--batch->pending > 0) {
+            return;
+        }
+    }
+
+    auto response = std::make_shared<crow::response>(render(*batch));
+    crow::response* res = batch->res;
+    auto end = [res, response]() {
+        *res = std::move(*response);
+        res->end();
+    };
+    if (batch->io_context) {
+        asio::post(*batch->io_context, end);
+    } else {
+        end();
+    }
+}
+
+bool BatchManager::isJson(const std::string& body)
+{
+    std::string parse_error;
+    json11::Json::parse(body, parse_error);
+    return parse_error.empty();
+}
+
+crow::response BatchManager::render(const Batch& batch)
+{
+    JsonWriter json(256 + batch.results.size() * 256);
+    json.beginObject()
+        .field("success", true)
+        .field("elapsed_ms", millisecondsSince(batch.started))
+        .field("concurrency", batch.concurrency)
+        .key("results").beginArray();
+    for (size_t i = 0; i < batch.results.size(); i++) {
+        const SubRequest& sub = batch.requests[i];
+        const InProcessResponse& result = batch.results[i];
+        json.beginObject()
+            .field("index", i)
+            .field("method", sub.method_name)
+            .field("path", sub.path)
+            .field("status", result.code)
+            .field("ok", result.code >= 200 && result.code < 300)
+            .field("elapsed_ms", result.elapsed_ms)
+            .key("body");
+        if (result.body.empty()) {
+            json.null();
+        } else if (result.content_type.find("json") != std::string::npos && isJson(result.body)) {
+            json.raw(result.body);
+        } else {
+            // includes a body that claims to be JSON but is not, which raw() would splice in as is
+            json.value(result.body);
+        }
+        json.endObject();
+    }
+    json.endArray().endObject();
+    return json.response(200);
+}
@@ -0,0 +1,69 @@
+#ifndef BATCHMANAGER_H
+#define BATCHMANAGER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <crow.h>
+#include "InProcessRequest.h"
+#include "TaskExecutor.h"
+
+/**
+ * @brief Serves POST /api/batch: many API requests sent in one round trip.
+ *
+ * The body lists the sub-requests, either as an array or as an object with a concurrency cap:
+ *
+ *     {"concurrency": 4, "requests": [
+ *         {"method": "GET", "path": "/api/projects"},
+ *         {"method": "POST", "path": "/api/projects/app/start", "body": {}}]}
+ *
+ * Each sub-request is dispatched through the app's router without a network hop, so it is answered
+ * exactly as the endpoint itself would answer it. The sub-requests are independent: up to
+ * `concurrency` of them run at once on the batch executor (1 runs them one after the other, in
+ * order). The results come back in request order with their status and timing:
+ *
+ *     {"success": true, "elapsed_ms": 42, "concurrency": 4, "results": [
+ *         {"index": 0, "method": "GET", "path": "/api/projects", "status": 200, "ok": true,
+ *          "elapsed_ms": 12, "body": {...}}, ...]}
+ *
+ * The batch route is asynchronous: no server thread waits for the sub-requests.
+ */
+class BatchManager {
+public:
+    /**
+     * @param workers sub-requests running at once over all batches, also the highest concurrency of one batch
+     * @param maxRequests sub-requests accepted in one batch
+     */
+    BatchManager(crow::SimpleApp& app, size_t workers, size_t maxRequests);
+
+    BatchManager(const BatchManager&) = delete;
+    BatchManager& operator=(const BatchManager&) = delete;
+
+    void registerRestEndpoints(crow::SimpleApp& app);
+
+private:
+    struct SubRequest {
+        crow::HTTPMethod method = crow::HTTPMethod::Get;
+        std::string method_name;
+        std::string path;
+        std::string body;
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::string error;      // set if the sub-request is invalid and not dispatched
+    };
+
+    struct Batch;
+
+    void handleBatch(const crow::request& req, crow::response& res);
+    void runNext(const std::shared_ptr<Batch>& batch);
+    void finish(const std::shared_ptr<Batch>& batch, size_t index, InProcessResponse result);
+    static crow::response render(const Batch& batch);
+    static bool isJson(const std::string& body);
+
+    crow::SimpleApp& app_;
+    TaskExecutor executor_;
+    const size_t max_requests_;
+};
+
+#endif // BATCHMANAGER_H
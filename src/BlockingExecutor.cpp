@@ -0,0 +1,61 @@
+#include "BlockingExecutor.h"
+#include "JsonWriter.h"
+
+namespace {
+
+crow::response errorResponse(int code, const std::string& error)
+{
+    JsonWriter json;
+    json.beginObject().field("success", false).field("error", error).endObject();
+    return json.response(code);
+}
+
+} // namespace
+
+BlockingExecutor::BlockingExecutor(size_t workers, size_t maxQueued)
+    : executor_("blocking", workers, maxQueued)
+{
+}
+
+bool BlockingExecutor::dispatch(std::function<void()> work)
+{
+    try {
+        // the future is not needed, the work reports through its own callbacks
+        executor_.submit(std::move(work));
+        return true;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+void BlockingExecutor::respond(const crow::request& req, crow::response& res, std::function<crow::response()> render)
+{
+    respond(req.io_context, res, std::move(render));
+}
+
+void BlockingExecutor::respond(asio::io_context* io_context, crow::response& res, std::function<crow::response()> render)
+{
+    const bool dispatched = dispatch([io_context, &res, render]() {
+        auto result = std::make_shared<crow::response>();
+        try {
+            *result = render();
+        } catch (const std::exception& e) {
+            *result = errorResponse(500, e.what());
+        }
+        auto end = [&res, result]() {
+            res = std::move(*result);
+            res.end();
+        };
+        if (io_context) {
+            asio::post(*io_context, end);
+        } else {
+            end();
+        }
+    });
+    if (!dispatched) {
+        crow::logger(crow::LogLevel::Warning) << "Blocking executor is full, answering 503";
+        res = errorResponse(503, "Server is busy, retry later");
+        res.set_header("Retry-After", "1");
+        res.end();
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef BLOCKINGEXECUTOR_H
+#define BLOCKINGEXECUTOR_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <crow.h>
+#include "TaskExecutor.h"
+
+/**
+ * @brief Runs request handlers that block (subprocesses, SQLite, filesystem walks) off crow's io threads.
+ *
+ * A handler hands its work over together with the `crow::response&` of an asynchronous route; the
+ * work runs on one of the executor's threads and the response it returns is written back from the
+ * connection's own io thread, since crow connections are not thread safe. The io threads are left
+ * to reading requests, writing responses and WebSocket frames.
+ *
+ *     CROW_ROUTE(app, "/api/thing")([this](const crow::request& req, crow::response& res) {
+ *         blocking->respond(req, res, [this]() { return slowHandler(); });
+ *     });
+ *
+ * When more than maxQueued handlers wait for a thread, further ones are answered with 503.
+ */
+class BlockingExecutor {
+public:
+    BlockingExecutor(size_t workers, size_t maxQueued);
+
+    BlockingExecutor(const BlockingExecutor&) = delete;
+    BlockingExecutor& operator=(const BlockingExecutor&) = delete;
+
+    /**
+     * @brief runs render on a worker, then ends res with its response on the connection's io thread
+     *
+     * An exception thrown by render is answered with 500. Without an io_context (a request dispatched
+     * in-process) res is ended from the worker.
+     */
+    void respond(const crow::request& req, crow::response& res, std::function<crow::response()> render);
+    void respond(asio::io_context* io_context, crow::response& res, std::function<crow::response()> render);
+
+    /**
+     * @brief runs work on a worker
+     * @return false if the queue is full
+     */
+    bool dispatch(std::function<void()> work);
+
+    size_t workers() const { return executor_.workers(); }
+    size_t queued() { return executor_.queued(); }
+
+private:
+    TaskExecutor executor_;
+};
+
+#endif // BLOCKINGEXECUTOR_H
@@ -0,0 +1,254 @@
+#include "CgroupSampler.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// cgroups below root searched for a container whose cgroup is not in a known place
+constexpr int MAX_SEARCH_DEPTH = 8;
+
+// calls fn(key, value) for each "key value" line, as in cpu.stat and memory.stat
+template <typename Fn>
+void forEachKeyValue(const std::string& text, Fn fn)
+{
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!line_end) {
+            line_end = end;
+        }
+        const char* space = static_cast<const char*>(memchr(p, ' ', line_end - p));
+        if (space) {
+            fn(std::string_view(p, space - p), strtoull(space + 1, nullptr, 10));
+        }
+        p = line_end + 1;
+    }
+}
+
+// sums the per-device "MAJ:MIN rbytes=.. wbytes=.. rios=.. wios=.." lines of io.stat
+void parseIoStat(const std::string& text, CgroupUsage& usage)
+{
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!line_end) {
+            line_end = end;
+        }
+        const char* field = static_cast<const char*>(memchr(p, ' ', line_end - p));
+        while (field && field < line_end) {
+            field++;
+            const char* equals = static_cast<const char*>(memchr(field, '=', line_end - field));
+            if (!equals) {
+                break;
+            }
+            const size_t name_length = equals - field;
+            const uint64_t value = strtoull(equals + 1, nullptr, 10);
+            if (name_length == 6 && memcmp(field, "rbytes", 6) == 0) usage.io_read_bytes += value;
+            else if (name_length == 6 && memcmp(field, "wbytes", 6) == 0) usage.io_write_bytes += value;
+            else if (name_length == 4 && memcmp(field, "rios", 4) == 0) usage.io_read_ops += value;
+            else if (name_length == 4 && memcmp(field, "wios", 4) == 0) usage.io_write_ops += value;
+            field = static_cast<const char*>(memchr(equals, ' ', line_end - equals));
+        }
+        p = line_end + 1;
+    }
+}
+
+double perSecond(uint64_t current, uint64_t previous, double seconds)
+{
+    return current >= previous && seconds > 0 ? (current - previous) / seconds : 0;
+}
+
+} // namespace
+
+void CgroupUsage::add(const CgroupUsage& other)
+{
+    cpu_usage_usec += other.cpu_usage_usec;
+    cpu_user_usec += other.cpu_user_usec;
+    cpu_system_usec += other.cpu_system_usec;
+    memory_current += other.memory_current;
+    memory_anon += other.memory_anon;
+    memory_file += other.memory_file;
+    io_read_bytes += other.io_read_bytes;
+    io_write_bytes += other.io_write_bytes;
+    io_read_ops += other.io_read_ops;
+    io_write_ops += other.io_write_ops;
+    cpu_percent += other.cpu_percent;
+    io_read_bytes_per_sec += other.io_read_bytes_per_sec;
+    io_write_bytes_per_sec += other.io_write_bytes_per_sec;
+}
+
+json11::Json CgroupUsage::toJson() const
+{
+    return json11::Json::object{
+        {"cpu_percent", cpu_percent},
+        {"cpu_usage_usec", static_cast<double>(cpu_usage_usec)},
+        {"cpu_user_usec", static_cast<double>(cpu_user_usec)},
+        {"cpu_system_usec", static_cast<double>(cpu_system_usec)},
+        {"memory_bytes", static_cast<double>(memory_current)},
+        {"memory_anon_bytes", static_cast<double>(memory_anon)},
+        {"memory_file_bytes", static_cast<double>(memory_file)},
+        {"io_read_bytes", static_cast<double>(io_read_bytes)},
+        {"io_write_bytes", static_cast<double>(io_write_bytes)},
+        {"io_read_ops", static_cast<double>(io_read_ops)},
+        {"io_write_ops", static_cast<double>(io_write_ops)},
+        {"io_read_bytes_per_sec", io_read_bytes_per_sec},
+        {"io_write_bytes_per_sec", io_write_bytes_per_sec}};
+}
+
+CgroupSampler::CgroupSampler(const std::string& root)
+    : root_(root)
+{
+    buffer_.reserve(16 * 1024);
+}
+
+CgroupSampler::~CgroupSampler()
+{
+    for (auto& [key, group] : groups_) {
+        closeGroup(group);
+    }
+}
+
+std::string CgroupSampler::findContainerCgroup(const std::string& containerId) const
+{
+    if (containerId.empty()) {
+        return "";
+    }
+    for (const std::string& candidate : {"system.slice/docker-" + containerId + ".scope", "docker/" + containerId}) {
+        if (access((root_ + "/" + candidate + "/cgroup.procs").c_str(), F_OK) == 0
+            || access((root_ + "/" + candidate + "/cpu.stat").c_str(), F_OK) == 0) {
+            return candidate;
+        }
+    }
+
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::recursive_directory_iterator it(root_, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_directory(ec)) {
+            continue;
+        }
+        if (it->path().filename().string().find(containerId) != std::string::npos) {
+            return fs::relative(it->path(), root_, ec).string();
+        }
+        if (it.depth() >= MAX_SEARCH_DEPTH) {
+            it.disable_recursion_pending();
+        }
+    }
+    return "";
+}
+
+int CgroupSampler::openFile(const std::string& path, const char* name) const
+{
+    return open((root_ + "/" + path + "/" + name).c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+void CgroupSampler::closeGroup(Group& group)
+{
+    for (int* fd : {&group.cpu_stat, &group.memory_current, &group.memory_stat, &group.io_stat}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+bool CgroupSampler::track(const std::string& key, const std::string& path)
+{
+    untrack(key);
+    Group group;
+    group.path = path;
+    group.cpu_stat = openFile(path, "cpu.stat");
+    if (group.cpu_stat < 0) {
+        return false;
+    }
+    group.memory_current = openFile(path, "memory.current");
+    group.memory_stat = openFile(path, "memory.stat");
+    group.io_stat = openFile(path, "io.stat");
+    groups_[key] = std::move(group);
+    return true;
+}
+
+void CgroupSampler::untrack(const std::string& key)
+{
+    auto it = groups_.find(key);
+    if (it != groups_.end()) {
+        closeGroup(it->second);
+        groups_.erase(it);
+    }
+}
+
+bool CgroupSampler::readFile(int fd)
+{
+    buffer_.resize(buffer_.capacity());
+    size_t length = 0;
+    while (true) {
+        if (length == buffer_.size()) {
+            buffer_.resize(buffer_.size() * 2);
+        }
+        ssize_t n = pread(fd, &buffer_[length], buffer_.size() - length, static_cast<off_t>(length));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            buffer_.clear();
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        length += static_cast<size_t>(n);
+    }
+    buffer_.resize(length);
+    return true;
+}
+
+bool CgroupSampler::read(const std::string& key, CgroupUsage& usage)
+{
+    auto it = groups_.find(key);
+    if (it == groups_.end()) {
+        return false;
+    }
+    Group& group = it->second;
+    usage = CgroupUsage{};
+
+    // a removed cgroup fails reads on its open files (ENODEV), which is how a stopped container shows
+    if (!readFile(group.cpu_stat)) {
+        return false;
+    }
+    forEachKeyValue(buffer_, [&usage](std::string_view name, uint64_t value) {
+        if (name == "usage_usec") usage.cpu_usage_usec = value;
+        else if (name == "user_usec") usage.cpu_user_usec = value;
+        else if (name == "system_usec") usage.cpu_system_usec = value;
+    });
+    if (group.memory_current >= 0 && readFile(group.memory_current)) {
+        usage.memory_current = strtoull(buffer_.c_str(), nullptr, 10);
+    }
+    if (group.memory_stat >= 0 && readFile(group.memory_stat)) {
+        forEachKeyValue(buffer_, [&usage](std::string_view name, uint64_t value) {
+            if (name == "anon") usage.memory_anon = value;
+            else if (name == "file") usage.memory_file = value;
+        });
+    }
+    if (group.io_stat >= 0 && readFile(group.io_stat)) {
+        parseIoStat(buffer_, usage);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (group.has_last) {
+        const double seconds = std::chrono::duration<double>(now - group.last_time).count();
+        usage.cpu_percent = perSecond(usage.cpu_usage_usec, group.last.cpu_usage_usec, seconds) / 1e4;
+        usage.io_read_bytes_per_sec = perSecond(usage.io_read_bytes, group.last.io_read_bytes, seconds);
+        usage.io_write_bytes_per_sec = perSecond(usage.io_write_bytes, group.last.io_write_bytes, seconds);
+    }
+    group.last = usage;
+    group.last_time = now;
+    group.has_last = true;
+    return true;
+}
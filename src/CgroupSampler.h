@@ -0,0 +1,101 @@
+#ifndef CGROUPSAMPLER_H
+#define CGROUPSAMPLER_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "json11.hpp"
+
+/**
+ * @brief Resource usage of one cgroup, or the sum of several.
+ *
+ * Counters are cumulative as the kernel reports them. Rates are computed from the previous read of
+ * the same cgroup and stay 0 on the first read.
+ */
+struct CgroupUsage {
+    uint64_t cpu_usage_usec = 0;
+    uint64_t cpu_user_usec = 0;
+    uint64_t cpu_system_usec = 0;
+    uint64_t memory_current = 0;
+    uint64_t memory_anon = 0;
+    uint64_t memory_file = 0;
+    uint64_t io_read_bytes = 0;
+    uint64_t io_write_bytes = 0;
+    uint64_t io_read_ops = 0;
+    uint64_t io_write_ops = 0;
+
+    double cpu_percent = 0;             // 100 is one fully used core
+    double io_read_bytes_per_sec = 0;
+    double io_write_bytes_per_sec = 0;
+
+    void add(const CgroupUsage& other);
+    json11::Json toJson() const;
+};
+
+/**
+ * @brief Reads container resource usage straight from the cgroup v2 filesystem.
+ *
+ * A tracked cgroup keeps cpu.stat, memory.current, memory.stat and io.stat open, every read is a
+ * pread of each file into one reused buffer, so sampling costs no process and no path lookups.
+ * Controllers that are not enabled for a cgroup simply read as 0. Not thread safe, meant to be
+ * driven by one sampling thread.
+ */
+class CgroupSampler {
+public:
+    /**
+     * @param root mount point of the cgroup v2 hierarchy, a directory tree with the same layout in tests
+     */
+    explicit CgroupSampler(const std::string& root = "/sys/fs/cgroup");
+    ~CgroupSampler();
+
+    CgroupSampler(const CgroupSampler&) = delete;
+    CgroupSampler& operator=(const CgroupSampler&) = delete;
+
+    /**
+     * @brief finds the cgroup of a docker container
+     *
+     * Tries the systemd (system.slice/docker-<id>.scope) and cgroupfs (docker/<id>) layouts first,
+     * then searches the tree, which covers rootless docker and other parents.
+     * @return path relative to root, empty if not found
+     */
+    std::string findContainerCgroup(const std::string& containerId) const;
+
+    /**
+     * @brief opens the files of cgroup path (relative to root) under key, replacing what key tracked
+     * @return false if the cgroup has no cpu.stat
+     */
+    bool track(const std::string& key, const std::string& path);
+    void untrack(const std::string& key);
+    bool tracks(const std::string& key) const { return groups_.count(key) > 0; }
+    size_t trackedCount() const { return groups_.size(); }
+
+    /**
+     * @brief reads the current usage of a tracked cgroup
+     * @return false if key is not tracked or the cgroup is gone (its container stopped)
+     */
+    bool read(const std::string& key, CgroupUsage& usage);
+
+private:
+    struct Group {
+        std::string path;
+        int cpu_stat = -1;
+        int memory_current = -1;
+        int memory_stat = -1;
+        int io_stat = -1;
+        bool has_last = false;
+        CgroupUsage last;
+        std::chrono::steady_clock::time_point last_time;
+    };
+
+    int openFile(const std::string& path, const char* name) const;
+    static void closeGroup(Group& group);
+    // reads a whole file into buffer_, false on error
+    bool readFile(int fd);
+
+    std::string root_;
+    std::map<std::string, Group> groups_;
+    std::string buffer_;
+};
+
+#endif // CGROUPSAMPLER_H
@@ -0,0 +1,123 @@
+#ifndef COALESCINGCACHE_H
+#define COALESCINGCACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Counters of a CoalescingCache
+ */
+struct CoalescingCacheStats {
+    uint64_t hits = 0;          // served from a fresh entry
+    uint64_t misses = 0;        // ran the loader
+    uint64_t coalesced = 0;     // waited on a loader another caller had already started
+    uint64_t invalidations = 0;
+    size_t entries = 0;
+};
+
+/**
+ * @brief TTL cache with request coalescing (singleflight) for idempotent queries.
+ *
+ * Concurrent get() calls for the same key share one loader execution: the first caller runs it,
+ * the others block on its result. The result is then served until its ttl expires or the key is
+ * invalidated. A loader that throws is not cached, every waiter receives the exception.
+ *
+ * Invalidating a key while its loader runs drops that result: callers already waiting still get
+ * it, later callers start a fresh load.
+ */
+template <typename Value>
+class CoalescingCache {
+public:
+    using Loader = std::function<Value()>;
+
+    Value get(const std::string& key, std::chrono::milliseconds ttl, const Loader& loader)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            Entry& entry = it->second;
+            if (!entry.ready) {
+                stats_.coalesced++;
+                auto future = entry.future;
+                lock.unlock();
+                return future.get();
+            }
+            if (std::chrono::steady_clock::now() < entry.expires) {
+                stats_.hits++;
+                auto future = entry.future;
+                lock.unlock();
+                return future.get();
+            }
+        }
+
+        stats_.misses++;
+        std::promise<Value> promise;
+        const uint64_t epoch = ++epoch_;
+        entries_[key] = Entry{promise.get_future().share(), {}, false, epoch};
+        lock.unlock();
+
+        try {
+            Value value = loader();
+            promise.set_value(value);
+
+            lock.lock();
+            auto done = entries_.find(key);
+            if (done != entries_.end() && done->second.epoch == epoch) {
+                done->second.ready = true;
+                done->second.expires = std::chrono::steady_clock::now() + ttl;
+            }
+            return value;
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            lock.lock();
+            auto failed = entries_.find(key);
+            if (failed != entries_.end() && failed->second.epoch == epoch) {
+                entries_.erase(failed);
+            }
+            throw;
+        }
+    }
+
+    void invalidate(const std::string& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.erase(key) > 0) {
+            stats_.invalidations++;
+        }
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.invalidations += entries_.size();
+        entries_.clear();
+    }
+
+    CoalescingCacheStats stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CoalescingCacheStats stats = stats_;
+        stats.entries = entries_.size();
+        return stats;
+    }
+
+private:
+    struct Entry {
+        std::shared_future<Value> future;
+        std::chrono::steady_clock::time_point expires;
+        bool ready = false;
+        uint64_t epoch = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+    CoalescingCacheStats stats_;
+    uint64_t epoch_ = 0;
+};
+
+#endif // COALESCINGCACHE_H
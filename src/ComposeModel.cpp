@@ -0,0 +1,501 @@
+#include "ComposeModel.h"
+#include "json11.hpp"
+#include "node.hpp"
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace {
+
+std::string scalarToString(const fkyaml::node& node)
+{
+    if (node.is_string()) {
+        return node.as_str();
+    }
+    if (node.is_integer()) {
+        return std::to_string(node.as_int());
+    }
+    if (node.is_boolean()) {
+        return node.as_bool() ? "true" : "false";
+    }
+    if (node.is_float_number()) {
+        std::ostringstream oss;
+        oss << node.as_float();
+        return oss.str();
+    }
+    return "";
+}
+
+// accepts either a single scalar or a sequence of scalars
+std::vector<std::string> scalarOrSequence(const fkyaml::node& node)
+{
+    std::vector<std::string> values;
+    if (node.is_sequence()) {
+        for (const auto& item : node.as_seq()) {
+            if (item.is_mapping() && item.contains("path")) {
+                // env_file long syntax: {path: ..., required: ...}
+                values.push_back(scalarToString(item.at("path")));
+            } else if (item.is_scalar()) {
+                values.push_back(scalarToString(item));
+            }
+        }
+    } else if (node.is_scalar()) {
+        values.push_back(scalarToString(node));
+    }
+    return values;
+}
+
+json11::Json stringsToJson(const std::vector<std::string>& values)
+{
+    json11::Json::array arr;
+    for (const auto& value : values) {
+        arr.push_back(value);
+    }
+    return arr;
+}
+
+std::vector<std::string> jsonToStrings(const json11::Json& json)
+{
+    std::vector<std::string> values;
+    for (const auto& item : json.array_items()) {
+        values.push_back(item.string_value());
+    }
+    return values;
+}
+
+} // namespace
+
+std::string ComposeModel::hashContent(const std::string& content)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream oss;
+    oss << std::hex;
+    oss.width(16);
+    oss.fill('0');
+    oss << hash;
+    return oss.str();
+}
+
+ComposeModel ComposeModel::parse(const std::string& content, const std::string& filePath)
+{
+    ComposeModel model;
+    model.file_path = filePath;
+    model.content_hash = hashContent(content);
+    model.size = static_cast<int64_t>(content.size());
+
+    try {
+        auto root = fkyaml::node::deserialize(content);
+        if (!root.is_mapping() || !root.contains("services") || !root["services"].is_mapping()) {
+            model.error = "no services section found";
+            return model;
+        }
+
+        std::string shared;
+        for (const auto& [key, value] : root.as_map()) {
+            if (!(key.is_string() && key.as_str() == "services")) {
+                shared += fkyaml::node::serialize(key) + fkyaml::node::serialize(value);
+            }
+        }
+        model.shared_hash = hashContent(shared);
+
+        for (const auto& [service_key, service_config] : root["services"].as_map()) {
+            if (fkyaml::node_type::STRING != service_key.get_type()) {
+                model.error = "invalid node type service";
+                return model;
+            }
+
+            ComposeServiceModel service;
+            service.name = service_key.as_str();
+            service.definition_hash = hashContent(fkyaml::node::serialize(service_config));
+
+            if (!service_config.is_mapping()) {
+                model.services.push_back(service);
+                continue;
+            }
+
+            if (service_config.contains("image")) {
+                service.image = scalarToString(service_config.at("image"));
+            }
+
+            if (service_config.contains("build")) {
+                const auto& build = service_config.at("build");
+                if (build.is_string()) {
+                    service.build_context = build.as_str();
+                } else if (build.is_mapping()) {
+                    if (build.contains("context")) {
+                        service.build_context = scalarToString(build.at("context"));
+                    }
+                    if (build.contains("dockerfile")) {
+                        service.dockerfile = scalarToString(build.at("dockerfile"));
+                    }
+                }
+            }
+
+            if (service_config.contains("env_file")) {
+                service.env_files = scalarOrSequence(service_config.at("env_file"));
+            }
+
+            if (service_config.contains("volumes") && service_config.at("volumes").is_sequence()) {
+                for (const auto& volume : service_config.at("volumes").as_seq()) {
+                    if (volume.is_string()) {
+                        service.volumes.push_back(volume.as_str());
+                    } else if (volume.is_mapping() && volume.contains("source") && volume.contains("target")) {
+                        service.volumes.push_back(scalarToString(volume.at("source")) + ":" + scalarToString(volume.at("target")));
+                    }
+                }
+            }
+
+            if (service_config.contains("depends_on")) {
+                const auto& depends_on = service_config.at("depends_on");
+                if (depends_on.is_mapping()) {
+                    for (const auto& [dependency, condition] : depends_on.as_map()) {
+                        service.depends_on.push_back(scalarToString(dependency));
+                    }
+                } else {
+                    service.depends_on = scalarOrSequence(depends_on);
+                }
+            }
+
+            if (service_config.contains("ports") && service_config.at("ports").is_sequence()) {
+                for (const auto& port : service_config.at("ports").as_seq()) {
+                    if (port.is_scalar()) {
+                        service.ports.push_back(scalarToString(port));
+                    } else if (port.is_mapping() && port.contains("target")) {
+                        std::string mapping = scalarToString(port.at("target"));
+                        if (port.contains("published")) {
+                            mapping = scalarToString(port.at("published")) + ":" + mapping;
+                        }
+                        if (port.contains("protocol")) {
+                            mapping += "/" + scalarToString(port.at("protocol"));
+                        }
+                        service.ports.push_back(mapping);
+                    }
+                }
+            }
+
+            if (service_config.contains("healthcheck") && service_config.at("healthcheck").is_mapping()) {
+                const auto& healthcheck = service_config.at("healthcheck");
+                service.has_healthcheck = !(healthcheck.contains("disable") && healthcheck.at("disable").is_boolean() && healthcheck.at("disable").as_bool());
+                if (healthcheck.contains("test")) {
+                    std::string test;
+                    for (const auto& part : scalarOrSequence(healthcheck.at("test"))) {
+                        test += (test.empty() ? "" : " ") + part;
+                    }
+                    service.healthcheck_test = test;
+                }
+            }
+
+            model.services.push_back(service);
+        }
+
+        if (model.services.empty()) {
+            model.error = "no service found in docker file";
+            return model;
+        }
+        model.valid = true;
+    } catch (const std::exception& e) {
+        model.error = e.what();
+    }
+    return model;
+}
+
+std::vector<std::string> ComposeModel::serviceNames() const
+{
+    std::vector<std::string> names;
+    for (const auto& service : services) {
+        names.push_back(service.name);
+    }
+    return names;
+}
+
+std::vector<std::string> ComposeModel::images() const
+{
+    std::vector<std::string> list;
+    for (const auto& service : services) {
+        if (!service.image.empty()) {
+            list.push_back(service.image);
+        }
+    }
+    return list;
+}
+
+const ComposeServiceModel* ComposeModel::service(const std::string& name) const
+{
+    for (const auto& service : services) {
+        if (service.name == name) {
+            return &service;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> ComposeServiceModel::dependentFiles() const
+{
+    std::vector<std::string> files;
+    if (!build_context.empty()) {
+        files.push_back(build_context);
+    }
+    if (!dockerfile.empty()) {
+        files.push_back(dockerfile);
+    }
+    files.insert(files.end(), env_files.begin(), env_files.end());
+    for (const auto& volume : volumes) {
+        size_t colonPos = volume.find(':');
+        if (colonPos != std::string::npos) {
+            std::string hostPath = volume.substr(0, colonPos);
+            if (!hostPath.empty() && hostPath[0] != '/' && hostPath[0] != '$') {
+                files.push_back(hostPath);
+            }
+        }
+    }
+    return files;
+}
+
+std::vector<std::string> ComposeModel::dependentFiles() const
+{
+    std::vector<std::string> files;
+    for (const auto& service : services) {
+        const std::vector<std::string> service_files = service.dependentFiles();
+        files.insert(files.end(), service_files.begin(), service_files.end());
+    }
+    return files;
+}
+
+std::string ComposeModel::toJson() const
+{
+    json11::Json::array services_json;
+    for (const auto& service : services) {
+        services_json.push_back(json11::Json::object{
+            {"name", service.name},
+            {"image", service.image},
+            {"build_context", service.build_context},
+            {"dockerfile", service.dockerfile},
+            {"env_files", stringsToJson(service.env_files)},
+            {"volumes", stringsToJson(service.volumes)},
+            {"depends_on", stringsToJson(service.depends_on)},
+            {"ports", stringsToJson(service.ports)},
+            {"has_healthcheck", service.has_healthcheck},
+            {"healthcheck_test", service.healthcheck_test},
+            {"definition_hash", service.definition_hash}
+        });
+    }
+    json11::Json json = json11::Json::object{
+        {"file_path", file_path},
+        {"content_hash", content_hash},
+        {"mtime_ns", std::to_string(mtime_ns)},
+        {"size", std::to_string(size)},
+        {"valid", valid},
+        {"error", error},
+        {"shared_hash", shared_hash},
+        {"services", services_json}
+    };
+    return json.dump();
+}
+
+ComposeModel ComposeModel::fromJson(const std::string& json)
+{
+    ComposeModel model;
+    std::string err;
+    auto parsed = json11::Json::parse(json, err);
+    if (!err.empty()) {
+        model.error = "invalid cached model: " + err;
+        return model;
+    }
+    model.file_path = parsed["file_path"].string_value();
+    model.content_hash = parsed["content_hash"].string_value();
+    model.mtime_ns = std::atoll(parsed["mtime_ns"].string_value().c_str());
+    model.size = std::atoll(parsed["size"].string_value().c_str());
+    model.valid = parsed["valid"].bool_value();
+    model.error = parsed["error"].string_value();
+    model.shared_hash = parsed["shared_hash"].string_value();
+    for (const auto& item : parsed["services"].array_items()) {
+        ComposeServiceModel service;
+        service.name = item["name"].string_value();
+        service.image = item["image"].string_value();
+        service.build_context = item["build_context"].string_value();
+        service.dockerfile = item["dockerfile"].string_value();
+        service.env_files = jsonToStrings(item["env_files"]);
+        service.volumes = jsonToStrings(item["volumes"]);
+        service.depends_on = jsonToStrings(item["depends_on"]);
+        service.ports = jsonToStrings(item["ports"]);
+        service.has_healthcheck = item["has_healthcheck"].bool_value();
+        service.healthcheck_test = item["healthcheck_test"].string_value();
+        service.definition_hash = item["definition_hash"].string_value();
+        model.services.push_back(service);
+    }
+    return model;
+}
+
+std::map<std::string, std::string> ComposeModel::parseDotEnv(const std::string& content)
+{
+    auto trim = [](const std::string& text) {
+        const size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return std::string();
+        }
+        return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+    };
+
+    std::map<std::string, std::string> variables;
+    std::istringstream stream(content);
+    std::string line;
+    while (std::getline(stream, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line.compare(0, 7, "export ") == 0) {
+            line = trim(line.substr(7));
+        }
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        const std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+            value = value.substr(1, value.size() - 2);
+        } else {
+            const size_t comment = value.find(" #");
+            if (comment != std::string::npos) {
+                value = trim(value.substr(0, comment));
+            }
+        }
+        if (!key.empty()) {
+            variables[key] = value;
+        }
+    }
+    return variables;
+}
+
+std::string ComposeModel::interpolate(const std::string& content, const std::map<std::string, std::string>& variables)
+{
+    auto lookup = [&variables](const std::string& name, bool* set) {
+        auto it = variables.find(name);
+        *set = it != variables.end();
+        return *set ? it->second : std::string();
+    };
+    auto isNameChar = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+
+    std::string result;
+    result.reserve(content.size());
+    for (size_t i = 0; i < content.size(); i++) {
+        if (content[i] != '$' || i + 1 == content.size()) {
+            result += content[i];
+            continue;
+        }
+        const char next = content[i + 1];
+        if (next == '$') {
+            result += '$';
+            i++;
+        } else if (next == '{') {
+            const size_t close = content.find('}', i + 2);
+            if (close == std::string::npos) {
+                result += content.substr(i);
+                break;
+            }
+            const std::string expression = content.substr(i + 2, close - i - 2);
+            size_t end = 0;
+            while (end < expression.size() && isNameChar(expression[end])) {
+                end++;
+            }
+            bool set = false;
+            const std::string value = lookup(expression.substr(0, end), &set);
+            const std::string modifier = expression.substr(end);
+            const bool colon = !modifier.empty() && modifier[0] == ':';
+            const std::string operation = modifier.substr(colon ? 1 : 0);
+            const bool present = colon ? !value.empty() : set;
+            if (!operation.empty() && operation[0] == '-') {
+                result += present ? value : operation.substr(1);
+            } else if (!operation.empty() && operation[0] == '+') {
+                result += present ? operation.substr(1) : "";
+            } else {
+                result += value;        // also `?error`, which compose would fail on
+            }
+            i = close;
+        } else if (isNameChar(next)) {
+            size_t end = i + 1;
+            while (end < content.size() && isNameChar(content[end])) {
+                end++;
+            }
+            bool set = false;
+            result += lookup(content.substr(i + 1, end - i - 1), &set);
+            i = end - 1;
+        } else {
+            result += '$';
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<const ComposeModel> ComposeModelCache::get(const std::string& key, const std::string& filePath, bool* changed)
+{
+    if (changed) {
+        *changed = false;
+    }
+
+    struct stat st;
+    if (stat(filePath.c_str(), &st) != 0) {
+        auto missing = std::make_shared<ComposeModel>();
+        missing->file_path = filePath;
+        missing->error = "compose file not found: " + filePath;
+        return missing;
+    }
+    const int64_t mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    const int64_t size = static_cast<int64_t>(st.st_size);
+
+    std::shared_ptr<const ComposeModel> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = models_.find(key);
+        if (it != models_.end()) {
+            cached = it->second;
+        }
+    }
+    if (cached && cached->file_path == filePath && cached->mtime_ns == mtime_ns && cached->size == size) {
+        return cached;
+    }
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        auto unreadable = std::make_shared<ComposeModel>();
+        unreadable->file_path = filePath;
+        unreadable->error = "failed to open compose file: " + filePath;
+        return unreadable;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::shared_ptr<ComposeModel> model;
+    if (cached && cached->file_path == filePath && cached->content_hash == ComposeModel::hashContent(content)) {
+        // touched but unchanged, keep the compiled model
+        model = std::make_shared<ComposeModel>(*cached);
+    } else {
+        model = std::make_shared<ComposeModel>(ComposeModel::parse(content, filePath));
+    }
+    model->mtime_ns = mtime_ns;
+    model->size = size;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    models_[key] = model;
+    if (changed) {
+        *changed = true;
+    }
+    return model;
+}
+
+void ComposeModelCache::put(const std::string& key, const ComposeModel& model)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    models_[key] = std::make_shared<ComposeModel>(model);
+}
+
+void ComposeModelCache::erase(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    models_.erase(key);
+}
@@ -0,0 +1,104 @@
+#ifndef COMPOSEMODEL_H
+#define COMPOSEMODEL_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A single service of a docker compose file, as far as MetaInstaller cares about it
+ */
+struct ComposeServiceModel {
+    std::string name;
+    std::string image;
+    std::string build_context;
+    std::string dockerfile;
+    std::vector<std::string> env_files;
+    std::vector<std::string> volumes;       // raw short syntax, or "source:target" for the long syntax
+    std::vector<std::string> depends_on;
+    std::vector<std::string> ports;         // raw short syntax, or "published:target/protocol" for the long syntax
+    bool has_healthcheck = false;
+    std::string healthcheck_test;
+    std::string definition_hash;            // hash of the whole service definition, tells any change apart
+
+    /**
+     * @brief files/directories this service refers to (build context, dockerfile, env files, relative volume sources)
+     */
+    std::vector<std::string> dependentFiles() const;
+};
+
+/**
+ * @brief Compiled form of a docker compose file, built with a single fkyaml parse.
+ *
+ * The model remembers the content hash and the mtime/size of the file it was built from,
+ * so callers can tell cheaply whether it is still current.
+ */
+struct ComposeModel {
+    std::string file_path;
+    std::string content_hash;               // FNV-1a 64 of the file content, hex
+    int64_t mtime_ns = 0;
+    int64_t size = 0;
+    bool valid = false;
+    std::string error;
+    std::vector<ComposeServiceModel> services;
+    std::string shared_hash;                // hash of everything besides the services (networks, volumes, ...)
+
+    /**
+     * @brief parses compose yaml content into a model
+     * @param content yaml text
+     * @param filePath path recorded in the model (not read)
+     */
+    static ComposeModel parse(const std::string& content, const std::string& filePath = "");
+
+    std::vector<std::string> serviceNames() const;
+    std::vector<std::string> images() const;
+    const ComposeServiceModel* service(const std::string& name) const;
+    /**
+     * @brief files/directories the compose file refers to (build contexts, dockerfiles, env files, relative volume sources)
+     */
+    std::vector<std::string> dependentFiles() const;
+
+    std::string toJson() const;
+    static ComposeModel fromJson(const std::string& json);
+
+    static std::string hashContent(const std::string& content);
+
+    /**
+     * @brief variables of a `.env` file: KEY=VALUE lines, `#` comments, optional `export ` and quotes
+     */
+    static std::map<std::string, std::string> parseDotEnv(const std::string& content);
+    /**
+     * @brief substitutes `$VAR`, `${VAR}`, `${VAR:-default}`, `${VAR-default}`, `${VAR:+alt}` and `${VAR+alt}`
+     * the way compose does before parsing; `$$` is a literal `$`, unset variables are empty
+     */
+    static std::string interpolate(const std::string& content, const std::map<std::string, std::string>& variables);
+};
+
+/**
+ * @brief Thread safe per-project cache of compose models.
+ *
+ * get() only stats the file while its mtime and size match the cached model. When they differ the
+ * file is re-read and hashed, and parsed again only if the content hash changed.
+ */
+class ComposeModelCache {
+public:
+    /**
+     * @brief returns the current model for a project, rebuilding it if the file changed on disk
+     * @param key project name
+     * @param filePath compose file path
+     * @param changed set to true when the returned model differs from the cached one (needs persisting)
+     * @return model, never null. check ComposeModel::valid
+     */
+    std::shared_ptr<const ComposeModel> get(const std::string& key, const std::string& filePath, bool* changed = nullptr);
+    void put(const std::string& key, const ComposeModel& model);
+    void erase(const std::string& key);
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<const ComposeModel>> models_;
+};
+
+#endif // COMPOSEMODEL_H
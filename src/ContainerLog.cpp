@@ -0,0 +1,223 @@
+#include "ContainerLog.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <limits>
+
+namespace {
+
+std::string trim(const std::string& value)
+{
+    size_t start = value.find_first_not_of(" \t");
+    size_t end = value.find_last_not_of(" \t\r");
+    return start == std::string::npos ? "" : value.substr(start, end - start + 1);
+}
+
+} // namespace
+
+int64_t parseLogTimestamp(const std::string& value, int32_t* nanos)
+{
+    if (nanos) {
+        *nanos = 0;
+    }
+    if (value.empty()) {
+        return -1;
+    }
+    if (std::all_of(value.begin(), value.end(), ::isdigit)) {
+        return value.size() <= 12 ? std::stoll(value) : -1;
+    }
+
+    std::tm tm{};
+    int consumed = 0;
+    if (sscanf(value.c_str(), "%4d-%2d-%2dT%2d:%2d:%2d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+               &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &consumed) != 6 || consumed != 19) {
+        return -1;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    int64_t seconds = timegm(&tm);
+
+    size_t pos = 19;
+    if (pos < value.size() && value[pos] == '.') {
+        pos++;
+        int32_t fraction = 0;
+        int digits = 0;
+        while (pos < value.size() && isdigit(static_cast<unsigned char>(value[pos]))) {
+            if (digits < 9) {
+                fraction = fraction * 10 + (value[pos] - '0');
+                digits++;
+            }
+            pos++;
+        }
+        for (; digits < 9; digits++) {
+            fraction *= 10;
+        }
+        if (nanos) {
+            *nanos = fraction;
+        }
+    }
+    if (pos < value.size() && (value[pos] == '+' || value[pos] == '-')) {
+        int hours = 0, minutes = 0;
+        if (sscanf(value.c_str() + pos + 1, "%2d:%2d", &hours, &minutes) != 2) {
+            return -1;
+        }
+        int64_t offset = hours * 3600 + minutes * 60;
+        seconds += value[pos] == '+' ? -offset : offset;
+    } else if (pos < value.size() && value[pos] != 'Z') {
+        return -1;
+    }
+    return seconds;
+}
+
+LogLine LogLine::parse(const std::string& raw)
+{
+    LogLine line;
+    std::string rest = raw;
+    // compose prefixes each line with the container name: "project-web-1  | <timestamp> <message>"
+    auto separator = raw.find(" | ");
+    if (separator != std::string::npos) {
+        line.container = trim(raw.substr(0, separator));
+        rest = raw.substr(separator + 3);
+    }
+    if (!rest.empty() && rest.back() == '\r') {
+        rest.pop_back();
+    }
+
+    auto space = rest.find(' ');
+    if (space != std::string::npos && !rest.empty() && isdigit(static_cast<unsigned char>(rest[0]))) {
+        line.seconds = parseLogTimestamp(rest.substr(0, space), &line.nanos);
+    }
+    if (line.seconds >= 0) {
+        line.timestamp = rest.substr(0, space);
+        line.message = rest.substr(space + 1);
+    } else {
+        line.message = rest;
+    }
+    return line;
+}
+
+json11::Json LogLine::toJson() const
+{
+    return json11::Json::object{
+        {"container", container},
+        {"timestamp", timestamp},
+        {"message", message}};
+}
+
+std::string LogPosition::cursor() const
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%lld.%09d-%zu", static_cast<long long>(seconds), nanos, skip);
+    return buffer;
+}
+
+std::string LogPosition::rfc3339() const
+{
+    time_t time = static_cast<time_t>(seconds);
+    std::tm tm{};
+    gmtime_r(&time, &tm);
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%09dZ", tm.tm_year + 1900, tm.tm_mon + 1,
+             tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, nanos);
+    return buffer;
+}
+
+bool LogPosition::fromCursor(const std::string& cursor, LogPosition& position)
+{
+    long long seconds = 0;
+    int nanos = 0;
+    size_t skip = 0;
+    int consumed = 0;
+    if (sscanf(cursor.c_str(), "%lld.%9d-%zu%n", &seconds, &nanos, &skip, &consumed) != 3
+        || consumed != static_cast<int>(cursor.size()) || seconds < 0 || nanos < 0) {
+        return false;
+    }
+    position.seconds = seconds;
+    position.nanos = nanos;
+    position.skip = skip;
+    return true;
+}
+
+bool logLineBefore(const LogLine& a, const LogLine& b)
+{
+    if (a.seconds != b.seconds) {
+        return a.seconds < b.seconds;
+    }
+    if (a.nanos != b.nanos) {
+        return a.nanos < b.nanos;
+    }
+    return a.container < b.container;
+}
+
+LogPage selectLogPage(std::vector<LogLine> lines, const LogQuery& query)
+{
+    lines.erase(std::remove_if(lines.begin(), lines.end(), [](const LogLine& line) { return line.seconds < 0; }),
+                lines.end());
+    std::stable_sort(lines.begin(), lines.end(), logLineBefore);
+
+    // position of each line among the lines sharing its timestamp
+    std::vector<size_t> group(lines.size(), 0);
+    for (size_t i = 1; i < lines.size(); i++) {
+        bool same = lines[i].seconds == lines[i - 1].seconds && lines[i].nanos == lines[i - 1].nanos;
+        group[i] = same ? group[i - 1] + 1 : 0;
+    }
+
+    LogPosition lower = (!query.backward && query.cursor.valid()) ? query.cursor : query.since;
+    LogPosition upper = query.until;
+    if (query.until.valid()) {
+        // until includes every line of its timestamp
+        upper.skip = std::numeric_limits<size_t>::max();
+    }
+    if (query.backward && query.cursor.valid()) {
+        upper = query.cursor;
+    }
+
+    auto compare = [&](size_t i, const LogPosition& position) {
+        // <0: line before position, >0: line at or after it
+        if (lines[i].seconds != position.seconds) return lines[i].seconds < position.seconds ? -1 : 1;
+        if (lines[i].nanos != position.nanos) return lines[i].nanos < position.nanos ? -1 : 1;
+        return group[i] < position.skip ? -1 : 1;
+    };
+
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lower.valid() && compare(i, lower) < 0) continue;
+        if (upper.valid() && compare(i, upper) > 0) continue;
+        candidates.push_back(i);
+    }
+
+    LogPage page;
+    page.has_more = candidates.size() > query.limit;
+    if (candidates.size() > query.limit) {
+        if (query.backward) {
+            candidates.erase(candidates.begin(), candidates.end() - query.limit);
+        } else {
+            candidates.resize(query.limit);
+        }
+    }
+    for (size_t i : candidates) {
+        page.lines.push_back(lines[i]);
+    }
+
+    if (candidates.empty()) {
+        // nothing in range, both continuations stay where the query started
+        LogPosition boundary = query.backward ? upper : lower;
+        if (boundary.skip == std::numeric_limits<size_t>::max()) {
+            // just after until: the first nanosecond past it
+            boundary.skip = 0;
+            if (++boundary.nanos == 1000000000) {
+                boundary.seconds++;
+                boundary.nanos = 0;
+            }
+        }
+        page.before = boundary;
+        page.after = boundary;
+        return page;
+    }
+    const size_t first = candidates.front();
+    const size_t last = candidates.back();
+    page.before = {lines[first].seconds, lines[first].nanos, group[first]};
+    page.after = {lines[last].seconds, lines[last].nanos, group[last] + 1};
+    return page;
+}
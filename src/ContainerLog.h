@@ -0,0 +1,100 @@
+#ifndef CONTAINERLOG_H
+#define CONTAINERLOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "json11.hpp"
+
+/**
+ * @brief parses an RFC 3339 time (with optional fraction and offset) or unix seconds
+ * @param nanos receives the fractional part in nanoseconds, if given
+ * @return unix seconds, -1 if value is neither
+ */
+int64_t parseLogTimestamp(const std::string& value, int32_t* nanos = nullptr);
+
+/**
+ * @brief One line of `docker compose logs --timestamps` output.
+ */
+struct LogLine {
+    std::string container;
+    std::string timestamp;      // as printed by docker, empty if the line had none
+    std::string message;
+    int64_t seconds = -1;
+    int32_t nanos = 0;
+
+    /**
+     * @brief splits "project-web-1  | 2025-07-10T09:03:00.000000000Z message" into its parts
+     */
+    static LogLine parse(const std::string& raw);
+
+    json11::Json toJson() const;
+};
+
+/**
+ * @brief A place in a log, between two lines: after the first `skip` lines stamped (seconds, nanos).
+ *
+ * Lines are ordered by timestamp, then container, then output order. Lines sharing a timestamp are
+ * told apart by `skip`, so a position stays exact when many lines have the same time. Positions are
+ * handed to clients as opaque cursors.
+ */
+struct LogPosition {
+    int64_t seconds = -1;
+    int32_t nanos = 0;
+    size_t skip = 0;
+
+    bool valid() const { return seconds >= 0; }
+
+    /**
+     * @brief encodes the position as a cursor string
+     */
+    std::string cursor() const;
+
+    /**
+     * @brief the timestamp as RFC 3339 with nanoseconds, as `docker logs --since/--until` accept it
+     */
+    std::string rfc3339() const;
+
+    /**
+     * @brief decodes a cursor produced by cursor()
+     * @return false if the cursor is malformed
+     */
+    static bool fromCursor(const std::string& cursor, LogPosition& position);
+};
+
+/**
+ * @brief A page request over a container log.
+ *
+ * Forward pages return the oldest lines after `cursor` (or from `since`), backward pages the newest
+ * lines before `cursor` (or up to `until`, or now).
+ */
+struct LogQuery {
+    std::string service;
+    LogPosition since;
+    LogPosition until;
+    LogPosition cursor;
+    size_t limit = 200;
+    bool backward = false;
+};
+
+struct LogPage {
+    std::vector<LogLine> lines;     // oldest first
+    LogPosition before;             // position before the first line, continues backward
+    LogPosition after;              // position after the last line, continues forward
+    bool has_more = false;          // more lines exist in the requested direction
+};
+
+/**
+ * @brief orders two lines by timestamp, then container
+ */
+bool logLineBefore(const LogLine& a, const LogLine& b);
+
+/**
+ * @brief selects the page query asks for from lines fetched from docker
+ *
+ * lines must hold every line of each timestamp it contains, which `docker logs --since/--until`
+ * guarantee since both bounds are inclusive. Lines without a timestamp are ignored.
+ */
+LogPage selectLogPage(std::vector<LogLine> lines, const LogQuery& query);
+
+#endif // CONTAINERLOG_H
@@ -0,0 +1,356 @@
+#include "ContentStore.h"
+#include "ImageArchive.h"
+#include "utils.h"
+#include <crow.h>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <linux/fs.h>
+
+namespace fs = std::filesystem;
+
+void ContentStore::Sha256::update(const void* input, size_t size)
+{
+    const unsigned char* data = static_cast<const unsigned char*>(input);
+    length_ += size;
+    if (buffered_ > 0) {
+        const size_t take = std::min(size, block_.size() - buffered_);
+        std::memcpy(block_.data() + buffered_, data, take);
+        buffered_ += take;
+        data += take;
+        size -= take;
+        if (buffered_ < block_.size()) {
+            return;
+        }
+        compress(block_.data());
+        buffered_ = 0;
+    }
+    for (; size >= block_.size(); data += block_.size(), size -= block_.size()) {
+        compress(data);
+    }
+    std::memcpy(block_.data(), data, size);
+    buffered_ = size;
+}
+
+std::string ContentStore::Sha256::hex()
+{
+    const uint64_t bits = length_ * 8;
+    const unsigned char pad = 0x80;
+    const unsigned char zero = 0;
+    update(&pad, 1);
+    while (buffered_ != 56) {
+        update(&zero, 1);
+    }
+    unsigned char length[8];
+    for (int i = 0; i < 8; i++) {
+        length[i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+    }
+    update(length, 8);
+
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(64);
+    for (uint32_t word : state_) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            out += digits[(word >> shift) & 0xF];
+        }
+    }
+    return out;
+}
+
+namespace {
+
+uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+} // namespace
+
+void ContentStore::Sha256::compress(const unsigned char* p)
+{
+    static const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t(p[4 * i]) << 24) | (uint32_t(p[4 * i + 1]) << 16) | (uint32_t(p[4 * i + 2]) << 8) | uint32_t(p[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; i++) {
+        const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+    for (int i = 0; i < 64; i++) {
+        const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+    state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+}
+
+ContentStore::ContentStore(const std::string& root, uint64_t minSize)
+    : root_(root)
+    , min_size_(minSize)
+{
+    std::error_code ec;
+    fs::create_directories(Utils::path_join_multiple({root_, "blobs"}), ec);
+    if (ec) {
+        crow::logger(crow::LogLevel::Warning) << "Cannot create content store in " << root_ << ": " << ec.message();
+    }
+}
+
+std::string ContentStore::sha256(const void* data, size_t size)
+{
+    Sha256 hash;
+    hash.update(data, size);
+    return hash.hex();
+}
+
+std::string ContentStore::sha256File(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return "";
+    }
+    Sha256 hash;
+    std::vector<unsigned char> buffer(1 << 20);
+    ssize_t n;
+    while ((n = ::read(fd, buffer.data(), buffer.size())) > 0) {
+        hash.update(buffer.data(), static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return n < 0 ? "" : hash.hex();
+}
+
+ContentStore::LinkKind ContentStore::linkFile(const std::string& source, const std::string& target, LinkKind fallback)
+{
+    const int src = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src < 0) {
+        return LinkKind::None;
+    }
+    struct stat st;
+    if (::fstat(src, &st) != 0) {
+        ::close(src);
+        return LinkKind::None;
+    }
+    const int dst = ::open(target.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 07777);
+    if (dst < 0) {
+        ::close(src);
+        return LinkKind::None;
+    }
+#ifdef FICLONE
+    const bool cloned = ::ioctl(dst, FICLONE, src) == 0;
+#else
+    const bool cloned = false;
+#endif
+    ::close(dst);
+    ::close(src);
+    if (cloned) {
+        return LinkKind::Reflink;
+    }
+    ::unlink(target.c_str());
+    if (fallback == LinkKind::Hardlink) {
+        return ::link(source.c_str(), target.c_str()) == 0 ? LinkKind::Hardlink : LinkKind::None;
+    }
+    return LinkKind::None;
+}
+
+ContentStore::LinkKind ContentStore::fallbackFor(const ArchiveEntry& entry)
+{
+    return ImageArchive::isImage(entry.path) ? LinkKind::Hardlink : LinkKind::None;
+}
+
+std::string ContentStore::blobPath(const std::string& hash) const
+{
+    return Utils::path_join_multiple({root_, "blobs", hash.substr(0, 2), hash});
+}
+
+bool ContentStore::eligible(const ArchiveEntry& entry) const
+{
+    return !entry.is_directory && entry.size >= min_size_ && entry.size > 0 && !entry.crc.empty();
+}
+
+void ContentStore::removeBlobs(const std::vector<std::string>& hashes)
+{
+    for (const auto& hash : hashes) {
+        std::error_code ec;
+        fs::remove(blobPath(hash), ec);
+    }
+}
+
+std::set<std::string> ContentStore::linkKnown(const std::string& projectName, const ArchiveManifest& manifest, const std::string& targetRoot,
+                                              const ContentHash& contentHash)
+{
+    std::set<std::string> linked;
+
+    // size and CRC only name a candidate blob if no other blob shares them
+    std::map<std::pair<uint64_t, std::string>, std::vector<std::string>> by_key;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& blob : database_.loadContentBlobs()) {
+            by_key[{blob.size, blob.crc}].push_back(blob.hash);
+        }
+    }
+    if (by_key.empty()) {
+        return linked;
+    }
+
+    // a CRC32 match can be a collision: the content's SHA-256 must be the blob's. Hashing reads the
+    // whole entry, it runs before the store is locked
+    std::vector<std::pair<const ArchiveEntry*, std::string>> verified;
+    for (const auto& [path, entry] : manifest.entries) {
+        if (!eligible(entry)) {
+            continue;
+        }
+        auto it = by_key.find({entry.size, entry.crc});
+        if (it == by_key.end() || it->second.size() != 1) {
+            continue;
+        }
+        if (contentHash(path) == it->second.front()) {
+            verified.emplace_back(&entry, it->second.front());
+        }
+    }
+    if (verified.empty()) {
+        return linked;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ContentRef> refs;
+    uint64_t bytes = 0;
+    for (const auto& [entry, hash] : verified) {
+        const std::string& path = entry->path;
+        std::error_code exists;
+        if (!fs::exists(blobPath(hash), exists)) {
+            continue;   // released while it was hashed
+        }
+        const fs::path target = fs::path(targetRoot) / path;
+        std::error_code ec;
+        fs::create_directories(target.parent_path(), ec);
+        fs::remove(target, ec);
+        if (linkFile(blobPath(hash), target.string(), fallbackFor(*entry)) == LinkKind::None) {
+            continue;
+        }
+        linked.insert(path);
+        refs.push_back({path, hash, entry->size, entry->crc});
+        bytes += entry->size;
+    }
+
+    std::vector<std::string> orphaned;
+    if (!refs.empty() && !database_.saveContentRefs(projectName, refs, orphaned)) {
+        crow::logger(crow::LogLevel::Warning) << "Failed to save content store references of '" << projectName << "'";
+    }
+    removeBlobs(orphaned);
+    if (!linked.empty()) {
+        crow::logger(crow::LogLevel::Info) << "Content store: linked " << linked.size() << " files (" << bytes << " bytes) of '"
+                                           << projectName << "' instead of extracting them";
+    }
+    return linked;
+}
+
+void ContentStore::ingest(const std::string& projectName, const ArchiveManifest& manifest, const std::string& root,
+                          const std::set<std::string>& skip)
+{
+    // hashing reads every byte, it runs before the store is locked
+    std::vector<std::pair<const ArchiveEntry*, std::string>> hashed;
+    for (const auto& [path, entry] : manifest.entries) {
+        if (!eligible(entry) || skip.count(path)) {
+            continue;
+        }
+        const std::string file = (fs::path(root) / path).string();
+        std::error_code ec;
+        if (!fs::is_regular_file(fs::symlink_status(file, ec))) {
+            continue;
+        }
+        std::string hash = sha256File(file);
+        if (!hash.empty()) {
+            hashed.emplace_back(&entry, std::move(hash));
+        }
+    }
+    if (hashed.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ContentRef> refs;
+    size_t shared = 0;
+    for (const auto& [entry, hash] : hashed) {
+        const std::string file = (fs::path(root) / entry->path).string();
+        const std::string blob = blobPath(hash);
+        std::error_code ec;
+        if (fs::exists(blob, ec)) {
+            // same content stored already: the extracted copy gives way to a link. A file that cannot
+            // be linked stays as extracted and does not reference the blob
+            const std::string temporary = file + ".mi-link";
+            fs::remove(temporary, ec);
+            if (linkFile(blob, temporary, fallbackFor(*entry)) == LinkKind::None) {
+                continue;
+            }
+            fs::rename(temporary, file, ec);
+            if (ec) {
+                fs::remove(temporary, ec);
+                continue;
+            }
+            shared++;
+        } else {
+            fs::create_directories(fs::path(blob).parent_path(), ec);
+            const std::string temporary = blob + ".tmp";
+            fs::remove(temporary, ec);
+            if (linkFile(file, temporary, fallbackFor(*entry)) == LinkKind::None) {
+                continue;
+            }
+            fs::rename(temporary, blob, ec);
+            if (ec) {
+                fs::remove(temporary, ec);
+                continue;
+            }
+        }
+        refs.push_back({entry->path, hash, entry->size, entry->crc});
+    }
+
+    std::vector<std::string> orphaned;
+    if (!refs.empty() && !database_.saveContentRefs(projectName, refs, orphaned)) {
+        crow::logger(crow::LogLevel::Warning) << "Failed to save content store references of '" << projectName << "'";
+    }
+    removeBlobs(orphaned);
+    crow::logger(crow::LogLevel::Info) << "Content store: " << refs.size() << " files of '" << projectName << "' stored, "
+                                       << shared << " of them already known";
+}
+
+void ContentStore::release(const std::string& projectName, const std::vector<std::string>& paths)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> orphaned;
+    if (!database_.releaseContentRefs(projectName, paths, orphaned)) {
+        crow::logger(crow::LogLevel::Warning) << "Failed to release content store references of '" << projectName << "'";
+        return;
+    }
+    removeBlobs(orphaned);
+    if (!orphaned.empty()) {
+        crow::logger(crow::LogLevel::Info) << "Content store: freed " << orphaned.size() << " blobs no longer referenced";
+    }
+}
+
+ContentStore::Stats ContentStore::stats()
+{
+    Stats stats;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& blob : database_.loadContentBlobs()) {
+        stats.blobs++;
+        stats.bytes += blob.size;
+        stats.referenced_bytes += blob.size * static_cast<uint64_t>(std::max<int64_t>(blob.refs, 0));
+    }
+    return stats;
+}
@@ -0,0 +1,114 @@
+#ifndef CONTENTSTORE_H
+#define CONTENTSTORE_H
+
+#include <cstddef>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "ArchiveManifest.h"
+#include "MetaDatabase.h"
+
+/**
+ * @brief Keeps each large file of the loaded projects once on disk, whichever projects contain it.
+ *
+ * Blobs live under `<root>/blobs/<2 hex digits>/<sha256>`. A project file is a reflink of its blob
+ * (FICLONE, copy on write) where the filesystem supports it. Otherwise image archives, which nothing
+ * writes to once extracted, are hardlinked, and every other file is left out of the store: a hardlinked
+ * file written by one project would change under all the others, and a copy would save nothing. The
+ * database counts the project files linked to each blob and a blob is deleted once nothing references it.
+ *
+ * Archive entries carry a size and CRC: an entry matching exactly one stored blob is a candidate,
+ * linked instead of extracted once the SHA-256 of its content (streamed out of the archive, never
+ * written) equals the blob's. Extracted files are hashed with SHA-256 and either replaced by a link
+ * to the same content already stored or added to the store. Files smaller than minSize are left alone.
+ */
+class ContentStore {
+public:
+    struct Stats {
+        size_t blobs = 0;
+        uint64_t bytes = 0;                 // on disk, once per blob
+        uint64_t referenced_bytes = 0;      // as the projects see them
+    };
+
+    /**
+     * @brief incremental FIPS 180-4 SHA-256, for content streamed rather than read from a file
+     */
+    class Sha256 {
+    public:
+        void update(const void* data, size_t size);
+        /**
+         * @return hex digest; the hasher is finished afterwards
+         */
+        std::string hex();
+
+    private:
+        void compress(const unsigned char* block);
+
+        std::array<uint32_t, 8> state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        std::array<unsigned char, 64> block_{};
+        size_t buffered_ = 0;
+        uint64_t length_ = 0;
+    };
+
+    // SHA-256 hex digest of an archive entry's content, empty if it cannot be read
+    using ContentHash = std::function<std::string(const std::string& path)>;
+
+    ContentStore(const std::string& root, uint64_t minSize);
+
+    ContentStore(const ContentStore&) = delete;
+    ContentStore& operator=(const ContentStore&) = delete;
+
+    /**
+     * @brief links the files of manifest the store already holds below targetRoot
+     * @param contentHash hashes a candidate entry; size and CRC only preselect, the SHA-256 decides
+     * @return paths linked, which need not be extracted
+     */
+    std::set<std::string> linkKnown(const std::string& projectName, const ArchiveManifest& manifest, const std::string& targetRoot,
+                                    const ContentHash& contentHash);
+
+    /**
+     * @brief moves the extracted files of manifest found below root into the store and links them back
+     * @param skip paths that are links already
+     */
+    void ingest(const std::string& projectName, const ArchiveManifest& manifest, const std::string& root,
+                const std::set<std::string>& skip = {});
+
+    /**
+     * @brief drops the project's references to the given paths (all of them if none are given),
+     * deleting blobs nothing references any more
+     */
+    void release(const std::string& projectName, const std::vector<std::string>& paths = {});
+
+    Stats stats();
+    const std::string& root() const { return root_; }
+    uint64_t minSize() const { return min_size_; }
+
+    static std::string sha256(const void* data, size_t size);
+    /**
+     * @return hex digest of the file's content, empty if it cannot be read
+     */
+    static std::string sha256File(const std::string& path);
+
+private:
+    enum class LinkKind { None, Reflink, Hardlink };
+
+    // creates target as a reflink of source, or where reflinks are not supported as fallback
+    // (Hardlink, or None to give up)
+    static LinkKind linkFile(const std::string& source, const std::string& target, LinkKind fallback);
+    // hardlink for image archives, which are only read once extracted, nothing for anything else
+    static LinkKind fallbackFor(const ArchiveEntry& entry);
+    std::string blobPath(const std::string& hash) const;
+    bool eligible(const ArchiveEntry& entry) const;
+    void removeBlobs(const std::vector<std::string>& hashes);
+
+    const std::string root_;
+    const uint64_t min_size_;
+    MetaDatabase database_;
+    std::mutex mutex_;      // links, reference counts and blob removal
+};
+
+#endif // CONTENTSTORE_H
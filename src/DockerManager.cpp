@@ -5,6 +5,8 @@
 #include <fstream>
 #include <sstream>
 #include "json11.hpp"
+#include "JsonLines.h"
+#include "JsonWriter.h"
 #include "MarkdownToHtml.h"
 #include <thread>
 #include <chrono>
@@ -18,6 +20,34 @@
 
 namespace fs = std::filesystem;
 
+namespace {
+
+// Query cache keys and lifetimes. The dashboard polls service status every 2s per tab,
+// so its ttl is just below that: all tabs polling in the same window share one systemctl call.
+const std::string CACHE_KEY_DOCKER_INFO = "docker_info";
+const std::string CACHE_KEY_COMPOSE_INFO = "compose_info";
+const std::string CACHE_KEY_DOCKER_RUNNING = "docker_running";
+const std::string CACHE_KEY_SERVICE_STATUS = "service_status";
+const std::string CACHE_KEY_SYSTEM_INFO = "system_info";
+const std::string CACHE_KEY_DISK_USAGE = "disk_usage";
+
+constexpr std::chrono::milliseconds CACHE_TTL_VERSION_INFO{30000};
+constexpr std::chrono::milliseconds CACHE_TTL_SERVICE_STATUS{1500};
+constexpr std::chrono::milliseconds CACHE_TTL_SYSTEM_INFO{5000};
+constexpr std::chrono::milliseconds CACHE_TTL_DISK_USAGE{10000};
+
+crow::json::wvalue cacheStatsToJson(const CoalescingCacheStats& stats) {
+    crow::json::wvalue json;
+    json["hits"] = stats.hits;
+    json["misses"] = stats.misses;
+    json["coalesced"] = stats.coalesced;
+    json["invalidations"] = stats.invalidations;
+    json["entries"] = stats.entries;
+    return json;
+}
+
+} // namespace
+
 bool DockerManager::validateSudoPassword() {
     if (sudo_password_.empty()) {
         return false;
@@ -79,10 +109,12 @@ crow::response DockerManager::createUnauthorizedResponse(const std::string& oper
 
 DockerManager::DockerManager()
     : process_manager_(std::make_unique<ProcessManager>())
+    , image_index_(std::make_shared<ImageIndex>())
     , current_progress_{InstallationStatus::NOT_STARTED, 0, "Ready"}
     , docker_install_path_(/* std::filesystem::current_path().string() *//* std::string(".") + */ "/usr/local/bin")
     // , docker_compose_install_path_(/* std::filesystem::current_path().string() *//* std::string(".") + */ "/usr/local/bin")
     , installation_in_progress_(false)
+    , service_status_version_("docker-service", [this]() { return serviceStatusFingerprint(); })
 {
     
     {
@@ -655,6 +687,12 @@ bool DockerManager::addToSystemPath(const std::string& path) {
 }
 
 DockerInfo DockerManager::getDockerInfo() {
+    return docker_info_cache_.get(CACHE_KEY_DOCKER_INFO, CACHE_TTL_VERSION_INFO, [this]() {
+        return queryDockerInfo();
+    });
+}
+
+DockerInfo DockerManager::queryDockerInfo() {
     DockerInfo info;
     // broadcastLog(__FUNCTION__, "getting docker info", "info");
     try {
@@ -716,6 +754,12 @@ DockerInfo DockerManager::getDockerInfo() {
 }
 
 DockerComposeInfo DockerManager::getDockerComposeInfo() {
+    return compose_info_cache_.get(CACHE_KEY_COMPOSE_INFO, CACHE_TTL_VERSION_INFO, [this]() {
+        return queryDockerComposeInfo();
+    });
+}
+
+DockerComposeInfo DockerManager::queryDockerComposeInfo() {
     DockerComposeInfo info;
     
     try {
@@ -755,6 +799,12 @@ bool DockerManager::isDockerComposeInstalled() {
 }
 
 bool DockerManager::isDockerRunning() {
+    return docker_running_cache_.get(CACHE_KEY_DOCKER_RUNNING, CACHE_TTL_SERVICE_STATUS, [this]() {
+        return queryDockerRunning();
+    });
+}
+
+bool DockerManager::queryDockerRunning() {
     try {
         std::string output = executeCommandWithOutput("docker", {"info"});
         return !output.empty();
@@ -776,6 +826,7 @@ bool DockerManager::startDockerService() {
             sudo_password_,
             nullptr
         );
+        invalidateQueryCaches();
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -795,6 +846,7 @@ bool DockerManager::stopDockerService() {
             sudo_password_,
             nullptr
         );
+        invalidateQueryCaches();
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -810,6 +862,7 @@ bool DockerManager::restartDockerService() {
             sudo_password_,
             nullptr
         );
+        invalidateQueryCaches();
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -817,6 +870,12 @@ bool DockerManager::restartDockerService() {
 }
 
 std::string DockerManager::getDockerServiceStatus() {
+    return query_cache_.get(CACHE_KEY_SERVICE_STATUS, CACHE_TTL_SERVICE_STATUS, [this]() {
+        return queryDockerServiceStatus();
+    });
+}
+
+std::string DockerManager::queryDockerServiceStatus() {
     try {
         std::string output;
         auto [pid, ret_code] = process_manager_->startProcessBlocking(
@@ -843,12 +902,9 @@ std::vector<std::string> DockerManager::listContainers(bool all) {
         }
         
         std::string output = executeCommandWithOutput("docker", args);
-        std::istringstream iss(output);
-        std::string line;
-        while (std::getline(iss, line)) {
-            if (!line.empty() && line.find_first_of("{") != std::string::npos) {
-                containers.push_back(line);
-            }
+        JsonLineScanner scanner(output);
+        while (scanner.next()) {
+            containers.emplace_back(scanner.line());
         }
     } catch (const std::exception& e) {
         // Return empty vector on error
@@ -860,12 +916,9 @@ std::vector<std::string> DockerManager::listImages() {
     std::vector<std::string> images;
     try {
         std::string output = executeCommandWithOutput("docker", {"images", "--format", "json"});
-        std::istringstream iss(output);
-        std::string line;
-        while (std::getline(iss, line)) {
-            if (!line.empty() && line.find_first_of("{") != std::string::npos) {
-                images.push_back(line);
-            }
+        JsonLineScanner scanner(output);
+        while (scanner.next()) {
+            images.emplace_back(scanner.line());
         }
     } catch (const std::exception& e) {
         // Return empty vector on error
@@ -881,6 +934,12 @@ bool DockerManager::pullImage(const std::string& imageName, std::function<void(c
             {},
             progressCallback
         );
+        if (ret_code == 0) {
+            image_index_->add(imageName);
+            // the listing needs docker's id, size and date, refreshed on the next query
+            image_index_->invalidate();
+            query_cache_.invalidate(CACHE_KEY_DISK_USAGE);
+        }
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -888,6 +947,12 @@ bool DockerManager::pullImage(const std::string& imageName, std::function<void(c
 }
 
 std::string DockerManager::getSystemInfo() {
+    return query_cache_.get(CACHE_KEY_SYSTEM_INFO, CACHE_TTL_SYSTEM_INFO, [this]() {
+        return querySystemInfo();
+    });
+}
+
+std::string DockerManager::querySystemInfo() {
     try {
         return executeCommandWithOutput("docker", {"system", "info", "--format", "json"});
     } catch (const std::exception& e) {
@@ -896,28 +961,28 @@ std::string DockerManager::getSystemInfo() {
 }
 
 std::string DockerManager::getDiskUsage() {
+    return query_cache_.get(CACHE_KEY_DISK_USAGE, CACHE_TTL_DISK_USAGE, [this]() {
+        return queryDiskUsage();
+    });
+}
+
+std::string DockerManager::queryDiskUsage() {
     try {
         std::string output = executeCommandWithOutput("docker", {"system", "df", "--format", "json"});
         
-        // Parse each line as a separate JSON object and create an array
-        json11::Json::array result_array;
-        std::istringstream iss(output);
-        std::string line;
-        
-        while (std::getline(iss, line)) {
-            if (!line.empty()) {
-                std::string parse_error;
-                json11::Json json_obj = json11::Json::parse(line, parse_error);
-                
-                if (parse_error.empty()) {
-                    result_array.push_back(json_obj);
+        // Each line is one JSON object, join the well-formed ones into an array as they are
+        std::string result = "[";
+        JsonLineScanner scanner(output);
+        while (scanner.next()) {
+            if (scanner.valid()) {
+                if (result.size() > 1) {
+                    result += ",";
                 }
+                result += scanner.line();
             }
         }
-        
-        // Convert the array to a JSON string
-        json11::Json result(result_array);
-        return result.dump();
+        result += "]";
+        return result;
     } catch (const std::exception& e) {
         return std::string("Error: ") + e.what();
     }
@@ -931,6 +996,10 @@ bool DockerManager::cleanupSystem() {
             {},
             nullptr
         );
+        // prune removes dangling images we never hear about individually
+        image_index_->invalidate();
+        query_cache_.invalidate(CACHE_KEY_DISK_USAGE);
+        query_cache_.invalidate(CACHE_KEY_SYSTEM_INFO);
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -1165,6 +1234,12 @@ bool DockerManager::removeImage(const std::string& imageId, bool force) {
         args.push_back(imageId);
         
         auto [pid, ret_code] = process_manager_->startProcessBlocking("docker", args, {}, nullptr);
+        if (ret_code == 0) {
+            image_index_->remove(imageId);
+            // the listing needs docker's id, size and date, refreshed on the next query
+            image_index_->invalidate();
+            query_cache_.invalidate(CACHE_KEY_DISK_USAGE);
+        }
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -1178,12 +1253,21 @@ bool DockerManager::loadImageFromFile(const std::string& filePath) {
             return false;
         }
         
+        std::string output;
         auto [pid, ret_code] = process_manager_->startProcessBlocking(
             "docker", 
             {"load", "-i", filePath}, 
             {}, 
-            nullptr
+            [&output](const std::string& data) {
+                output += data;
+            }
         );
+        if (ret_code == 0) {
+            image_index_->addFromLoadOutput(output);
+            // the listing needs docker's id, size and date, refreshed on the next query
+            image_index_->invalidate();
+            query_cache_.invalidate(CACHE_KEY_DISK_USAGE);
+        }
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -1212,6 +1296,11 @@ bool DockerManager::tagImage(const std::string& sourceImage, const std::string&
             {}, 
             nullptr
         );
+        if (ret_code == 0) {
+            image_index_->add(targetTag);
+            // the listing needs docker's id, size and date, refreshed on the next query
+            image_index_->invalidate();
+        }
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -1230,6 +1319,12 @@ bool DockerManager::buildImage(const std::string& dockerfilePath, const std::str
             {}, 
             nullptr
         );
+        if (ret_code == 0) {
+            image_index_->add(imageName);
+            // the listing needs docker's id, size and date, refreshed on the next query
+            image_index_->invalidate();
+            query_cache_.invalidate(CACHE_KEY_DISK_USAGE);
+        }
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -1357,31 +1452,25 @@ std::vector<ContainerInfo> DockerManager::getDetailedContainers(bool all) {
             return containers;
         }
         
-        std::istringstream iss(output);
-        std::string line;
-        while (std::getline(iss, line)) {
-            if (line.empty()) continue;
-            
-            std::string parse_error;
-            json11::Json json = json11::Json::parse(line, parse_error);
-            
-            if (!parse_error.empty()) continue;
+        JsonLineScanner scanner(output);
+        JsonField fields[6];
+        while (scanner.next()) {
+            if (!scanner.fields({"ID", "Names", "Image", "Status", "CreatedAt", "Ports"}, fields)) continue;
             
             ContainerInfo info;
-            info.id = json["ID"].string_value();
-            info.name = json["Names"].string_value();
-            info.image = json["Image"].string_value();
-            info.status = json["Status"].string_value();
-            info.created = json["CreatedAt"].string_value();
+            info.id = fields[0].str();
+            info.name = fields[1].str();
+            info.image = fields[2].str();
+            info.status = fields[3].str();
+            info.created = fields[4].str();
             
             // Parse ports if available
-            std::string ports_str = json["Ports"].string_value();
-            if (!ports_str.empty()) {
-                std::istringstream ports_stream(ports_str);
-                std::string port;
-                while (std::getline(ports_stream, port, ',')) {
-                    info.ports.push_back(port);
-                }
+            std::string ports_str = fields[5].str();
+            std::string_view ports(ports_str);
+            while (!ports.empty()) {
+                const size_t comma = ports.find(',');
+                info.ports.emplace_back(ports.substr(0, comma));
+                ports = comma == std::string_view::npos ? std::string_view() : ports.substr(comma + 1);
             }
             
             containers.push_back(info);
@@ -1567,25 +1656,32 @@ bool DockerManager::composeServiceAction(const std::string& projectName, const s
 void DockerManager::registerRestEndpoints(crow::SimpleApp& app) {
     // Docker information endpoints
     CROW_ROUTE(app, "/api/docker/info").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleGetDockerInfo();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleGetDockerInfo();
+        });
     });
 
     CROW_ROUTE(app, "/api/docker-compose/info").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleGetDockerComposeInfo();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleGetDockerComposeInfo();
+        });
     });
 
     // Installation endpoints
     CROW_ROUTE(app, "/api/docker/install").methods("POST"_method)
-    ([this](const crow::request& req) {
-        // return handleInstallDocker();
-        return handleInstallDocker();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleInstallDocker(); });
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/uninstall").methods("DELETE"_method)
-    ([this](const crow::request& req) {
-        return handleUninstallDocker();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleUninstallDocker(); });
+        });
     });
 
     // CROW_ROUTE(app, "/api/docker-compose/install").methods("POST"_method)
@@ -1600,65 +1696,93 @@ void DockerManager::registerRestEndpoints(crow::SimpleApp& app) {
 
     // Service management endpoints
     CROW_ROUTE(app, "/api/docker/service/start").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleStartDockerService();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleStartDockerService();
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/service/stop").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleStopDockerService();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleStopDockerService();
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/service/restart").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleRestartDockerService();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleRestartDockerService();
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/service/status").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleGetServiceStatus();
+    ([this](const crow::request& req, crow::response& res) {
+        service_status_version_.serve(req, res, [this]() { return handleGetServiceStatus(); });
     });
 
     // Container and image management
     CROW_ROUTE(app, "/api/docker/containers").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleListContainers(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return handleListContainers(req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/images").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleListImages();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleListImages();
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/images/pull").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handlePullImage(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return handlePullImage(req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/containers/<string>").methods("DELETE"_method)
-    ([this](const crow::request& req, const std::string& containerId) {
-        return handleRemoveContainer(containerId, req);
+    ([this](const crow::request& req, crow::response& res, const std::string& containerId) {
+        respondBlocking(req, res, [this, &req, containerId]() {
+            return handleRemoveContainer(containerId, req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/images/<string>").methods("DELETE"_method)
-    ([this](const crow::request& req, const std::string& imageId) {
-        return handleRemoveImage(imageId, req);
+    ([this](const crow::request& req, crow::response& res, const std::string& imageId) {
+        respondBlocking(req, res, [this, &req, imageId]() {
+            return handleRemoveImage(imageId, req);
+        });
     });
 
     // System information endpoints
     CROW_ROUTE(app, "/api/docker/system/info").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleGetSystemInfo();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleGetSystemInfo();
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/system/df").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleGetDiskUsage();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleGetDiskUsage();
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/system/prune").methods("POST"_method)
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleCleanupSystem(); });
+        });
+    });
+
+    // Query cache statistics
+    CROW_ROUTE(app, "/api/docker/cache/stats").methods("GET"_method)
     ([this](const crow::request& req) {
-        return handleCleanupSystem();
+        return handleGetCacheStats();
     });
 
     // Installation progress endpoint
@@ -1669,100 +1793,138 @@ void DockerManager::registerRestEndpoints(crow::SimpleApp& app) {
 
     // Advanced image management endpoints
     CROW_ROUTE(app, "/api/docker/images/load").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleLoadImageFromFile(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleLoadImageFromFile(req); });
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/images/save").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleSaveImageToFile(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleSaveImageToFile(req); });
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/images/tag").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleTagImage(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return handleTagImage(req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/images/build").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleBuildImage(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleBuildImage(req); });
+        });
     });
 
     // Container lifecycle endpoints
     CROW_ROUTE(app, "/api/docker/containers/<string>/start").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& containerId) {
-        return handleStartContainer(containerId);
+    ([this](const crow::request& req, crow::response& res, const std::string& containerId) {
+        respondBlocking(req, res, [this, containerId]() {
+            return handleStartContainer(containerId);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/containers/<string>/stop").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& containerId) {
-        return handleStopContainer(containerId, req);
+    ([this](const crow::request& req, crow::response& res, const std::string& containerId) {
+        respondBlocking(req, res, [this, &req, containerId]() {
+            return handleStopContainer(containerId, req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/containers/<string>/restart").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& containerId) {
-        return handleRestartContainer(containerId, req);
+    ([this](const crow::request& req, crow::response& res, const std::string& containerId) {
+        respondBlocking(req, res, [this, &req, containerId]() {
+            return handleRestartContainer(containerId, req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/containers/<string>/pause").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& containerId) {
-        return handlePauseContainer(containerId);
+    ([this](const crow::request& req, crow::response& res, const std::string& containerId) {
+        respondBlocking(req, res, [this, containerId]() {
+            return handlePauseContainer(containerId);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/containers/<string>/unpause").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& containerId) {
-        return handleUnpauseContainer(containerId);
+    ([this](const crow::request& req, crow::response& res, const std::string& containerId) {
+        respondBlocking(req, res, [this, containerId]() {
+            return handleUnpauseContainer(containerId);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/containers/<string>/logs").methods("GET"_method)
-    ([this](const crow::request& req, const std::string& containerId) {
-        return handleGetContainerLogs(containerId, req);
+    ([this](const crow::request& req, crow::response& res, const std::string& containerId) {
+        respondBlocking(req, res, [this, &req, containerId]() {
+            return handleGetContainerLogs(containerId, req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/containers/detailed").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleGetDetailedContainers(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return handleGetDetailedContainers(req);
+        });
     });
 
     // Docker Compose endpoints
     CROW_ROUTE(app, "/api/docker/compose/projects").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleLoadComposeFile(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return handleLoadComposeFile(req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/compose/projects").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleListComposeProjects();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleListComposeProjects();
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/compose/projects/<string>").methods("DELETE"_method)
-    ([this](const crow::request& req, const std::string& projectName) {
-        return handleRemoveComposeProject(projectName);
+    ([this](const crow::request& req, crow::response& res, const std::string& projectName) {
+        respondBlocking(req, res, [this, projectName]() {
+            return handleRemoveComposeProject(projectName);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/compose/projects/<string>/up").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& projectName) {
-        return handleComposeUp(projectName, req);
+    ([this](const crow::request& req, crow::response& res, const std::string& projectName) {
+        respondBlocking(req, res, [this, &req, projectName]() {
+            return handleComposeUp(projectName, req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/compose/projects/<string>/down").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& projectName) {
-        return handleComposeDown(projectName, req);
+    ([this](const crow::request& req, crow::response& res, const std::string& projectName) {
+        respondBlocking(req, res, [this, &req, projectName]() {
+            return handleComposeDown(projectName, req);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/compose/projects/<string>/restart").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& projectName) {
-        return handleComposeRestart(projectName);
+    ([this](const crow::request& req, crow::response& res, const std::string& projectName) {
+        respondBlocking(req, res, [this, projectName]() {
+            return handleComposeRestart(projectName);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/compose/projects/<string>/services").methods("GET"_method)
-    ([this](const crow::request& req, const std::string& projectName) {
-        return handleComposeServices(projectName);
+    ([this](const crow::request& req, crow::response& res, const std::string& projectName) {
+        respondBlocking(req, res, [this, projectName]() {
+            return handleComposeServices(projectName);
+        });
     });
 
     CROW_ROUTE(app, "/api/docker/compose/projects/<string>/services/<string>/<string>").methods("POST"_method)
-    ([this](const crow::request& req, const std::string& projectName, const std::string& serviceName, const std::string& action) {
-        return handleComposeServiceAction(projectName, serviceName, req);
+    ([this](const crow::request& req, crow::response& res, const std::string& projectName, const std::string& serviceName, const std::string& /*action*/) {
+        respondBlocking(req, res, [this, &req, projectName, serviceName]() {
+            return handleComposeServiceAction(projectName, serviceName, req);
+        });
     });
 
     // Complete Docker installation endpoint (Docker + Docker Compose + Services)
@@ -1773,26 +1935,34 @@ void DockerManager::registerRestEndpoints(crow::SimpleApp& app) {
     
     // Service enablement endpoints
     CROW_ROUTE(app, "/api/docker/service/enable").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleEnableDockerService();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleEnableDockerService();
+        });
     });
     
     CROW_ROUTE(app, "/api/docker/service/disable").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleDisableDockerService();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleDisableDockerService();
+        });
     });
     
     // System integration status endpoint
     CROW_ROUTE(app, "/api/docker/system/integration-status").methods("GET"_method)
-    ([this](const crow::request& req) {
-        return handleGetSystemIntegrationStatus();
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleGetSystemIntegrationStatus();
+        });
     });
 
 
     // Test endpoint
     CROW_ROUTE(app, "/api/test/sudo").methods("POST"_method)
-    ([this](const crow::request& req) {
-        return handleTestSudo(req);
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            return handleTestSudo(req);
+        });
     });
 }
 
@@ -1910,6 +2080,7 @@ crow::response DockerManager::handleUninstallDocker() {
             }
         }
         bool success = uninstallDocker();
+        invalidateQueryCaches();
         
         crow::json::wvalue json_response;
         json_response["success"] = success;
@@ -2198,33 +2369,22 @@ crow::response DockerManager::handleListContainers(const crow::request& req) {
 crow::response DockerManager::handleListImages() {
     crow::response res;
     try {
-        std::vector<std::string> images = listImages();
+        std::vector<ImageRecord> images = image_index_->list();
         
-        crow::json::wvalue json_response;
-        json_response["images"] = crow::json::wvalue::list();
-        
-        for (size_t i = 0; i < images.size(); ++i) {
-            try {
-                // Parse the JSON string from Docker
-                crow::json::rvalue parsed_image = crow::json::load(images[i]);
-                
-                crow::json::wvalue image_obj;
-                image_obj["id"] = parsed_image["ID"].s();
-                image_obj["repository"] = parsed_image["Repository"].s();
-                image_obj["tag"] = parsed_image["Tag"].s();
-                image_obj["size"] = parsed_image["Size"].s();
-                image_obj["created"] = parsed_image["CreatedAt"].s();
-                
-                json_response["images"][i] = std::move(image_obj);
-            } catch (const std::exception& e) {
-                // If JSON parsing fails, skip this image
-                continue;
-            }
+        JsonWriter json(256 + images.size() * 256);
+        json.beginObject().key("images").beginArray();
+        for (const auto& image : images) {
+            json.beginObject()
+                .field("id", image.id)
+                .field("repository", image.repository.empty() ? "<none>" : image.repository)
+                .field("tag", image.tag.empty() ? "<none>" : image.tag)
+                .field("size", image.size)
+                .field("created", image.created)
+                .field("canonical", image.canonical)
+                .endObject();
         }
-        
-        res.code = 200;
-        res.set_header("Content-Type", "application/json");
-        res.write(json_response.dump());
+        json.endArray().endObject();
+        res = json.response(200);
         
         // Log success
         // broadcastLog("image_list", "Image list retrieved successfully", "info");
@@ -2955,29 +3115,20 @@ crow::response DockerManager::handleGetDetailedContainers(const crow::request& r
         bool all = req.url_params.get("all") != nullptr;
         std::vector<ContainerInfo> containers = getDetailedContainers(all);
         
-        crow::json::wvalue json_response;
-        json_response["containers"] = crow::json::wvalue::list();
-        
-        for (size_t i = 0; i < containers.size(); ++i) {
-            const auto& container = containers[i];
-            crow::json::wvalue container_json;
-            container_json["id"] = container.id;
-            container_json["name"] = container.name;
-            container_json["image"] = container.image;
-            container_json["status"] = container.status;
-            container_json["created"] = container.created;
-            container_json["ports"] = crow::json::wvalue::list();
-            
-            for (size_t j = 0; j < container.ports.size(); ++j) {
-                container_json["ports"][j] = container.ports[j];
-            }
-            
-            json_response["containers"][i] = std::move(container_json);
-        }
-        
-        res.code = 200;
-        res.set_header("Content-Type", "application/json");
-        res.write(json_response.dump());
+        JsonWriter json(256 + containers.size() * 384);
+        json.beginObject().key("containers").beginArray();
+        for (const auto& container : containers) {
+            json.beginObject()
+                .field("id", container.id)
+                .field("name", container.name)
+                .field("image", container.image)
+                .field("status", container.status)
+                .field("created", container.created)
+                .field("ports", container.ports)
+                .endObject();
+        }
+        json.endArray().endObject();
+        res = json.response(200);
         
         // Log success
         // broadcastLog("container_detailed", "Detailed container list retrieved successfully", "info");
@@ -3448,6 +3599,7 @@ crow::response DockerManager::handleInstallDocker() {
         bool dockerSuccess = installDocker([](const InstallationProgress& progress) {
             crow::logger(crow::LogLevel::Debug) <<"[STAT]:" << get_installation_status(progress.status) << ",[PERC]:" << progress.percentage << "%,[MSG]:" << progress.message << ",[ERR]:" << progress.error_details;
         });
+        invalidateQueryCaches();
         
         // bool dockerComposeSuccess = false;
         // if (dockerSuccess) {
@@ -3642,92 +3794,141 @@ crow::response DockerManager::handleGetSystemIntegrationStatus() {
 #include "DockerManager.h"
 #include <chrono>
 
-void DockerManager::setWebSocketConnections(std::vector<crow::websocket::connection*>* log_connections, 
-                                           std::vector<crow::websocket::connection*>* progress_connections) {
-    log_connections_ = log_connections;
-    progress_connections_ = progress_connections;
+void DockerManager::invalidateQueryCaches() {
+    docker_info_cache_.clear();
+    compose_info_cache_.clear();
+    docker_running_cache_.clear();
+    query_cache_.clear();
+    // only called when the docker service changed state, wake up long-polling status clients
+    service_status_version_.bump();
+}
+
+std::string DockerManager::serviceStatusFingerprint() {
+    std::string fingerprint = isDockerRunning() ? "running" : "not running";
+    std::string status = getDockerServiceStatus();
+    auto pos = status.find("Active:");
+    if (pos != std::string::npos) {
+        std::string active = status.substr(pos, status.find('\n', pos) - pos);
+        // "Active: active (running) since Mon ...; 2h ago" -> "Active: active (running)"
+        auto since = active.find(" since ");
+        fingerprint += "|" + active.substr(0, since);
+    }
+    return fingerprint;
+}
+
+crow::response DockerManager::handleGetCacheStats() {
+    crow::response res;
+    try {
+        crow::json::wvalue json_response;
+        json_response["docker_info"] = cacheStatsToJson(docker_info_cache_.stats());
+        json_response["compose_info"] = cacheStatsToJson(compose_info_cache_.stats());
+        json_response["docker_running"] = cacheStatsToJson(docker_running_cache_.stats());
+        json_response["queries"] = cacheStatsToJson(query_cache_.stats());
+
+        res.code = 200;
+        res.set_header("Content-Type", "application/json");
+        res.write(json_response.dump());
+    } catch (const std::exception& e) {
+        crow::json::wvalue error_response;
+        error_response["error"] = e.what();
+        res.code = 500;
+        res.set_header("Content-Type", "application/json");
+        res.write(error_response.dump());
+    }
+    return res;
+}
+
+void DockerManager::setImageIndex(std::shared_ptr<ImageIndex> image_index) {
+    image_index_ = image_index;
+}
+
+void DockerManager::setAdmissionControl(std::shared_ptr<AdmissionControl> admission) {
+    admission_ = admission;
+}
+
+crow::response DockerManager::admitted(const char* lane, const std::function<crow::response()>& handler) {
+    return admission_ ? admission_->run(lane, handler) : handler();
+}
+
+void DockerManager::setBlockingExecutor(std::shared_ptr<BlockingExecutor> blocking) {
+    blocking_ = blocking;
+    service_status_version_.setExecutor(blocking_.get());
+}
+
+void DockerManager::respondBlocking(const crow::request& req, crow::response& res, std::function<crow::response()> render) {
+    if (blocking_) {
+        blocking_->respond(req, res, std::move(render));
+        return;
+    }
+    res = render();
+    res.end();
+}
+
+void DockerManager::setWebSocketConnections(LogHub* log_hub, 
+                                           LogHub* progress_hub) {
+    log_hub_ = log_hub;
+    progress_hub_ = progress_hub;
 }
 
 void DockerManager::broadcastLog(const std::string& operation, const std::string& message, const std::string& level) {
-    if (!log_connections_) return;
-    
-    // Create JSON log message
-    crow::json::wvalue log_message;
-    log_message["type"] = "log";
-    log_message["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
-    log_message["operation"] = operation;
-    log_message["message"] = message;
-    log_message["level"] = level;
+    if (!log_hub_) return;
     
-    std::string json_str = log_message.dump();
-    
-    // Broadcast to all connected log clients
-    for (auto it = log_connections_->begin(); it != log_connections_->end(); ) {
-        auto* conn = *it;
-        try {
-            conn->send_text(json_str);
-            ++it;
-        } catch (const std::exception& e) {
-            // Remove invalid connection
-            it = log_connections_->erase(it);
-        }
-    }
+    // Serialized and sent only to clients subscribed to this operation's topic
+    log_hub_->publish(LogHub::topicForOperation(operation), operation, message, level);
 }
 
 void DockerManager::broadcastProgress(const InstallationProgress& progress) {
-    if (!progress_connections_) return;
-    
-    // Create JSON progress message
-    crow::json::wvalue progress_message;
-    progress_message["type"] = "progress";
-    progress_message["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
-    progress_message["status"] = static_cast<int>(progress.status);
-    progress_message["percentage"] = progress.percentage;
-    progress_message["message"] = progress.message;
-    progress_message["error_details"] = progress.error_details;
-    progress_message["installation_in_progress"] = installation_in_progress_;
-    
+    if (!progress_hub_) return;
+
+    std::string status_name;
     // Add status name for easier client-side handling
     switch (progress.status) {
         case InstallationStatus::NOT_STARTED:
-            progress_message["status_name"] = "NOT_STARTED";
+            status_name = "NOT_STARTED";
             break;
         case InstallationStatus::IN_PROGRESS:
-            progress_message["status_name"] = "IN_PROGRESS";
+            status_name = "IN_PROGRESS";
             break;
         case InstallationStatus::COMPLETED:
-            progress_message["status_name"] = "COMPLETED";
+            status_name = "COMPLETED";
             break;
         case InstallationStatus::FAILED:
-            progress_message["status_name"] = "FAILED";
+            status_name = "FAILED";
             break;
         case InstallationStatus::EXTRACTING:
-            progress_message["status_name"] = "EXTRACTING";
+            status_name = "EXTRACTING";
             break;
         case InstallationStatus::INSTALLING:
-            progress_message["status_name"] = "INSTALLING";
+            status_name = "INSTALLING";
             break;
         case InstallationStatus::CONFIGURING:
-            progress_message["status_name"] = "CONFIGURING";
+            status_name = "CONFIGURING";
             break;
     }
-    
-    std::string json_str = progress_message.dump();
-    // std::cerr << json_str << "\n";
-    
-    // Broadcast to all connected progress clients
-    for (auto it = progress_connections_->begin(); it != progress_connections_->end(); ) {
-        auto* conn = *it;
-        try {
-            conn->send_text(json_str);
-            ++it;
-        } catch (const std::exception& e) {
-            // Remove invalid connection
-            it = progress_connections_->erase(it);
-        }
-    }
+
+    LogHub::ProgressEvent event;
+    event.status = status_name;
+    event.percentage = progress.percentage;
+    event.message = progress.message;
+    event.operation = "docker_install";
+    event.error = progress.error_details;
+    event.level = progress.status == InstallationStatus::FAILED ? "error" : "info";
+
+    // Create JSON progress message, only if a text client receives it
+    auto renderJson = [&]() {
+        crow::json::wvalue progress_message;
+        progress_message["type"] = "progress";
+        progress_message["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+        progress_message["status"] = static_cast<int>(progress.status);
+        progress_message["percentage"] = progress.percentage;
+        progress_message["message"] = progress.message;
+        progress_message["error_details"] = progress.error_details;
+        progress_message["installation_in_progress"] = installation_in_progress_;
+        progress_message["status_name"] = status_name;
+        return progress_message.dump();
+    };
+
+    progress_hub_->publishProgress(LogHub::topicForOperation(event.operation), event, renderJson);
 }
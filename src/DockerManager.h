@@ -10,6 +10,12 @@
 #include <chrono>
 #include "ProcessManager.h"
 #include "dotenv.hpp"
+#include "ImageIndex.h"
+#include "CoalescingCache.h"
+#include "VersionedResource.h"
+#include "LogHub.h"
+#include "AdmissionControl.h"
+#include "BlockingExecutor.h"
 
 struct DockerInfo {
     std::string version;
@@ -136,11 +142,21 @@ public:
     InstallationProgress getCurrentProgress() const { return current_progress_; }
     
     // WebSocket support
-    void setWebSocketConnections(std::vector<crow::websocket::connection*>* log_connections, 
-                                std::vector<crow::websocket::connection*>* progress_connections);
+    void setWebSocketConnections(LogHub* log_hub, 
+                                LogHub* progress_hub);
     void broadcastLog(const std::string& operation, const std::string& message, const std::string& level = "info");
     void broadcastProgress(const InstallationProgress& progress);
 
+    // Shared local image index (see ImageIndex)
+    void setImageIndex(std::shared_ptr<ImageIndex> image_index);
+    std::shared_ptr<ImageIndex> getImageIndex() const { return image_index_; }
+
+    // Concurrency limits of the slow endpoints (see AdmissionControl), none if not set
+    void setAdmissionControl(std::shared_ptr<AdmissionControl> admission);
+
+    // Threads the blocking endpoints run on instead of crow's io threads (see BlockingExecutor)
+    void setBlockingExecutor(std::shared_ptr<BlockingExecutor> blocking);
+
 private:
     // Helper methods
     std::string extractDockerBinary();
@@ -216,9 +232,39 @@ private:
     // Test endpoint
     crow::response handleTestSudo(const crow::request& _req);
 
+    // Query cache statistics endpoint
+    crow::response handleGetCacheStats();
+
+    // Uncached implementations behind the query caches
+    DockerInfo queryDockerInfo();
+    DockerComposeInfo queryDockerComposeInfo();
+    bool queryDockerRunning();
+    std::string queryDockerServiceStatus();
+    std::string querySystemInfo();
+    std::string queryDiskUsage();
+    /**
+     * @brief docker running flag and systemd "Active:" state, without the parts that change every second
+     */
+    std::string serviceStatusFingerprint();
+    /**
+     * @brief drops every cached query result, used after docker service state changes
+     */
+    void invalidateQueryCaches();
+    crow::response admitted(const char* lane, const std::function<crow::response()>& handler);
+    void respondBlocking(const crow::request& req, crow::response& res, std::function<crow::response()> render);
+
     // Member variables
     std::unique_ptr<ProcessManager> process_manager_;
+    std::shared_ptr<ImageIndex> image_index_;
+    std::shared_ptr<AdmissionControl> admission_;
+    std::shared_ptr<BlockingExecutor> blocking_;
     InstallationProgress current_progress_;
+
+    // Coalescing caches of idempotent queries, shared by all dashboard tabs
+    CoalescingCache<DockerInfo> docker_info_cache_;
+    CoalescingCache<DockerComposeInfo> compose_info_cache_;
+    CoalescingCache<bool> docker_running_cache_;
+    CoalescingCache<std::string> query_cache_;     // service status, system info, disk usage
     std::string docker_install_path_;
     // std::string docker_compose_install_path_;
     std::string temp_dir_;
@@ -227,8 +273,8 @@ private:
     std::map<std::string, DockerComposeProject> compose_projects_;
     
     // WebSocket connections
-    std::vector<crow::websocket::connection*>* log_connections_{nullptr};
-    std::vector<crow::websocket::connection*>* progress_connections_{nullptr};
+    LogHub* log_hub_{nullptr};
+    LogHub* progress_hub_{nullptr};
 
     std::string sudo_password_;
     bool sudo_validated_{false};
@@ -240,6 +286,10 @@ private:
     bool validateSudoPassword();
     bool requiresSudoPermission(const std::string& operation);
     crow::response createUnauthorizedResponse(const std::string& operation);
+
+    // Version of the docker service status, for ETag and long-poll GETs. Declared last so its
+    // watcher thread is stopped before the caches its probe uses are destroyed.
+    VersionedResource service_status_version_;
 };
 
 #endif // DOCKERMANAGER_H
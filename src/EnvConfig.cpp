@@ -22,7 +22,58 @@ void EnvConfig::initialize_env_variables() {
                     "Logging level (DEBUG, INFO, WARN, ERROR)")},
         {EnvKey::SUDO_PASSWORD,
          EnvVariable(EnvKey::SUDO_PASSWORD, "SUDO_PASSWORD", "",
-                    "Sudo password for the current user")}
+                    "Sudo password for the current user")},
+        {EnvKey::SEVEN_ZIP_PATH,
+         EnvVariable(EnvKey::SEVEN_ZIP_PATH, "SEVEN_ZIP_PATH", "",
+                    "Path to a 7-Zip executable to use instead of the embedded 7zzs (empty = embedded)")},
+        {EnvKey::CGROUP_ROOT,
+         EnvVariable(EnvKey::CGROUP_ROOT, "CGROUP_ROOT", "/sys/fs/cgroup",
+                    "Mount point of the cgroup v2 hierarchy read for project resource usage")},
+        {EnvKey::RESOURCE_SAMPLE_INTERVAL_MS,
+         EnvVariable(EnvKey::RESOURCE_SAMPLE_INTERVAL_MS, "RESOURCE_SAMPLE_INTERVAL_MS", "5000",
+                    "Milliseconds between project resource usage samples (0 = disabled)")},
+        {EnvKey::METRICS_SNAPSHOT_INTERVAL_S,
+         EnvVariable(EnvKey::METRICS_SNAPSHOT_INTERVAL_S, "METRICS_SNAPSHOT_INTERVAL_S", "300",
+                    "Seconds between saves of the metrics history to the settings database (0 = not saved)")},
+        {EnvKey::RESERVED_THREADS,
+         EnvVariable(EnvKey::RESERVED_THREADS, "RESERVED_THREADS", "0",
+                    "Handler threads kept for quick requests besides the slow ones (0 = number of CPUs)")},
+        {EnvKey::HEAVY_CONCURRENCY,
+         EnvVariable(EnvKey::HEAVY_CONCURRENCY, "HEAVY_CONCURRENCY", "2",
+                    "Image builds, saves, loads, prunes and project loads running at once")},
+        {EnvKey::HEAVY_QUEUE,
+         EnvVariable(EnvKey::HEAVY_QUEUE, "HEAVY_QUEUE", "4",
+                    "Heavy requests waiting for a slot before further ones get 429")},
+        {EnvKey::PROJECT_CONCURRENCY,
+         EnvVariable(EnvKey::PROJECT_CONCURRENCY, "PROJECT_CONCURRENCY", "2",
+                    "Project starts, stops, restarts and removals running at once")},
+        {EnvKey::PROJECT_QUEUE,
+         EnvVariable(EnvKey::PROJECT_QUEUE, "PROJECT_QUEUE", "8",
+                    "Project operations waiting for a slot before further ones get 429")},
+        {EnvKey::BLOCKING_QUEUE,
+         EnvVariable(EnvKey::BLOCKING_QUEUE, "BLOCKING_QUEUE", "256",
+                    "Requests waiting for a handler thread before further ones get 503")},
+        {EnvKey::BATCH_CONCURRENCY,
+         EnvVariable(EnvKey::BATCH_CONCURRENCY, "BATCH_CONCURRENCY", "8",
+                    "Sub-requests of /api/batch running at once")},
+        {EnvKey::BATCH_MAX_REQUESTS,
+         EnvVariable(EnvKey::BATCH_MAX_REQUESTS, "BATCH_MAX_REQUESTS", "100",
+                    "Sub-requests accepted in one /api/batch request")},
+        {EnvKey::LOCAL_SOCKET_PATH,
+         EnvVariable(EnvKey::LOCAL_SOCKET_PATH, "LOCAL_SOCKET_PATH", "",
+                    "Unix socket serving the REST API and WebSockets besides the TCP port (empty = disabled)")},
+        {EnvKey::LOCAL_SOCKET_MODE,
+         EnvVariable(EnvKey::LOCAL_SOCKET_MODE, "LOCAL_SOCKET_MODE", "660",
+                    "Octal file mode of the unix socket, deciding who may connect")},
+        {EnvKey::LOCAL_SOCKET_GROUP,
+         EnvVariable(EnvKey::LOCAL_SOCKET_GROUP, "LOCAL_SOCKET_GROUP", "",
+                    "Group owning the unix socket (empty = the server's group)")},
+        {EnvKey::CONTENT_STORE_MIN_SIZE,
+         EnvVariable(EnvKey::CONTENT_STORE_MIN_SIZE, "CONTENT_STORE_MIN_SIZE", "1048576",
+                    "Smallest project file, in bytes, kept once in the content store and shared between projects (-1 = no store)")},
+        {EnvKey::TRASH_WORKERS,
+         EnvVariable(EnvKey::TRASH_WORKERS, "TRASH_WORKERS", "4",
+                    "Threads deleting a removed project's files in the background, at idle I/O priority")}
     };
     return;
 }
@@ -11,7 +11,24 @@
 enum class EnvKey {
     REST_PORT = 1,
     LOG_LEVEL,
-    SUDO_PASSWORD
+    SUDO_PASSWORD,
+    SEVEN_ZIP_PATH,
+    CGROUP_ROOT,
+    RESOURCE_SAMPLE_INTERVAL_MS,
+    METRICS_SNAPSHOT_INTERVAL_S,
+    RESERVED_THREADS,
+    HEAVY_CONCURRENCY,
+    HEAVY_QUEUE,
+    PROJECT_CONCURRENCY,
+    PROJECT_QUEUE,
+    BLOCKING_QUEUE,
+    BATCH_CONCURRENCY,
+    BATCH_MAX_REQUESTS,
+    LOCAL_SOCKET_PATH,
+    LOCAL_SOCKET_MODE,
+    LOCAL_SOCKET_GROUP,
+    CONTENT_STORE_MIN_SIZE,
+    TRASH_WORKERS
 };
 
 // No hash specialization needed for std::map
@@ -1,6 +1,7 @@
 #include "FileManager.h"
 #include "utils.h"
 #include "json11.hpp"
+#include "JsonWriter.h"
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -22,36 +23,53 @@ FileManager::~FileManager() {
     // Cleanup if needed
 }
 
+void FileManager::setBlockingExecutor(std::shared_ptr<BlockingExecutor> blocking) {
+    blocking_ = blocking;
+}
+
+void FileManager::respondBlocking(const crow::request& req, crow::response& res, std::function<crow::response()> render) {
+    if (blocking_) {
+        blocking_->respond(req, res, std::move(render));
+        return;
+    }
+    res = render();
+    res.end();
+}
+
 void FileManager::registerRestEndpoints(crow::SimpleApp& app) {
     // List directory contents (basic)
-    CROW_ROUTE(app, "/api/file/list/<string>").methods("GET"_method)([this](const crow::request& req, const std::string& path) {
-        return handleListDirectory(req, path);
+    CROW_ROUTE(app, "/api/file/list/<string>").methods("GET"_method)([this](const crow::request& req, crow::response& res, const std::string& path) {
+        respondBlocking(req, res, [this, &req, path]() {
+            return handleListDirectory(req, path);
+        });
     });
     
     // List directory contents (detailed)
-    CROW_ROUTE(app, "/api/file/list-detailed").methods("POST"_method)([this](const crow::request& req) {
-        std::string parseError;
-        auto json = json11::Json::parse(req.body, parseError);
-        if (!json["path"].is_string())
-        {
-            json11::Json response = json11::Json::object{
-                {"success", false},
-                {"message", "path is necessary"}
-            };
-            return crow::response(400, "application/json", response.dump());
-        }
+    CROW_ROUTE(app, "/api/file/list-detailed").methods("POST"_method)([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this, &req]() {
+            std::string parseError;
+            auto json = json11::Json::parse(req.body, parseError);
+            if (!json["path"].is_string())
+            {
+                json11::Json response = json11::Json::object{
+                    {"success", false},
+                    {"message", "path is necessary"}
+                };
+                return crow::response(400, "application/json", response.dump());
+            }
 
-        std::string _path = json["path"].string_value();
+            std::string _path = json["path"].string_value();
 
-        if (_path.empty())
-        {
-            json11::Json response = json11::Json::object{
-                {"success", false},
-                {"message", "path is empty string"}
-            };
-            return crow::response(400, "application/json", response.dump());
-        }
-        return handleListDirectoryDetailed(req, _path);
+            if (_path.empty())
+            {
+                json11::Json response = json11::Json::object{
+                    {"success", false},
+                    {"message", "path is empty string"}
+                };
+                return crow::response(400, "application/json", response.dump());
+            }
+            return handleListDirectoryDetailed(req, _path);
+        });
     });
 
     // // Get file content
@@ -256,26 +274,21 @@ crow::response FileManager::handleListDirectoryDetailed(const crow::request& req
         }
         std::vector<FileInfo> entries = listDirectoryDetailed(path);
         
-        json11::Json::array entriesJson;
+        JsonWriter json(256 + entries.size() * 128);
+        json.beginObject()
+            .field("success", true)
+            .field("path", path)
+            .key("entries").beginArray();
         for (const auto& entry : entries) {
-            json11::Json entryJson = json11::Json::object{
-                {"name", entry.name},
-                {"is_directory", entry.is_directory},
-                {"size", static_cast<int>(entry.size)},
-                {"last_modified", entry.last_modified}
-            };
-            entriesJson.push_back(entryJson);
+            json.beginObject()
+                .field("name", entry.name)
+                .field("is_directory", entry.is_directory)
+                .field("size", entry.size)
+                .field("last_modified", entry.last_modified)
+                .endObject();
         }
-        
-        json11::Json response = json11::Json::object{
-            {"success", true},
-            {"path", path},
-            {"entries", entriesJson}
-        };
-        
-        crow::response res(200, response.dump());
-        res.set_header("Content-Type", "application/json");
-        return res;
+        json.endArray().endObject();
+        return json.response(200);
     } catch (const std::exception& e) {
         json11::Json error = json11::Json::object{
             {"success", false},
@@ -6,6 +6,7 @@
 #include <memory>
 #include <crow.h>
 #include <filesystem>
+#include "BlockingExecutor.h"
 
 class FileManager {
 public:
@@ -15,6 +16,9 @@ public:
     // REST API registration
     void registerRestEndpoints(crow::SimpleApp& app);
 
+    // Threads the directory listings run on instead of crow's io threads (see BlockingExecutor)
+    void setBlockingExecutor(std::shared_ptr<BlockingExecutor> blocking);
+
     // File operations
     struct FileInfo {
         std::string name;
@@ -41,9 +45,11 @@ private:
     // Utility methods
     std::string getMimeType(const std::string& filePath);
     std::string getBasePath() const;
+    void respondBlocking(const crow::request& req, crow::response& res, std::function<crow::response()> render);
     
     // Member variables
     std::string base_directory_;
+    std::shared_ptr<BlockingExecutor> blocking_;
 };
 
 #endif // FILEMANAGER_H
@@ -0,0 +1,282 @@
+#include "ImageArchive.h"
+#include "utils.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+bool endsWith(const std::string& text, const std::string& suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/**
+ * @brief runs commands with each one's stdout connected to the next one's stdin
+ *
+ * The last command writes to outputFile, or, if none is given, into output together with the
+ * stderr of every command.
+ * @return exit status of each command, -1 for one that did not run or was killed
+ */
+std::vector<int> runPipeline(const std::vector<std::vector<std::string>>& commands, const std::string& outputFile, std::string& output)
+{
+    std::vector<int> statuses(commands.size(), -1);
+    // a forked child of this multithreaded process may only make async-signal-safe calls: argv and
+    // stdin are prepared before forking, the child only redirects and execs
+    std::vector<std::vector<char*>> argvs;
+    for (const auto& command : commands) {
+        std::vector<char*> argv;
+        for (const auto& arg : command) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        argvs.push_back(std::move(argv));
+    }
+    const int null_input = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    int capture[2];
+    if (null_input < 0 || ::pipe2(capture, O_CLOEXEC) != 0) {
+        if (null_input >= 0) {
+            ::close(null_input);
+        }
+        return statuses;
+    }
+
+    std::vector<pid_t> pids;
+    int input = -1;
+    for (size_t i = 0; i < commands.size(); i++) {
+        const bool last = i + 1 == commands.size();
+        int next[2] = {-1, -1};
+        int out = capture[1];
+        if (!last) {
+            if (::pipe2(next, O_CLOEXEC) != 0) {
+                break;
+            }
+            out = next[1];
+        } else if (!outputFile.empty()) {
+            out = ::open(outputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (out < 0) {
+                output += "cannot open " + outputFile + "\n";
+                break;
+            }
+        }
+
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            ::dup2(input >= 0 ? input : null_input, STDIN_FILENO);
+            ::dup2(out, STDOUT_FILENO);
+            ::dup2(capture[1], STDERR_FILENO);
+            ::execvp(argvs[i][0], argvs[i].data());
+            _exit(127);
+        }
+        if (input >= 0) {
+            ::close(input);
+        }
+        if (out != capture[1]) {
+            ::close(out);
+        }
+        input = next[0];
+        if (pid < 0) {
+            break;
+        }
+        pids.push_back(pid);
+    }
+    if (input >= 0) {
+        ::close(input);
+    }
+    ::close(null_input);
+    ::close(capture[1]);
+
+    char buffer[4096];
+    for (;;) {
+        const ssize_t n = ::read(capture[0], buffer, sizeof(buffer));
+        if (n > 0) {
+            output.append(buffer, static_cast<size_t>(n));
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    ::close(capture[0]);
+
+    for (size_t i = 0; i < pids.size(); i++) {
+        int status = 0;
+        while (::waitpid(pids[i], &status, 0) < 0 && errno == EINTR) {
+        }
+        statuses[i] = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+    return statuses;
+}
+
+} // namespace
+
+bool ImageArchive::isImage(const std::string& path)
+{
+    return endsWith(path, ".tar") || compressionOf(path) != Compression::None;
+}
+
+ImageArchive::Compression ImageArchive::compressionOf(const std::string& path)
+{
+    if (endsWith(path, ".tar.gz") || endsWith(path, ".tgz")) {
+        return Compression::Gzip;
+    }
+    if (endsWith(path, ".tar.zst")) {
+        return Compression::Zstd;
+    }
+    if (endsWith(path, ".tar.xz")) {
+        return Compression::Xz;
+    }
+    return Compression::None;
+}
+
+std::string ImageArchive::name(Compression compression)
+{
+    switch (compression) {
+    case Compression::Gzip: return "gzip";
+    case Compression::Zstd: return "zstd";
+    case Compression::Xz: return "xz";
+    default: return "none";
+    }
+}
+
+ImageArchive::Compression ImageArchive::fromName(const std::string& name, bool* ok)
+{
+    if (ok) {
+        *ok = true;
+    }
+    const std::string lower = Utils::str_to_lower(name);
+    if (lower == "gzip" || lower == "gz") {
+        return Compression::Gzip;
+    }
+    if (lower == "zstd" || lower == "zst") {
+        return Compression::Zstd;
+    }
+    if (lower == "xz") {
+        return Compression::Xz;
+    }
+    if (ok && lower != "none") {
+        *ok = false;
+    }
+    return Compression::None;
+}
+
+std::string ImageArchive::suffix(Compression compression)
+{
+    switch (compression) {
+    case Compression::Gzip: return ".gz";
+    case Compression::Zstd: return ".zst";
+    case Compression::Xz: return ".xz";
+    default: return "";
+    }
+}
+
+std::vector<std::string> ImageArchive::decoderCommand(const std::string& path)
+{
+    switch (compressionOf(path)) {
+    case Compression::Gzip:
+        // pigz inflates on one thread but reads, writes and checks on others
+        if (!findExecutable("pigz").empty()) {
+            return {"pigz", "-d", "-c", path};
+        }
+        if (!findExecutable("gzip").empty()) {
+            return {"gzip", "-d", "-c", path};
+        }
+        break;
+    case Compression::Zstd:
+        if (!findExecutable("zstd").empty()) {
+            return {"zstd", "-d", "-c", "-q", path};
+        }
+        break;
+    case Compression::Xz:
+        if (!findExecutable("xz").empty()) {
+            return {"xz", "-d", "-c", "-T0", path};
+        }
+        break;
+    default:
+        break;
+    }
+    return {};
+}
+
+std::vector<std::string> ImageArchive::encoderCommand(Compression compression, const std::string& path)
+{
+    switch (compression) {
+    case Compression::Gzip:
+        if (!findExecutable("pigz").empty()) {
+            return {"pigz", "-c", path};
+        }
+        if (!findExecutable("gzip").empty()) {
+            return {"gzip", "-c", path};
+        }
+        break;
+    case Compression::Zstd:
+        if (!findExecutable("zstd").empty()) {
+            return {"zstd", "-c", "-q", "-3", "-T0", path};
+        }
+        break;
+    case Compression::Xz:
+        if (!findExecutable("xz").empty()) {
+            return {"xz", "-c", "-3", "-T0", path};
+        }
+        break;
+    default:
+        break;
+    }
+    return {};
+}
+
+bool ImageArchive::canCompress(Compression compression)
+{
+    return compression != Compression::None && !encoderCommand(compression, "-").empty();
+}
+
+int ImageArchive::load(const std::string& path, std::string& output)
+{
+    const auto decoder = decoderCommand(path);
+    if (decoder.empty()) {
+        return runPipeline({{"docker", "load", "-i", path}}, "", output)[0];
+    }
+    const auto statuses = runPipeline({decoder, {"docker", "load"}}, "", output);
+    return statuses[0] != 0 ? statuses[0] : statuses[1];
+}
+
+bool ImageArchive::compress(const std::string& source, const std::string& target, Compression compression, std::string& output)
+{
+    const auto encoder = encoderCommand(compression, source);
+    if (encoder.empty()) {
+        output += "no encoder for " + name(compression) + "\n";
+        return false;
+    }
+    return runPipeline({encoder}, target, output)[0] == 0;
+}
+
+bool ImageArchive::decode(const std::string& path, std::string& output)
+{
+    const auto decoder = decoderCommand(path);
+    if (decoder.empty()) {
+        return false;
+    }
+    return runPipeline({decoder}, "/dev/null", output)[0] == 0;
+}
+
+std::string ImageArchive::findExecutable(const std::string& name)
+{
+    const char* path = std::getenv("PATH");
+    std::string directories = path ? path : "/usr/local/bin:/usr/bin:/bin";
+    size_t start = 0;
+    while (start <= directories.size()) {
+        size_t end = directories.find(':', start);
+        if (end == std::string::npos) {
+            end = directories.size();
+        }
+        const std::string directory = directories.substr(start, end - start);
+        if (!directory.empty()) {
+            const std::string candidate = directory + "/" + name;
+            if (::access(candidate.c_str(), X_OK) == 0) {
+                return candidate;
+            }
+        }
+        start = end + 1;
+    }
+    return "";
+}
@@ -0,0 +1,78 @@
+#ifndef IMAGEARCHIVE_H
+#define IMAGEARCHIVE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Docker image tarballs shipped in project archives, as saved (`.tar`) or compressed on their
+ * own (`.tar.gz`/`.tgz`, `.tar.zst`, `.tar.xz`).
+ *
+ * A compressed image is decoded by a streaming decoder whose output is piped into `docker load`, so
+ * the uncompressed tar never touches the disk. Decoders using several threads are preferred where
+ * installed (pigz for gzip, `xz -T0`); without any decoder for the format the file is handed to
+ * `docker load -i`, which decodes it inside the daemon.
+ *
+ * Images compressed this way need no further compression by 7z: an archive of them can be stored
+ * (`-mx=0`), which is much faster to build than LZMA at `-mx=9` over the uncompressed tars.
+ */
+class ImageArchive {
+public:
+    enum class Compression { None, Gzip, Zstd, Xz };
+
+    /**
+     * @return true for the image file names above
+     */
+    static bool isImage(const std::string& path);
+    /**
+     * @return the compression the file name tells, None for a plain `.tar` or any other file
+     */
+    static Compression compressionOf(const std::string& path);
+    /**
+     * @return "none", "gzip", "zstd" or "xz"
+     */
+    static std::string name(Compression compression);
+    /**
+     * @param ok set to false for an unknown name
+     */
+    static Compression fromName(const std::string& name, bool* ok = nullptr);
+    /**
+     * @return what compressing appends to `.tar`, e.g. ".zst"
+     */
+    static std::string suffix(Compression compression);
+
+    /**
+     * @brief command writing the decoded image to stdout, empty if no decoder is installed
+     */
+    static std::vector<std::string> decoderCommand(const std::string& path);
+    /**
+     * @brief command writing the compressed tar to stdout, empty if no encoder is installed
+     */
+    static std::vector<std::string> encoderCommand(Compression compression, const std::string& path);
+    /**
+     * @return whether an encoder for the compression is installed
+     */
+    static bool canCompress(Compression compression);
+
+    /**
+     * @brief loads an image file of any of the forms above into the daemon
+     * @param output receives what `docker load` (and the decoder) printed
+     * @return exit status of `docker load`, or of the decoder if that failed
+     */
+    static int load(const std::string& path, std::string& output);
+    /**
+     * @brief compresses the tar source into target
+     */
+    static bool compress(const std::string& source, const std::string& target, Compression compression, std::string& output);
+    /**
+     * @brief decodes the image into nothing, to time decoding apart from `docker load`
+     */
+    static bool decode(const std::string& path, std::string& output);
+
+    /**
+     * @return full path of the executable found in PATH, empty if there is none
+     */
+    static std::string findExecutable(const std::string& name);
+};
+
+#endif // IMAGEARCHIVE_H
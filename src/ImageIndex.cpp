@@ -0,0 +1,349 @@
+#include "ImageIndex.h"
+#include "ProcessManager.h"
+#include "json11.hpp"
+#include <cctype>
+#include <sstream>
+
+namespace {
+
+const std::string DEFAULT_REGISTRY = "docker.io";
+
+std::string stripDigestPrefix(const std::string& id)
+{
+    const std::string prefix = "sha256:";
+    return id.compare(0, prefix.size(), prefix) == 0 ? id.substr(prefix.size()) : id;
+}
+
+std::string noneToEmpty(const std::string& value)
+{
+    return value == "<none>" ? "" : value;
+}
+
+} // namespace
+
+ImageReference ImageReference::parse(const std::string& reference)
+{
+    ImageReference ref;
+    std::string name = reference;
+
+    // trim surrounding whitespace/quotes that may come from compose files or CLI output
+    const char* trim_chars = " \t\r\n\"'";
+    name.erase(0, name.find_first_not_of(trim_chars));
+    name.erase(name.find_last_not_of(trim_chars) + 1);
+
+    auto at = name.find('@');
+    if (at != std::string::npos) {
+        ref.digest = name.substr(at + 1);
+        name = name.substr(0, at);
+    }
+
+    auto last_slash = name.rfind('/');
+    auto last_colon = name.rfind(':');
+    if (last_colon != std::string::npos && (last_slash == std::string::npos || last_colon > last_slash)) {
+        ref.tag = name.substr(last_colon + 1);
+        name = name.substr(0, last_colon);
+    }
+
+    auto first_slash = name.find('/');
+    if (first_slash != std::string::npos) {
+        std::string first = name.substr(0, first_slash);
+        if (first.find('.') != std::string::npos || first.find(':') != std::string::npos || first == "localhost") {
+            ref.registry = first;
+            name = name.substr(first_slash + 1);
+        }
+    }
+    if (ref.registry.empty() || ref.registry == "index.docker.io" || ref.registry == "registry-1.docker.io") {
+        ref.registry = DEFAULT_REGISTRY;
+    }
+    if (ref.registry == DEFAULT_REGISTRY && name.find('/') == std::string::npos) {
+        name = "library/" + name;
+    }
+    ref.repository = name;
+
+    if (ref.tag.empty() && ref.digest.empty()) {
+        ref.tag = "latest";
+    }
+    return ref;
+}
+
+std::string ImageReference::canonical() const
+{
+    if (tag.empty()) {
+        return canonicalDigest();
+    }
+    return registry + "/" + repository + ":" + tag;
+}
+
+std::string ImageReference::canonicalDigest() const
+{
+    if (digest.empty()) {
+        return "";
+    }
+    return registry + "/" + repository + "@" + digest;
+}
+
+ImageIndex::ImageIndex(std::chrono::seconds refreshInterval)
+    : refresh_interval_(refreshInterval)
+{
+}
+
+bool ImageIndex::refresh()
+{
+    std::string output;
+    ProcessManager pm;
+    auto [pid, ret_code] = pm.startProcessBlocking(
+        "docker",
+        {"images", "--digests", "--format", "json"},
+        {},
+        [&output](const std::string& data) {
+            output += data;
+        });
+    if (ret_code != 0) {
+        return false;
+    }
+
+    std::vector<ImageRecord> records;
+    std::istringstream iss(output);
+    std::string line;
+    while (std::getline(iss, line)) {
+        if (line.empty() || line.find('{') == std::string::npos) {
+            continue;
+        }
+        std::string err;
+        auto json = json11::Json::parse(line, err);
+        if (!err.empty()) {
+            continue;
+        }
+        ImageRecord record;
+        record.id = json["ID"].string_value();
+        record.repository = noneToEmpty(json["Repository"].string_value());
+        record.tag = noneToEmpty(json["Tag"].string_value());
+        record.digest = noneToEmpty(json["Digest"].string_value());
+        record.size = json["Size"].string_value();
+        record.created = json["CreatedAt"].string_value();
+        if (!record.repository.empty()) {
+            ImageReference ref = ImageReference::parse(record.repository + (record.tag.empty() ? "" : ":" + record.tag));
+            ref.digest = record.digest;
+            record.canonical = ref.canonical();
+        }
+        records.push_back(record);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.clear();
+    by_reference_.clear();
+    by_id_.clear();
+    for (const auto& record : records) {
+        indexRecord(record);
+    }
+    stale_ = false;
+    refreshed_at_ = std::chrono::steady_clock::now();
+    generation_++;
+    return true;
+}
+
+void ImageIndex::indexRecord(const ImageRecord& record)
+{
+    size_t index = records_.size();
+    records_.push_back(record);
+
+    if (!record.repository.empty()) {
+        ImageReference ref = ImageReference::parse(record.repository + (record.tag.empty() ? "" : ":" + record.tag));
+        ref.digest = record.digest;
+        if (!record.tag.empty()) {
+            by_reference_[ref.canonical()] = index;
+        }
+        if (!ref.digest.empty()) {
+            by_reference_[ref.canonicalDigest()] = index;
+        }
+    }
+    if (!record.id.empty()) {
+        std::string id = stripDigestPrefix(record.id);
+        by_id_[id] = index;
+        by_id_[id.substr(0, 12)] = index;
+    }
+}
+
+void ImageIndex::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stale_ = true;
+}
+
+void ImageIndex::ensureFresh()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stale_ && std::chrono::steady_clock::now() - refreshed_at_ < refresh_interval_) {
+            return;
+        }
+    }
+    refresh();
+}
+
+void ImageIndex::add(const std::string& reference, const std::string& id)
+{
+    ImageReference ref = ImageReference::parse(reference);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (containsLocked(ref)) {
+        return;
+    }
+    ImageRecord record;
+    record.id = id;
+    record.repository = (ref.registry == DEFAULT_REGISTRY ? "" : ref.registry + "/") + ref.repository;
+    if (record.repository.compare(0, 8, "library/") == 0) {
+        record.repository = record.repository.substr(8);
+    }
+    record.tag = ref.tag;
+    record.digest = ref.digest;
+    record.canonical = ref.canonical();
+    indexRecord(record);
+    generation_++;
+}
+
+void ImageIndex::remove(const std::string& referenceOrId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string id;
+    auto it_id = by_id_.find(stripDigestPrefix(referenceOrId));
+    if (it_id != by_id_.end()) {
+        id = records_[it_id->second].id;
+    }
+    ImageReference ref = ImageReference::parse(referenceOrId);
+
+    std::vector<ImageRecord> kept;
+    for (const auto& record : records_) {
+        bool match = (!id.empty() && record.id == id) ||
+                     (id.empty() && !record.canonical.empty() &&
+                      (record.canonical == ref.canonical() || (!ref.digest.empty() && record.canonical == ref.canonicalDigest())));
+        if (!match) {
+            kept.push_back(record);
+        }
+    }
+    records_.clear();
+    by_reference_.clear();
+    by_id_.clear();
+    for (const auto& record : kept) {
+        indexRecord(record);
+    }
+    generation_++;
+}
+
+void ImageIndex::addFromLoadOutput(const std::string& output)
+{
+    for (const std::string& reference : loadedImages(output)) {
+        add(reference);
+    }
+    if (output.find("Loaded image ID: ") != std::string::npos) {
+        // untagged image, only a full refresh can tell us about it
+        invalidate();
+    }
+}
+
+std::vector<std::string> ImageIndex::loadedImages(const std::string& output)
+{
+    std::vector<std::string> references;
+    std::istringstream iss(output);
+    std::string line;
+    const std::string loaded = "Loaded image: ";
+    while (std::getline(iss, line)) {
+        auto pos = line.find(loaded);
+        if (pos != std::string::npos) {
+            std::string reference = line.substr(pos + loaded.size());
+            while (!reference.empty() && std::isspace(static_cast<unsigned char>(reference.back()))) {
+                reference.pop_back();
+            }
+            if (!reference.empty()) {
+                references.push_back(reference);
+            }
+        }
+    }
+    return references;
+}
+
+bool ImageIndex::containsLocked(const ImageReference& reference) const
+{
+    if (!reference.digest.empty() && by_reference_.count(reference.canonicalDigest())) {
+        return true;
+    }
+    return !reference.tag.empty() && by_reference_.count(reference.canonical()) > 0;
+}
+
+bool ImageIndex::contains(const std::string& reference)
+{
+    return missing({reference}).empty();
+}
+
+std::vector<std::string> ImageIndex::missing(const std::vector<std::string>& references)
+{
+    ensureFresh();
+    std::vector<std::string> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& reference : references) {
+        if (by_id_.count(stripDigestPrefix(reference))) {
+            continue;
+        }
+        if (!containsLocked(ImageReference::parse(reference))) {
+            result.push_back(reference);
+        }
+    }
+    return result;
+}
+
+std::vector<ImageRecord> ImageIndex::list()
+{
+    ensureFresh();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+std::vector<ImageRecord> ImageIndex::unreferenced(const std::vector<std::string>& referencedImages)
+{
+    ensureFresh();
+    std::set<std::string> referenced_keys;
+    std::set<std::string> referenced_ids;
+    for (const auto& reference : referencedImages) {
+        ImageReference ref = ImageReference::parse(reference);
+        referenced_keys.insert(ref.canonical());
+        if (!ref.digest.empty()) {
+            referenced_keys.insert(ref.canonicalDigest());
+        }
+        referenced_ids.insert(stripDigestPrefix(reference));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto is_referenced = [&](const ImageRecord& record) {
+        std::string id = stripDigestPrefix(record.id);
+        if (!id.empty() && (referenced_ids.count(id) || referenced_ids.count(id.substr(0, 12)))) {
+            return true;
+        }
+        if (record.repository.empty()) {
+            return false;
+        }
+        ImageReference ref = ImageReference::parse(record.repository + (record.tag.empty() ? "" : ":" + record.tag));
+        ref.digest = record.digest;
+        return referenced_keys.count(ref.canonical()) > 0 || (!ref.digest.empty() && referenced_keys.count(ref.canonicalDigest()) > 0);
+    };
+
+    // an image id shared with a referenced tag must not be collected either
+    std::set<std::string> kept_ids;
+    for (const auto& record : records_) {
+        if (!record.id.empty() && is_referenced(record)) {
+            kept_ids.insert(record.id);
+        }
+    }
+
+    std::vector<ImageRecord> result;
+    for (const auto& record : records_) {
+        if (!is_referenced(record) && (record.id.empty() || !kept_ids.count(record.id))) {
+            result.push_back(record);
+        }
+    }
+    return result;
+}
+
+uint64_t ImageIndex::generation()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
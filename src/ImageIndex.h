@@ -0,0 +1,126 @@
+#ifndef IMAGEINDEX_H
+#define IMAGEINDEX_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A docker image reference split into its canonical parts.
+ *
+ * `nginx`, `nginx:latest`, `library/nginx` and `docker.io/library/nginx:latest` all canonicalize
+ * to registry `docker.io`, repository `library/nginx`, tag `latest`.
+ */
+struct ImageReference {
+    std::string registry;
+    std::string repository;
+    std::string tag;
+    std::string digest;     // "sha256:...", empty if not pinned
+
+    static ImageReference parse(const std::string& reference);
+
+    /**
+     * @brief registry/repository:tag (or registry/repository@digest when only a digest is given)
+     */
+    std::string canonical() const;
+    std::string canonicalDigest() const;
+};
+
+/**
+ * @brief One image as reported by `docker images`
+ */
+struct ImageRecord {
+    std::string id;
+    std::string repository;
+    std::string tag;
+    std::string digest;
+    std::string size;
+    std::string created;
+    std::string canonical;  // empty for dangling images
+};
+
+/**
+ * @brief Server side index of local docker images keyed by canonical reference.
+ *
+ * The index is filled by one `docker images` call and then kept current incrementally
+ * (add after load/pull/tag/build, remove after rmi). Operations docker performs behind our
+ * back are picked up by a full refresh once the index is older than the refresh interval,
+ * or right away after invalidate(). Callers invalidate after a prune, which removes images we
+ * never hear about, and after their own changes too: an incremental record answers lookups at
+ * once but lacks the id, size and date /api/docker/images shows.
+ */
+class ImageIndex {
+public:
+    explicit ImageIndex(std::chrono::seconds refreshInterval = std::chrono::seconds(60));
+
+    /**
+     * @brief reloads the index from `docker images`
+     * @return false if docker could not be queried
+     */
+    bool refresh();
+
+    /**
+     * @brief marks the index stale, the next query triggers a full refresh
+     */
+    void invalidate();
+
+    /**
+     * @brief records an image that is known to exist now (e.g. after `docker load`)
+     */
+    void add(const std::string& reference, const std::string& id = "");
+
+    /**
+     * @brief forgets an image by reference or id (e.g. after `docker rmi`)
+     */
+    void remove(const std::string& referenceOrId);
+
+    /**
+     * @brief records every image mentioned in `docker load` output ("Loaded image: ..." lines)
+     */
+    void addFromLoadOutput(const std::string& output);
+
+    /**
+     * @brief references named by the "Loaded image: ..." lines of `docker load` output
+     */
+    static std::vector<std::string> loadedImages(const std::string& output);
+
+    bool contains(const std::string& reference);
+
+    /**
+     * @brief returns the references of the given list that are not present locally, in one pass
+     */
+    std::vector<std::string> missing(const std::vector<std::string>& references);
+
+    /**
+     * @brief all tagged and dangling images, refreshed if stale
+     */
+    std::vector<ImageRecord> list();
+
+    /**
+     * @brief images not matched by any of the given references, i.e. candidates for garbage collection
+     */
+    std::vector<ImageRecord> unreferenced(const std::vector<std::string>& referencedImages);
+
+    uint64_t generation();
+
+private:
+    void ensureFresh();
+    void indexRecord(const ImageRecord& record);
+    bool containsLocked(const ImageReference& reference) const;
+
+    std::mutex mutex_;
+    std::chrono::seconds refresh_interval_;
+    std::chrono::steady_clock::time_point refreshed_at_{};
+    bool stale_{true};
+    uint64_t generation_{0};
+
+    std::vector<ImageRecord> records_;
+    std::unordered_map<std::string, size_t> by_reference_;  // canonical name:tag and name@digest
+    std::unordered_map<std::string, size_t> by_id_;         // full and short ids
+};
+
+#endif // IMAGEINDEX_H
@@ -0,0 +1,41 @@
+#include "InProcessRequest.h"
+#include <chrono>
+
+InProcessResponse dispatchInProcess(crow::SimpleApp& app,
+                                    crow::HTTPMethod method,
+                                    const std::string& path,
+                                    const std::string& body,
+                                    const std::vector<std::pair<std::string, std::string>>& headers)
+{
+    const auto started = std::chrono::steady_clock::now();
+
+    crow::request req;
+    req.method = method;
+    req.raw_url = path;
+    req.url = path.substr(0, path.find('?'));
+    req.url_params = crow::query_string(path);
+    req.body = body;
+    req.http_ver_major = 1;
+    req.http_ver_minor = 1;
+    req.remote_ip_address = "127.0.0.1";
+    for (const auto& [name, value] : headers) {
+        req.add_header(name, value);
+    }
+
+    asio::io_context io_context;
+    auto work = asio::make_work_guard(io_context);
+    req.io_context = &io_context;
+
+    crow::response res;
+    app.handle_full(req, res);
+    while (!res.is_completed()) {
+        io_context.run_one_for(std::chrono::milliseconds(100));
+    }
+
+    InProcessResponse result;
+    result.code = res.code;
+    result.body = std::move(res.body);
+    result.content_type = res.get_header_value("Content-Type");
+    result.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
@@ -0,0 +1,33 @@
+#ifndef INPROCESSREQUEST_H
+#define INPROCESSREQUEST_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <crow.h>
+
+/**
+ * @brief Answer of a request dispatched through the app's router without a network hop.
+ */
+struct InProcessResponse {
+    int code = 0;
+    std::string body;
+    std::string content_type;
+    long long elapsed_ms = 0;
+};
+
+/**
+ * @brief runs a request through the app's router on the calling thread and waits for its response
+ *
+ * Asynchronous handlers (see BlockingExecutor) end their response from the request's io_context, so
+ * the request gets its own io_context, which is run here until the response is complete.
+ *
+ * @param path endpoint, may include a query string
+ */
+InProcessResponse dispatchInProcess(crow::SimpleApp& app,
+                                    crow::HTTPMethod method,
+                                    const std::string& path,
+                                    const std::string& body = std::string(),
+                                    const std::vector<std::pair<std::string, std::string>>& headers = {});
+
+#endif // INPROCESSREQUEST_H
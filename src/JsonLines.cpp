@@ -0,0 +1,325 @@
+#include "JsonLines.h"
+#include <cstdlib>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline const char* skipSpace(const char* p, const char* end)
+{
+    while (p < end && isSpace(*p)) {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief p is just after the opening quote, returns the closing quote or nullptr
+ */
+inline const char* skipString(const char* p, const char* end, bool& escaped)
+{
+    while (true) {
+        p = JsonLineScanner::findQuoteOrEscape(p, end);
+        if (p >= end) {
+            return nullptr;
+        }
+        if (*p == '"') {
+            return p;
+        }
+        escaped = true;
+        p += 2;
+    }
+}
+
+/**
+ * @brief p is at a value, returns the end of the value or nullptr if malformed
+ */
+const char* skipValue(const char* p, const char* end)
+{
+    if (p >= end) {
+        return nullptr;
+    }
+    if (*p == '"') {
+        bool escaped = false;
+        const char* close = skipString(p + 1, end, escaped);
+        return close ? close + 1 : nullptr;
+    }
+    if (*p == '{' || *p == '[') {
+        // nested values are only skipped, counting brackets is enough
+        int depth = 0;
+        while (p < end) {
+            const char c = *p;
+            if (c == '"') {
+                bool escaped = false;
+                p = skipString(p + 1, end, escaped);
+                if (!p) {
+                    return nullptr;
+                }
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return p + 1;
+                }
+            }
+            p++;
+        }
+        return nullptr;
+    }
+    const char* start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && !isSpace(*p)) {
+        p++;
+    }
+    return p > start ? p : nullptr;
+}
+
+void appendUtf8(std::string& out, uint32_t code)
+{
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+bool parseHex4(std::string_view s, size_t i, uint32_t& code)
+{
+    if (i + 4 > s.size()) {
+        return false;
+    }
+    code = 0;
+    for (size_t k = i; k < i + 4; k++) {
+        const char c = s[k];
+        code <<= 4;
+        if (c >= '0' && c <= '9') {
+            code |= static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            code |= static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            code |= static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string JsonField::str() const
+{
+    if (!found || !is_string) {
+        return "";
+    }
+    if (!escaped) {
+        return std::string(raw);
+    }
+    std::string out;
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); i++) {
+        if (raw[i] != '\\' || i + 1 >= raw.size()) {
+            out += raw[i];
+            continue;
+        }
+        const char c = raw[++i];
+        switch (c) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code = 0;
+                if (!parseHex4(raw, i + 1, code)) {
+                    out += c;
+                    break;
+                }
+                i += 4;
+                uint32_t low = 0;
+                if (code >= 0xD800 && code < 0xDC00 && i + 2 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u'
+                    && parseHex4(raw, i + 3, low) && low >= 0xDC00 && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default: out += c; break;   // \" \\ \/
+        }
+    }
+    return out;
+}
+
+double JsonField::number(double fallback) const
+{
+    if (!found || raw.empty()) {
+        return fallback;
+    }
+    char* end = nullptr;
+    const double value = strtod(std::string(raw).c_str(), &end);
+    return end && *end == '\0' ? value : fallback;
+}
+
+JsonLineScanner::JsonLineScanner(std::string_view buffer)
+    : buffer_(buffer)
+{
+}
+
+const char* JsonLineScanner::findQuoteOrEscape(const char* p, const char* end)
+{
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        if (mask != 0) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\') {
+        p++;
+    }
+    return p;
+}
+
+bool JsonLineScanner::next()
+{
+    while (position_ < buffer_.size()) {
+        const char* start = buffer_.data() + position_;
+        const char* limit = buffer_.data() + buffer_.size();
+        const char* newline = static_cast<const char*>(memchr(start, '\n', static_cast<size_t>(limit - start)));
+        const char* line_end = newline ? newline : limit;
+        position_ = static_cast<size_t>(line_end - buffer_.data()) + (newline ? 1 : 0);
+
+        start = skipSpace(start, line_end);
+        while (line_end > start && isSpace(line_end[-1])) {
+            line_end--;
+        }
+        if (start < line_end && *start == '{') {
+            line_ = std::string_view(start, static_cast<size_t>(line_end - start));
+            return true;
+        }
+    }
+    line_ = {};
+    return false;
+}
+
+bool JsonLineScanner::fields(std::initializer_list<std::string_view> keys, JsonField* out) const
+{
+    return scan(keys, out, true);
+}
+
+bool JsonLineScanner::valid() const
+{
+    return scan({}, nullptr, false);
+}
+
+bool JsonLineScanner::scan(std::initializer_list<std::string_view> keys, JsonField* out, bool stopWhenFound) const
+{
+    for (size_t i = 0; i < keys.size(); i++) {
+        out[i] = JsonField();
+    }
+    size_t remaining = keys.size();
+    if (stopWhenFound && remaining == 0) {
+        return true;
+    }
+
+    const char* p = line_.data();
+    const char* end = p + line_.size();
+    if (p >= end || *p != '{') {
+        return false;
+    }
+    p = skipSpace(p + 1, end);
+    if (p < end && *p == '}') {
+        return skipSpace(p + 1, end) == end;
+    }
+
+    while (p < end) {
+        if (*p != '"') {
+            return false;
+        }
+        bool key_escaped = false;
+        const char* key_end = skipString(p + 1, end, key_escaped);
+        if (!key_end) {
+            return false;
+        }
+        const std::string_view key(p + 1, static_cast<size_t>(key_end - p - 1));
+        p = skipSpace(key_end + 1, end);
+        if (p >= end || *p != ':') {
+            return false;
+        }
+        p = skipSpace(p + 1, end);
+
+        JsonField* target = nullptr;
+        if (!key_escaped) {
+            size_t index = 0;
+            for (std::string_view wanted : keys) {
+                if (!out[index].found && wanted == key) {
+                    target = &out[index];
+                    break;
+                }
+                index++;
+            }
+        }
+
+        const char* value_end;
+        if (target && p < end && *p == '"') {
+            bool escaped = false;
+            const char* close = skipString(p + 1, end, escaped);
+            if (!close) {
+                return false;
+            }
+            target->raw = std::string_view(p + 1, static_cast<size_t>(close - p - 1));
+            target->is_string = true;
+            target->escaped = escaped;
+            value_end = close + 1;
+        } else {
+            value_end = skipValue(p, end);
+            if (!value_end) {
+                return false;
+            }
+            if (target) {
+                target->raw = std::string_view(p, static_cast<size_t>(value_end - p));
+            }
+        }
+        if (target) {
+            target->found = true;
+            if (--remaining == 0 && stopWhenFound) {
+                return true;
+            }
+        }
+
+        p = skipSpace(value_end, end);
+        if (p >= end) {
+            return false;
+        }
+        if (*p == '}') {
+            return skipSpace(p + 1, end) == end;
+        }
+        if (*p != ',') {
+            return false;
+        }
+        p = skipSpace(p + 1, end);
+    }
+    return false;
+}
@@ -0,0 +1,84 @@
+#ifndef JSONLINES_H
+#define JSONLINES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief A top-level value of a JSON object, as found by JsonLineScanner.
+ *
+ * `raw` points into the scanned buffer: the characters between the quotes for a string, the text of
+ * the value otherwise (number, literal, or a whole nested object/array).
+ */
+struct JsonField {
+    std::string_view raw;
+    bool found = false;
+    bool is_string = false;
+    bool escaped = false;       // raw holds backslash escapes, str() resolves them
+
+    /**
+     * @brief the string value (escapes resolved), empty if the field is missing or not a string
+     */
+    std::string str() const;
+    double number(double fallback = 0) const;
+};
+
+/**
+ * @brief Walks `docker ... --format json` output, one JSON object per line, without building a DOM.
+ *
+ * The buffer is read once, in place: lines are split with memchr and only the requested top-level
+ * keys of each object are picked out as views into the buffer. Strings, which make up most of the
+ * bytes, are skipped by searching for the next quote or backslash 16 bytes at a time with SSE2 where
+ * it is available. The buffer must outlive the scanner and the fields it returns.
+ *
+ *     JsonLineScanner scanner(output);
+ *     JsonField fields[2];
+ *     while (scanner.next()) {
+ *         if (scanner.fields({"ID", "State"}, fields)) { ... fields[0].str() ... }
+ *     }
+ */
+class JsonLineScanner {
+public:
+    explicit JsonLineScanner(std::string_view buffer);
+
+    /**
+     * @brief moves to the next line that starts with `{` (after whitespace)
+     * @return false at the end of the buffer
+     */
+    bool next();
+
+    /**
+     * @brief the current line, without surrounding whitespace
+     */
+    std::string_view line() const { return line_; }
+
+    /**
+     * @brief looks up keys in the current line's object, out[i] receives keys[i]
+     *
+     * Stops reading the line once every key was found.
+     * @return false if the object is malformed before all keys were found
+     */
+    bool fields(std::initializer_list<std::string_view> keys, JsonField* out) const;
+
+    /**
+     * @brief checks that the current line is exactly one well-formed object
+     */
+    bool valid() const;
+
+    /**
+     * @brief position of the first `"` or `\` in [p, end), end if none
+     */
+    static const char* findQuoteOrEscape(const char* p, const char* end);
+
+private:
+    bool scan(std::initializer_list<std::string_view> keys, JsonField* out, bool stopWhenFound) const;
+
+    std::string_view buffer_;
+    size_t position_ = 0;
+    std::string_view line_;
+};
+
+#endif // JSONLINES_H
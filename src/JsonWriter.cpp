@@ -0,0 +1,219 @@
+#include "JsonWriter.h"
+#include <charconv>
+#include <cmath>
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+// 1 for bytes that cannot appear in a JSON string as they are
+struct EscapeTable {
+    bool escape[256] = {};
+    constexpr EscapeTable()
+    {
+        for (int c = 0; c < 0x20; c++) {
+            escape[c] = true;
+        }
+        escape[static_cast<unsigned char>('"')] = true;
+        escape[static_cast<unsigned char>('\\')] = true;
+        escape[0xE2] = true;    // possibly U+2028/U+2029, which break JavaScript string literals
+    }
+};
+
+constexpr EscapeTable ESCAPE_TABLE;
+
+} // namespace
+
+JsonWriter::JsonWriter(size_t reserve)
+{
+    buffer_.reserve(reserve);
+}
+
+void JsonWriter::separate()
+{
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (!has_items_.empty()) {
+        if (has_items_.back()) {
+            buffer_ += ',';
+        }
+        has_items_.back() = true;
+    }
+}
+
+void JsonWriter::open(char bracket)
+{
+    separate();
+    buffer_ += bracket;
+    has_items_.push_back(false);
+}
+
+void JsonWriter::close(char bracket)
+{
+    if (!has_items_.empty()) {
+        has_items_.pop_back();
+    }
+    buffer_ += bracket;
+}
+
+JsonWriter& JsonWriter::beginObject()
+{
+    open('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject()
+{
+    close('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray()
+{
+    open('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray()
+{
+    close(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name)
+{
+    separate();
+    buffer_ += '"';
+    escape(buffer_, name);
+    buffer_ += "\":";
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view text)
+{
+    separate();
+    buffer_ += '"';
+    escape(buffer_, text);
+    buffer_ += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag)
+{
+    separate();
+    buffer_ += flag ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number)
+{
+    if (!std::isfinite(number)) {
+        return null();
+    }
+    separate();
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    buffer_.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const std::vector<std::string>& texts)
+{
+    beginArray();
+    for (const std::string& text : texts) {
+        value(text);
+    }
+    return endArray();
+}
+
+JsonWriter& JsonWriter::null()
+{
+    separate();
+    buffer_ += "null";
+    return *this;
+}
+
+JsonWriter& JsonWriter::integer(int64_t number)
+{
+    separate();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    buffer_.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::unsignedInteger(uint64_t number)
+{
+    separate();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    buffer_.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(std::string_view json)
+{
+    separate();
+    buffer_ += json;
+    return *this;
+}
+
+std::string JsonWriter::release()
+{
+    std::string out = std::move(buffer_);
+    buffer_.clear();
+    has_items_.clear();
+    after_key_ = false;
+    return out;
+}
+
+crow::response JsonWriter::response(int code)
+{
+    crow::response res(code);
+    res.body = release();
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+void JsonWriter::escape(std::string& out, std::string_view text)
+{
+    const char* run = text.data();
+    const char* end = run + text.size();
+    for (const char* p = run; p < end; p++) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (!ESCAPE_TABLE.escape[c]) {
+            continue;
+        }
+        if (c == 0xE2) {
+            if (end - p < 3 || static_cast<unsigned char>(p[1]) != 0x80
+                || (static_cast<unsigned char>(p[2]) != 0xA8 && static_cast<unsigned char>(p[2]) != 0xA9)) {
+                continue;
+            }
+            out.append(run, p);
+            out += static_cast<unsigned char>(p[2]) == 0xA8 ? "\\u2028" : "\\u2029";
+            p += 2;
+            run = p + 1;
+            continue;
+        }
+        out.append(run, p);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                const char code[] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF]};
+                out.append(code, sizeof(code));
+                break;
+            }
+        }
+        run = p + 1;
+    }
+    out.append(run, end);
+}
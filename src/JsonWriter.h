@@ -0,0 +1,99 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <crow.h>
+
+/**
+ * @brief Serializes JSON straight into one growing buffer, without building a json11 or crow DOM.
+ *
+ * Values are written in the order they are given; commas are placed automatically. Strings are
+ * escaped in runs: everything between two characters that need escaping is appended in one go.
+ * The buffer is moved into the response, so a list is held in memory once, as its final text.
+ *
+ *     JsonWriter json;
+ *     json.beginObject().field("success", true).key("items").beginArray();
+ *     for (const auto& item : items) {
+ *         json.beginObject().field("name", item.name).field("size", item.size).endObject();
+ *     }
+ *     json.endArray().endObject();
+ *     return json.response(200);
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(size_t reserve = 4096);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    /**
+     * @brief the next value belongs to this key
+     */
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(bool flag);
+    JsonWriter& value(double number);       // non-finite numbers are written as null
+    JsonWriter& value(const std::vector<std::string>& texts);
+    JsonWriter& null();
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+    JsonWriter& value(T number)
+    {
+        if constexpr (std::is_signed<T>::value) {
+            return integer(static_cast<int64_t>(number));
+        } else {
+            return unsignedInteger(static_cast<uint64_t>(number));
+        }
+    }
+
+    /**
+     * @brief appends an already serialized JSON value as it is
+     */
+    JsonWriter& raw(std::string_view json);
+
+    template <typename T>
+    JsonWriter& field(std::string_view name, const T& v)
+    {
+        key(name);
+        return value(v);
+    }
+
+    const std::string& str() const { return buffer_; }
+
+    /**
+     * @brief hands the buffer over, the writer is empty afterwards
+     */
+    std::string release();
+
+    /**
+     * @brief moves the buffer into an application/json response
+     */
+    crow::response response(int code = 200);
+
+    /**
+     * @brief appends text as the body of a JSON string (without the quotes)
+     */
+    static void escape(std::string& out, std::string_view text);
+
+private:
+    JsonWriter& integer(int64_t number);
+    JsonWriter& unsignedInteger(uint64_t number);
+    void separate();
+    void open(char bracket);
+    void close(char bracket);
+
+    std::string buffer_;
+    std::vector<bool> has_items_;   // one per open object/array
+    bool after_key_ = false;
+};
+
+#endif // JSONWRITER_H
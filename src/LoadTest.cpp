@@ -0,0 +1,436 @@
+#include "LoadTest.h"
+#include <crow.h>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+LoadTest::LoadTest(const Options& options)
+    : options_(options)
+{
+    // base_url is http://host:port
+    std::string rest = options_.base_url;
+    auto scheme = rest.find("://");
+    if (scheme != std::string::npos) {
+        rest = rest.substr(scheme + 3);
+    }
+    auto colon = rest.rfind(':');
+    if (colon != std::string::npos) {
+        host_ = rest.substr(0, colon);
+        port_ = std::atoi(rest.substr(colon + 1).c_str());
+    } else {
+        host_ = rest;
+        port_ = 80;
+    }
+}
+
+std::string LoadTest::help() {
+    std::string help_str;
+    help_str += "  --loadtest <mix>       : Run the load generator ('default' = " + std::string(DEFAULT_MIX) + ")\n";
+    help_str += "    - <mix> is a comma separated list of scenario=workers\n";
+    help_str += "    - scenarios: projects, containers, files, cycle, ws, wsbinary, wsbroadcast\n";
+    help_str += "  --loadtest_duration <s>: Load test duration in seconds (default 30)\n";
+    help_str += "  --loadtest_url <url>   : Target an already running server instead of starting one\n";
+    help_str += "  --loadtest_pid <pid>   : Server process whose RSS is sampled (defaults to self when in-process)\n";
+    help_str += "  --loadtest_project <n> : Project used by the 'cycle' scenario (default test_project_1)\n";
+    return help_str;
+}
+
+bool LoadTest::parse_mix() {
+    std::string mix = (options_.mix.empty() || options_.mix == "default") ? DEFAULT_MIX : options_.mix;
+    static const std::vector<std::string> known = {"projects", "containers", "files", "cycle", "ws", "wsbinary", "wsbroadcast"};
+
+    std::stringstream ss(mix);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        auto eq = item.find('=');
+        std::string name = item.substr(0, eq);
+        int workers = (eq == std::string::npos) ? 1 : std::atoi(item.substr(eq + 1).c_str());
+        if (std::find(known.begin(), known.end(), name) == known.end() || workers <= 0) {
+            crow::logger(crow::LogLevel::ERROR) << "Invalid load test mix entry: '" << item << "'";
+            return false;
+        }
+        auto scenario = std::make_unique<Scenario>();
+        scenario->name = name;
+        scenario->workers = workers;
+        scenarios_.push_back(std::move(scenario));
+    }
+    return !scenarios_.empty();
+}
+
+bool LoadTest::run() {
+    if (host_.empty() || port_ <= 0) {
+        crow::logger(crow::LogLevel::ERROR) << "Invalid load test url: " << options_.base_url;
+        return false;
+    }
+    if (!parse_mix()) {
+        return false;
+    }
+
+    std::stringstream mix_ss;
+    for (const auto& scenario : scenarios_) {
+        mix_ss << scenario->name << "=" << scenario->workers << " ";
+    }
+    crow::logger(crow::LogLevel::Info) << "Load test against " << options_.base_url
+                                       << " for " << options_.duration_seconds << "s, mix: " << mix_ss.str();
+
+    started_at_ = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (auto& scenario : scenarios_) {
+        for (int i = 0; i < scenario->workers; ++i) {
+            if (scenario->name == "ws" || scenario->name == "wsbinary" || scenario->name == "wsbroadcast") {
+                bool send_messages = scenario->name == "wsbroadcast";
+                bool binary = scenario->name == "wsbinary";
+                workers.emplace_back([this, &scenario, send_messages, binary]() { run_ws_worker(*scenario, send_messages, binary); });
+            } else {
+                workers.emplace_back([this, &scenario]() { run_http_worker(*scenario); });
+            }
+        }
+    }
+    std::thread sampler([this]() { run_sampler(); });
+
+    std::this_thread::sleep_for(std::chrono::seconds(options_.duration_seconds));
+    stop_ = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    sampler.join();
+
+    print_report();
+
+    uint64_t errors = 0;
+    for (const auto& scenario : scenarios_) {
+        errors += scenario->errors;
+    }
+    return errors == 0;
+}
+
+void LoadTest::run_http_worker(Scenario& scenario) {
+    httplib::Client client(host_, port_);
+    client.set_keep_alive(true);
+    client.set_connection_timeout(5);
+    client.set_read_timeout(60);
+
+    std::vector<double> latencies;
+    const std::string list_body = json11::Json(json11::Json::object{{"path", options_.list_path}}).dump();
+    const std::string project_path = "/api/projects/" + options_.project_name;
+    bool start_next = true;
+
+    while (!stop_) {
+        auto begin = std::chrono::steady_clock::now();
+        httplib::Result res;
+        if (scenario.name == "projects") {
+            res = client.Get("/api/projects");
+        } else if (scenario.name == "containers") {
+            res = client.Get("/api/docker/containers");
+        } else if (scenario.name == "files") {
+            res = client.Post("/api/file/list-detailed", list_body, "application/json");
+        } else if (scenario.name == "cycle") {
+            res = client.Post(project_path + (start_next ? "/start" : "/stop"));
+            start_next = !start_next;
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        scenario.requests++;
+        if (!res || res->status < 200 || res->status >= 300) {
+            scenario.errors++;
+            if (!res) {
+                // connection level failure, back off a little so we don't spin
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }
+        latencies.push_back(elapsed);
+    }
+
+    std::lock_guard<std::mutex> lock(scenario.latencies_mutex);
+    scenario.latencies_ms.insert(scenario.latencies_ms.end(), latencies.begin(), latencies.end());
+}
+
+namespace {
+
+// Minimal RFC 6455 client, just enough to subscribe and count frames
+int ws_connect(const std::string& host, int port, const std::string& path, const std::string& subprotocol = "") {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (auto* ai = result; ai != nullptr; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    if (fd < 0) {
+        return -1;
+    }
+
+    timeval tv{};
+    tv.tv_sec = 0;
+    tv.tv_usec = 200 * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    std::string handshake =
+        "GET " + path + " HTTP/1.1\r\n"
+        "Host: " + host + ":" + std::to_string(port) + "\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n" +
+        (subprotocol.empty() ? std::string() : "Sec-WebSocket-Protocol: " + subprotocol + "\r\n") +
+        "\r\n";
+    if (send(fd, handshake.data(), handshake.size(), MSG_NOSIGNAL) != (ssize_t)handshake.size()) {
+        close(fd);
+        return -1;
+    }
+
+    std::string response;
+    char c;
+    for (int waited = 0; response.find("\r\n\r\n") == std::string::npos;) {
+        ssize_t n = recv(fd, &c, 1, 0);
+        if (n == 1) {
+            response += c;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && ++waited < 25) {
+            continue;
+        } else {
+            close(fd);
+            return -1;
+        }
+    }
+    if (response.find(" 101 ") == std::string::npos) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// number of events in a binary frame, which carries a MessagePack array of events
+uint64_t msgpack_array_size(const std::string& buffer, size_t offset) {
+    if (offset >= buffer.size()) {
+        return 0;
+    }
+    unsigned char type = static_cast<unsigned char>(buffer[offset]);
+    if ((type & 0xf0) == 0x90) {
+        return type & 0x0f;
+    }
+    uint64_t size = 0;
+    int bytes = type == 0xdc ? 2 : type == 0xdd ? 4 : 0;
+    for (int i = 1; i <= bytes && offset + i < buffer.size(); ++i) {
+        size = (size << 8) | static_cast<unsigned char>(buffer[offset + i]);
+    }
+    return size;
+}
+
+bool ws_send_text(int fd, const std::string& payload) {
+    // Client frames must be masked, a zero mask keeps the payload unchanged
+    std::string frame;
+    frame += static_cast<char>(0x81);
+    if (payload.size() < 126) {
+        frame += static_cast<char>(0x80 | payload.size());
+    } else {
+        frame += static_cast<char>(0x80 | 126);
+        frame += static_cast<char>((payload.size() >> 8) & 0xff);
+        frame += static_cast<char>(payload.size() & 0xff);
+    }
+    frame.append(4, '\0');
+    frame += payload;
+    return send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) == (ssize_t)frame.size();
+}
+
+} // namespace
+
+void LoadTest::run_ws_worker(Scenario& scenario, bool send_messages, bool binary) {
+    std::vector<double> latencies;
+    std::string buffer;
+    char chunk[16 * 1024];
+
+    while (!stop_) {
+        auto begin = std::chrono::steady_clock::now();
+        int fd = ws_connect(host_, port_, "/ws/logs", binary ? "metainstaller.msgpack.v1" : "");
+        scenario.requests++;
+        if (fd < 0) {
+            scenario.errors++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+
+        auto last_send = std::chrono::steady_clock::now();
+        buffer.clear();
+        bool connected = true;
+        while (!stop_ && connected) {
+            if (send_messages && std::chrono::steady_clock::now() - last_send >= std::chrono::milliseconds(100)) {
+                connected = ws_send_text(fd, "{\"type\":\"loadtest\"}");
+                last_send = std::chrono::steady_clock::now();
+            }
+
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                connected = false;
+                break;
+            }
+            if (n > 0) {
+                buffer.append(chunk, n);
+            }
+
+            // Consume every complete (unmasked) server frame in the buffer
+            while (buffer.size() >= 2) {
+                uint64_t len = static_cast<unsigned char>(buffer[1]) & 0x7f;
+                size_t header = 2;
+                if (len == 126) {
+                    if (buffer.size() < 4) break;
+                    len = (static_cast<unsigned char>(buffer[2]) << 8) | static_cast<unsigned char>(buffer[3]);
+                    header = 4;
+                } else if (len == 127) {
+                    if (buffer.size() < 10) break;
+                    len = 0;
+                    for (int i = 0; i < 8; ++i) {
+                        len = (len << 8) | static_cast<unsigned char>(buffer[2 + i]);
+                    }
+                    header = 10;
+                }
+                if (buffer.size() < header + len) break;
+                int opcode = static_cast<unsigned char>(buffer[0]) & 0x0f;
+                if (opcode == 0x8) {
+                    connected = false;
+                } else if (opcode == 0x1) {
+                    scenario.ws_messages++;
+                    scenario.ws_bytes += len;
+                } else if (opcode == 0x2) {
+                    scenario.ws_messages += msgpack_array_size(buffer, header);
+                    scenario.ws_bytes += len;
+                }
+                buffer.erase(0, header + len);
+            }
+        }
+
+        if (!connected && !stop_) {
+            scenario.errors++;
+        } else {
+            // polite close: FIN + close opcode, masked, empty payload
+            const char close_frame[] = {static_cast<char>(0x88), static_cast<char>(0x80), 0, 0, 0, 0};
+            send(fd, close_frame, sizeof(close_frame), MSG_NOSIGNAL);
+        }
+        close(fd);
+    }
+
+    std::lock_guard<std::mutex> lock(scenario.latencies_mutex);
+    scenario.latencies_ms.insert(scenario.latencies_ms.end(), latencies.begin(), latencies.end());
+}
+
+void LoadTest::run_sampler() {
+    uint64_t last_requests = 0;
+    auto last_time = std::chrono::steady_clock::now();
+
+    while (!stop_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(options_.sample_interval_ms));
+        auto now = std::chrono::steady_clock::now();
+        uint64_t requests = total_requests();
+        double interval = std::chrono::duration<double>(now - last_time).count();
+        double elapsed = std::chrono::duration<double>(now - started_at_).count();
+        long rss = read_rss_kb();
+
+        rss_samples_.push_back({elapsed, rss, requests});
+        crow::logger(crow::LogLevel::Info) << std::fixed << std::setprecision(1)
+                                           << "[LOADTEST] t=" << elapsed << "s"
+                                           << " rps=" << (interval > 0 ? (requests - last_requests) / interval : 0)
+                                           << " requests=" << requests
+                                           << " rss=" << (rss >= 0 ? std::to_string(rss) + "kB" : std::string("n/a"));
+        last_requests = requests;
+        last_time = now;
+    }
+}
+
+void LoadTest::print_report() const {
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at_).count();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "\n================ LOAD TEST REPORT ================\n";
+    ss << "target: " << options_.base_url << ", duration: " << elapsed << "s\n\n";
+    ss << std::left << std::setw(12) << "scenario" << std::right
+       << std::setw(8) << "workers" << std::setw(10) << "requests" << std::setw(8) << "errors"
+       << std::setw(10) << "req/s" << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms"
+       << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << std::setw(12) << "ws msgs/s" << std::setw(10) << "ws B/msg" << "\n";
+
+    uint64_t total = 0;
+    uint64_t errors = 0;
+    for (const auto& scenario : scenarios_) {
+        std::vector<double> sorted = scenario->latencies_ms;
+        std::sort(sorted.begin(), sorted.end());
+        total += scenario->requests;
+        errors += scenario->errors;
+        ss << std::left << std::setw(12) << scenario->name << std::right
+           << std::setw(8) << scenario->workers
+           << std::setw(10) << scenario->requests.load()
+           << std::setw(8) << scenario->errors.load()
+           << std::setw(10) << scenario->requests / elapsed
+           << std::setw(10) << percentile(sorted, 0.50)
+           << std::setw(10) << percentile(sorted, 0.95)
+           << std::setw(10) << percentile(sorted, 0.99)
+           << std::setw(10) << (sorted.empty() ? 0.0 : sorted.back())
+           << std::setw(12) << scenario->ws_messages / elapsed
+           << std::setw(10) << (scenario->ws_messages > 0 ? static_cast<double>(scenario->ws_bytes) / scenario->ws_messages : 0.0) << "\n";
+    }
+    ss << "\ntotal: " << total << " requests, " << errors << " errors, " << total / elapsed << " req/s\n";
+
+    if (!rss_samples_.empty() && rss_samples_.front().rss_kb >= 0) {
+        long min_rss = rss_samples_.front().rss_kb;
+        long max_rss = min_rss;
+        for (const auto& sample : rss_samples_) {
+            min_rss = std::min(min_rss, sample.rss_kb);
+            max_rss = std::max(max_rss, sample.rss_kb);
+        }
+        ss << "server rss: start " << rss_samples_.front().rss_kb << " kB, min " << min_rss
+           << " kB, max " << max_rss << " kB, end " << rss_samples_.back().rss_kb << " kB\n";
+    }
+    ss << "==================================================\n";
+    std::cout << ss.str() << std::flush;
+}
+
+long LoadTest::read_rss_kb() const {
+    if (options_.server_pid <= 0) {
+        return -1;
+    }
+    std::ifstream status("/proc/" + std::to_string(options_.server_pid) + "/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::atol(line.c_str() + 6);
+        }
+    }
+    return -1;
+}
+
+uint64_t LoadTest::total_requests() const {
+    uint64_t total = 0;
+    for (const auto& scenario : scenarios_) {
+        total += scenario->requests;
+    }
+    return total;
+}
+
+double LoadTest::percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
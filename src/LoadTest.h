@@ -0,0 +1,91 @@
+#pragma once
+#include "httplib.h"
+#include "json11.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief HTTP/WebSocket load generator for the MetaInstaller REST API.
+ *
+ * Drives a configurable mix of concurrent workers for a fixed duration and reports
+ * throughput, latency percentiles, error counts and server RSS over time.
+ *
+ * The mix is a comma separated list of `scenario=workers`, e.g.
+ * `projects=8,containers=4,files=2,cycle=1,ws=16`. Available scenarios:
+ *   - projects    : GET  /api/projects
+ *   - containers  : GET  /api/docker/containers
+ *   - files       : POST /api/file/list-detailed
+ *   - cycle       : POST /api/projects/<project>/start then /stop
+ *   - ws          : passive /ws/logs subscriber, counts received messages
+ *   - wsbinary    : passive /ws/logs subscriber using the batched MessagePack subprotocol
+ *   - wsbroadcast : /ws/logs client sending a message every 100ms (server fans it out to all subscribers)
+ */
+class LoadTest {
+public:
+    struct Options {
+        std::string base_url;               // e.g. http://127.0.0.1:14040
+        std::string mix;                    // scenario=workers list, 'default' for the built-in mix
+        int duration_seconds{30};
+        int sample_interval_ms{1000};
+        int server_pid{0};                  // process whose RSS is sampled, 0 = none
+        std::string project_name{"test_project_1"};
+        std::string list_path{"/"};
+    };
+
+    explicit LoadTest(const Options& options);
+
+    /**
+     * @brief runs the configured mix until the duration elapses and prints the report
+     * @return true if no request failed
+     */
+    bool run();
+
+    /**
+     * @brief returns help string describing the mix syntax and scenarios
+     */
+    static std::string help();
+
+    static constexpr const char* DEFAULT_MIX = "projects=4,containers=4,files=2,cycle=1,ws=8";
+
+private:
+    struct Scenario {
+        std::string name;
+        int workers{0};
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> ws_messages{0};
+        std::atomic<uint64_t> ws_bytes{0};
+        std::mutex latencies_mutex;
+        std::vector<double> latencies_ms;
+    };
+
+    struct RssSample {
+        double elapsed_seconds;
+        long rss_kb;
+        uint64_t total_requests;
+    };
+
+    Options options_;
+    std::string host_;
+    int port_{0};
+    std::vector<std::unique_ptr<Scenario>> scenarios_;
+    std::vector<RssSample> rss_samples_;
+    std::atomic<bool> stop_{false};
+    std::chrono::steady_clock::time_point started_at_;
+
+    bool parse_mix();
+    void run_http_worker(Scenario& scenario);
+    void run_ws_worker(Scenario& scenario, bool send_messages, bool binary);
+    void run_sampler();
+    void print_report() const;
+
+    long read_rss_kb() const;
+    uint64_t total_requests() const;
+    static double percentile(const std::vector<double>& sorted, double p);
+};
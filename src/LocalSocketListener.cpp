@@ -0,0 +1,139 @@
+#include "LocalSocketListener.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <grp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+LocalSocketListener::LocalSocketListener(crow::SimpleApp& app, const std::string& path, mode_t mode,
+                                         const std::string& group, uint16_t threads)
+    : app_(app)
+    , path_(path)
+    , mode_(mode)
+    , group_(group)
+    , threads_(std::max<uint16_t>(threads, 2))
+{
+}
+
+LocalSocketListener::~LocalSocketListener()
+{
+    stop();
+}
+
+bool LocalSocketListener::removeStaleSocket()
+{
+    struct stat st;
+    if (lstat(path_.c_str(), &st) != 0) {
+        return true;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        crow::logger(crow::LogLevel::Error) << "Local socket path " << path_ << " exists and is not a socket";
+        return false;
+    }
+
+    // a socket nobody accepts on is left over from a previous run
+    asio::io_context io_context;
+    crow::stream_protocol::socket probe(io_context);
+    asio::error_code ec;
+    probe.connect(crow::stream_protocol::endpoint(path_), ec);
+    if (!ec) {
+        crow::logger(crow::LogLevel::Error) << "Another process is listening on local socket " << path_;
+        return false;
+    }
+    if (unlink(path_.c_str()) != 0) {
+        crow::logger(crow::LogLevel::Error) << "Cannot remove stale local socket " << path_ << ": " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool LocalSocketListener::applyPermissions()
+{
+    if (chmod(path_.c_str(), mode_) != 0) {
+        crow::logger(crow::LogLevel::Error) << "Cannot set mode of local socket " << path_ << ": " << std::strerror(errno);
+        return false;
+    }
+    if (group_.empty()) {
+        return true;
+    }
+    struct group* entry = getgrnam(group_.c_str());
+    if (!entry) {
+        crow::logger(crow::LogLevel::Error) << "Unknown group '" << group_ << "' for local socket " << path_;
+        return false;
+    }
+    if (chown(path_.c_str(), static_cast<uid_t>(-1), entry->gr_gid) != 0) {
+        crow::logger(crow::LogLevel::Error) << "Cannot give local socket " << path_ << " to group '" << group_ << "': " << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool LocalSocketListener::start()
+{
+    if (server_) {
+        return true;
+    }
+    if (!removeStaleSocket()) {
+        return false;
+    }
+    std::error_code fs_error;
+    const std::filesystem::path parent = std::filesystem::path(path_).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, fs_error);
+    }
+
+    // the socket accepts connections from bind() on: it is bound owner-only and opened up to mode and
+    // group afterwards. bind() gives the socket file the mode of the socket itself, so that is set on
+    // the descriptor first, without touching the process-wide umask
+    sockaddr_un address{};
+    if (path_.size() >= sizeof(address.sun_path)) {
+        crow::logger(crow::LogLevel::Error) << "Local socket path " << path_ << " is too long";
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path_.c_str(), path_.size() + 1);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || fchmod(fd, 0600) != 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(fd, SOMAXCONN) != 0) {
+        crow::logger(crow::LogLevel::Error) << "Cannot listen on local socket " << path_ << ": " << std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    try {
+        server_ = std::make_unique<server_t>(&app_, crow::stream_protocol(), fd, "MetaInstaller", &middlewares_, threads_);
+    } catch (const std::exception& e) {
+        crow::logger(crow::LogLevel::Error) << "Cannot listen on local socket " << path_ << ": " << e.what();
+        ::close(fd);
+        unlink(path_.c_str());
+        return false;
+    }
+    if (!applyPermissions()) {
+        server_.reset();
+        unlink(path_.c_str());
+        return false;
+    }
+
+    thread_ = std::thread([this]() { server_->run(); });
+    if (server_->wait_for_start(std::chrono::steady_clock::now() + std::chrono::seconds(3)) == std::cv_status::timeout) {
+        crow::logger(crow::LogLevel::Warning) << "Local socket " << path_ << " is slow to start";
+    }
+    return true;
+}
+
+void LocalSocketListener::stop()
+{
+    if (!server_) {
+        return;
+    }
+    server_->stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    server_.reset();
+    unlink(path_.c_str());
+}
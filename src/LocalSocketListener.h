@@ -0,0 +1,61 @@
+#ifndef LOCALSOCKETLISTENER_H
+#define LOCALSOCKETLISTENER_H
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <sys/types.h>
+#include <crow.h>
+
+/**
+ * @brief Serves the app's routes and WebSockets on a unix domain socket, next to the TCP port.
+ *
+ * Scripts on the same host connect to the socket instead of loopback TCP:
+ *
+ *     curl --unix-socket /run/metainstaller.sock http://localhost/api/projects
+ *
+ * Requests go through the same router and handlers as TCP requests. Access is controlled by the
+ * socket file itself: it gets `mode` (0660 by default) and, if set, `group`, so only the owner
+ * and the group's members can connect. The socket is bound owner-only, so nobody else can connect
+ * before its permissions are set. A stale socket left by a previous run is replaced; a path
+ * that is not a socket, or a socket another process still listens on, is left alone.
+ */
+class LocalSocketListener {
+public:
+    LocalSocketListener(crow::SimpleApp& app, const std::string& path, mode_t mode, const std::string& group,
+                        uint16_t threads = 2);
+    ~LocalSocketListener();
+
+    LocalSocketListener(const LocalSocketListener&) = delete;
+    LocalSocketListener& operator=(const LocalSocketListener&) = delete;
+
+    /**
+     * @brief binds the socket, applies its permissions and starts serving; call once the app's routes are validated
+     * @return false (logged) if the socket cannot be created or its permissions cannot be set
+     */
+    bool start();
+
+    /**
+     * @brief stops serving and removes the socket file
+     */
+    void stop();
+
+    const std::string& path() const { return path_; }
+
+private:
+    using server_t = crow::Server<crow::SimpleApp, crow::UnixSocketAdaptor>;
+
+    bool removeStaleSocket();
+    bool applyPermissions();
+
+    crow::SimpleApp& app_;
+    const std::string path_;
+    const mode_t mode_;
+    const std::string group_;
+    const uint16_t threads_;
+    std::tuple<> middlewares_;     // crow::SimpleApp has none
+    std::unique_ptr<server_t> server_;
+    std::thread thread_;
+};
+
+#endif // LOCALSOCKETLISTENER_H
@@ -0,0 +1,353 @@
+#include "LogHub.h"
+#include "json11.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// a batch this large is sent without waiting for the batch window
+constexpr size_t MAX_BATCH_BYTES = 64 * 1024;
+// interned strings per binary connection, later strings are sent inline
+constexpr size_t MAX_INTERNED = 1024;
+
+enum BinaryEventKind { DEFINE = 0, LOG = 1, PROGRESS = 2 };
+
+// periodic topics, only sent to connections that subscribed to them by name or prefix
+const char* const OPT_IN_PREFIXES[] = {"resources:"};
+
+int64_t nowMilliseconds()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+} // namespace
+
+LogHub::LogHub()
+    : flusher_(&LogHub::flushLoop, this)
+{
+}
+
+LogHub::~LogHub()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    flush_cv_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+}
+
+void LogHub::add(crow::websocket::connection* conn)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Connection connection;
+    connection.binary = conn->get_subprotocol() == BINARY_SUBPROTOCOL;
+    connections_[conn] = std::move(connection);
+}
+
+void LogHub::remove(crow::websocket::connection* conn)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.erase(conn);
+}
+
+size_t LogHub::connectionCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connections_.size();
+}
+
+std::string LogHub::topicForOperation(const std::string& operation)
+{
+    std::string topic = operation;
+    std::transform(topic.begin(), topic.end(), topic.begin(), ::tolower);
+    auto underscore = topic.find('_');
+    if (underscore != std::string::npos) {
+        topic[underscore] = ':';
+    }
+    return topic;
+}
+
+int LogHub::levelRank(const std::string& level)
+{
+    if (level == "debug") return 0;
+    if (level == "info") return 1;
+    if (level == "success") return 2;
+    if (level == "warning" || level == "warn") return 3;
+    if (level == "error") return 4;
+    return 1;
+}
+
+bool LogHub::matches(const Subscription& subscription, const std::string& topic, int level)
+{
+    if (level < subscription.min_level) {
+        return false;
+    }
+    if (subscription.topics.empty()) {
+        for (const char* prefix : OPT_IN_PREFIXES) {
+            if (topic.rfind(prefix, 0) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (const auto& pattern : subscription.topics) {
+        if (!pattern.empty() && pattern.back() == '*') {
+            if (topic.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0) {
+                return true;
+            }
+        } else if (pattern == topic) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogHub::fits(crow::websocket::connection* conn, size_t bytes)
+{
+    return conn->pending_bytes() + bytes <= MAX_BACKLOG_BYTES;
+}
+
+bool LogHub::handleControlMessage(crow::websocket::connection& conn, const std::string& data)
+{
+    if (data.find('{') == std::string::npos) {
+        return false;
+    }
+    std::string parse_error;
+    json11::Json json = json11::Json::parse(data, parse_error);
+    const std::string type = json["type"].string_value();
+    if (!parse_error.empty() || (type != "subscribe" && type != "unsubscribe")) {
+        return false;
+    }
+
+    Subscription current;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = connections_.find(&conn);
+        if (it == connections_.end()) {
+            return true;
+        }
+        Subscription& subscription = it->second.subscription;
+        if (type == "subscribe") {
+            subscription = Subscription{};
+            for (const auto& topic : json["topics"].array_items()) {
+                if (!topic.string_value().empty() && topic.string_value() != "*") {
+                    subscription.topics.insert(topic.string_value());
+                }
+            }
+            if (json["min_level"].is_string()) {
+                subscription.min_level = levelRank(json["min_level"].string_value());
+            }
+        } else {
+            for (const auto& topic : json["topics"].array_items()) {
+                subscription.topics.erase(topic.string_value());
+            }
+        }
+        current = subscription;
+    }
+
+    static const char* level_names[] = {"debug", "info", "success", "warning", "error"};
+    json11::Json reply = json11::Json::object{
+        {"type", "subscribed"},
+        {"topics", json11::Json::array(current.topics.begin(), current.topics.end())},
+        {"min_level", level_names[current.min_level]}};
+    conn.send_text(reply.dump());
+    return true;
+}
+
+void LogHub::intern(Connection& connection, const std::string& value)
+{
+    if (connection.interned.count(value) || connection.interned.size() >= MAX_INTERNED) {
+        return;
+    }
+    const uint32_t id = static_cast<uint32_t>(connection.interned.size());
+    connection.interned[value] = id;
+    connection.pending.array(3);
+    connection.pending.integer(DEFINE);
+    connection.pending.integer(id);
+    connection.pending.string(value);
+    connection.pending_events++;
+}
+
+void LogHub::reference(Connection& connection, const std::string& value)
+{
+    auto it = connection.interned.find(value);
+    if (it != connection.interned.end()) {
+        connection.pending.integer(it->second);
+    } else {
+        connection.pending.string(value);
+    }
+}
+
+void LogHub::sendText(crow::websocket::connection* conn, const std::string& text)
+{
+    conn->send_text(text);
+    frames_sent_++;
+    bytes_sent_ += text.size();
+}
+
+void LogHub::flush(crow::websocket::connection* conn, Connection& connection)
+{
+    MsgPackWriter frame;
+    frame.array(connection.pending_events);
+    frame.raw(connection.pending.data());
+    connection.pending.clear();
+    connection.pending_events = 0;
+
+    conn->send_binary(frame.data());
+    frames_sent_++;
+    bytes_sent_ += frame.size();
+}
+
+std::map<crow::websocket::connection*, LogHub::Connection>::iterator LogHub::disconnect(
+    std::map<crow::websocket::connection*, Connection>::iterator it)
+{
+    disconnected_++;
+    crow::logger(crow::LogLevel::Warning) << "Closing a log WebSocket that does not keep up, " << it->first->pending_bytes()
+                                          << " bytes unread";
+    try {
+        it->first->close("too slow, reconnect to resume");
+    } catch (const std::exception&) {
+    }
+    return connections_.erase(it);
+}
+
+void LogHub::flushLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        flush_cv_.wait(lock, [this]() { return stopping_ || has_pending_; });
+        if (stopping_) {
+            return;
+        }
+        // events published within the window join this batch
+        lock.unlock();
+        std::this_thread::sleep_for(BATCH_WINDOW);
+        lock.lock();
+
+        has_pending_ = false;
+        for (auto it = connections_.begin(); it != connections_.end(); ) {
+            if (it->second.pending_events == 0) {
+                ++it;
+                continue;
+            }
+            try {
+                flush(it->first, it->second);
+                ++it;
+            } catch (const std::exception& e) {
+                // Remove invalid connection
+                it = connections_.erase(it);
+            }
+        }
+    }
+}
+
+template<typename Encode>
+void LogHub::deliver(const std::string& topic, int level, const std::function<std::string()>& renderJson, Encode encode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::string json_str;
+    bool delivered = false;
+    for (auto it = connections_.begin(); it != connections_.end(); ) {
+        auto* conn = it->first;
+        Connection& connection = it->second;
+        if (!matches(connection.subscription, topic, level)) {
+            ++it;
+            continue;
+        }
+        delivered = true;
+        try {
+            if (connection.binary) {
+                encode(connection);
+                connection.pending_events++;
+                if (!fits(conn, connection.pending.size())) {
+                    it = disconnect(it);
+                    continue;
+                }
+                if (connection.pending.size() >= MAX_BATCH_BYTES) {
+                    flush(conn, connection);
+                } else {
+                    has_pending_ = true;
+                }
+            } else {
+                // rendered once, for the first text client
+                if (json_str.empty()) {
+                    json_str = renderJson();
+                }
+                if (!fits(conn, json_str.size())) {
+                    it = disconnect(it);
+                    continue;
+                }
+                sendText(conn, json_str);
+            }
+            ++it;
+        } catch (const std::exception& e) {
+            // Remove invalid connection
+            it = connections_.erase(it);
+        }
+    }
+
+    if (!delivered) {
+        dropped_++;
+        return;
+    }
+    published_++;
+    if (has_pending_) {
+        flush_cv_.notify_one();
+    }
+}
+
+void LogHub::publish(const std::string& topic, const std::string& operation, const std::string& message, const std::string& level)
+{
+    const int rank = levelRank(level);
+    const int64_t timestamp = nowMilliseconds();
+
+    auto renderJson = [&]() {
+        crow::json::wvalue log_message;
+        log_message["type"] = "log";
+        log_message["timestamp"] = timestamp;
+        log_message["topic"] = topic;
+        log_message["operation"] = operation;
+        log_message["message"] = message;
+        log_message["level"] = level;
+        return log_message.dump();
+    };
+
+    deliver(topic, rank, renderJson, [&](Connection& connection) {
+        intern(connection, topic);
+        intern(connection, operation);
+        connection.pending.array(6);
+        connection.pending.integer(LOG);
+        connection.pending.integer(timestamp);
+        reference(connection, topic);
+        reference(connection, operation);
+        connection.pending.integer(rank);
+        connection.pending.string(message);
+    });
+}
+
+void LogHub::publishProgress(const std::string& topic, const ProgressEvent& progress, const std::function<std::string()>& renderJson)
+{
+    const int64_t timestamp = nowMilliseconds();
+
+    deliver(topic, levelRank(progress.level), renderJson, [&](Connection& connection) {
+        intern(connection, topic);
+        intern(connection, progress.status);
+        intern(connection, progress.operation);
+        connection.pending.array(8);
+        connection.pending.integer(PROGRESS);
+        connection.pending.integer(timestamp);
+        reference(connection, topic);
+        reference(connection, progress.status);
+        connection.pending.integer(progress.percentage);
+        connection.pending.string(progress.message);
+        reference(connection, progress.operation);
+        connection.pending.string(progress.error);
+    });
+}
@@ -0,0 +1,141 @@
+#ifndef LOGHUB_H
+#define LOGHUB_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <crow.h>
+#include "MsgPack.h"
+
+/**
+ * @brief Fan-out of operation logs (/ws/logs) and progress (/ws/progress) with per-connection topic subscriptions.
+ *
+ * Every event is published under a topic: `project:<name>` for project operations, and for
+ * docker operations the operation name with its first underscore turned into a colon
+ * (`docker_install` -> `docker:install`, `image_pull` -> `image:pull`).
+ *
+ * A new connection receives everything, as before subscriptions existed. A client narrows its
+ * stream with a control message:
+ *
+ *     {"type": "subscribe", "topics": ["project:demo", "image:*"], "min_level": "warning"}
+ *     {"type": "unsubscribe", "topics": ["image:*"]}
+ *
+ * `subscribe` replaces the connection's subscription; an empty or missing topic list means all
+ * topics. A topic ending in `*` matches by prefix. A line is delivered when its topic matches and its
+ * level is at least min_level (debug < info < success < warning < error). Lines nobody matches
+ * are dropped before they are serialized. Periodic topics (`resources:<name>`) are opt-in: a
+ * subscription without topics does not include them, naming them or a matching prefix does.
+ *
+ * A client that offers the `metainstaller.msgpack.v1` WebSocket subprotocol on connect receives
+ * binary frames instead of one JSON text frame per event. Events published within BATCH_WINDOW
+ * are sent together as one MessagePack array; each element is itself an array:
+ *
+ *     [0, id, string]                                                      defines an interned string
+ *     [1, timestamp_ms, topic, operation, level, message]                  log line
+ *     [2, timestamp_ms, topic, status, percentage, message, operation, error]  progress update
+ *
+ * topic, operation and status are ids defined earlier on the same connection (or the string itself
+ * once the connection's table is full), level is the numeric rank listed above.
+ *
+ * Neither encoding can tell a client which events it missed, so a connection is closed rather than
+ * skipped when it falls behind: every event is checked against the bytes crow still holds for the
+ * connection as it is queued, and one that would take them over MAX_BACKLOG_BYTES disconnects the
+ * client. It may reconnect and fetch the current state.
+ */
+class LogHub {
+public:
+    static constexpr const char* BINARY_SUBPROTOCOL = "metainstaller.msgpack.v1";
+    static constexpr std::chrono::milliseconds BATCH_WINDOW{5};
+    static constexpr size_t MAX_BACKLOG_BYTES = 8 * 1024 * 1024;
+
+    struct ProgressEvent {
+        std::string status;
+        int percentage = 0;
+        std::string message;
+        std::string operation;
+        std::string error;
+        std::string level = "info";
+    };
+
+    LogHub();
+    ~LogHub();
+
+    void add(crow::websocket::connection* conn);
+    void remove(crow::websocket::connection* conn);
+
+    /**
+     * @brief applies a subscribe/unsubscribe control message
+     * @return false if data is not a control message
+     */
+    bool handleControlMessage(crow::websocket::connection& conn, const std::string& data);
+
+    void publish(const std::string& topic, const std::string& operation, const std::string& message, const std::string& level);
+
+    /**
+     * @brief publishes a progress update
+     * @param renderJson builds the JSON text frame, only called if a text client receives the update
+     */
+    void publishProgress(const std::string& topic, const ProgressEvent& progress, const std::function<std::string()>& renderJson);
+
+    static std::string topicForOperation(const std::string& operation);
+    static int levelRank(const std::string& level);
+
+    size_t connectionCount();
+    uint64_t publishedCount() const { return published_; }
+    uint64_t droppedCount() const { return dropped_; }
+    uint64_t framesSent() const { return frames_sent_; }
+    uint64_t bytesSent() const { return bytes_sent_; }
+    uint64_t disconnectedCount() const { return disconnected_; }
+
+private:
+    struct Subscription {
+        std::set<std::string> topics;   // empty: all topics
+        int min_level = 0;
+    };
+
+    struct Connection {
+        Subscription subscription;
+        bool binary = false;
+        MsgPackWriter pending;          // encoded events not yet sent
+        uint32_t pending_events = 0;
+        std::unordered_map<std::string, uint32_t> interned;
+    };
+
+    static bool matches(const Subscription& subscription, const std::string& topic, int level);
+    // true if bytes more can be sent to conn without its unsent bytes exceeding MAX_BACKLOG_BYTES
+    static bool fits(crow::websocket::connection* conn, size_t bytes);
+
+    template<typename Encode>
+    void deliver(const std::string& topic, int level, const std::function<std::string()>& renderJson, Encode encode);
+
+    void intern(Connection& connection, const std::string& value);
+    void reference(Connection& connection, const std::string& value);
+    void sendText(crow::websocket::connection* conn, const std::string& text);
+    void flush(crow::websocket::connection* conn, Connection& connection);
+    // closes a connection that fell behind and stops delivering to it
+    std::map<crow::websocket::connection*, Connection>::iterator disconnect(
+        std::map<crow::websocket::connection*, Connection>::iterator it);
+    void flushLoop();
+
+    std::mutex mutex_;
+    std::map<crow::websocket::connection*, Connection> connections_;
+    std::condition_variable flush_cv_;
+    bool has_pending_ = false;
+    bool stopping_ = false;
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> frames_sent_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> disconnected_{0};
+    std::thread flusher_;
+};
+
+#endif // LOGHUB_H
@@ -0,0 +1,315 @@
+#include "LogStreamManager.h"
+#include "ProjectManager.h"
+#include "json11.hpp"
+#include <algorithm>
+
+namespace {
+
+const std::string ROUTE_PREFIX = "/ws/projects/";
+const std::string ROUTE_SUFFIX = "/logs";
+
+// bytes a line takes in a frame, near enough: its fields plus the JSON around them
+size_t frameBytes(const LogLine& line)
+{
+    return line.container.size() + line.timestamp.size() + line.message.size() + 48;
+}
+
+} // namespace
+
+LogStreamManager::LogStreamManager(ProjectManager& projects)
+    : projects_(projects)
+    , flusher_(&LogStreamManager::flushLoop, this)
+{
+}
+
+LogStreamManager::~LogStreamManager()
+{
+    std::map<std::string, std::shared_ptr<Stream>> streams;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        streams.swap(streams_);
+        subscribers_.clear();
+    }
+    cv_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    for (auto& [key, stream] : streams) {
+        stream->process.killProcess();
+    }
+}
+
+void LogStreamManager::registerWebSocketEndpoints(crow::SimpleApp& app)
+{
+    CROW_WEBSOCKET_ROUTE(app, "/ws/projects/<string>/logs")
+        .onaccept([this](const crow::request& req, void** userdata) {
+            return accept(req, userdata);
+        })
+        .onopen([this](crow::websocket::connection& conn) {
+            subscribe(conn);
+        })
+        .onclose([this](crow::websocket::connection& conn, const std::string& reason, uint16_t) {
+            unsubscribe(conn);
+            crow::logger(crow::LogLevel::Debug) << "Container log stream closed: " << reason;
+        })
+        .onmessage([](crow::websocket::connection&, const std::string&, bool) {
+            // the stream is one-way, client messages are ignored
+        })
+        .onerror([](crow::websocket::connection&, const std::string& error_message) {
+            crow::logger(crow::LogLevel::Error) << "Container log WebSocket error: " << error_message;
+        });
+}
+
+size_t LogStreamManager::streamCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.size();
+}
+
+bool LogStreamManager::accept(const crow::request& req, void** userdata)
+{
+    const std::string& url = req.url;
+    if (url.size() <= ROUTE_PREFIX.size() + ROUTE_SUFFIX.size()) {
+        return false;
+    }
+    auto request = std::make_unique<Request>();
+    request->project = url.substr(ROUTE_PREFIX.size(), url.size() - ROUTE_PREFIX.size() - ROUTE_SUFFIX.size());
+    if (projects_.getProjectInfo(request->project).compose_file_path.empty()) {
+        crow::logger(crow::LogLevel::Warning) << "Container log stream refused, project not found: " << request->project;
+        return false;
+    }
+
+    const char* service = req.url_params.get("service");
+    request->service = service ? service : "";
+    const char* since = req.url_params.get("since");
+    if (since && *since) {
+        request->since = parseLogTimestamp(since);
+        if (request->since < 0) {
+            crow::logger(crow::LogLevel::Warning) << "Container log stream refused, invalid since: " << since;
+            return false;
+        }
+    }
+
+    *userdata = request.release();
+    return true;
+}
+
+std::shared_ptr<LogStreamManager::Stream> LogStreamManager::startStream(const Request& request, std::vector<std::shared_ptr<Stream>>& stopped)
+{
+    const std::string key = request.project + "\n" + request.service;
+    auto it = streams_.find(key);
+    if (it != streams_.end() && !it->second->ended) {
+        return it->second;
+    }
+    if (it != streams_.end()) {
+        // its process has exited, a new subscriber starts a new one
+        stopped.push_back(it->second);
+        streams_.erase(it);
+    }
+
+    const ProjectInfo project = projects_.getProjectInfo(request.project);
+    std::vector<std::string> args = {"compose", "-f", project.compose_file_path, "-p", request.project,
+                                     "logs", "--follow", "--timestamps", "--no-color",
+                                     "--tail", std::to_string(HISTORY_LINES)};
+    if (!request.service.empty()) {
+        args.push_back(request.service);
+    }
+
+    auto stream = std::make_shared<Stream>();
+    stream->key = key;
+    streams_[key] = stream;
+
+    std::weak_ptr<Stream> weak = stream;
+    pid_t pid = stream->process.startProcess(
+        "docker",
+        args,
+        {{"COMPOSE_PROJECT_NAME", request.project}},
+        [this, weak](const std::string& output) { onOutput(weak, output); },
+        [this, weak]() { onEnded(weak); },
+        project.working_directory);
+    if (pid < 0) {
+        stream->ended = true;
+    }
+    crow::logger(crow::LogLevel::Info) << "Started container log stream for project " << request.project
+                                       << (request.service.empty() ? "" : ", service " + request.service);
+    return stream;
+}
+
+void LogStreamManager::subscribe(crow::websocket::connection& conn)
+{
+    std::unique_ptr<Request> request(static_cast<Request*>(conn.userdata()));
+    conn.userdata(nullptr);
+    if (!request) {
+        conn.close("missing log stream request");
+        return;
+    }
+
+    std::vector<std::shared_ptr<Stream>> stopped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        auto stream = startStream(*request, stopped);
+        stream->subscribers.insert(&conn);
+
+        Subscriber& subscriber = subscribers_[&conn];
+        subscriber.stream = stream;
+        for (const auto& line : stream->history) {
+            if (request->since < 0 || line.seconds < 0 || line.seconds >= request->since) {
+                enqueue(subscriber, line);
+            }
+        }
+    }
+    for (auto& stream : stopped) {
+        stream->process.killProcess();
+    }
+}
+
+void LogStreamManager::unsubscribe(crow::websocket::connection& conn)
+{
+    // a connection closed before it was opened still owns its request
+    delete static_cast<Request*>(conn.userdata());
+    conn.userdata(nullptr);
+
+    std::shared_ptr<Stream> stopped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = subscribers_.find(&conn);
+        if (it == subscribers_.end()) {
+            return;
+        }
+        auto stream = it->second.stream;
+        subscribers_.erase(it);
+        stream->subscribers.erase(&conn);
+
+        auto current = streams_.find(stream->key);
+        if (stream->subscribers.empty() && current != streams_.end() && current->second == stream) {
+            streams_.erase(current);
+            stopped = stream;
+        }
+    }
+    // outside the lock: the output callbacks take it until the reader thread is joined
+    if (stopped) {
+        stopped->process.killProcess();
+        crow::logger(crow::LogLevel::Info) << "Stopped container log stream, no subscribers left";
+    }
+}
+
+void LogStreamManager::enqueue(Subscriber& subscriber, const LogLine& line)
+{
+    subscriber.pending.push_back(line);
+    subscriber.pending_bytes += frameBytes(line);
+    while (subscriber.pending.size() > MAX_PENDING_LINES || subscriber.pending_bytes > MAX_PENDING_BYTES) {
+        subscriber.pending_bytes -= frameBytes(subscriber.pending.front());
+        subscriber.pending.pop_front();
+        subscriber.dropped++;
+    }
+}
+
+void LogStreamManager::onOutput(const std::weak_ptr<Stream>& weak, const std::string& output)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto stream = weak.lock();
+    if (!stream) {
+        return;
+    }
+
+    stream->partial += output;
+    size_t start = 0;
+    size_t newline;
+    while ((newline = stream->partial.find('\n', start)) != std::string::npos) {
+        LogLine line = LogLine::parse(stream->partial.substr(start, newline - start));
+        start = newline + 1;
+
+        stream->history.push_back(line);
+        if (stream->history.size() > HISTORY_LINES) {
+            stream->history.pop_front();
+        }
+        for (auto* conn : stream->subscribers) {
+            auto it = subscribers_.find(conn);
+            if (it == subscribers_.end()) {
+                continue;
+            }
+            enqueue(it->second, line);
+        }
+    }
+    stream->partial.erase(0, start);
+}
+
+void LogStreamManager::onEnded(const std::weak_ptr<Stream>& weak)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto stream = weak.lock()) {
+        stream->ended = true;
+    }
+}
+
+void LogStreamManager::flushLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait_for(lock, FLUSH_INTERVAL, [this]() { return stopping_; });
+        if (stopping_) {
+            return;
+        }
+
+        for (auto& [conn, subscriber] : subscribers_) {
+            if (subscriber.closing) {
+                continue;
+            }
+            try {
+                // a client that has not read what it was sent gets nothing more until it catches up
+                const bool behind = conn->pending_bytes() + std::min(subscriber.pending_bytes, MAX_FRAME_BYTES) > MAX_BACKLOG_BYTES;
+                if (!behind && (!subscriber.pending.empty() || subscriber.dropped > 0)) {
+                    json11::Json::array lines;
+                    size_t bytes = 0;
+                    while (!subscriber.pending.empty() && lines.size() < MAX_LINES_PER_FRAME) {
+                        const size_t line_bytes = frameBytes(subscriber.pending.front());
+                        if (!lines.empty() && bytes + line_bytes > MAX_FRAME_BYTES) {
+                            break;
+                        }
+                        bytes += line_bytes;
+                        lines.push_back(subscriber.pending.front().toJson());
+                        subscriber.pending_bytes -= line_bytes;
+                        subscriber.pending.pop_front();
+                    }
+                    json11::Json frame = json11::Json::object{
+                        {"type", "lines"},
+                        {"lines", lines},
+                        {"dropped", static_cast<double>(subscriber.dropped)}};
+                    subscriber.dropped = 0;
+                    const std::string text = frame.dump();
+                    conn->send_text(text);
+                }
+                if (subscriber.stream->ended && subscriber.pending.empty()) {
+                    conn->send_text("{\"type\":\"end\"}");
+                    conn->close("log stream ended");
+                    subscriber.closing = true;
+                }
+            } catch (const std::exception& e) {
+                subscriber.closing = true;
+            }
+        }
+
+        // reap streams whose process exited, their subscribers were told above or will be on the next pass
+        std::vector<std::shared_ptr<Stream>> stopped;
+        for (auto it = streams_.begin(); it != streams_.end(); ) {
+            if (it->second->ended) {
+                stopped.push_back(it->second);
+                it = streams_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (!stopped.empty()) {
+            lock.unlock();
+            for (auto& stream : stopped) {
+                stream->process.killProcess();
+            }
+            stopped.clear();
+            lock.lock();
+        }
+    }
+}
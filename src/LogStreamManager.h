@@ -0,0 +1,104 @@
+#ifndef LOGSTREAMMANAGER_H
+#define LOGSTREAMMANAGER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <crow.h>
+#include "ContainerLog.h"
+#include "ProcessManager.h"
+
+class ProjectManager;
+
+/**
+ * @brief Serves /ws/projects/<name>/logs?service=&since=: live container logs of a project.
+ *
+ * One `docker compose logs --follow` process runs per (project, service) and is shared by all
+ * subscribers of that pair. It is started by the first subscriber and stopped when the last one
+ * leaves. The stream keeps the latest HISTORY_LINES lines so a new subscriber first receives the
+ * recent history (only lines at or after `since`, an RFC 3339 time or unix seconds, when given)
+ * and then the new lines as they arrive.
+ *
+ * Lines are sent every FLUSH_INTERVAL as one text frame per subscriber:
+ *
+ *     {"type": "lines", "lines": [{"container", "timestamp", "message"}, ...], "dropped": 0}
+ *
+ * Each subscriber has its own queue. At most MAX_LINES_PER_FRAME lines and MAX_FRAME_BYTES are sent
+ * per interval, and at most MAX_PENDING_LINES lines or MAX_PENDING_BYTES wait in the queue; both caps
+ * are applied as lines are queued. When a subscriber falls further behind, its oldest lines are
+ * dropped and counted in `dropped`, without slowing the stream or the other subscribers. Frames wait
+ * in the queue while crow still holds MAX_BACKLOG_BYTES the subscriber has not read, so a client that
+ * stops reading loses lines here instead of piling them up in crow.
+ * When the log process exits (e.g. the project was stopped) subscribers receive {"type": "end"}
+ * and are closed.
+ */
+class LogStreamManager {
+public:
+    static constexpr size_t HISTORY_LINES = 200;
+    static constexpr size_t MAX_PENDING_LINES = 5000;
+    static constexpr size_t MAX_PENDING_BYTES = 4 * 1024 * 1024;
+    static constexpr size_t MAX_LINES_PER_FRAME = 500;
+    static constexpr size_t MAX_FRAME_BYTES = 256 * 1024;
+    static constexpr size_t MAX_BACKLOG_BYTES = 8 * 1024 * 1024;
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{100};
+
+    explicit LogStreamManager(ProjectManager& projects);
+    ~LogStreamManager();
+
+    void registerWebSocketEndpoints(crow::SimpleApp& app);
+
+    /**
+     * @brief number of log processes currently running
+     */
+    size_t streamCount();
+
+private:
+    struct Stream {
+        std::string key;
+        ProcessManager process;
+        std::string partial;            // output after the last newline
+        std::deque<LogLine> history;
+        std::set<crow::websocket::connection*> subscribers;
+        bool ended = false;
+    };
+
+    struct Subscriber {
+        std::shared_ptr<Stream> stream;
+        std::deque<LogLine> pending;
+        size_t pending_bytes = 0;
+        uint64_t dropped = 0;
+        bool closing = false;
+    };
+
+    struct Request {
+        std::string project;
+        std::string service;
+        int64_t since = -1;
+    };
+
+    bool accept(const crow::request& req, void** userdata);
+    void subscribe(crow::websocket::connection& conn);
+    void unsubscribe(crow::websocket::connection& conn);
+    std::shared_ptr<Stream> startStream(const Request& request, std::vector<std::shared_ptr<Stream>>& stopped);
+    static void enqueue(Subscriber& subscriber, const LogLine& line);
+    void onOutput(const std::weak_ptr<Stream>& weak, const std::string& output);
+    void onEnded(const std::weak_ptr<Stream>& weak);
+    void flushLoop();
+
+    ProjectManager& projects_;
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<Stream>> streams_;
+    std::map<crow::websocket::connection*, Subscriber> subscribers_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread flusher_;
+};
+
+#endif // LOGSTREAMMANAGER_H
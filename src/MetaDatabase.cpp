@@ -121,6 +121,78 @@ bool MetaDatabase::initDatabase() {
         return false;
     }
 
+    // Create compose_models table (compiled docker compose files, see ComposeModel)
+    sql = "CREATE TABLE IF NOT EXISTS compose_models ("
+          "project_name TEXT PRIMARY KEY NOT NULL,"
+          "compose_file_path TEXT,"
+          "content_hash TEXT,"
+          "mtime_ns INTEGER,"
+          "size INTEGER,"
+          "model TEXT);";
+
+    rc = sqlite3_exec(db, sql, callback, 0, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_close(db);
+        return false;
+    }
+
+    // Create project_manifests table (entries of the archive a project was extracted from, see ArchiveManifest)
+    sql = "CREATE TABLE IF NOT EXISTS project_manifests ("
+          "project_name TEXT PRIMARY KEY NOT NULL,"
+          "archive_path TEXT,"
+          "manifest TEXT);";
+
+    rc = sqlite3_exec(db, sql, callback, 0, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_close(db);
+        return false;
+    }
+
+    // Create content_blobs and content_refs tables (files shared between projects, see ContentStore)
+    sql = "CREATE TABLE IF NOT EXISTS content_blobs ("
+          "hash TEXT PRIMARY KEY NOT NULL,"
+          "size INTEGER NOT NULL,"
+          "crc TEXT,"
+          "refs INTEGER NOT NULL DEFAULT 0);"
+          "CREATE INDEX IF NOT EXISTS content_blobs_size_crc ON content_blobs (size, crc);"
+          "CREATE TABLE IF NOT EXISTS content_refs ("
+          "project_name TEXT NOT NULL,"
+          "path TEXT NOT NULL,"
+          "hash TEXT NOT NULL,"
+          "PRIMARY KEY (project_name, path));";
+
+    rc = sqlite3_exec(db, sql, callback, 0, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_close(db);
+        return false;
+    }
+
+    // Create metric_points table (snapshots of MetricsStore buckets)
+    sql = "CREATE TABLE IF NOT EXISTS metric_points ("
+          "project TEXT NOT NULL,"
+          "service TEXT NOT NULL,"
+          "metric TEXT NOT NULL,"
+          "resolution INTEGER NOT NULL,"
+          "bucket INTEGER NOT NULL,"
+          "count INTEGER,"
+          "sum REAL,"
+          "max REAL,"
+          "PRIMARY KEY (project, service, metric, resolution, bucket));";
+
+    rc = sqlite3_exec(db, sql, callback, 0, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_close(db);
+        return false;
+    }
+
     sqlite3_close(db);
     return true;
 }
@@ -522,3 +594,514 @@ std::string MetaDatabase::getSetting(const std::string& key) {
     sqlite3_close(db);
     return value;
 }
+
+bool MetaDatabase::saveComposeModel(const std::string& projectName, const ComposeModel& model) {
+    sqlite3* db;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    const char* insertModelSql = "INSERT OR REPLACE INTO compose_models "
+                                 "(project_name, compose_file_path, content_hash, mtime_ns, size, model) "
+                                 "VALUES (?, ?, ?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, insertModelSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    const std::string modelJson = model.toJson();
+    sqlite3_bind_text(stmt, 1, projectName.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, model.file_path.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, model.content_hash.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 4, model.mtime_ns);
+    sqlite3_bind_int64(stmt, 5, model.size);
+    sqlite3_bind_text(stmt, 6, modelJson.c_str(), -1, SQLITE_STATIC);
+
+    rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to execute statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return false;
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return true;
+}
+
+std::map<std::string, ComposeModel> MetaDatabase::loadComposeModels() {
+    std::map<std::string, ComposeModel> models;
+    sqlite3* db;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return models;
+    }
+
+    const char* selectModelsSql = "SELECT project_name, model FROM compose_models;";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, selectModelsSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return models;
+    }
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        std::string projectName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const char* modelJson = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        if (modelJson) {
+            models[projectName] = ComposeModel::fromJson(modelJson);
+        }
+    }
+
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to execute statement: " << sqlite3_errmsg(db) << std::endl;
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return models;
+}
+
+bool MetaDatabase::deleteComposeModel(const std::string& projectName) {
+    sqlite3* db;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    const char* deleteModelSql = "DELETE FROM compose_models WHERE project_name = ?;";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, deleteModelSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, projectName.c_str(), -1, SQLITE_STATIC);
+
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return rc == SQLITE_DONE;
+}
+
+bool MetaDatabase::saveProjectManifest(const std::string& projectName, const std::string& archivePath, const ArchiveManifest& manifest) {
+    sqlite3* db;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    const char* insertManifestSql = "INSERT OR REPLACE INTO project_manifests (project_name, archive_path, manifest) VALUES (?, ?, ?);";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, insertManifestSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    const std::string manifestJson = manifest.toJson();
+    sqlite3_bind_text(stmt, 1, projectName.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, archivePath.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, manifestJson.c_str(), -1, SQLITE_STATIC);
+
+    rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to execute statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+        return false;
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return true;
+}
+
+bool MetaDatabase::loadProjectManifest(const std::string& projectName, ArchiveManifest& manifest) {
+    sqlite3* db;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    const char* selectManifestSql = "SELECT manifest FROM project_manifests WHERE project_name = ?;";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, selectManifestSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, projectName.c_str(), -1, SQLITE_STATIC);
+
+    bool found = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* manifestJson = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        if (manifestJson) {
+            manifest = ArchiveManifest::fromJson(manifestJson);
+            found = true;
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return found;
+}
+
+bool MetaDatabase::deleteProjectManifest(const std::string& projectName) {
+    sqlite3* db;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    const char* deleteManifestSql = "DELETE FROM project_manifests WHERE project_name = ?;";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, deleteManifestSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, projectName.c_str(), -1, SQLITE_STATIC);
+
+    rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return rc == SQLITE_DONE;
+}
+
+namespace {
+
+// runs one statement with text/integer parameters, returning the first column of every row
+bool runStatement(sqlite3* db, const char* sql, const std::vector<std::string>& texts, std::vector<std::string>* rows = nullptr,
+                  const std::vector<int64_t>& integers = {})
+{
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    int index = 1;
+    for (const auto& text : texts) {
+        sqlite3_bind_text(stmt, index++, text.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    for (int64_t integer : integers) {
+        sqlite3_bind_int64(stmt, index++, integer);
+    }
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const char* value = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        if (rows && value) {
+            rows->push_back(value);
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to execute statement: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// moves the project file at path off its blob
+bool unreferencePath(sqlite3* db, const std::string& projectName, const std::string& path)
+{
+    std::vector<std::string> previous;
+    return runStatement(db, "SELECT hash FROM content_refs WHERE project_name = ? AND path = ?;", {projectName, path}, &previous)
+        && (previous.empty() || (runStatement(db, "UPDATE content_blobs SET refs = refs - 1 WHERE hash = ?;", {previous.front()})
+                                 && runStatement(db, "DELETE FROM content_refs WHERE project_name = ? AND path = ?;", {projectName, path})));
+}
+
+bool collectOrphans(sqlite3* db, std::vector<std::string>& orphaned)
+{
+    return runStatement(db, "SELECT hash FROM content_blobs WHERE refs <= 0;", {}, &orphaned)
+        && runStatement(db, "DELETE FROM content_blobs WHERE refs <= 0;", {});
+}
+
+bool finishTransaction(sqlite3* db, bool ok)
+{
+    char* errMsg = 0;
+    if (sqlite3_exec(db, ok ? "COMMIT;" : "ROLLBACK;", NULL, NULL, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        ok = false;
+    }
+    sqlite3_close(db);
+    return ok;
+}
+
+} // namespace
+
+std::vector<ContentBlob> MetaDatabase::loadContentBlobs() {
+    std::vector<ContentBlob> blobs;
+    sqlite3* db;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return blobs;
+    }
+
+    const char* selectBlobsSql = "SELECT hash, size, crc, refs FROM content_blobs;";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, selectBlobsSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return blobs;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ContentBlob blob;
+        const char* hash = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const char* crc = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        blob.hash = hash ? hash : "";
+        blob.size = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+        blob.crc = crc ? crc : "";
+        blob.refs = sqlite3_column_int64(stmt, 3);
+        blobs.push_back(blob);
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return blobs;
+}
+
+bool MetaDatabase::saveContentRefs(const std::string& projectName, const std::vector<ContentRef>& refs, std::vector<std::string>& orphaned) {
+    sqlite3* db;
+    char* errMsg = 0;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    rc = sqlite3_exec(db, "BEGIN TRANSACTION;", NULL, NULL, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_close(db);
+        return false;
+    }
+
+    bool ok = true;
+    for (const auto& ref : refs) {
+        ok = ok && unreferencePath(db, projectName, ref.path)
+            && runStatement(db, "INSERT OR IGNORE INTO content_blobs (hash, crc, size, refs) VALUES (?, ?, ?, 0);",
+                            {ref.hash, ref.crc}, nullptr, {static_cast<int64_t>(ref.size)})
+            && runStatement(db, "UPDATE content_blobs SET refs = refs + 1 WHERE hash = ?;", {ref.hash})
+            && runStatement(db, "INSERT INTO content_refs (project_name, path, hash) VALUES (?, ?, ?);", {projectName, ref.path, ref.hash});
+    }
+    std::vector<std::string> released;
+    ok = ok && collectOrphans(db, released);
+    if (!finishTransaction(db, ok)) {
+        return false;
+    }
+    orphaned.insert(orphaned.end(), released.begin(), released.end());
+    return true;
+}
+
+bool MetaDatabase::releaseContentRefs(const std::string& projectName, const std::vector<std::string>& paths, std::vector<std::string>& orphaned) {
+    sqlite3* db;
+    char* errMsg = 0;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    rc = sqlite3_exec(db, "BEGIN TRANSACTION;", NULL, NULL, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_close(db);
+        return false;
+    }
+
+    bool ok = true;
+    if (paths.empty()) {
+        ok = runStatement(db, "UPDATE content_blobs SET refs = refs - (SELECT COUNT(*) FROM content_refs r "
+                              "WHERE r.hash = content_blobs.hash AND r.project_name = ?);", {projectName})
+            && runStatement(db, "DELETE FROM content_refs WHERE project_name = ?;", {projectName});
+    }
+    for (const auto& path : paths) {
+        ok = ok && unreferencePath(db, projectName, path);
+    }
+    std::vector<std::string> released;
+    ok = ok && collectOrphans(db, released);
+    if (!finishTransaction(db, ok)) {
+        return false;
+    }
+    orphaned.insert(orphaned.end(), released.begin(), released.end());
+    return true;
+}
+
+bool MetaDatabase::saveMetricPoints(const std::vector<MetricPoint>& points, const std::map<int64_t, int64_t>& oldestBuckets) {
+    sqlite3* db;
+    char* errMsg = 0;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return false;
+    }
+
+    rc = sqlite3_exec(db, "BEGIN TRANSACTION;", NULL, NULL, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_close(db);
+        return false;
+    }
+
+    const char* insertPointSql = "INSERT OR REPLACE INTO metric_points "
+                                 "(project, service, metric, resolution, bucket, count, sum, max) "
+                                 "VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, insertPointSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+        sqlite3_close(db);
+        return false;
+    }
+
+    for (const MetricPoint& point : points) {
+        sqlite3_bind_text(stmt, 1, point.project.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, point.service.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, point.metric.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 4, point.resolution);
+        sqlite3_bind_int64(stmt, 5, point.bucket);
+        sqlite3_bind_int64(stmt, 6, point.count);
+        sqlite3_bind_double(stmt, 7, point.sum);
+        sqlite3_bind_double(stmt, 8, point.max);
+
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE) {
+            std::cerr << "Failed to execute statement: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_finalize(stmt);
+            sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+            sqlite3_close(db);
+            return false;
+        }
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    // Drop buckets the in-memory rings no longer reach
+    const char* deleteOldSql = "DELETE FROM metric_points WHERE resolution = ? AND bucket < ?;";
+    rc = sqlite3_prepare_v2(db, deleteOldSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+        sqlite3_close(db);
+        return false;
+    }
+    for (const auto& [resolution, oldest] : oldestBuckets) {
+        sqlite3_bind_int64(stmt, 1, resolution);
+        sqlite3_bind_int64(stmt, 2, oldest);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    rc = sqlite3_exec(db, "COMMIT;", NULL, NULL, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "SQL error: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_close(db);
+        return false;
+    }
+
+    sqlite3_close(db);
+    return true;
+}
+
+std::vector<MetricPoint> MetaDatabase::loadMetricPoints() {
+    std::vector<MetricPoint> points;
+    sqlite3* db;
+    int rc;
+
+    rc = sqlite3_open(getDatabasePath().c_str(), &db);
+    if (rc) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return points;
+    }
+
+    const char* selectPointsSql = "SELECT project, service, metric, resolution, bucket, count, sum, max FROM metric_points;";
+    sqlite3_stmt* stmt;
+    rc = sqlite3_prepare_v2(db, selectPointsSql, -1, &stmt, NULL);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        return points;
+    }
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        MetricPoint point;
+        point.project = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        point.service = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        point.metric = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        point.resolution = sqlite3_column_int64(stmt, 3);
+        point.bucket = sqlite3_column_int64(stmt, 4);
+        point.count = static_cast<uint32_t>(sqlite3_column_int64(stmt, 5));
+        point.sum = sqlite3_column_double(stmt, 6);
+        point.max = sqlite3_column_double(stmt, 7);
+        points.push_back(point);
+    }
+
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Failed to execute statement: " << sqlite3_errmsg(db) << std::endl;
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return points;
+}
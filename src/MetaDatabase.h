@@ -3,7 +3,10 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "types.hpp"
+#include "ComposeModel.h"
+#include "ArchiveManifest.h"
 
 class MetaDatabase {
 public:
@@ -17,6 +20,25 @@ public:
     bool saveSetting(const std::string& key, const std::string& value);
     std::string getSetting(const std::string& key);
 
+    bool saveComposeModel(const std::string& projectName, const ComposeModel& model);
+    std::map<std::string, ComposeModel> loadComposeModels();
+    bool deleteComposeModel(const std::string& projectName);
+    // entries of the archive a project was extracted from, for delta updates
+    bool saveProjectManifest(const std::string& projectName, const std::string& archivePath, const ArchiveManifest& manifest);
+    bool loadProjectManifest(const std::string& projectName, ArchiveManifest& manifest);
+    bool deleteProjectManifest(const std::string& projectName);
+
+    // content store (see ContentStore): blobs with the number of project files linked to them
+    std::vector<ContentBlob> loadContentBlobs();
+    // points each (project, path) at its blob; blobs left without references are deleted and their hashes added to orphaned
+    bool saveContentRefs(const std::string& projectName, const std::vector<ContentRef>& refs, std::vector<std::string>& orphaned);
+    // drops the references of the given paths, or of every path of the project if none are given
+    bool releaseContentRefs(const std::string& projectName, const std::vector<std::string>& paths, std::vector<std::string>& orphaned);
+
+    // adds or replaces points, then deletes buckets older than oldestBuckets[resolution]
+    bool saveMetricPoints(const std::vector<MetricPoint>& points, const std::map<int64_t, int64_t>& oldestBuckets);
+    std::vector<MetricPoint> loadMetricPoints();
+
 private:
     std::string getDatabasePath();
 };
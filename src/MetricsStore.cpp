@@ -0,0 +1,357 @@
+#include "MetricsStore.h"
+#include "MetaDatabase.h"
+#include "ContainerLog.h"
+#include "json11.hpp"
+#include <algorithm>
+#include <ctime>
+#include <limits>
+
+namespace {
+
+crow::response jsonResponse(int code, const json11::Json& body)
+{
+    crow::response res(code, body.dump());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+} // namespace
+
+std::vector<MetricsStore::Tier> MetricsStore::defaultTiers()
+{
+    return {{5, 720}, {60, 1440}, {600, 1008}};
+}
+
+MetricsStore::MetricsStore(std::vector<Tier> tiers, size_t maxSeries)
+    : tiers_(std::move(tiers))
+    , max_series_(maxSeries)
+{
+}
+
+MetricsStore::~MetricsStore()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (snapshot_thread_.joinable()) {
+        snapshot_thread_.join();
+    }
+    if (database_) {
+        snapshot();
+    }
+}
+
+MetricsStore::Store MetricsStore::makeStore() const
+{
+    Store store;
+    for (const Tier& tier : tiers_) {
+        Ring ring;
+        ring.bucket.assign(tier.slots, 0);
+        ring.count.assign(tier.slots, 0);
+        ring.sum.assign(tier.slots, 0);
+        ring.max.assign(tier.slots, 0);
+        store.rings.push_back(std::move(ring));
+    }
+    return store;
+}
+
+void MetricsStore::add(Ring& ring, const Tier& tier, uint32_t bucket, uint32_t count, double sum, double max)
+{
+    const size_t slot = bucket % tier.slots;
+    if (ring.bucket[slot] > bucket) {
+        // older than the ring reaches
+        return;
+    }
+    if (ring.bucket[slot] != bucket) {
+        ring.bucket[slot] = bucket;
+        ring.count[slot] = 0;
+        ring.sum[slot] = 0;
+        ring.max[slot] = -std::numeric_limits<float>::infinity();
+    }
+    ring.count[slot] = static_cast<uint16_t>(std::min<uint32_t>(ring.count[slot] + count, UINT16_MAX));
+    ring.sum[slot] += static_cast<float>(sum);
+    ring.max[slot] = std::max(ring.max[slot], static_cast<float>(max));
+}
+
+bool MetricsStore::record(const std::string& project, const std::string& service, const std::string& metric,
+                          int64_t timestamp, double value)
+{
+    if (timestamp <= 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Key key{project, service, metric};
+    auto it = series_.find(key);
+    if (it == series_.end()) {
+        if (series_.size() >= max_series_) {
+            return false;
+        }
+        it = series_.emplace(std::move(key), makeStore()).first;
+    }
+    for (size_t i = 0; i < tiers_.size(); i++) {
+        add(it->second.rings[i], tiers_[i], static_cast<uint32_t>(timestamp / tiers_[i].resolution), 1, value, value);
+    }
+    return true;
+}
+
+void MetricsStore::removeProject(const std::string& project)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = series_.lower_bound(Key{project, "", ""});
+    while (it != series_.end() && std::get<0>(it->first) == project) {
+        it = series_.erase(it);
+    }
+}
+
+MetricsStore::QueryResult MetricsStore::query(const std::string* project, const std::string* service,
+                                              const std::string* metric, int64_t from, int64_t to, size_t maxPoints)
+{
+    QueryResult result;
+    result.from = from;
+    result.to = to;
+    if (tiers_.empty() || from > to || maxPoints == 0) {
+        return result;
+    }
+
+    // the finest tier that still holds `from`
+    const int64_t now = std::max<int64_t>(to, time(nullptr));
+    size_t chosen = tiers_.size() - 1;
+    for (size_t i = 0; i < tiers_.size(); i++) {
+        if (tiers_[i].resolution * static_cast<int64_t>(tiers_[i].slots) >= now - from) {
+            chosen = i;
+            break;
+        }
+    }
+    const Tier& tier = tiers_[chosen];
+    const int64_t resolution = tier.resolution;
+    const int64_t buckets = to / resolution - from / resolution + 1;
+    const int64_t per_point = (buckets + static_cast<int64_t>(maxPoints) - 1) / static_cast<int64_t>(maxPoints);
+    result.step = resolution * std::max<int64_t>(per_point, 1);
+
+    const int64_t last = to / resolution;
+    const int64_t first = std::max(from / resolution, last - static_cast<int64_t>(tier.slots) + 1);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = project ? series_.lower_bound(Key{*project, "", ""}) : series_.begin();
+    for (; it != series_.end(); ++it) {
+        const auto& [series_project, series_service, series_metric] = it->first;
+        if (project && series_project != *project) {
+            break;
+        }
+        if ((service && series_service != *service) || (metric && series_metric != *metric)) {
+            continue;
+        }
+
+        const Ring& ring = it->second.rings[chosen];
+        Series series{series_project, series_service, series_metric, {}, {}, {}};
+        int64_t group = -1;
+        double sum = 0;
+        uint64_t count = 0;
+        float max = 0;
+        auto flush = [&]() {
+            if (count > 0) {
+                series.timestamps.push_back(group);
+                series.avg.push_back(sum / count);
+                series.max.push_back(max);
+            }
+        };
+        for (int64_t bucket = first; bucket <= last; bucket++) {
+            const size_t slot = static_cast<size_t>(bucket % static_cast<int64_t>(tier.slots));
+            if (ring.bucket[slot] != bucket || ring.count[slot] == 0) {
+                continue;
+            }
+            const int64_t bucket_group = bucket * resolution / result.step * result.step;
+            if (bucket_group != group) {
+                flush();
+                group = bucket_group;
+                sum = 0;
+                count = 0;
+                max = ring.max[slot];
+            }
+            sum += ring.sum[slot];
+            count += ring.count[slot];
+            max = std::max(max, ring.max[slot]);
+        }
+        flush();
+        result.series.push_back(std::move(series));
+    }
+    return result;
+}
+
+size_t MetricsStore::seriesCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return series_.size();
+}
+
+size_t MetricsStore::memoryBytes()
+{
+    size_t per_series = 0;
+    for (const Tier& tier : tiers_) {
+        per_series += tier.slots * (sizeof(uint32_t) + sizeof(uint16_t) + 2 * sizeof(float));
+    }
+    return per_series * seriesCount();
+}
+
+std::vector<MetricPoint> MetricsStore::exportPoints(int64_t minResolution)
+{
+    std::vector<MetricPoint> points;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t since = exported_until_;
+    exported_until_ = time(nullptr);
+    for (const auto& [key, store] : series_) {
+        for (size_t i = 0; i < tiers_.size(); i++) {
+            const Tier& tier = tiers_[i];
+            if (tier.resolution < minResolution) {
+                continue;
+            }
+            const Ring& ring = store.rings[i];
+            for (size_t slot = 0; slot < tier.slots; slot++) {
+                // a bucket still open at the previous export may have changed since
+                if (ring.count[slot] == 0 || (static_cast<int64_t>(ring.bucket[slot]) + 1) * tier.resolution <= since) {
+                    continue;
+                }
+                points.push_back(MetricPoint{std::get<0>(key), std::get<1>(key), std::get<2>(key), tier.resolution,
+                                             ring.bucket[slot], ring.count[slot], ring.sum[slot], ring.max[slot]});
+            }
+        }
+    }
+    return points;
+}
+
+void MetricsStore::importPoints(const std::vector<MetricPoint>& points)
+{
+    for (const MetricPoint& point : points) {
+        auto tier = std::find_if(tiers_.begin(), tiers_.end(), [&point](const Tier& t) { return t.resolution == point.resolution; });
+        if (tier == tiers_.end() || point.bucket <= 0 || point.count == 0) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        Key key{point.project, point.service, point.metric};
+        auto it = series_.find(key);
+        if (it == series_.end()) {
+            if (series_.size() >= max_series_) {
+                continue;
+            }
+            it = series_.emplace(std::move(key), makeStore()).first;
+        }
+        add(it->second.rings[tier - tiers_.begin()], *tier, static_cast<uint32_t>(point.bucket), point.count, point.sum, point.max);
+    }
+}
+
+void MetricsStore::snapshot()
+{
+    std::vector<MetricPoint> points = exportPoints(SNAPSHOT_MIN_RESOLUTION);
+    std::map<int64_t, int64_t> oldest;
+    const int64_t now = time(nullptr);
+    for (const Tier& tier : tiers_) {
+        if (tier.resolution >= SNAPSHOT_MIN_RESOLUTION) {
+            oldest[tier.resolution] = now / tier.resolution - static_cast<int64_t>(tier.slots);
+        }
+    }
+    if (!database_->saveMetricPoints(points, oldest)) {
+        crow::logger(crow::LogLevel::Warning) << "Failed to save metrics snapshot";
+    }
+}
+
+void MetricsStore::enableSnapshots(std::shared_ptr<MetaDatabase> database, std::chrono::seconds interval)
+{
+    if (!database || interval.count() <= 0 || database_) {
+        return;
+    }
+    importPoints(database->loadMetricPoints());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // what was just restored is in the database already
+        exported_until_ = time(nullptr);
+    }
+    database_ = database;
+    snapshot_interval_ = interval;
+    snapshot_thread_ = std::thread(&MetricsStore::snapshotLoop, this);
+}
+
+void MetricsStore::snapshotLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, snapshot_interval_, [this]() { return stopping_; })) {
+        lock.unlock();
+        snapshot();
+        lock.lock();
+    }
+}
+
+void MetricsStore::registerRestEndpoints(crow::SimpleApp& app)
+{
+    CROW_ROUTE(app, "/api/metrics/query").methods("GET"_method)([this](const crow::request& req)
+    {
+        return handleQuery(req);
+    });
+}
+
+crow::response MetricsStore::handleQuery(const crow::request& req)
+{
+    auto badRequest = [](const std::string& error) {
+        return jsonResponse(400, json11::Json::object{{"success", false}, {"error", error}});
+    };
+
+    const int64_t now = time(nullptr);
+    int64_t to = now;
+    if (const char* value = req.url_params.get("to")) {
+        to = parseLogTimestamp(value);
+        if (to < 0) {
+            return badRequest("invalid to: " + std::string(value));
+        }
+    }
+    int64_t from = to - 3600;
+    if (const char* value = req.url_params.get("from")) {
+        from = parseLogTimestamp(value);
+        if (from < 0) {
+            return badRequest("invalid from: " + std::string(value));
+        }
+    }
+    if (from > to) {
+        return badRequest("from is after to");
+    }
+    size_t points = DEFAULT_POINTS;
+    if (const char* value = req.url_params.get("points")) {
+        char* end = nullptr;
+        long parsed = strtol(value, &end, 10);
+        if (*value == '\0' || *end != '\0' || parsed < 1 || parsed > 10000) {
+            return badRequest("points must be between 1 and 10000");
+        }
+        points = static_cast<size_t>(parsed);
+    }
+
+    const char* project_param = req.url_params.get("project");
+    const char* service_param = req.url_params.get("service");
+    const char* metric_param = req.url_params.get("metric");
+    const std::string project = project_param ? project_param : "";
+    const std::string service = service_param ? service_param : "";
+    const std::string metric = metric_param ? metric_param : "";
+    QueryResult result = query(project_param ? &project : nullptr, service_param ? &service : nullptr,
+                               metric_param ? &metric : nullptr, from, to, points);
+
+    json11::Json::array series;
+    for (const Series& s : result.series) {
+        json11::Json::array timestamps;
+        timestamps.reserve(s.timestamps.size());
+        for (int64_t timestamp : s.timestamps) {
+            timestamps.push_back(static_cast<double>(timestamp));
+        }
+        series.push_back(json11::Json::object{
+            {"project", s.project},
+            {"service", s.service},
+            {"metric", s.metric},
+            {"timestamps", timestamps},
+            {"avg", json11::Json::array(s.avg.begin(), s.avg.end())},
+            {"max", json11::Json::array(s.max.begin(), s.max.end())}});
+    }
+    return jsonResponse(200, json11::Json::object{
+        {"success", true},
+        {"from", static_cast<double>(result.from)},
+        {"to", static_cast<double>(result.to)},
+        {"step", static_cast<double>(result.step)},
+        {"series", series}});
+}
@@ -0,0 +1,152 @@
+#ifndef METRICSSTORE_H
+#define METRICSSTORE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <crow.h>
+#include "types.hpp"
+
+class MetaDatabase;
+
+/**
+ * @brief Fixed-memory history of project metrics, kept at several resolutions.
+ *
+ * A series is keyed by (project, service, metric); project wide values use an empty service. Every
+ * recorded value is added to each tier: a ring of `slots` buckets of `resolution` seconds holding
+ * count, sum and max, stored column by column. A bucket is reused once its slot comes around again,
+ * so each tier keeps resolution * slots of history and a series never grows. At most MAX_SERIES
+ * series are kept, values for further series are dropped.
+ *
+ * GET /api/metrics/query?project=&service=&metric=&from=&to=&points= returns the series matching the
+ * given filters (a missing filter matches all, `service=` selects the project wide series) between
+ * from and to (RFC 3339 or unix seconds, default the last hour). The finest tier still holding `from`
+ * is read and its buckets are merged into at most `points` (default 300) points per series:
+ *
+ *     {"success": true, "from": .., "to": .., "step": 60, "series": [
+ *         {"project": "demo", "service": "web", "metric": "cpu_percent",
+ *          "timestamps": [..], "avg": [..], "max": [..]}]}
+ *
+ * Buckets nothing was recorded in are left out. With snapshots enabled the tiers of a minute or more
+ * are written to the database every interval (only buckets that changed since the last snapshot)
+ * and restored on start.
+ */
+class MetricsStore {
+public:
+    struct Tier {
+        int64_t resolution;     // seconds per bucket
+        size_t slots;
+    };
+
+    struct Series {
+        std::string project;
+        std::string service;
+        std::string metric;
+        std::vector<int64_t> timestamps;
+        std::vector<double> avg;
+        std::vector<double> max;
+    };
+
+    struct QueryResult {
+        int64_t from = 0;
+        int64_t to = 0;
+        int64_t step = 0;
+        std::vector<Series> series;
+    };
+
+    static constexpr size_t MAX_SERIES = 1024;
+    static constexpr size_t DEFAULT_POINTS = 300;
+    static constexpr int64_t SNAPSHOT_MIN_RESOLUTION = 60;
+
+    /**
+     * @brief 5 s for an hour, 1 min for a day, 10 min for a week
+     */
+    static std::vector<Tier> defaultTiers();
+
+    explicit MetricsStore(std::vector<Tier> tiers = defaultTiers(), size_t maxSeries = MAX_SERIES);
+    ~MetricsStore();
+
+    MetricsStore(const MetricsStore&) = delete;
+    MetricsStore& operator=(const MetricsStore&) = delete;
+
+    /**
+     * @return false if the series is new and the store is full
+     */
+    bool record(const std::string& project, const std::string& service, const std::string& metric,
+                int64_t timestamp, double value);
+
+    /**
+     * @brief drops every series of a project
+     */
+    void removeProject(const std::string& project);
+
+    /**
+     * @param project, service, metric filters, nullptr matches all
+     * @param maxPoints points per series at most
+     */
+    QueryResult query(const std::string* project, const std::string* service, const std::string* metric,
+                      int64_t from, int64_t to, size_t maxPoints = DEFAULT_POINTS);
+
+    size_t seriesCount();
+    size_t memoryBytes();
+
+    /**
+     * @brief buckets of tiers with at least minResolution that changed since the previous export
+     */
+    std::vector<MetricPoint> exportPoints(int64_t minResolution);
+
+    /**
+     * @brief restores exported buckets, those of tiers this store does not have are ignored
+     */
+    void importPoints(const std::vector<MetricPoint>& points);
+
+    /**
+     * @brief restores the tiers saved in database, then saves them every interval and on destruction
+     */
+    void enableSnapshots(std::shared_ptr<MetaDatabase> database, std::chrono::seconds interval);
+
+    void registerRestEndpoints(crow::SimpleApp& app);
+
+private:
+    using Key = std::tuple<std::string, std::string, std::string>;
+
+    // one tier of one series, column by column
+    struct Ring {
+        std::vector<uint32_t> bucket;   // timestamp / resolution of the bucket in the slot, 0 if empty
+        std::vector<uint16_t> count;
+        std::vector<float> sum;
+        std::vector<float> max;
+    };
+
+    struct Store {
+        std::vector<Ring> rings;        // one per tier
+    };
+
+    Store makeStore() const;
+    void add(Ring& ring, const Tier& tier, uint32_t bucket, uint32_t count, double sum, double max);
+    void snapshot();
+    void snapshotLoop();
+    crow::response handleQuery(const crow::request& req);
+
+    const std::vector<Tier> tiers_;
+    const size_t max_series_;
+
+    std::mutex mutex_;
+    std::map<Key, Store> series_;
+    int64_t exported_until_ = 0;        // buckets ending before this were exported already
+
+    std::shared_ptr<MetaDatabase> database_;
+    std::chrono::seconds snapshot_interval_{0};
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread snapshot_thread_;
+};
+
+#endif // METRICSSTORE_H
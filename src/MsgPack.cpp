@@ -0,0 +1,206 @@
+#include "MsgPack.h"
+#include <stdexcept>
+
+void MsgPackWriter::bigEndian(uint64_t value, int bytes)
+{
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+        data_ += static_cast<char>((value >> shift) & 0xff);
+    }
+}
+
+void MsgPackWriter::nil()
+{
+    data_ += static_cast<char>(0xc0);
+}
+
+void MsgPackWriter::boolean(bool value)
+{
+    data_ += static_cast<char>(value ? 0xc3 : 0xc2);
+}
+
+void MsgPackWriter::unsignedInteger(uint64_t value)
+{
+    if (value < 0x80) {
+        data_ += static_cast<char>(value);
+    } else if (value <= 0xff) {
+        data_ += static_cast<char>(0xcc);
+        bigEndian(value, 1);
+    } else if (value <= 0xffff) {
+        data_ += static_cast<char>(0xcd);
+        bigEndian(value, 2);
+    } else if (value <= 0xffffffffULL) {
+        data_ += static_cast<char>(0xce);
+        bigEndian(value, 4);
+    } else {
+        data_ += static_cast<char>(0xcf);
+        bigEndian(value, 8);
+    }
+}
+
+void MsgPackWriter::integer(int64_t value)
+{
+    if (value >= 0) {
+        unsignedInteger(static_cast<uint64_t>(value));
+    } else if (value >= -32) {
+        data_ += static_cast<char>(value);
+    } else if (value >= INT8_MIN) {
+        data_ += static_cast<char>(0xd0);
+        bigEndian(static_cast<uint64_t>(value), 1);
+    } else if (value >= INT16_MIN) {
+        data_ += static_cast<char>(0xd1);
+        bigEndian(static_cast<uint64_t>(value), 2);
+    } else if (value >= INT32_MIN) {
+        data_ += static_cast<char>(0xd2);
+        bigEndian(static_cast<uint64_t>(value), 4);
+    } else {
+        data_ += static_cast<char>(0xd3);
+        bigEndian(static_cast<uint64_t>(value), 8);
+    }
+}
+
+void MsgPackWriter::string(const std::string& value)
+{
+    const size_t size = value.size();
+    if (size < 32) {
+        data_ += static_cast<char>(0xa0 | size);
+    } else if (size <= 0xff) {
+        data_ += static_cast<char>(0xd9);
+        bigEndian(size, 1);
+    } else if (size <= 0xffff) {
+        data_ += static_cast<char>(0xda);
+        bigEndian(size, 2);
+    } else {
+        data_ += static_cast<char>(0xdb);
+        bigEndian(size, 4);
+    }
+    data_ += value;
+}
+
+void MsgPackWriter::array(uint32_t size)
+{
+    if (size < 16) {
+        data_ += static_cast<char>(0x90 | size);
+    } else if (size <= 0xffff) {
+        data_ += static_cast<char>(0xdc);
+        bigEndian(size, 2);
+    } else {
+        data_ += static_cast<char>(0xdd);
+        bigEndian(size, 4);
+    }
+}
+
+void MsgPackWriter::map(uint32_t size)
+{
+    if (size < 16) {
+        data_ += static_cast<char>(0x80 | size);
+    } else if (size <= 0xffff) {
+        data_ += static_cast<char>(0xde);
+        bigEndian(size, 2);
+    } else {
+        data_ += static_cast<char>(0xdf);
+        bigEndian(size, 4);
+    }
+}
+
+namespace {
+
+class Decoder {
+public:
+    explicit Decoder(const std::string& data) : data_(data) {}
+
+    json11::Json value()
+    {
+        const uint8_t type = byte();
+        if (type < 0x80) return json11::Json(static_cast<int>(type));
+        if (type >= 0xe0) return json11::Json(static_cast<int>(static_cast<int8_t>(type)));
+        if ((type & 0xf0) == 0x80) return map(type & 0x0f);
+        if ((type & 0xf0) == 0x90) return array(type & 0x0f);
+        if ((type & 0xe0) == 0xa0) return text(type & 0x1f);
+
+        switch (type) {
+            case 0xc0: return json11::Json(nullptr);
+            case 0xc2: return json11::Json(false);
+            case 0xc3: return json11::Json(true);
+            case 0xcc: return number(static_cast<double>(bigEndian(1)));
+            case 0xcd: return number(static_cast<double>(bigEndian(2)));
+            case 0xce: return number(static_cast<double>(bigEndian(4)));
+            case 0xcf: return number(static_cast<double>(bigEndian(8)));
+            case 0xd0: return number(static_cast<double>(static_cast<int8_t>(bigEndian(1))));
+            case 0xd1: return number(static_cast<double>(static_cast<int16_t>(bigEndian(2))));
+            case 0xd2: return number(static_cast<double>(static_cast<int32_t>(bigEndian(4))));
+            case 0xd3: return number(static_cast<double>(static_cast<int64_t>(bigEndian(8))));
+            case 0xd9: return text(bigEndian(1));
+            case 0xda: return text(bigEndian(2));
+            case 0xdb: return text(bigEndian(4));
+            case 0xdc: return array(bigEndian(2));
+            case 0xdd: return array(bigEndian(4));
+            case 0xde: return map(bigEndian(2));
+            case 0xdf: return map(bigEndian(4));
+        }
+        throw std::runtime_error("unsupported MessagePack type " + std::to_string(type));
+    }
+
+private:
+    uint8_t byte()
+    {
+        if (pos_ >= data_.size()) {
+            throw std::runtime_error("truncated MessagePack data");
+        }
+        return static_cast<uint8_t>(data_[pos_++]);
+    }
+
+    uint64_t bigEndian(int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) {
+            value = (value << 8) | byte();
+        }
+        return value;
+    }
+
+    static json11::Json number(double value) { return json11::Json(value); }
+
+    json11::Json text(uint64_t size)
+    {
+        if (data_.size() - pos_ < size) {
+            throw std::runtime_error("truncated MessagePack string");
+        }
+        std::string value = data_.substr(pos_, size);
+        pos_ += size;
+        return json11::Json(value);
+    }
+
+    json11::Json array(uint64_t size)
+    {
+        json11::Json::array items;
+        for (uint64_t i = 0; i < size; i++) {
+            items.push_back(value());
+        }
+        return json11::Json(items);
+    }
+
+    json11::Json map(uint64_t size)
+    {
+        json11::Json::object items;
+        for (uint64_t i = 0; i < size; i++) {
+            json11::Json key = value();
+            items[key.is_string() ? key.string_value() : key.dump()] = value();
+        }
+        return json11::Json(items);
+    }
+
+    const std::string& data_;
+    size_t pos_ = 0;
+};
+
+} // namespace
+
+json11::Json MsgPackReader::decode(const std::string& data, std::string& error)
+{
+    try {
+        return Decoder(data).value();
+    } catch (const std::exception& e) {
+        error = e.what();
+        return json11::Json();
+    }
+}
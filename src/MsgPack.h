@@ -0,0 +1,52 @@
+#ifndef MSGPACK_H
+#define MSGPACK_H
+
+#include <cstdint>
+#include <string>
+#include "json11.hpp"
+
+/**
+ * @brief Minimal MessagePack encoder for the binary WebSocket streams.
+ *
+ * Only the types the streams use are supported: nil, bool, integers, strings, arrays and maps.
+ * Every value is written in its smallest encoding.
+ */
+class MsgPackWriter {
+public:
+    void nil();
+    void boolean(bool value);
+    void integer(int64_t value);
+    void string(const std::string& value);
+    void array(uint32_t size);
+    void map(uint32_t size);
+
+    /**
+     * @brief appends already encoded MessagePack values
+     */
+    void raw(const std::string& encoded) { data_ += encoded; }
+
+    const std::string& data() const { return data_; }
+    size_t size() const { return data_.size(); }
+    bool empty() const { return data_.empty(); }
+    void clear() { data_.clear(); }
+
+private:
+    void unsignedInteger(uint64_t value);
+    void bigEndian(uint64_t value, int bytes);
+
+    std::string data_;
+};
+
+/**
+ * @brief Decodes MessagePack produced by MsgPackWriter into json11 values, for tests and debugging.
+ */
+class MsgPackReader {
+public:
+    /**
+     * @brief decodes the first value in data
+     * @param error set if data is truncated or uses an unsupported type
+     */
+    static json11::Json decode(const std::string& data, std::string& error);
+};
+
+#endif // MSGPACK_H
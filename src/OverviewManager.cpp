@@ -0,0 +1,117 @@
+#include "OverviewManager.h"
+#include "InProcessRequest.h"
+#include "json11.hpp"
+#include <future>
+
+namespace {
+
+// overview requests in flight at once, each queueing one task per section
+constexpr size_t MAX_QUEUED_SECTIONS = 64;
+
+long long millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+OverviewManager::OverviewManager(crow::SimpleApp& app, size_t workers)
+    : app_(app)
+    , executor_("overview", workers, MAX_QUEUED_SECTIONS)
+{
+}
+
+void OverviewManager::addSection(const std::string& name, const std::string& path, std::chrono::milliseconds timeout)
+{
+    sections_.push_back({name, path, timeout});
+}
+
+void OverviewManager::setBlockingExecutor(std::shared_ptr<BlockingExecutor> blocking)
+{
+    blocking_ = blocking;
+}
+
+void OverviewManager::respondBlocking(const crow::request& req, crow::response& res, std::function<crow::response()> render)
+{
+    if (blocking_) {
+        blocking_->respond(req, res, std::move(render));
+        return;
+    }
+    res = render();
+    res.end();
+}
+
+void OverviewManager::registerRestEndpoints(crow::SimpleApp& app)
+{
+    CROW_ROUTE(app, "/api/overview").methods("GET"_method)
+    ([this](const crow::request& req, crow::response& res) {
+        respondBlocking(req, res, [this]() {
+            return handleGetOverview();
+        });
+    });
+}
+
+crow::response OverviewManager::handleGetOverview()
+{
+    const auto started = std::chrono::steady_clock::now();
+
+    std::vector<std::future<InProcessResponse>> futures;
+    std::vector<std::string> submit_errors(sections_.size());
+    for (size_t i = 0; i < sections_.size(); i++) {
+        const std::string path = sections_[i].path;
+        try {
+            futures.push_back(executor_.submit([this, path]() {
+                return dispatchInProcess(app_, crow::HTTPMethod::Get, path);
+            }));
+        } catch (const std::exception& e) {
+            futures.emplace_back();
+            submit_errors[i] = e.what();
+        }
+    }
+
+    json11::Json::object sections;
+    bool complete = true;
+    for (size_t i = 0; i < sections_.size(); i++) {
+        const Section& section = sections_[i];
+        json11::Json::object entry;
+
+        if (!submit_errors[i].empty()) {
+            entry = {{"ok", false}, {"timed_out", false}, {"elapsed_ms", 0}, {"error", submit_errors[i]}};
+            complete = false;
+        } else if (futures[i].wait_until(started + section.timeout) != std::future_status::ready) {
+            // left running on the executor, its result is dropped
+            entry = {{"ok", false},
+                     {"timed_out", true},
+                     {"elapsed_ms", static_cast<double>(millisecondsSince(started))},
+                     {"error", "timed out after " + std::to_string(section.timeout.count()) + " ms"}};
+            complete = false;
+        } else {
+            try {
+                InProcessResponse result = futures[i].get();
+                std::string parse_error;
+                json11::Json data = json11::Json::parse(result.body, parse_error);
+                entry = {{"ok", result.code >= 200 && result.code < 300},
+                         {"timed_out", false},
+                         {"status", result.code},
+                         {"elapsed_ms", static_cast<double>(result.elapsed_ms)},
+                         {"data", parse_error.empty() ? data : json11::Json(result.body)}};
+                complete = complete && result.code >= 200 && result.code < 300;
+            } catch (const std::exception& e) {
+                entry = {{"ok", false}, {"timed_out", false}, {"elapsed_ms", static_cast<double>(millisecondsSince(started))}, {"error", std::string(e.what())}};
+                complete = false;
+            }
+        }
+        entry["path"] = section.path;
+        sections[section.name] = entry;
+    }
+
+    json11::Json response = json11::Json::object{
+        {"success", true},
+        {"complete", complete},
+        {"elapsed_ms", static_cast<double>(millisecondsSince(started))},
+        {"sections", sections}};
+
+    crow::response res(200, response.dump());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
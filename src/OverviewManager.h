@@ -0,0 +1,55 @@
+#ifndef OVERVIEWMANAGER_H
+#define OVERVIEWMANAGER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <crow.h>
+#include "BlockingExecutor.h"
+#include "TaskExecutor.h"
+
+/**
+ * @brief Serves GET /api/overview: the dashboard's separate status requests gathered in one payload.
+ *
+ * Every section is an existing GET endpoint of the app. The sections are dispatched through the
+ * app's router concurrently on a bounded executor, so the overview always returns exactly what the
+ * individual endpoints return. A section that does not answer within its timeout is reported as
+ * timed out while the others are still returned. Waiting for the sections happens on the blocking
+ * executor, never on one of crow's io threads.
+ */
+class OverviewManager {
+public:
+    explicit OverviewManager(crow::SimpleApp& app, size_t workers = 4);
+
+    /**
+     * @brief adds a section to the overview
+     * @param name key of the section in the response
+     * @param path GET endpoint providing the section, may include a query string
+     * @param timeout time the section may take before it is reported as timed out
+     */
+    void addSection(const std::string& name, const std::string& path,
+                    std::chrono::milliseconds timeout = std::chrono::milliseconds(3000));
+
+    void registerRestEndpoints(crow::SimpleApp& app);
+
+    // Threads the overview waits for its sections on instead of crow's io threads (see BlockingExecutor)
+    void setBlockingExecutor(std::shared_ptr<BlockingExecutor> blocking);
+
+private:
+    struct Section {
+        std::string name;
+        std::string path;
+        std::chrono::milliseconds timeout;
+    };
+
+    crow::response handleGetOverview();
+    void respondBlocking(const crow::request& req, crow::response& res, std::function<crow::response()> render);
+
+    crow::SimpleApp& app_;
+    TaskExecutor executor_;
+    std::shared_ptr<BlockingExecutor> blocking_;
+    std::vector<Section> sections_;
+};
+
+#endif // OVERVIEWMANAGER_H
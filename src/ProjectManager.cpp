@@ -2,6 +2,9 @@
 #include "utils.h"
 #include "ProcessManager.h"
 #include "json11.hpp"
+#include "JsonLines.h"
+#include "JsonWriter.h"
+#include "ImageArchive.h"
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -11,15 +14,84 @@
 #include <algorithm>
 #include <random>
 #include <tuple>
+#include <set>
 #include "node.hpp"
 #include <iostream>
 #include "sqlite3.h"
 #include "dotenv.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
+namespace {
+
+// archive entries are written below the project directory, never next to it
+bool isInsideProject(const std::string &path)
+{
+    const fs::path relative(path);
+    if (path.empty() || relative.is_absolute())
+    {
+        return false;
+    }
+    return std::none_of(relative.begin(), relative.end(), [](const fs::path &part) { return part == ".."; });
+}
+
+#ifndef RENAME_EXCHANGE
+#define RENAME_EXCHANGE (1 << 1)
+#endif
+
+// swaps two directories of the same filesystem in one step, in two renames where the filesystem cannot
+bool exchangeDirectories(const std::string &first, const std::string &second, std::string &error)
+{
+#ifdef SYS_renameat2
+    if (::syscall(SYS_renameat2, AT_FDCWD, first.c_str(), AT_FDCWD, second.c_str(), RENAME_EXCHANGE) == 0)
+    {
+        return true;
+    }
+    if (errno != ENOSYS && errno != EINVAL && errno != EOPNOTSUPP)
+    {
+        error = std::strerror(errno);
+        return false;
+    }
+#endif
+    const std::string parked = second + ".exchange";
+    std::error_code ec;
+    fs::rename(second, parked, ec);
+    if (!ec)
+    {
+        fs::rename(first, second, ec);
+        if (ec)
+        {
+            std::error_code ignored;
+            fs::rename(parked, second, ignored);
+        }
+        else
+        {
+            fs::rename(parked, first, ec);
+        }
+    }
+    if (ec)
+    {
+        error = ec.message();
+    }
+    return !ec;
+}
+
+long long millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
 ProjectManager::ProjectManager()
     : process_manager_(std::make_unique<ProcessManager>())
+    , image_index_(std::make_shared<ImageIndex>())
+    , projects_version_("projects", [this]() { return projectsFingerprint(); })
 {
 
     // Set default projects directory
@@ -37,8 +109,17 @@ ProjectManager::ProjectManager()
         broadcastLog("ProjectManager", "Failed to initialize database", "error");
     } else {
         // Load projects from database
-        projects_ = database_->loadProjectsFromDatabase();
-        broadcastLog("ProjectManager", "Loaded " + std::to_string(projects_.size()) + " projects from database", "info");
+        auto loaded = database_->loadProjectsFromDatabase();
+        const size_t count = loaded.size();
+        {
+            std::unique_lock<std::shared_mutex> lock(projects_mutex_);
+            projects_ = std::move(loaded);
+        }
+        for (const auto &[name, model] : database_->loadComposeModels())
+        {
+            compose_models_.put(name, model);
+        }
+        broadcastLog("ProjectManager", "Loaded " + std::to_string(count) + " projects from database", "info");
     }
 
     broadcastLog("ProjectManager", "ProjectManager initialized", "info");
@@ -52,13 +133,13 @@ ProjectManager::ProjectManager()
 ProjectManager::~ProjectManager()
 {
     // Clean up any running projects
-    for (const auto &pair : projects_)
-    {
-        // if (pair.second.is_running)
-        // {
-        //     stopProject(pair.first);
-        // }
-    }
+    // for (const auto &pair : projectsSnapshot())
+    // {
+    //     if (pair.second.is_running)
+    //     {
+    //         stopProject(pair.first);
+    //     }
+    // }
     broadcastLog("ProjectManager", "ProjectManager destroyed", "info");
 }
 
@@ -83,18 +164,35 @@ std::string ProjectManager::executeCommandWithOutput(const std::string& command,
     return "";
 }
 
-bool ProjectManager::loadImageFromFile(const std::string& filePath) {
+bool ProjectManager::loadImageFromFile(const std::string& filePath, std::vector<std::string>* loadedImages) {
     try {
         if (!fs::exists(filePath)) {
             return false;
         }
         
-        auto [pid, ret_code] = process_manager_->startProcessBlocking(
-            "docker", 
-            {"load", "-i", filePath}, 
-            {}, 
-            nullptr
-        );
+        std::string output;
+        int ret_code = 0;
+        if (ImageArchive::compressionOf(filePath) != ImageArchive::Compression::None) {
+            // decoded on the way into the daemon, without an uncompressed copy on disk
+            ret_code = ImageArchive::load(filePath, output);
+        } else {
+            ret_code = std::get<1>(process_manager_->startProcessBlocking(
+                "docker", 
+                {"load", "-i", filePath}, 
+                {}, 
+                [&output](const std::string& data) {
+                    output += data;
+                }
+            ));
+        }
+        if (ret_code == 0) {
+            image_index_->addFromLoadOutput(output);
+            // the listing needs docker's id, size and date, refreshed on the next query
+            image_index_->invalidate();
+            if (loadedImages) {
+                *loadedImages = ImageIndex::loadedImages(output);
+            }
+        }
         return ret_code == 0;
     } catch (const std::exception& e) {
         return false;
@@ -167,15 +265,15 @@ bool ProjectManager::loadImageFromFile(const std::string& filePath) {
 //     }
 // }
 
-std::tuple<bool, std::string> ProjectManager::composeUp(const std::string& projectName) {
+std::tuple<bool, std::string> ProjectManager::composeUp(const std::string& projectName, const std::vector<std::string>& extraArgs) {
     try {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end()) {
+        ProjectInfo project;
+        if (!findProject(projectName, project)) {
             return {false, "Project not found: " + projectName};
         }
         
-        const auto& project = it->second;
         std::vector<std::string> args = {"compose", "-f", project.compose_file_path, "-p", projectName, "up", "-d"};
+        args.insert(args.end(), extraArgs.begin(), extraArgs.end());
         
         std::string _out;
         auto [pid, ret_code] = process_manager_->startProcessBlocking(
@@ -200,12 +298,11 @@ std::tuple<bool, std::string> ProjectManager::composeUp(const std::string& proje
 
 std::tuple<bool, std::string> ProjectManager::composeDown(const std::string& projectName, bool removeVolumes) {
     try {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end()) {
+        ProjectInfo project;
+        if (!findProject(projectName, project)) {
             return {false, "Project not found: " + projectName};
         }
         
-        const auto& project = it->second;
         std::vector<std::string> args = {"compose", "-f", project.compose_file_path, "-p", projectName, "down"};
         if (removeVolumes) {
             args.push_back("-v");
@@ -233,12 +330,11 @@ std::tuple<bool, std::string> ProjectManager::composeDown(const std::string& pro
 
 std::tuple<bool, std::string> ProjectManager::composeRestart(const std::string& projectName) {
     try {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end()) {
+        ProjectInfo project;
+        if (!findProject(projectName, project)) {
             return {false, "Project not found: " + projectName};
         }
         
-        const auto& project = it->second;
         std::string _out;
         auto [pid, ret_code] = process_manager_->startProcessBlocking(
             "docker", 
@@ -261,12 +357,11 @@ std::tuple<bool, std::string> ProjectManager::composeRestart(const std::string&
 
 std::tuple<bool, std::string> ProjectManager::composeSatus(const std::string& projectName) {
     try {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end()) {
+        ProjectInfo project;
+        if (!findProject(projectName, project)) {
             return {false, "Project not found: " + projectName};
         }
         
-        const auto& project = it->second;
         std::string output;
         auto [pid, ret_code] = process_manager_->startProcessBlocking(
             "docker", 
@@ -282,24 +377,19 @@ std::tuple<bool, std::string> ProjectManager::composeSatus(const std::string& pr
             return {false, "Failed to get project status: " + output};
         }
         
-        // Parse JSON output line by line
-        std::istringstream iss(output);
-        std::string line;
+        // Scan JSON output line by line, only the state is needed
+        JsonLineScanner scanner(output);
+        JsonField state_field;
         bool allRunning = true;
         int serviceCount = 0;
         
-        while (std::getline(iss, line)) {
-            if (line.empty()) continue;
-            
+        while (scanner.next()) {
             serviceCount++;
-            std::string parseError;
-            json11::Json service = json11::Json::parse(line, parseError);
-            
-            if (!parseError.empty()) {
-                return {false, "Failed to parse JSON output: " + parseError};
+            if (!scanner.fields({"State"}, &state_field)) {
+                return {false, "Failed to parse JSON output: " + std::string(scanner.line())};
             }
             
-            std::string state = Utils::str_to_lower(service["State"].string_value());
+            std::string state = Utils::str_to_lower(state_field.str());
             if (state != "running") {
                 allRunning = false;
                 break;
@@ -324,9 +414,15 @@ std::tuple<bool, std::string> ProjectManager::composeSatus(const std::string& pr
 
 std::tuple<bool, std::string, std::vector<std::string>> ProjectManager::composeServices(const std::string& projectName) {
     try {
-        auto it = projects_.find(projectName);
-        if (it != projects_.end()) {
-            return {true, "Successfully retrieved services", it->second.services};
+        ProjectInfo project;
+        if (findProject(projectName, project)) {
+            // The compose file may have been edited on disk: the services come from the cached
+            // model, which is rebuilt when the file changes, and the project entry is left as loaded
+            auto model = getComposeModel(projectName);
+            if (model->valid) {
+                return {true, "Successfully retrieved services", model->serviceNames()};
+            }
+            return {true, "Successfully retrieved services", project.services};
         }
         return {false, "Project not found: " + projectName, {}};
     } catch (const std::exception& e) {
@@ -334,23 +430,6 @@ std::tuple<bool, std::string, std::vector<std::string>> ProjectManager::composeS
     }
 }
 
-std::vector<std::string> ProjectManager::listImages() {
-    std::vector<std::string> images;
-    try {
-        std::string output = executeCommandWithOutput("docker", {"images", "--format", "json"});
-        std::istringstream iss(output);
-        std::string line;
-        while (std::getline(iss, line)) {
-            if (!line.empty() && line.find_first_of("{") != std::string::npos) {
-                images.push_back(line);
-            }
-        }
-    } catch (const std::exception& e) {
-        // Return empty vector on error
-    }
-    return images;
-}
-
 bool ProjectManager::extract7zArchive(const std::string &archivePath, const std::string &extractPath,
                                       const std::string &password)
 {
@@ -405,7 +484,7 @@ bool ProjectManager::extract7zArchive(const std::string &archivePath, const std:
 }
 
 bool ProjectManager::create7zArchive(const std::string &sourcePath, const std::string &archivePath,
-                                     const std::string &password)
+                                     const std::string &password, int level)
 {
     try
     {
@@ -416,7 +495,7 @@ bool ProjectManager::create7zArchive(const std::string &sourcePath, const std::s
             "a", // add to archive
             archivePath,
             sourcePath + "/*",
-            "-mx=9" // maximum compression
+            "-mx=" + std::to_string(level) // 9 = maximum compression, 0 = store
         };
 
         if (!password.empty())
@@ -552,7 +631,175 @@ std::vector<std::string> ProjectManager::list7zContents(const std::string &archi
     return contents;
 }
 
-ProjectArchiveInfo ProjectManager::analyzeArchive(const std::string &archivePath, const std::string &password)
+std::string ProjectManager::read7zFile(const std::string &archivePath, const std::string &password, const std::string &file, bool *ok)
+{
+    std::string content;
+    std::string sevenZipPath = Utils::get_7z_executable_path();
+    ProcessManager pm;
+    // -so writes the entry to stdout; progress, messages and errors are silenced so nothing else mixes in
+    std::vector<std::string> args = {"e", "-so", "-bso0", "-bsp0", "-bse0", archivePath, file};
+    if (!password.empty())
+    {
+        args.push_back("-p" + password);
+    }
+    auto result = pm.startProcessBlocking(
+        sevenZipPath,
+        args,
+        {},
+        [&content](const std::string &data)
+        {
+            content += data;
+        });
+    if (ok)
+    {
+        *ok = std::get<1>(result) == 0;
+    }
+    return content;
+}
+
+std::string ProjectManager::hash7zFile(const std::string &archivePath, const std::string &password, const std::string &file)
+{
+    ContentStore::Sha256 hash;
+    std::string sevenZipPath = Utils::get_7z_executable_path();
+    ProcessManager pm;
+    std::vector<std::string> args = {"e", "-so", "-bso0", "-bsp0", "-bse0", archivePath, file};
+    if (!password.empty())
+    {
+        args.push_back("-p" + password);
+    }
+    auto result = pm.startProcessBlocking(
+        sevenZipPath,
+        args,
+        {},
+        [&hash](const std::string &data)
+        {
+            hash.update(data.data(), data.size());
+        });
+    if (std::get<1>(result) != 0)
+    {
+        return "";
+    }
+    return hash.hex();
+}
+
+ArchiveManifest ProjectManager::list7zManifest(const std::string &archivePath, const std::string &password, bool *ok)
+{
+    if (ok)
+    {
+        *ok = false;
+    }
+    try
+    {
+        std::string sevenZipPath = Utils::get_7z_executable_path();
+
+        ProcessManager pm;
+        std::vector<std::string> args = {
+            "l",    // list contents
+            "-slt", // one "Key = Value" block per entry, with size and CRC
+            archivePath};
+
+        if (!password.empty())
+        {
+            args.push_back("-p" + password);
+        }
+
+        std::string output;
+        auto result = pm.startProcessBlocking(
+            sevenZipPath,
+            args,
+            {},
+            [&output](const std::string &data)
+            {
+                output += data;
+            });
+
+        if (std::get<1>(result) != 0)
+        {
+            broadcastLog("list7zManifest", "Failed to list archive: " + output, "error");
+            return {};
+        }
+        if (ok)
+        {
+            *ok = true;
+        }
+        return ArchiveManifest::parseSltListing(output);
+    }
+    catch (const std::exception &e)
+    {
+        broadcastLog("list7zManifest", "Exception: " + std::string(e.what()), "error");
+        return {};
+    }
+}
+
+bool ProjectManager::extract7zFiles(const std::string &archivePath, const std::string &extractPath,
+                                    const std::string &password, const std::vector<std::string> &files)
+{
+    if (files.empty())
+    {
+        return true;
+    }
+    // names go through a list file: there may be more than a command line holds
+    const std::string listFile = extractPath + ".list";
+    try
+    {
+        std::string sevenZipPath = Utils::get_7z_executable_path();
+        std::filesystem::create_directories(extractPath);
+        {
+            std::ofstream list(listFile, std::ios::trunc);
+            for (const auto &file : files)
+            {
+                list << file << "\n";
+            }
+            if (!list)
+            {
+                broadcastLog("extract7zFiles", "Failed to write list file: " + listFile, "error");
+                return false;
+            }
+        }
+
+        ProcessManager pm;
+        std::vector<std::string> args = {
+            "-o" + extractPath,
+            "-y",         // assume yes to all queries
+            "-spd",       // names are literal, not wildcards
+            "-scsUTF-8"   // charset of the list file
+        };
+        if (!password.empty())
+        {
+            args.push_back("-p" + password);
+        }
+        args.push_back("x");
+        args.push_back(archivePath);
+        args.push_back("@" + listFile);
+
+        std::string output;
+        auto result = pm.startProcessBlocking(
+            sevenZipPath,
+            args,
+            {},
+            [&output](const std::string &data)
+            {
+                output += data;
+            });
+        std::filesystem::remove(listFile);
+
+        if (std::get<1>(result) != 0)
+        {
+            broadcastLog("extract7zFiles", "Failed to extract from archive: " + output, "error");
+            return false;
+        }
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::error_code ec;
+        std::filesystem::remove(listFile, ec);
+        broadcastLog("extract7zFiles", "Exception: " + std::string(e.what()), "error");
+        return false;
+    }
+}
+
+ProjectArchiveInfo ProjectManager::analyzeArchive(const std::string &archivePath, const std::string &password, bool verify)
 {
     ProjectArchiveInfo info;
     info.archive_path = archivePath;
@@ -566,41 +813,93 @@ ProjectArchiveInfo ProjectManager::analyzeArchive(const std::string &archivePath
             return info;
         }
 
-        // Test archive integrity
-        info.integrity_verified = test7zArchive(archivePath, password);
-        if (!info.integrity_verified)
+        if (verify)
         {
-            info.error_message = "Archive integrity check failed or wrong password";
-            return info;
+            // Test archive integrity
+            info.integrity_verified = test7zArchive(archivePath, password);
+            if (!info.integrity_verified)
+            {
+                info.error_message = "Archive integrity check failed or wrong password";
+                return info;
+            }
         }
 
-        // List contents
-        info.contained_files = list7zContents(archivePath, password);
-
-        info.is_encrypted = !test7zArchive(archivePath, "");
+        // List contents; the technical listing flags every encrypted entry, so telling an encrypted
+        // archive apart needs no second pass over it
+        const ArchiveManifest manifest = list7zManifest(archivePath, password);
+        for (const auto &[path, entry] : manifest.entries)
+        {
+            info.contained_files.push_back(path);
+            info.is_encrypted = info.is_encrypted || entry.encrypted;
+        }
+        if (!verify && info.contained_files.empty())
+        {
+            info.error_message = "Archive cannot be listed or wrong password";
+            return info;
+        }
 
         // Look for docker-compose.yml
-        bool hasComposeFile = false;
+        bool hasEnvFile = false;
         for (const auto &file : info.contained_files)
         {
-            if (file == "docker-compose.yml" || file == "docker-compose.yaml")
+            if (info.compose_file.empty() && (file == "docker-compose.yml" || file == "docker-compose.yaml"))
             {
-                hasComposeFile = true;
-                break;
+                info.compose_file = file;
             }
-            // Look for Docker image tar files - C++17 compatible check
-            if (file.length() >= 4 && file.substr(file.length() - 4) == ".tar")
+            hasEnvFile = hasEnvFile || file == ".env";
+            // Look for Docker image tar files, plain or compressed
+            if (ImageArchive::isImage(file))
             {
                 info.docker_images.push_back(file);
-            } /*  else if (file.length() >= 7 && file.substr(file.length() - 7) == ".tar.gz") {
-                 info.docker_images.push_back(file);
-             } */
+            }
         }
 
-        if (!hasComposeFile)
+        if (info.compose_file.empty())
         {
             info.error_message = "No docker-compose.yml file found in archive";
         }
+        else
+        {
+            // Only the compose file and .env are decompressed, to memory
+            bool read = false;
+            info.compose_file_content = read7zFile(archivePath, password, info.compose_file, &read);
+            std::map<std::string, std::string> variables;
+            if (read && hasEnvFile)
+            {
+                bool envRead = false;
+                const std::string envContent = read7zFile(archivePath, password, ".env", &envRead);
+                if (envRead)
+                {
+                    variables = ComposeModel::parseDotEnv(envContent);
+                }
+            }
+
+            std::vector<std::string> images;
+            const ComposeModel model = ComposeModel::parse(ComposeModel::interpolate(info.compose_file_content, variables), info.compose_file);
+            if (!read)
+            {
+                info.compose_error = "Cannot read " + info.compose_file + " from archive (wrong password?)";
+            }
+            else if (!std::get<0>(validateDockerComposeFile(model, images)))
+            {
+                info.compose_error = model.valid ? "Every service needs an image" : model.error;
+            }
+            if (read && model.valid)
+            {
+                info.missing_images = image_index_->missing(model.images());
+                for (const auto &service : model.services)
+                {
+                    ProjectArchiveService preview;
+                    preview.name = service.name;
+                    preview.image = service.image;
+                    preview.image_present = !service.image.empty()
+                        && std::find(info.missing_images.begin(), info.missing_images.end(), service.image) == info.missing_images.end();
+                    preview.ports = service.ports;
+                    preview.depends_on = service.depends_on;
+                    info.services.push_back(preview);
+                }
+            }
+        }
 
         broadcastLog("analyzeArchive", "Archive analyzed: " + archivePath + " (files: " + std::to_string(info.contained_files.size()) + ", images: " + std::to_string(info.docker_images.size()) + ")", "info");
     }
@@ -716,165 +1015,65 @@ bool ProjectManager::extractArchive(const std::string &archivePath, const std::s
 //     return images;
 // }
 
-std::vector<std::string> ProjectManager::parseDockerComposeDependentFiles(const std::string &composeContent, const std::string &basePath)
+std::shared_ptr<const ComposeModel> ProjectManager::getComposeModel(const std::string &projectName, const std::string &composeFilePath)
 {
-    std::vector<std::string> files;
-
-    try
+    std::string path = composeFilePath;
+    if (path.empty())
     {
-        auto root = fkyaml::node::deserialize(composeContent);
-
-        // Check services section
-        if (root.contains("services"))
+        ProjectInfo project;
+        if (findProject(projectName, project))
         {
-            auto services = root.at("services");
-            for (const auto &[service_name, service_config] : services.as_map())
-            {
-                // Check build context
-                if (service_config.contains("build"))
-                {
-                    if (service_config.at("build").is_string())
-                    {
-                        files.push_back(service_config.at("build").as_str());
-                    }
-                    else if (service_config.at("build").is_mapping())
-                    {
-                        auto build = service_config.at("build");
-                        if (build.contains("context"))
-                        {
-                            files.push_back(build.at("context").as_str());
-                        }
-                        if (build.contains("dockerfile"))
-                        {
-                            files.push_back(build.at("dockerfile").as_str());
-                        }
-                    }
-                }
-
-                // Check env_file
-                if (service_config.contains("env_file"))
-                {
-                    if (service_config.at("env_file").is_string())
-                    {
-                        files.push_back(service_config.at("env_file").as_str());
-                    }
-                    else if (service_config.at("env_file").is_sequence())
-                    {
-                        for (const auto &env_file : service_config.at("env_file").as_seq())
-                        {
-                            files.push_back(env_file.as_str());
-                        }
-                    }
-                }
-
-                // Check volumes
-                if (service_config.contains("volumes"))
-                {
-                    for (const auto &volume : service_config.at("volumes").as_seq())
-                    {
-                        if (volume.is_string())
-                        {
-                            std::string vol = volume.as_str();
-                            size_t colonPos = vol.find(':');
-                            if (colonPos != std::string::npos)
-                            {
-                                std::string hostPath = vol.substr(0, colonPos);
-                                if (!hostPath.empty() && hostPath[0] != '/' && hostPath[0] != '$')
-                                {
-                                    files.push_back(hostPath);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+            path = project.compose_file_path;
         }
     }
-    catch (const std::exception &e)
+
+    bool changed = false;
+    auto model = compose_models_.get(projectName, path, &changed);
+    if (changed && model->valid && hasProject(projectName))
     {
-        broadcastLog("parseDockerComposeDependentFiles", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("getComposeModel", "Compose file of '" + projectName + "' changed, model rebuilt (" + model->content_hash + ")", "info", projectName);
+        if (!database_->saveComposeModel(projectName, *model))
+        {
+            broadcastLog("getComposeModel", "Warning: Failed to save compose model to database", "warning", projectName);
+        }
     }
-
-    return files;
+    return model;
 }
 
-std::tuple<bool, std::vector<std::string>> ProjectManager::validateDockerComposeFile(const std::string &composeFilePath, std::vector<std::string> &_list_images)
+std::tuple<bool, std::vector<std::string>> ProjectManager::validateDockerComposeFile(const ComposeModel &composeModel, std::vector<std::string> &_list_images)
 {
     std::vector<std::string> _list_services;
-    try
+    if (!composeModel.valid)
     {
-        if (!std::filesystem::exists(composeFilePath))
-        {
-            return {false, _list_services};
-        }
+        broadcastLog("validateDockerComposeFile", composeModel.error + " in " + composeModel.file_path, "error");
+        return {false, _list_services};
+    }
 
-        std::ifstream file(composeFilePath);
-        if (!file.is_open())
-        {
-            return {false, _list_services};
-        }
+    std::string _str_services;
+    std::string _str_images;
+    for (const auto &_service : composeModel.services)
+    {
+        _list_services.push_back(_service.name);
+        _str_services += _service.name;
+        _str_services += ",";
 
-        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-        file.close();
-        auto _node = fkyaml::node::deserialize(content);
-        // auto _contain_services = _node.contains("services");
-        auto _node_services = _node["services"];
-        // auto _is_null_dummy = _dummy.is_null();
-        if (!_node_services.is_mapping())
-        {
-            // auto _type = _service.get_type();
-            return {false, _list_services};
-        }
-        auto _services = _node_services.as_map();
-        if (_services.size() < 1)
+        if (_service.image.empty())
         {
-            broadcastLog("validateDockerComposeFile", "no service found in docker file", "error");
+            broadcastLog("validateDockerComposeFile", "invalid node type image in " + composeModel.file_path, "error");
             return {false, _list_services};
         }
-        std::string _str_services;
-        std::string _str_images;
-        for (const auto &_service : _services)
-        {
-            // first is the service name and second is the node
-            if(fkyaml::node_type::STRING != _service.first.get_type())
-            {
-                broadcastLog("validateDockerComposeFile", "invalid node type service in " + composeFilePath, "error");
-                return {false, _list_services};
-            }
-            _list_services.push_back(_service.first.as_str());
-            _str_services += _service.first.as_str();
-            _str_services += ",";
-
-            auto _node_image = _service.second["image"];
-            if (!_node_image.is_string())
-            {
-                broadcastLog("validateDockerComposeFile", "invalid node type image in " + composeFilePath, "error");
-                return {false, _list_services};
-            }
-            auto _str_image = _node_image.as_str();
-            if (_str_image.empty())
-            {
-                broadcastLog("validateDockerComposeFile", "invalid node type image name in " + composeFilePath, "error");
-                return {false, _list_services};
-            }
-            _list_images.push_back(_str_image);
-            _str_images += _str_image;
-            _str_images += ",";
-        }
-        _str_services.pop_back();
-        _str_images.pop_back();
-        broadcastLog("validateDockerComposeFile", "list docker-compose service = '" + _str_services + "'", "info");
-        broadcastLog("validateDockerComposeFile", "list images = '" + _str_images + "'", "info");
-
-        // Basic validation - check for required fields
-        bool _ret = (_services.size() > 0 && _list_images.size() > 0);
-        return {_ret, _list_services};
-    }
-    catch (const std::exception &e)
-    {
-        broadcastLog("validateDockerComposeFile", "Exception: " + std::string(e.what()), "error");
-        return {false, _list_services};
+        _list_images.push_back(_service.image);
+        _str_images += _service.image;
+        _str_images += ",";
     }
+    _str_services.pop_back();
+    _str_images.pop_back();
+    broadcastLog("validateDockerComposeFile", "list docker-compose service = '" + _str_services + "'", "info");
+    broadcastLog("validateDockerComposeFile", "list images = '" + _str_images + "'", "info");
+
+    // Basic validation - check for required fields
+    bool _ret = (_list_services.size() > 0 && _list_images.size() > 0);
+    return {_ret, _list_services};
 }
 
 std::vector<std::string> ProjectManager::findDockerImageFiles(const std::string &projectPath)
@@ -890,13 +1089,11 @@ std::vector<std::string> ProjectManager::findDockerImageFiles(const std::string
                 continue;
             }
             std::string filename = entry.path().filename().string();
-            // Check for Docker image tar files
-            if (filename.length() >= 4 && filename.substr(filename.length() - 4) == ".tar")
+            // Check for Docker image tar files, plain or compressed
+            if (ImageArchive::isImage(filename))
             {
                 imageFiles.push_back(entry.path().string());
-            } /*  else if (filename.length() >= 7 && filename.substr(filename.length() - 7) == ".tar.gz") {
-                  imageFiles.push_back(entry.path().string());
-             } */
+            }
         }
     }
     catch (const std::exception &e)
@@ -955,7 +1152,7 @@ std::string ProjectManager::createProjectDirectory(const std::string &projectNam
     }
     catch (const std::exception &e)
     {
-        broadcastLog("createProjectDirectory", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("createProjectDirectory", "Exception: " + std::string(e.what()), "error", projectName);
         return "";
     }
 }
@@ -965,38 +1162,137 @@ std::string ProjectManager::getProjectPath(const std::string &projectName)
     return Utils::path_join_multiple({projects_directory_, projectName});
 }
 
-bool ProjectManager::cleanupProjectDirectory(const std::string &projectName)
+bool ProjectManager::findProject(const std::string &projectName, ProjectInfo &project) const
 {
-    try
+    std::shared_lock<std::shared_mutex> lock(projects_mutex_);
+    auto it = projects_.find(projectName);
+    if (it == projects_.end())
     {
-        std::string projectPath = getProjectPath(projectName);
-        if (std::filesystem::exists(projectPath))
-        {
-            EnvParser _env;
-            _env.load_env_file(CONST_FILE_ENV_SECRET_PRIVATE);
-            auto _password = _env.get(CONST_KEY_SUDO_PSWD);
-            ProcessManager _pm;
-            const auto [_pid, _success] = _pm.startProcessBlockingAsRoot(
-                "rm",
-                {
-                    "-rf",
-                    projectPath,
-                },
-                {},
-                _password
-            );
-            // std::filesystem::remove_all(projectPath);
-            return (0 == _success);
+        return false;
+    }
+    project = it->second;
+    return true;
+}
+
+bool ProjectManager::hasProject(const std::string &projectName) const
+{
+    std::shared_lock<std::shared_mutex> lock(projects_mutex_);
+    return projects_.find(projectName) != projects_.end();
+}
+
+std::map<std::string, ProjectInfo> ProjectManager::projectsSnapshot() const
+{
+    std::shared_lock<std::shared_mutex> lock(projects_mutex_);
+    return projects_;
+}
+
+bool ProjectManager::modifyProject(const std::string &projectName, const std::function<void(ProjectInfo &)> &update)
+{
+    std::unique_lock<std::shared_mutex> lock(projects_mutex_);
+    auto it = projects_.find(projectName);
+    if (it == projects_.end())
+    {
+        return false;
+    }
+    update(it->second);
+    return true;
+}
+
+void ProjectManager::putProject(const ProjectInfo &project)
+{
+    std::unique_lock<std::shared_mutex> lock(projects_mutex_);
+    projects_[project.name] = project;
+}
+
+bool ProjectManager::eraseProject(const std::string &projectName)
+{
+    std::unique_lock<std::shared_mutex> lock(projects_mutex_);
+    return projects_.erase(projectName) > 0;
+}
+
+bool ProjectManager::saveProjects()
+{
+    // exclusive so that concurrent saves cannot write an older list over a newer one
+    std::unique_lock<std::shared_mutex> lock(projects_mutex_);
+    return database_->saveProjectsToDatabase(projects_);
+}
+
+std::shared_ptr<const std::string> ProjectManager::beginProjectOperation(const std::string &projectName, const std::string &operation,
+                                                                        std::string &running)
+{
+    std::lock_guard<std::mutex> lock(project_operations_mutex_);
+    auto [it, inserted] = project_operations_.emplace(projectName, operation);
+    if (!inserted)
+    {
+        running = it->second;
+        return nullptr;
+    }
+    return std::shared_ptr<const std::string>(new std::string(projectName), [this](const std::string *name)
+    {
+        {
+            std::lock_guard<std::mutex> lock(project_operations_mutex_);
+            project_operations_.erase(*name);
         }
-        return true; // Already clean
+        delete name;
+    });
+}
+
+crow::response ProjectManager::projectBusyResponse(const std::string &projectName, const std::string &running)
+{
+    JsonWriter json;
+    json.beginObject()
+        .field("success", false)
+        .field("project_name", projectName)
+        .field("error", "Project '" + projectName + "' is busy: " + running + " in progress")
+        .endObject();
+    return json.response(409);
+}
+
+bool ProjectManager::cleanupProjectDirectory(const std::string &projectName)
+{
+    try
+    {
+        std::string projectPath = getProjectPath(projectName);
+        if (content_store_)
+        {
+            content_store_->release(projectName);
+        }
+        return removeDirectory(projectPath);
     }
     catch (const std::exception &e)
     {
-        broadcastLog("cleanupProjectDirectory", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("cleanupProjectDirectory", "Exception: " + std::string(e.what()), "error", projectName);
         return false;
     }
 }
 
+bool ProjectManager::removeDirectory(const std::string &path)
+{
+    if (!std::filesystem::exists(path))
+    {
+        return true; // Already clean
+    }
+    if (trash_ && trash_->discard(path))
+    {
+        return true; // Deleted in the background
+    }
+    EnvParser _env;
+    _env.load_env_file(CONST_FILE_ENV_SECRET_PRIVATE);
+    auto _password = _env.get(CONST_KEY_SUDO_PSWD);
+    ProcessManager _pm;
+    const auto [_pid, _success] = _pm.startProcessBlockingAsRoot(
+        "rm",
+        {
+            "-rf",
+            path,
+        },
+        {},
+        _password
+    );
+    // std::filesystem::remove_all(path);
+    return (0 == _success);
+}
+
 bool ProjectManager::loadProject(const std::string &archivePath, const std::string &projectName, const std::string &password, std::function<void(const ProjectOperationProgress &)> progressCallback2)
 {
     ProjectOperationProgress progress;
@@ -1016,7 +1312,7 @@ bool ProjectManager::loadProject(const std::string &archivePath, const std::stri
     try
     {
         // Check if project already exists
-        if (projects_.find(projectName) != projects_.end())
+        if (hasProject(projectName))
         {
             progress.status = ProjectStatus::ERROR;
             progress.error_details = "Project with name '" + projectName + "' already exists";
@@ -1058,15 +1354,66 @@ bool ProjectManager::loadProject(const std::string &archivePath, const std::stri
         progress.status = ProjectStatus::EXTRACTING;
         progressCallback(progress);
 
-        bool extracted = extractArchive(
-            archivePath,
-            projectPath,
-            password,
-            [&progress, progressCallback](const ProjectOperationProgress &extractProgress){
-            progress.percentage = 20 + (extractProgress.percentage * 0.4); // 20-60%
-            progress.message = extractProgress.message;
+        bool listed = false;
+        ArchiveManifest manifest = list7zManifest(archivePath, password, &listed);
+        // the content store writes below the project at the listed paths
+        for (const auto &[path, entry] : manifest.entries)
+        {
+            if (!isInsideProject(path))
+            {
+                cleanupProjectDirectory(projectName);
+                progress.status = ProjectStatus::ERROR;
+                progress.error_details = "Archive entry outside of the project directory: " + path;
+                progressCallback(progress);
+                return false;
+            }
+        }
+        // Files the content store holds already are linked instead of extracted
+        std::set<std::string> linked;
+        if (content_store_ && listed)
+        {
+            linked = content_store_->linkKnown(projectName, manifest, projectPath,
+                [this, &archivePath, &password](const std::string &path)
+                {
+                    return hash7zFile(archivePath, password, path);
+                });
+        }
+
+        bool extracted = false;
+        if (linked.empty())
+        {
+            extracted = extractArchive(
+                archivePath,
+                projectPath,
+                password,
+                [&progress, progressCallback](const ProjectOperationProgress &extractProgress){
+                progress.percentage = 20 + (extractProgress.percentage * 0.4); // 20-60%
+                progress.message = extractProgress.message;
+                progressCallback(progress);
+            });
+        }
+        else
+        {
+            std::vector<std::string> remaining;
+            for (const auto &[path, entry] : manifest.entries)
+            {
+                if (entry.is_directory)
+                {
+                    std::filesystem::create_directories(Utils::path_join_multiple({projectPath, path}));
+                }
+                else if (!linked.count(path))
+                {
+                    remaining.push_back(path);
+                }
+            }
+            progress.message = "Extracting " + std::to_string(remaining.size()) + " files, " + std::to_string(linked.size()) + " linked from the content store...";
             progressCallback(progress);
-        });
+            extracted = extract7zFiles(archivePath, projectPath, password, remaining);
+        }
+        if (extracted && content_store_ && listed)
+        {
+            content_store_->ingest(projectName, manifest, projectPath, linked);
+        }
 
         if (!extracted)
         {
@@ -1089,10 +1436,14 @@ bool ProjectManager::loadProject(const std::string &archivePath, const std::stri
             composeFilePath = Utils::path_join_multiple({projectPath, "docker-compose.yaml"});
         }
 
+        // A previous project with the same name may have left a model behind
+        compose_models_.erase(projectName);
+        auto composeModel = getComposeModel(projectName, composeFilePath);
         std::vector<std::string> _list_images;
-        auto [_valid_compose, _list_services] = validateDockerComposeFile(composeFilePath, _list_images);
+        auto [_valid_compose, _list_services] = validateDockerComposeFile(*composeModel, _list_images);
         if (!_valid_compose)
         {
+            compose_models_.erase(projectName);
             cleanupProjectDirectory(projectName);
             progress.status = ProjectStatus::ERROR;
             progress.error_details = "Invalid or missing docker-compose.yml file";
@@ -1108,13 +1459,12 @@ bool ProjectManager::loadProject(const std::string &archivePath, const std::stri
 
         if (!loadDockerImagesFromProject(projectPath))
         {
-            broadcastLog("loadProject", "Warning: Some Docker images failed to load", "warning");
+            broadcastLog("loadProject", "Warning: Some Docker images failed to load", "warning", projectName);
+        }
+        for (const auto &missingImage : image_index_->missing(_list_images))
+        {
+            broadcastLog("loadProject", "Warning: required image not available locally: " + missingImage, "warning", projectName);
         }
-
-        // Read compose file content for analysis
-        std::ifstream composeFile(composeFilePath);
-        std::string composeContent((std::istreambuf_iterator<char>(composeFile)), std::istreambuf_iterator<char>());
-        composeFile.close();
 
         // Create project info
         ProjectInfo projectInfo;
@@ -1125,7 +1475,7 @@ bool ProjectManager::loadProject(const std::string &archivePath, const std::stri
         projectInfo.required_images = _list_images; // parseDockerComposeImages(composeContent);
         projectInfo.services = _list_services; 
         projectInfo.working_directory = projectPath; 
-        projectInfo.dependent_files = parseDockerComposeDependentFiles(composeContent, projectPath);
+        projectInfo.dependent_files = composeModel->dependentFiles();
         projectInfo.is_loaded = true;
         // projectInfo.is_running = false;
         projectInfo.status_message = "Project loaded successfully";
@@ -1139,11 +1489,19 @@ bool ProjectManager::loadProject(const std::string &archivePath, const std::stri
         projectInfo.last_modified = ss.str();
 
         // Store project
-        projects_[projectName] = projectInfo;
+        putProject(projectInfo);
+        projects_version_.bump();
 
         // Save to database
-        if (!database_->saveProjectsToDatabase(projects_)) {
-            broadcastLog("loadProject", "Warning: Failed to save project to database", "warning");
+        if (!saveProjects()) {
+            broadcastLog("loadProject", "Warning: Failed to save project to database", "warning", projectName);
+        }
+        if (!database_->saveComposeModel(projectName, *composeModel)) {
+            broadcastLog("loadProject", "Warning: Failed to save compose model to database", "warning", projectName);
+        }
+        // kept so that a later update extracts only what differs
+        if (!listed || !database_->saveProjectManifest(projectName, archivePath, manifest)) {
+            broadcastLog("loadProject", "Warning: Failed to save archive manifest to database", "warning", projectName);
         }
 
         // Load compose project
@@ -1159,16 +1517,17 @@ bool ProjectManager::loadProject(const std::string &archivePath, const std::stri
         progress.message = "Project loaded successfully";
         progressCallback(progress);
 
-        broadcastLog("loadProject", "Project '" + projectName + "' loaded successfully", "info");
+        broadcastLog("loadProject", "Project '" + projectName + "' loaded successfully", "info", projectName);
         return true;
     }
     catch (const std::exception &e)
     {
+        compose_models_.erase(projectName);
         cleanupProjectDirectory(projectName);
         progress.status = ProjectStatus::ERROR;
         progress.error_details = "Exception during project load: " + std::string(e.what());
         progressCallback(progress);
-        broadcastLog("loadProject", progress.error_details, "error");
+        broadcastLog("loadProject", progress.error_details, "error", projectName);
         return false;
     }
 }
@@ -1177,10 +1536,9 @@ bool ProjectManager::unloadProject(const std::string &projectName)
 {
     try
     {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end())
+        if (!hasProject(projectName))
         {
-            broadcastLog("unloadProject", "Project not found: " + projectName, "warning");
+            broadcastLog("unloadProject", "Project not found: " + projectName, "warning", projectName);
             return false;
         }
 
@@ -1194,19 +1552,27 @@ bool ProjectManager::unloadProject(const std::string &projectName)
         // removeComposeProject(projectName);
 
         // Remove from our tracking
-        projects_.erase(it);
+        eraseProject(projectName);
+        projects_version_.bump();
+        compose_models_.erase(projectName);
+        database_->deleteComposeModel(projectName);
+        database_->deleteProjectManifest(projectName);
+        if (content_store_)
+        {
+            content_store_->release(projectName);
+        }
 
         // Save to database
-        if (!database_->saveProjectsToDatabase(projects_)) {
-            broadcastLog("unloadProject", "Warning: Failed to save projects to database", "warning");
+        if (!saveProjects()) {
+            broadcastLog("unloadProject", "Warning: Failed to save projects to database", "warning", projectName);
         }
 
-        broadcastLog("unloadProject", "Project unloaded: " + projectName, "info");
+        broadcastLog("unloadProject", "Project unloaded: " + projectName, "info", projectName);
         return true;
     }
     catch (const std::exception &e)
     {
-        broadcastLog("unloadProject", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("unloadProject", "Exception: " + std::string(e.what()), "error", projectName);
         return false;
     }
 }
@@ -1224,30 +1590,746 @@ bool ProjectManager::removeProject(const std::string &projectName, bool removeFi
             cleanupProjectDirectory(projectName);
         }
 
-        broadcastLog("removeProject", "Project removed: " + projectName, "info");
+        broadcastLog("removeProject", "Project removed: " + projectName, "info", projectName);
         
         // Save to database
-        if (!database_->saveProjectsToDatabase(projects_)) {
-            broadcastLog("removeProject", "Warning: Failed to save projects to database", "warning");
+        if (!saveProjects()) {
+            broadcastLog("removeProject", "Warning: Failed to save projects to database", "warning", projectName);
         }
         
         return true;
     }
     catch (const std::exception &e)
     {
-        broadcastLog("removeProject", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("removeProject", "Exception: " + std::string(e.what()), "error", projectName);
         return false;
     }
 }
 
+ProjectReloadResult ProjectManager::reloadProject(const std::string &projectName, const std::string &archivePath,
+                                                  const std::string &password,
+                                                  std::function<void(const ProjectOperationProgress &)> progressCallback2)
+{
+    const auto started = std::chrono::steady_clock::now();
+    ProjectReloadResult result;
+    ProjectOperationProgress progress;
+    progress.status = ProjectStatus::EXTRACTING;
+    progress.percentage = 0;
+    progress.message = "Preparing new version...";
+    progress.current_operation = "reload";
+
+    auto progressCallback = [&progressCallback2](const ProjectOperationProgress &_p) -> void
+    {
+        if (progressCallback2)
+        {
+            progressCallback2(_p);
+        }
+    };
+    // a sibling of the project directory, so that both are on the same filesystem
+    const std::string stagingPath = Utils::path_join_multiple({projects_directory_, "." + projectName + ".stage"});
+    // false while the staging directory holds files the project created itself
+    bool stagingDisposable = true;
+    auto fail = [&](const std::string &error) -> ProjectReloadResult
+    {
+        if (stagingDisposable)
+        {
+            removeDirectory(stagingPath);
+        }
+        result.success = false;
+        result.error = error;
+        result.elapsed_ms = millisecondsSince(started);
+        progress.status = ProjectStatus::ERROR;
+        progress.error_details = error;
+        progressCallback(progress);
+        broadcastLog("reloadProject", error, "error", projectName);
+        return result;
+    };
+
+    try
+    {
+        ProjectInfo loaded;
+        if (!findProject(projectName, loaded))
+        {
+            return fail("Project not found: " + projectName);
+        }
+        const std::string projectPath = loaded.extracted_path.empty() ? getProjectPath(projectName) : loaded.extracted_path;
+        if (fs::exists(stagingPath))
+        {
+            // an interrupted reload may have moved the project's own files there
+            stagingDisposable = false;
+            return fail("A previous reload of '" + projectName + "' did not finish, inspect or remove " + stagingPath + " first");
+        }
+
+        // Extract and validate next to the running version
+        bool listed = false;
+        ArchiveManifest next = list7zManifest(archivePath, password, &listed);
+        if (!listed)
+        {
+            return fail("Failed to list archive: " + archivePath);
+        }
+        for (const auto &[path, entry] : next.entries)
+        {
+            if (!isInsideProject(path))
+            {
+                return fail("Archive entry outside of the project directory: " + path);
+            }
+        }
+        progress.percentage = 10;
+        progress.message = "Extracting archive into staging directory...";
+        progressCallback(progress);
+        if (!extractArchive(archivePath, stagingPath, password))
+        {
+            return fail("Failed to extract archive");
+        }
+
+        progress.status = ProjectStatus::VALIDATING;
+        progress.percentage = 40;
+        progress.message = "Validating Docker Compose file...";
+        progressCallback(progress);
+        const std::string composeName = fs::exists(Utils::path_join_multiple({stagingPath, "docker-compose.yml"})) ? "docker-compose.yml" : "docker-compose.yaml";
+        const std::string composeFilePath = Utils::path_join_multiple({projectPath, composeName});
+        std::ifstream stagedCompose(Utils::path_join_multiple({stagingPath, composeName}));
+        std::string content((std::istreambuf_iterator<char>(stagedCompose)), std::istreambuf_iterator<char>());
+        const ComposeModel stagedModel = ComposeModel::parse(content, composeFilePath);
+        std::vector<std::string> images;
+        auto [valid, services] = validateDockerComposeFile(stagedModel, images);
+        if (!valid)
+        {
+            return fail("Invalid or missing docker-compose.yml file, project left unchanged");
+        }
+
+        // Images load while the old containers keep running on the previous image IDs
+        progress.status = ProjectStatus::LOADING_IMAGES;
+        progress.percentage = 50;
+        progress.message = "Loading Docker images...";
+        progressCallback(progress);
+        ArchiveManifest current;
+        const bool hadManifest = database_->loadProjectManifest(projectName, current);
+        const ManifestDiff diff = current.diff(next);
+        for (const auto &[path, entry] : next.entries)
+        {
+            if (entry.is_directory || !ImageArchive::isImage(path))
+            {
+                continue;
+            }
+            if (hadManifest && std::find(diff.added.begin(), diff.added.end(), path) == diff.added.end()
+                && std::find(diff.changed.begin(), diff.changed.end(), path) == diff.changed.end())
+            {
+                continue; // loaded with the running version
+            }
+            std::vector<std::string> loaded;
+            if (!loadImageFromFile(Utils::path_join_multiple({stagingPath, path}), &loaded))
+            {
+                return fail("Failed to load image file: " + path);
+            }
+            result.loaded_images.insert(result.loaded_images.end(), loaded.begin(), loaded.end());
+        }
+        for (const auto &missingImage : image_index_->missing(images))
+        {
+            broadcastLog("reloadProject", "Warning: required image not available locally: " + missingImage, "warning", projectName);
+        }
+        result.prepare_ms = millisecondsSince(started);
+
+        try
+        {
+            result.was_running = !getProjectContainers(projectName).empty();
+        }
+        catch (const std::exception &e)
+        {
+            broadcastLog("reloadProject", "Warning: Failed to query containers: " + std::string(e.what()), "warning", projectName);
+        }
+
+        // Switch: stop the services so nothing writes to the project any more, move the files it
+        // created itself into the new version, exchange the directories and start on the new files
+        progress.percentage = 80;
+        progress.message = "Switching to the new version...";
+        progressCallback(progress);
+        const auto switched = std::chrono::steady_clock::now();
+        auto restartPrevious = [&]()
+        {
+            if (result.was_running)
+            {
+                composeUp(projectName, {"--remove-orphans"});
+            }
+        };
+        if (result.was_running)
+        {
+            auto [downOk, downOutput] = composeDown(projectName, false);
+            if (!downOk)
+            {
+                restartPrevious();
+                return fail("Failed to stop the running version: " + downOutput);
+            }
+        }
+
+        // Files the project created itself (data directories, generated config): every entry that is
+        // neither in the new archive nor dropped from the previous one. An unreadable directory aborts
+        // the reload, it may hold such files.
+        std::vector<std::string> carryOver;
+        std::error_code ec;
+        for (auto entry = fs::recursive_directory_iterator(projectPath, ec);
+             !ec && entry != fs::recursive_directory_iterator(); entry.increment(ec))
+        {
+            const std::string relative = fs::relative(entry->path(), projectPath).generic_string();
+            auto inNext = next.entries.find(relative);
+            if (inNext != next.entries.end())
+            {
+                if (!inNext->second.is_directory)
+                {
+                    entry.disable_recursion_pending();
+                }
+                continue;
+            }
+            entry.disable_recursion_pending();
+            if (hadManifest && current.contains(relative))
+            {
+                continue; // dropped from the archive
+            }
+            carryOver.push_back(relative);
+        }
+        if (ec)
+        {
+            restartPrevious();
+            return fail("Failed to list the files the project created itself, project left unchanged: " + ec.message());
+        }
+
+        // moved, not copied: ownership, permissions and hard links stay as they are, whoever owns the files
+        std::vector<std::string> moved;
+        auto moveBack = [&](const std::string &from, const std::string &to) -> bool
+        {
+            bool restored = true;
+            for (auto path = moved.rbegin(); path != moved.rend(); ++path)
+            {
+                std::error_code moveError;
+                fs::rename(fs::path(from) / *path, fs::path(to) / *path, moveError);
+                if (moveError)
+                {
+                    restored = false;
+                    broadcastLog("reloadProject", "Failed to move " + *path + " back: " + moveError.message(), "error", projectName);
+                }
+            }
+            return restored;
+        };
+        stagingDisposable = false;
+        for (const auto &relative : carryOver)
+        {
+            std::error_code moveError;
+            const fs::path target = fs::path(stagingPath) / relative;
+            fs::create_directories(target.parent_path(), moveError);
+            if (!moveError)
+            {
+                fs::rename(fs::path(projectPath) / relative, target, moveError);
+            }
+            if (moveError)
+            {
+                stagingDisposable = moveBack(stagingPath, projectPath);
+                restartPrevious();
+                return fail("Failed to carry over " + relative + ", project left unchanged: " + moveError.message());
+            }
+            moved.push_back(relative);
+        }
+        result.carried_over = moved.size();
+
+        std::string exchangeError;
+        if (!exchangeDirectories(stagingPath, projectPath, exchangeError))
+        {
+            stagingDisposable = moveBack(stagingPath, projectPath);
+            restartPrevious();
+            return fail("Failed to exchange project directories: " + exchangeError);
+        }
+        const ProjectInfo previous = loaded;
+        modifyProject(projectName, [&](ProjectInfo &project) {
+            project.archive_path = archivePath;
+            project.compose_file_path = composeFilePath;
+            project.required_images = images;
+            project.services = services;
+            project.dependent_files = stagedModel.dependentFiles();
+        });
+        if (result.was_running)
+        {
+            auto [upOk, upOutput] = composeUp(projectName, {"--force-recreate", "--remove-orphans"});
+            if (!upOk)
+            {
+                std::string rollbackError;
+                modifyProject(projectName, [&previous](ProjectInfo &project) { project = previous; });
+                composeDown(projectName, false);
+                if (exchangeDirectories(stagingPath, projectPath, rollbackError))
+                {
+                    // the new version sits in the staging directory again, with the project's own files
+                    stagingDisposable = moveBack(stagingPath, projectPath);
+                    restartPrevious();
+                    result.rolled_back = stagingDisposable;
+                }
+                return fail("Failed to start the new version" +
+                            std::string(result.rolled_back ? ", previous version restored: "
+                                                           : ", previous version kept in " + stagingPath + ": ") + upOutput);
+            }
+        }
+        result.switch_ms = millisecondsSince(switched);
+
+        {
+            auto now = std::chrono::system_clock::now();
+            auto time_t = std::chrono::system_clock::to_time_t(now);
+            std::stringstream ss;
+            ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+            const std::string modified = ss.str();
+            modifyProject(projectName, [&modified](ProjectInfo &project) { project.last_modified = modified; });
+        }
+        const auto model = getComposeModel(projectName, composeFilePath);
+        if (!saveProjects()) {
+            broadcastLog("reloadProject", "Warning: Failed to save project to database", "warning", projectName);
+        }
+        if (!database_->saveComposeModel(projectName, *model)) {
+            broadcastLog("reloadProject", "Warning: Failed to save compose model to database", "warning", projectName);
+        }
+        if (!database_->saveProjectManifest(projectName, archivePath, next)) {
+            broadcastLog("reloadProject", "Warning: Failed to save archive manifest to database", "warning", projectName);
+        }
+        projects_version_.bump();
+
+        // The previous version now sits in the staging directory
+        progress.percentage = 95;
+        progress.message = "Removing previous version...";
+        progressCallback(progress);
+        removeDirectory(stagingPath);
+        if (content_store_)
+        {
+            content_store_->release(projectName);
+            content_store_->ingest(projectName, next, projectPath);
+        }
+
+        result.success = true;
+        result.elapsed_ms = millisecondsSince(started);
+        progress.status = ProjectStatus::READY;
+        progress.percentage = 100;
+        progress.message = "Project reloaded";
+        progressCallback(progress);
+        broadcastLog("reloadProject", "Project '" + projectName + "' reloaded, switch took " + std::to_string(result.switch_ms) + " ms", "info", projectName);
+        return result;
+    }
+    catch (const std::exception &e)
+    {
+        return fail("Exception during project reload: " + std::string(e.what()));
+    }
+}
+
+ProjectUpdateResult ProjectManager::updateProject(const std::string &projectName, const std::string &archivePath,
+                                                  const std::string &password,
+                                                  std::function<void(const ProjectOperationProgress &)> progressCallback2)
+{
+    const auto started = std::chrono::steady_clock::now();
+    ProjectUpdateResult result;
+    ProjectOperationProgress progress;
+    progress.status = ProjectStatus::VALIDATING;
+    progress.percentage = 0;
+    progress.message = "Comparing archive with the loaded project...";
+    progress.current_operation = "update";
+
+    auto progressCallback = [&progressCallback2](const ProjectOperationProgress &_p) -> void
+    {
+        if (progressCallback2)
+        {
+            progressCallback2(_p);
+        }
+    };
+    const std::string stagingPath = Utils::path_join_multiple({projects_directory_, "." + projectName + ".update"});
+    // files the update replaces or removes are moved here, and back if it fails before it is committed
+    const std::string backupPath = Utils::path_join_multiple({projects_directory_, "." + projectName + ".backup"});
+    std::string projectPath;
+    ProjectInfo previous;
+    bool applying = false;
+    bool entryChanged = false;
+    bool composeRan = false;                        // compose was run on the new files
+    std::vector<std::string> backedUp;              // moved from the project into the backup
+    std::vector<std::string> placed;                // moved from staging into the project
+    std::vector<std::string> createdDirectories;
+    std::string restartError;                       // set if the restored version did not come back up
+    auto rollback = [&]() -> bool
+    {
+        bool restored = true;
+        std::error_code ec;
+        for (auto path = placed.rbegin(); path != placed.rend(); ++path)
+        {
+            fs::remove_all(fs::path(projectPath) / *path, ec);
+        }
+        for (auto path = backedUp.rbegin(); path != backedUp.rend(); ++path)
+        {
+            const fs::path target = fs::path(projectPath) / *path;
+            fs::create_directories(target.parent_path(), ec);
+            fs::rename(fs::path(backupPath) / *path, target, ec);
+            if (ec)
+            {
+                restored = false;
+                broadcastLog("updateProject", "Failed to restore " + *path + ": " + ec.message(), "error", projectName);
+            }
+        }
+        for (auto path = createdDirectories.rbegin(); path != createdDirectories.rend(); ++path)
+        {
+            fs::remove(fs::path(projectPath) / *path, ec);
+        }
+        if (entryChanged)
+        {
+            modifyProject(projectName, [&previous](ProjectInfo &project) { project = previous; });
+        }
+        getComposeModel(projectName);
+        if (restored && composeRan)
+        {
+            // the new run may have named services the restored file does not have and removed
+            // orphans of it: the restored file is brought up as a whole
+            auto [restarted, output] = composeUp(projectName, {"--remove-orphans"});
+            if (!restarted)
+            {
+                restartError = output;
+            }
+        }
+        return restored;
+    };
+    auto finish = [&]() -> ProjectUpdateResult
+    {
+        std::error_code ec;
+        fs::remove_all(stagingPath, ec);
+        result.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+        return result;
+    };
+    auto fail = [&](const std::string &failure) -> ProjectUpdateResult
+    {
+        std::string error = failure;
+        if (applying)
+        {
+            applying = false;
+            const bool restored = rollback();
+            result.rolled_back = restored && restartError.empty();
+            if (restored)
+            {
+                removeDirectory(backupPath);
+                error += ", previous files restored";
+                if (!restartError.empty())
+                {
+                    error += ", but starting them failed: " + restartError;
+                }
+            }
+            else
+            {
+                error += ", restoring the previous files failed, they are kept in " + backupPath;
+            }
+        }
+        result.success = false;
+        result.error = error;
+        progress.status = ProjectStatus::ERROR;
+        progress.error_details = error;
+        progressCallback(progress);
+        broadcastLog("updateProject", error, "error", projectName);
+        return finish();
+    };
+
+    try
+    {
+        if (!findProject(projectName, previous))
+        {
+            return fail("Project not found: " + projectName);
+        }
+        projectPath = previous.extracted_path.empty() ? getProjectPath(projectName) : previous.extracted_path;
+        if (fs::exists(backupPath))
+        {
+            return fail("A previous update of '" + projectName + "' did not finish, its replaced files are kept in " + backupPath +
+                        ": restore or remove them first");
+        }
+
+        bool listed = false;
+        ArchiveManifest next = list7zManifest(archivePath, password, &listed);
+        if (!listed)
+        {
+            return fail("Failed to list archive: " + archivePath);
+        }
+        const std::string composeName = next.contains("docker-compose.yml") ? "docker-compose.yml"
+                                      : next.contains("docker-compose.yaml") ? "docker-compose.yaml" : "";
+        if (composeName.empty())
+        {
+            return fail("Archive has no docker-compose.yml: " + archivePath);
+        }
+        for (const auto &[path, entry] : next.entries)
+        {
+            if (!isInsideProject(path))
+            {
+                return fail("Archive entry outside of the project directory: " + path);
+            }
+        }
+
+        ArchiveManifest current;
+        result.had_manifest = database_->loadProjectManifest(projectName, current);
+        if (!result.had_manifest)
+        {
+            // loaded before manifests were kept: compare with what is on disk, entries gone from the archive stay
+            current = ArchiveManifest::fromDirectory(projectPath, next);
+            broadcastLog("updateProject", "No archive manifest kept for '" + projectName + "', comparing with the extracted files", "warning", projectName);
+        }
+        const ManifestDiff diff = current.diff(next);
+        result.added = diff.added;
+        result.changed = diff.changed;
+        result.removed = diff.removed;
+        result.unchanged = diff.unchanged;
+        broadcastLog("updateProject", "'" + projectName + "': " + std::to_string(diff.added.size()) + " added, " +
+                     std::to_string(diff.changed.size()) + " changed, " + std::to_string(diff.removed.size()) + " removed, " +
+                     std::to_string(diff.unchanged) + " unchanged", "info", projectName);
+
+        const auto previousModel = getComposeModel(projectName);
+        bool wasRunning = false;
+        try
+        {
+            wasRunning = !getProjectContainers(projectName).empty();
+        }
+        catch (const std::exception &e)
+        {
+            broadcastLog("updateProject", "Warning: Failed to query containers: " + std::string(e.what()), "warning", projectName);
+        }
+
+        // Extract what differs next to the project, so a failure leaves the project as it was
+        std::vector<std::string> extract = diff.added;
+        extract.insert(extract.end(), diff.changed.begin(), diff.changed.end());
+        std::error_code ec;
+        fs::remove_all(stagingPath, ec);
+        progress.status = ProjectStatus::EXTRACTING;
+        progress.percentage = 10;
+        progress.message = "Extracting " + std::to_string(extract.size()) + " changed files...";
+        progressCallback(progress);
+        if (!extract7zFiles(archivePath, stagingPath, password, extract))
+        {
+            return fail("Failed to extract changed files from archive");
+        }
+
+        const std::string composeFilePath = Utils::path_join_multiple({projectPath, composeName});
+        if (diff.touches(composeName))
+        {
+            progress.status = ProjectStatus::VALIDATING;
+            progress.percentage = 40;
+            progress.message = "Validating Docker Compose file...";
+            progressCallback(progress);
+
+            std::ifstream stagedCompose(Utils::path_join_multiple({stagingPath, composeName}));
+            std::string content((std::istreambuf_iterator<char>(stagedCompose)), std::istreambuf_iterator<char>());
+            std::vector<std::string> images;
+            auto [valid, services] = validateDockerComposeFile(ComposeModel::parse(content, composeFilePath), images);
+            if (!valid)
+            {
+                return fail("Invalid docker-compose file in archive, project left unchanged");
+            }
+        }
+
+        // Apply: move staged files into place and what the archive no longer has out of the way,
+        // keeping everything replaced or removed in the backup until compose accepted the result
+        progress.percentage = 50;
+        progress.message = "Applying changes...";
+        progressCallback(progress);
+        auto makeDirectories = [&](const fs::path &relative)
+        {
+            fs::path current;
+            for (const auto &part : relative)
+            {
+                current /= part;
+                if (!fs::exists(fs::path(projectPath) / current))
+                {
+                    fs::create_directory(fs::path(projectPath) / current);
+                    createdDirectories.push_back(current.string());
+                }
+            }
+        };
+        auto backUp = [&](const std::string &path)
+        {
+            const fs::path source = fs::path(projectPath) / path;
+            if (!fs::exists(fs::symlink_status(source)))
+            {
+                return;
+            }
+            const fs::path target = fs::path(backupPath) / path;
+            fs::create_directories(target.parent_path());
+            fs::rename(source, target);
+            backedUp.push_back(path);
+        };
+        applying = true;
+        for (const auto &[path, entry] : next.entries)
+        {
+            if (entry.is_directory)
+            {
+                makeDirectories(path);
+            }
+        }
+        for (const auto &path : extract)
+        {
+            backUp(path);
+            makeDirectories(fs::path(path).parent_path());
+            fs::rename(fs::path(stagingPath) / path, fs::path(projectPath) / path);
+            placed.push_back(path);
+        }
+        for (const auto &path : diff.removed)
+        {
+            backUp(path);
+        }
+
+        // Load only the image tars that differ
+        progress.status = ProjectStatus::LOADING_IMAGES;
+        progress.percentage = 60;
+        progress.message = "Loading changed Docker images...";
+        progressCallback(progress);
+        std::set<std::string> loadedCanonical;
+        for (const auto &path : extract)
+        {
+            if (!ImageArchive::isImage(path))
+            {
+                continue;
+            }
+            std::vector<std::string> loaded;
+            if (!loadImageFromFile(Utils::path_join_multiple({projectPath, path}), &loaded))
+            {
+                broadcastLog("updateProject", "Warning: Failed to load image file: " + path, "warning", projectName);
+                continue;
+            }
+            for (const auto &reference : loaded)
+            {
+                result.loaded_images.push_back(reference);
+                loadedCanonical.insert(ImageReference::parse(reference).canonical());
+            }
+        }
+
+        // Services whose definition, image or files changed
+        const auto model = getComposeModel(projectName, composeFilePath);
+        std::vector<std::string> images;
+        auto [valid, services] = validateDockerComposeFile(*model, images);
+        if (!valid)
+        {
+            return fail("Invalid docker-compose file after update: " + model->error);
+        }
+        // compose substitutes the variables of the .env next to the compose file into every service,
+        // the model is parsed from the file before substitution and does not see a change there
+        const fs::path composeDirectory = fs::path(composeFilePath).parent_path().lexically_relative(projectPath);
+        const std::string dotEnv = (composeDirectory.empty() || composeDirectory == "." ? fs::path(".env") : composeDirectory / ".env").generic_string();
+        const bool sharedChanged = !previousModel->valid || previousModel->shared_hash.empty() || previousModel->shared_hash != model->shared_hash
+            || diff.touches(dotEnv);
+        for (const auto &service : model->services)
+        {
+            const ComposeServiceModel *before = previousModel->valid ? previousModel->service(service.name) : nullptr;
+            bool affected = sharedChanged || !before || before->definition_hash.empty() || before->definition_hash != service.definition_hash;
+            affected = affected || (!service.image.empty() && loadedCanonical.count(ImageReference::parse(service.image).canonical()) > 0);
+            for (const auto &file : service.dependentFiles())
+            {
+                affected = affected || diff.touches(file);
+            }
+            if (affected)
+            {
+                result.recreated_services.push_back(service.name);
+            }
+        }
+        if (previousModel->valid)
+        {
+            for (const auto &service : previousModel->services)
+            {
+                if (!model->service(service.name))
+                {
+                    result.removed_services.push_back(service.name);
+                }
+            }
+        }
+
+        {
+            auto now = std::chrono::system_clock::now();
+            auto time_t = std::chrono::system_clock::to_time_t(now);
+            std::stringstream ss;
+            ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
+            const std::string modified = ss.str();
+            entryChanged = true;
+            modifyProject(projectName, [&](ProjectInfo &project) {
+                project.archive_path = archivePath;
+                project.compose_file_path = composeFilePath;
+                project.required_images = images;
+                project.services = services;
+                project.dependent_files = model->dependentFiles();
+                project.last_modified = modified;
+            });
+        }
+
+        if (wasRunning && (!result.recreated_services.empty() || !result.removed_services.empty()))
+        {
+            progress.percentage = 80;
+            progress.message = "Recreating " + std::to_string(result.recreated_services.size()) + " services...";
+            progressCallback(progress);
+
+            std::vector<std::string> args = {"--remove-orphans"};
+            if (result.recreated_services.empty())
+            {
+                args.push_back("--no-recreate");
+            }
+            else
+            {
+                args.push_back("--no-deps");
+                args.push_back("--force-recreate");
+                args.insert(args.end(), result.recreated_services.begin(), result.recreated_services.end());
+            }
+            composeRan = true;
+            auto [started_up, output] = composeUp(projectName, args);
+            if (!started_up)
+            {
+                return fail("Failed to recreate services: " + output);
+            }
+            result.compose_applied = true;
+        }
+        else if (!wasRunning)
+        {
+            // nothing runs, the next start picks everything up
+            result.recreated_services.clear();
+        }
+
+        // Commit: the replaced files are no longer needed
+        applying = false;
+        for (const auto &path : diff.removed_directories)
+        {
+            // kept if the project put files of its own there
+            fs::remove(fs::path(projectPath) / path, ec);
+        }
+        removeDirectory(backupPath);
+        if (content_store_)
+        {
+            std::vector<std::string> replaced = diff.removed;
+            replaced.insert(replaced.end(), diff.changed.begin(), diff.changed.end());
+            content_store_->release(projectName, replaced);
+            ArchiveManifest applied;
+            for (const auto &path : extract)
+            {
+                applied.entries[path] = next.entries.at(path);
+            }
+            content_store_->ingest(projectName, applied, projectPath);
+        }
+
+        if (!saveProjects()) {
+            broadcastLog("updateProject", "Warning: Failed to save project to database", "warning", projectName);
+        }
+        if (!database_->saveComposeModel(projectName, *model)) {
+            broadcastLog("updateProject", "Warning: Failed to save compose model to database", "warning", projectName);
+        }
+        if (!database_->saveProjectManifest(projectName, archivePath, next)) {
+            broadcastLog("updateProject", "Warning: Failed to save archive manifest to database", "warning", projectName);
+        }
+        projects_version_.bump();
+
+        result.success = true;
+        progress.status = ProjectStatus::READY;
+        progress.percentage = 100;
+        progress.message = "Project updated";
+        progressCallback(progress);
+        broadcastLog("updateProject", "Project '" + projectName + "' updated, " + std::to_string(result.recreated_services.size()) + " services recreated", "info", projectName);
+        return finish();
+    }
+    catch (const std::exception &e)
+    {
+        return fail("Exception during project update: " + std::string(e.what()));
+    }
+}
+
 bool ProjectManager::startProject(const std::string &projectName)
 {
     try
     {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end())
+        if (!hasProject(projectName))
         {
-            broadcastLog("startProject", "Project not found: " + projectName, "error");
+            broadcastLog("startProject", "Project not found: " + projectName, "error", projectName);
             return false;
         }
 
@@ -1263,19 +2345,20 @@ bool ProjectManager::startProject(const std::string &projectName)
         if (success)
         {
             // it->second.is_running = true;
-            it->second.status_message = "Project is running";
-            broadcastLog("startProject", "Project started: '" + projectName + "' " + message, "success");
+            modifyProject(projectName, [](ProjectInfo &project) { project.status_message = "Project is running"; });
+            projects_version_.bump();
+            broadcastLog("startProject", "Project started: '" + projectName + "' " + message, "success", projectName);
         }
         else
         {
-            broadcastLog("startProject", "Failed to start project: '" + projectName + "': " + message, "error");
+            broadcastLog("startProject", "Failed to start project: '" + projectName + "': " + message, "error", projectName);
         }
 
         return success;
     }
     catch (const std::exception &e)
     {
-        broadcastLog("startProject", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("startProject", "Exception: " + std::string(e.what()), "error", projectName);
         return false;
     }
 }
@@ -1284,10 +2367,9 @@ bool ProjectManager::stopProject(const std::string &projectName)
 {
     try
     {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end())
+        if (!hasProject(projectName))
         {
-            broadcastLog("stopProject", "Project not found: " + projectName, "error");
+            broadcastLog("stopProject", "Project not found: " + projectName, "error", projectName);
             return false;
         }
 
@@ -1303,19 +2385,20 @@ bool ProjectManager::stopProject(const std::string &projectName)
         if (success)
         {
             // it->second.is_running = false;
-            it->second.status_message = "Project is stopped";
-            broadcastLog("stopProject", "Project stopped: '" + projectName + "' " + message, "info");
+            modifyProject(projectName, [](ProjectInfo &project) { project.status_message = "Project is stopped"; });
+            projects_version_.bump();
+            broadcastLog("stopProject", "Project stopped: '" + projectName + "' " + message, "info", projectName);
         }
         else
         {
-            broadcastLog("stopProject", "Failed to stop project: '" + projectName + "': " + message, "error");
+            broadcastLog("stopProject", "Failed to stop project: '" + projectName + "': " + message, "error", projectName);
         }
 
         return success;
     }
     catch (const std::exception &e)
     {
-        broadcastLog("stopProject", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("stopProject", "Exception: " + std::string(e.what()), "error", projectName);
         return false;
     }
 }
@@ -1324,10 +2407,9 @@ bool ProjectManager::restartProject(const std::string &projectName)
 {
     try
     {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end())
+        if (!hasProject(projectName))
         {
-            broadcastLog("restartProject", "Project not found: " + projectName, "error");
+            broadcastLog("restartProject", "Project not found: " + projectName, "error", projectName);
             return false;
         }
 
@@ -1337,36 +2419,37 @@ bool ProjectManager::restartProject(const std::string &projectName)
         if (success)
         {
             // it->second.is_running = true;
-            it->second.status_message = "Project restarted";
-            broadcastLog("restartProject", "Project restarted: '" + projectName + "': " + message, "info");
+            modifyProject(projectName, [](ProjectInfo &project) { project.status_message = "Project restarted"; });
+            projects_version_.bump();
+            broadcastLog("restartProject", "Project restarted: '" + projectName + "': " + message, "info", projectName);
         }
         else
         {
-            broadcastLog("restartProject", "Failed to restart project: '" + projectName + "': " + message, "error");
+            broadcastLog("restartProject", "Failed to restart project: '" + projectName + "': " + message, "error", projectName);
         }
 
         return success;
     }
     catch (const std::exception &e)
     {
-        broadcastLog("restartProject", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("restartProject", "Exception: " + std::string(e.what()), "error", projectName);
         return false;
     }
 }
 
 ProjectStatus ProjectManager::getProjectStatus(const std::string &projectName)
 {
-    auto it = projects_.find(projectName);
-    if (it == projects_.end())
+    ProjectInfo project;
+    if (!findProject(projectName, project))
     {
         return ProjectStatus::NOT_LOADED;
     }
 
-    if (it->second.is_running)
+    if (project.is_running)
     {
         return ProjectStatus::RUNNING;
     }
-    else if(it->second.is_loaded)
+    else if(project.is_loaded)
     {
         return ProjectStatus::READY;
     }
@@ -1379,21 +2462,89 @@ ProjectStatus ProjectManager::getProjectStatus(const std::string &projectName)
 std::vector<ProjectInfo> ProjectManager::listProjects()
 {
     std::vector<ProjectInfo> projectList;
-    for (auto &pair : projects_)
+    for (auto &pair : projectsSnapshot())
     {
         auto [_running, _msg] = composeSatus(pair.first);
         pair.second.is_running = _running;
+        modifyProject(pair.first, [_running](ProjectInfo &project) { project.is_running = _running; });
         projectList.push_back(pair.second);
     }
     return projectList;
 }
 
+std::string ProjectManager::projectsFingerprint()
+{
+    const auto names = getProjectNames();
+    if (names.empty())
+    {
+        return "";
+    }
+
+    // one `docker ps` for all projects instead of a `docker compose ps` each; the compose labels
+    // tell which project a container belongs to
+    std::string output;
+    auto [pid, ret_code] = process_manager_->startProcessBlocking(
+        "docker",
+        {"ps", "-a", "--filter", "label=com.docker.compose.project", "--format", "json"},
+        {},
+        [&output](const std::string &chunk)
+        {
+            output += chunk;
+        });
+    if (ret_code != 0)
+    {
+        return "docker ps failed";
+    }
+
+    // project -> running and total containers
+    std::map<std::string, std::pair<int, int>> counts;
+    for (const auto &name : names)
+    {
+        counts[name];
+    }
+    static const std::string PROJECT_LABEL = "com.docker.compose.project=";
+    JsonLineScanner scanner(output);
+    JsonField fields[2];
+    while (scanner.next())
+    {
+        if (!scanner.fields({"Labels", "State"}, fields))
+            continue;
+        const std::string labels = fields[0].str();
+        size_t start = 0;
+        while (start < labels.size())
+        {
+            size_t end = labels.find(',', start);
+            if (end == std::string::npos)
+                end = labels.size();
+            if (labels.compare(start, PROJECT_LABEL.size(), PROJECT_LABEL) == 0)
+            {
+                auto it = counts.find(labels.substr(start + PROJECT_LABEL.size(), end - start - PROJECT_LABEL.size()));
+                if (it != counts.end())
+                {
+                    it->second.second++;
+                    if (Utils::str_to_lower(fields[1].str()) == "running")
+                        it->second.first++;
+                }
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    std::string fingerprint;
+    for (const auto &[name, count] : counts)
+    {
+        fingerprint += name + ":" + std::to_string(count.first) + "/" + std::to_string(count.second) + ";";
+    }
+    return fingerprint;
+}
+
 ProjectInfo ProjectManager::getProjectInfo(const std::string &projectName)
 {
-    auto it = projects_.find(projectName);
-    if (it != projects_.end())
+    ProjectInfo project;
+    if (findProject(projectName, project))
     {
-        return it->second;
+        return project;
     }
 
     // Return empty project info if not found
@@ -1403,6 +2554,58 @@ ProjectInfo ProjectManager::getProjectInfo(const std::string &projectName)
     return empty;
 }
 
+std::vector<std::string> ProjectManager::getProjectNames()
+{
+    std::vector<std::string> names;
+    std::shared_lock<std::shared_mutex> lock(projects_mutex_);
+    names.reserve(projects_.size());
+    for (const auto &pair : projects_)
+    {
+        names.push_back(pair.first);
+    }
+    return names;
+}
+
+std::vector<ProjectContainer> ProjectManager::getProjectContainers(const std::string &projectName)
+{
+    ProjectInfo project;
+    if (!findProject(projectName, project))
+    {
+        throw std::runtime_error("Project not found: " + projectName);
+    }
+
+    std::string output;
+    auto [pid, ret_code] = process_manager_->startProcessBlocking(
+        "docker",
+        {"compose", "-f", project.compose_file_path, "-p", projectName, "ps", "--format", "json", "--no-trunc"},
+        {},
+        [&output](const std::string &chunk)
+        {
+            output += chunk;
+        },
+        project.working_directory);
+    if (ret_code != 0)
+    {
+        throw std::runtime_error("docker compose ps failed for project: " + projectName);
+    }
+
+    std::vector<ProjectContainer> containers;
+    JsonLineScanner scanner(output);
+    JsonField fields[4];
+    while (scanner.next())
+    {
+        if (!scanner.fields({"ID", "Name", "Service", "State"}, fields))
+            continue;
+        ProjectContainer container;
+        container.id = fields[0].str();
+        container.name = fields[1].str();
+        container.service = fields[2].str();
+        container.state = Utils::str_to_lower(fields[3].str());
+        containers.push_back(container);
+    }
+    return containers;
+}
+
 std::vector<std::string> ProjectManager::getProjectServices(const std::string &projectName)
 {
     try
@@ -1411,13 +2614,13 @@ std::vector<std::string> ProjectManager::getProjectServices(const std::string &p
         if (success) {
             return services;
         } else {
-            broadcastLog("getProjectServices", message, "error");
+            broadcastLog("getProjectServices", message, "error", projectName);
             return {};
         }
     }
     catch (const std::exception &e)
     {
-        broadcastLog("getProjectServices", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("getProjectServices", "Exception: " + std::string(e.what()), "error", projectName);
         return {};
     }
 }
@@ -1426,14 +2629,12 @@ std::string ProjectManager::getProjectLogs(const std::string &projectName, const
 {
     try
     {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end())
+        ProjectInfo project;
+        if (!findProject(projectName, project))
         {
-            broadcastLog("getProjectLogs", "Project not found: " + projectName, "error");
+            broadcastLog("getProjectLogs", "Project not found: " + projectName, "error", projectName);
             return "Error: Project not found: " + projectName;
         }
-
-        const auto& project = it->second;
         
         // Build docker-compose logs command
         std::vector<std::string> args = {"compose", "-f", project.compose_file_path, "-p", projectName, "logs"};
@@ -1453,8 +2654,9 @@ std::string ProjectManager::getProjectLogs(const std::string &projectName, const
             "docker", 
             args, 
             {{"COMPOSE_PROJECT_NAME", projectName}}, 
-            [&logs](const std::string& line) {
-                logs += line + "\n";
+            [&logs](const std::string& output) {
+                // output arrives in chunks that already carry their newlines
+                logs += output;
             },
             project.working_directory
         );
@@ -1462,70 +2664,171 @@ std::string ProjectManager::getProjectLogs(const std::string &projectName, const
         if (ret_code == 0)
         {
             broadcastLog("getProjectLogs", "Successfully retrieved logs for project: " + projectName + 
-                         (serviceName.empty() ? "" : ", service: " + serviceName), "info");
+                         (serviceName.empty() ? "" : ", service: " + serviceName), "info", projectName);
             return logs;
         }
-        else
+        else
+        {
+            broadcastLog("getProjectLogs", "Failed to retrieve logs for project: " + projectName + 
+                         (serviceName.empty() ? "" : ", service: " + serviceName), "error", projectName);
+            return "Error retrieving logs for project: " + projectName + 
+                   (serviceName.empty() ? "" : ", service: " + serviceName);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        broadcastLog("getProjectLogs", "Exception: " + std::string(e.what()), "error", projectName);
+        return "Error retrieving logs: " + std::string(e.what());
+    }
+}
+
+std::vector<LogLine> ProjectManager::fetchProjectLogLines(const ProjectInfo &project, const std::string &serviceName,
+                                                         const std::vector<std::string> &extraArgs)
+{
+    std::vector<std::string> args = {"compose", "-f", project.compose_file_path, "-p", project.name,
+                                     "logs", "--timestamps", "--no-color"};
+    args.insert(args.end(), extraArgs.begin(), extraArgs.end());
+    if (!serviceName.empty())
+    {
+        args.push_back(serviceName);
+    }
+
+    std::vector<LogLine> lines;
+    std::string partial;
+    auto [pid, ret_code] = process_manager_->startProcessBlocking(
+        "docker",
+        args,
+        {{"COMPOSE_PROJECT_NAME", project.name}},
+        [&lines, &partial](const std::string &output)
+        {
+            partial += output;
+            size_t start = 0;
+            size_t newline;
+            while ((newline = partial.find('\n', start)) != std::string::npos)
+            {
+                lines.push_back(LogLine::parse(partial.substr(start, newline - start)));
+                start = newline + 1;
+            }
+            partial.erase(0, start);
+        },
+        project.working_directory);
+    if (ret_code != 0)
+    {
+        throw std::runtime_error("docker compose logs failed for project: " + project.name);
+    }
+    if (!partial.empty())
+    {
+        lines.push_back(LogLine::parse(partial));
+    }
+    return lines;
+}
+
+LogPage ProjectManager::queryProjectLogs(const std::string &projectName, const LogQuery &query)
+{
+    ProjectInfo project;
+    if (!findProject(projectName, project))
+    {
+        throw std::runtime_error("Project not found: " + projectName);
+    }
+
+    if (!query.backward)
+    {
+        // --since is inclusive, the cursor's own timestamp is refetched and skipped by selectLogPage
+        std::vector<std::string> args;
+        const LogPosition &lower = query.cursor.valid() ? query.cursor : query.since;
+        if (lower.valid())
+        {
+            args.insert(args.end(), {"--since", lower.rfc3339()});
+        }
+        if (query.until.valid())
+        {
+            args.insert(args.end(), {"--until", query.until.rfc3339()});
+        }
+        return selectLogPage(fetchProjectLogLines(project, query.service, args), query);
+    }
+
+    const LogPosition &upper = query.cursor.valid() ? query.cursor : query.until;
+    if (!upper.valid())
+    {
+        // the newest lines: --tail is per container, selectLogPage keeps the newest `limit` of them
+        LogPage page = selectLogPage(
+            fetchProjectLogLines(project, query.service, {"--tail", std::to_string(query.limit)}), query);
+        page.has_more = page.has_more || page.lines.size() == query.limit;
+        return page;
+    }
+
+    // docker applies --tail before --until, so older pages are read through growing --since windows
+    // ending at the cursor until the page is full or the start of the log is reached
+    static const int64_t WINDOWS[] = {60, 600, 3600, 6 * 3600, 24 * 3600, 7 * 24 * 3600, -1};
+    LogPage page;
+    for (int64_t window : WINDOWS)
+    {
+        std::vector<std::string> args = {"--until", upper.rfc3339()};
+        LogPosition lower = query.since;
+        bool reached_start = window < 0;
+        if (window >= 0 && (!lower.valid() || upper.seconds - window > lower.seconds))
+        {
+            lower = {std::max<int64_t>(0, upper.seconds - window), 0, 0};
+        }
+        else
+        {
+            reached_start = true;
+        }
+        if (lower.valid())
+        {
+            args.insert(args.end(), {"--since", lower.rfc3339()});
+        }
+
+        page = selectLogPage(fetchProjectLogLines(project, query.service, args), query);
+        if (page.has_more || page.lines.size() == query.limit || reached_start)
         {
-            broadcastLog("getProjectLogs", "Failed to retrieve logs for project: " + projectName + 
-                         (serviceName.empty() ? "" : ", service: " + serviceName), "error");
-            return "Error retrieving logs for project: " + projectName + 
-                   (serviceName.empty() ? "" : ", service: " + serviceName);
+            page.has_more = page.has_more || (page.lines.size() == query.limit && !reached_start);
+            break;
         }
     }
-    catch (const std::exception &e)
-    {
-        broadcastLog("getProjectLogs", "Exception: " + std::string(e.what()), "error");
-        return "Error retrieving logs: " + std::string(e.what());
-    }
+    return page;
 }
 
 bool ProjectManager::validateRequiredImages(const std::string &projectName)
 {
     try
     {
-        auto it = projects_.find(projectName);
-        if (it == projects_.end())
+        ProjectInfo project;
+        if (!findProject(projectName, project))
         {
             return false;
         }
 
-        const auto &requiredImages = it->second.required_images;
-        auto availableImages = listImages();
-
-        for (const auto &requiredImage : requiredImages)
+        auto model = getComposeModel(projectName);
+        const auto requiredImages = model->valid ? model->images() : project.required_images;
+        auto missingImages = image_index_->missing(requiredImages);
+        for (const auto &missingImage : missingImages)
         {
-            bool found = false;
-            auto _iter_found = std::find(availableImages.begin(), availableImages.end(), requiredImage);
-            found = (_iter_found != availableImages.end());
-            // for (const auto &availableImage : availableImages)
-            // {
-            //     if (availableImage.find(requiredImage) != std::string::npos)
-            //     {
-            //         found = true;
-            //         break;
-            //     }
-            // }
-            if (!found)
-            {
-                broadcastLog("validateRequiredImages", "Missing required image: " + requiredImage, "error");
-                return false;
-            }
+            broadcastLog("validateRequiredImages", "Missing required image: " + missingImage, "error", projectName);
+        }
+        if (!missingImages.empty())
+        {
+            return false;
         }
 
         return true;
     }
     catch (const std::exception &e)
     {
-        broadcastLog("validateRequiredImages", "Exception: " + std::string(e.what()), "error");
+        broadcastLog("validateRequiredImages", "Exception: " + std::string(e.what()), "error", projectName);
         return false;
     }
 }
 
 bool ProjectManager::createProjectArchive(const std::string &projectPath, const std::string &archivePath,
                                           const std::string &password,
-                                          std::function<void(const ProjectOperationProgress &)> progressCallback)
+                                          std::function<void(const ProjectOperationProgress &)> progressCallback,
+                                          const ProjectArchiveOptions &options, ProjectArchiveReport *report)
 {
+    const auto started = std::chrono::steady_clock::now();
+    ProjectArchiveReport localReport;
+    ProjectArchiveReport &summary = report ? *report : localReport;
+    summary.mode = options.mode;
 
     ProjectOperationProgress progress;
     progress.status = ProjectStatus::NOT_LOADED;
@@ -1538,6 +2841,10 @@ bool ProjectManager::createProjectArchive(const std::string &projectPath, const
         progressCallback(progress);
     }
 
+    // "fast" packs a staging copy of the project; removed on every way out once created here
+    const std::string stagingPath = archivePath + ".staging";
+    bool stagingCreated = false;
+
     try
     {
         // Validate source path
@@ -1550,12 +2857,125 @@ bool ProjectManager::createProjectArchive(const std::string &projectPath, const
             return false;
         }
 
-        progress.percentage = 20;
+        for (const auto &entry : fs::recursive_directory_iterator(projectPath))
+        {
+            if (entry.is_regular_file())
+            {
+                summary.source_bytes += entry.file_size();
+            }
+        }
+
+        // "fast": images compressed on their own next to the other files, then stored as they are
+        std::string packedPath = projectPath;
+        const bool fast = options.mode == "fast";
+        if (fast)
+        {
+            if (fs::exists(fs::symlink_status(stagingPath)))
+            {
+                // another archive of the same path being built, or one that crashed: not ours to delete
+                progress.status = ProjectStatus::ERROR;
+                progress.error_details = "Staging path " + stagingPath + " exists, remove it first if no archive is being created there";
+                if (progressCallback)
+                    progressCallback(progress);
+                return false;
+            }
+            ImageArchive::Compression compression = ImageArchive::fromName(options.image_compression);
+            if (!ImageArchive::canCompress(compression))
+            {
+                broadcastLog("createProjectArchive", "No " + ImageArchive::name(compression) + " encoder installed, using gzip", "warning");
+                compression = ImageArchive::Compression::Gzip;
+            }
+            summary.image_compression = ImageArchive::name(compression);
+
+            progress.percentage = 10;
+            progress.message = "Compressing Docker images with " + summary.image_compression + "...";
+            if (progressCallback)
+                progressCallback(progress);
+
+            const auto compressStarted = std::chrono::steady_clock::now();
+            if (!fs::create_directory(stagingPath))
+            {
+                throw std::runtime_error("Staging path " + stagingPath + " was created concurrently");
+            }
+            stagingCreated = true;
+            packedPath = stagingPath;
+            for (const auto &entry : fs::recursive_directory_iterator(projectPath))
+            {
+                const fs::path relative = fs::relative(entry.path(), projectPath);
+                const fs::path target = fs::path(stagingPath) / relative;
+                std::error_code ec;
+                if (entry.is_symlink())
+                {
+                    fs::copy_symlink(entry.path(), target, ec);
+                }
+                else if (entry.is_directory())
+                {
+                    fs::create_directories(target, ec);
+                }
+                else if (entry.path().extension() == ".tar")
+                {
+                    std::string output;
+                    if (!ImageArchive::compress(entry.path().string(), target.string() + ImageArchive::suffix(compression), compression, output))
+                    {
+                        throw std::runtime_error("Failed to compress " + relative.string() + ": " + output);
+                    }
+                    summary.images_compressed++;
+                }
+                else
+                {
+                    // the other files are only read while packing
+                    fs::create_hard_link(entry.path(), target, ec);
+                    if (ec)
+                    {
+                        fs::copy_file(entry.path(), target, fs::copy_options::overwrite_existing);
+                    }
+                }
+            }
+            summary.compress_images_ms = millisecondsSince(compressStarted);
+        }
+
+        progress.percentage = fast ? 60 : 20;
         progress.message = "Creating archive...";
         if (progressCallback)
             progressCallback(progress);
 
-        bool success = create7zArchive(projectPath, archivePath, password);
+        bool success = create7zArchive(packedPath, archivePath, password, fast ? 0 : 9);
+        summary.build_ms = millisecondsSince(started);
+
+        if (success)
+        {
+            std::error_code ec;
+            summary.archive_bytes = fs::file_size(archivePath, ec);
+        }
+        if (success && options.measure_load)
+        {
+            progress.percentage = 80;
+            progress.message = "Measuring load time...";
+            if (progressCallback)
+                progressCallback(progress);
+
+            const auto testStarted = std::chrono::steady_clock::now();
+            test7zArchive(archivePath, password);
+            summary.extract_ms = millisecondsSince(testStarted);
+            const auto decodeStarted = std::chrono::steady_clock::now();
+            for (const auto &imageFile : findDockerImageFiles(packedPath))
+            {
+                std::string output;
+                if (ImageArchive::compressionOf(imageFile) != ImageArchive::Compression::None)
+                {
+                    ImageArchive::decode(imageFile, output);
+                }
+            }
+            summary.decode_ms = millisecondsSince(decodeStarted);
+        }
+        if (stagingCreated)
+        {
+            std::error_code ec;
+            fs::remove_all(stagingPath, ec);
+        }
+        broadcastLog("createProjectArchive", "Archive " + archivePath + " (" + summary.mode + ", images: " + summary.image_compression
+            + "): " + std::to_string(summary.archive_bytes) + " of " + std::to_string(summary.source_bytes) + " bytes in "
+            + std::to_string(summary.build_ms) + " ms", success ? "info" : "error");
 
         if (success)
         {
@@ -1578,6 +2998,11 @@ bool ProjectManager::createProjectArchive(const std::string &projectPath, const
     }
     catch (const std::exception &e)
     {
+        if (stagingCreated)
+        {
+            std::error_code ec;
+            fs::remove_all(stagingPath, ec);
+        }
         progress.status = ProjectStatus::ERROR;
         progress.error_details = "Exception during archive creation: " + std::string(e.what());
         if (progressCallback)
@@ -1594,14 +3019,57 @@ void ProjectManager::setProjectsDirectory(const std::string &directory)
     fs::create_directories(projects_directory_);
 }
 
-void ProjectManager::setWebSocketConnections(std::vector<crow::websocket::connection *> *log_connections,
-                                             std::vector<crow::websocket::connection *> *progress_connections)
+void ProjectManager::setImageIndex(std::shared_ptr<ImageIndex> image_index)
+{
+    image_index_ = image_index;
+}
+
+void ProjectManager::setContentStore(std::shared_ptr<ContentStore> content_store)
+{
+    content_store_ = content_store;
+}
+
+void ProjectManager::setTrashReaper(std::shared_ptr<TrashReaper> trash)
+{
+    trash_ = trash;
+}
+
+void ProjectManager::setAdmissionControl(std::shared_ptr<AdmissionControl> admission)
+{
+    admission_ = admission;
+}
+
+crow::response ProjectManager::admitted(const char *lane, const std::function<crow::response()> &handler)
+{
+    return admission_ ? admission_->run(lane, handler) : handler();
+}
+
+void ProjectManager::setBlockingExecutor(std::shared_ptr<BlockingExecutor> blocking)
+{
+    blocking_ = blocking;
+    projects_version_.setExecutor(blocking_.get());
+}
+
+void ProjectManager::respondBlocking(const crow::request &req, crow::response &res, std::function<crow::response()> render)
+{
+    if (blocking_)
+    {
+        blocking_->respond(req, res, std::move(render));
+        return;
+    }
+    res = render();
+    res.end();
+}
+
+void ProjectManager::setWebSocketConnections(LogHub *log_hub,
+                                             LogHub *progress_hub)
 {
-    log_connections_ = log_connections;
-    progress_connections_ = progress_connections;
+    log_hub_ = log_hub;
+    progress_hub_ = progress_hub;
 }
 
-void ProjectManager::broadcastLog(const std::string &operation, const std::string &message, const std::string &level)
+void ProjectManager::broadcastLog(const std::string &operation, const std::string &message, const std::string &level,
+                                  const std::string &projectName)
 {
     // if (!log_connections_)
     //     return;
@@ -1634,61 +3102,42 @@ void ProjectManager::broadcastLog(const std::string &operation, const std::strin
     // }
 
 
-    if (!log_connections_) return;
-    
-    // Create JSON log message
-    crow::json::wvalue log_message;
-    log_message["type"] = "log";
-    log_message["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
-    log_message["operation"] = operation;
-    log_message["message"] = message;
-    log_message["level"] = level;
-    
-    std::string json_str = log_message.dump();
-    
-    // Broadcast to all connected log clients
-    for (auto it = log_connections_->begin(); it != log_connections_->end(); ) {
-        auto* conn = *it;
-        try {
-            conn->send_text(json_str);
-            ++it;
-        } catch (const std::exception& e) {
-            // Remove invalid connection
-            it = log_connections_->erase(it);
-        }
-    }
+    if (!log_hub_) return;
 
+    log_hub_->publish(projectName.empty() ? "project" : "project:" + projectName, operation, message, level);
 }
 
-void ProjectManager::broadcastProgress(const ProjectOperationProgress &progress)
+void ProjectManager::broadcastProgress(const ProjectOperationProgress &progress, const std::string &projectName)
 {
-    if (!progress_connections_)
+    if (!progress_hub_)
         return;
 
     try
     {
-        json11::Json progressMessage = json11::Json::object{
-            {"type", "progress"},
-            {"status", projectStatusToString(progress.status)},
-            {"percentage", progress.percentage},
-            {"message", progress.message},
-            {"operation", progress.current_operation},
-            {"error", progress.error_details},
-            {"timestamp", std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
-                                             std::chrono::system_clock::now().time_since_epoch())
-                                             .count())}};
-
-        std::string jsonStr = progressMessage.dump();
-
-        for (auto *conn : *progress_connections_)
+        LogHub::ProgressEvent event;
+        event.status = projectStatusToString(progress.status);
+        event.percentage = progress.percentage;
+        event.message = progress.message;
+        event.operation = progress.current_operation;
+        event.error = progress.error_details;
+        event.level = progress.status == ProjectStatus::ERROR ? "error" : "info";
+
+        auto renderJson = [&]()
         {
-            if (conn)
-            {
-                conn->send_text(jsonStr);
-            }
-        }
+            json11::Json progressMessage = json11::Json::object{
+                {"type", "progress"},
+                {"status", event.status},
+                {"percentage", progress.percentage},
+                {"message", progress.message},
+                {"operation", progress.current_operation},
+                {"error", progress.error_details},
+                {"timestamp", std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                 std::chrono::system_clock::now().time_since_epoch())
+                                                 .count())}};
+            return progressMessage.dump();
+        };
+
+        progress_hub_->publishProgress(projectName.empty() ? "project" : "project:" + projectName, event, renderJson);
     }
     catch (const std::exception &e)
     {
@@ -1708,7 +3157,7 @@ void ProjectManager::updateProgress(const std::string &projectName, ProjectStatu
     progress.error_details = error;
 
     project_progress_[projectName] = progress;
-    broadcastProgress(progress);
+    broadcastProgress(progress, projectName);
 }
 
 std::string ProjectManager::projectStatusToString(ProjectStatus status)
@@ -1795,93 +3244,165 @@ bool ProjectManager::isValidProjectName(const std::string &name)
 void ProjectManager::registerRestEndpoints(crow::SimpleApp &app)
 {
     // Analyze archive endpoint
-    CROW_ROUTE(app, "/api/projects/analyze").methods("POST"_method)([this](const crow::request &req)
+    CROW_ROUTE(app, "/api/projects/analyze").methods("POST"_method)([this](const crow::request &req, crow::response &res)
+    {
+        respondBlocking(req, res, [this, &req]()
+        {
+            return handleAnalyzeArchive(req);
+        });
+    });
+
+    // Local images no project refers to (garbage collection candidates)
+    CROW_ROUTE(app, "/api/projects/images/unreferenced").methods("GET"_method)([this](const crow::request &req, crow::response &res)
+    {
+        respondBlocking(req, res, [this]()
+        {
+            return handleGetUnreferencedImages();
+        });
+    });
+
+    // Content store usage endpoint
+    CROW_ROUTE(app, "/api/store").methods("GET"_method)([this](const crow::request &req, crow::response &res)
     {
-        return handleAnalyzeArchive(req);
+        respondBlocking(req, res, [this]() { return handleGetContentStore(); });
     });
 
     // Load project endpoint
-    CROW_ROUTE(app, "/api/projects/load").methods("POST"_method)([this](const crow::request &req)
+    CROW_ROUTE(app, "/api/projects/load").methods("POST"_method)([this](const crow::request &req, crow::response &res)
     {
-        return handleLoadProject(req);
+        respondBlocking(req, res, [this, &req]()
+        {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleLoadProject(req); });
+        });
     });
 
     // Unload project endpoint
-    CROW_ROUTE(app, "/api/projects/<string>/unload").methods("POST"_method)([this](const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>/unload").methods("POST"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleUnloadProject(projectName);
+        respondBlocking(req, res, [this, projectName]()
+        {
+            return handleUnloadProject(projectName);
+        });
     });
 
     // Remove project endpoint
-    CROW_ROUTE(app, "/api/projects/<string>/remove").methods("DELETE"_method)([this](const crow::request &req, const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>/remove").methods("DELETE"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
+    {
+        respondBlocking(req, res, [this, &req, projectName]()
+        {
+            return admitted(AdmissionControl::PROJECTS_LANE, [&]() { return handleRemoveProject(projectName, req); });
+        });
+    });
+
+    // Replace project by a newer archive, switching once the new version is ready
+    CROW_ROUTE(app, "/api/projects/<string>/reload").methods("POST"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
+    {
+        respondBlocking(req, res, [this, &req, projectName]()
+        {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleReloadProject(projectName, req); });
+        });
+    });
+
+    // Update project from a newer archive, only what changed
+    CROW_ROUTE(app, "/api/projects/<string>/update").methods("POST"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleRemoveProject(projectName, req);
+        respondBlocking(req, res, [this, &req, projectName]()
+        {
+            return admitted(AdmissionControl::HEAVY_LANE, [&]() { return handleUpdateProject(projectName, req); });
+        });
     });
 
     // Start project endpoint
-    CROW_ROUTE(app, "/api/projects/<string>/start").methods("POST"_method)([this](const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>/start").methods("POST"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleStartProject(projectName);
+        respondBlocking(req, res, [this, projectName]()
+        {
+            return admitted(AdmissionControl::PROJECTS_LANE, [&]() { return handleStartProject(projectName); });
+        });
     });
 
     // Stop project endpoint
-    CROW_ROUTE(app, "/api/projects/<string>/stop").methods("POST"_method)([this](const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>/stop").methods("POST"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleStopProject(projectName);
+        respondBlocking(req, res, [this, projectName]()
+        {
+            return admitted(AdmissionControl::PROJECTS_LANE, [&]() { return handleStopProject(projectName); });
+        });
     });
 
     // Restart project endpoint
-    CROW_ROUTE(app, "/api/projects/<string>/restart").methods("POST"_method)([this](const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>/restart").methods("POST"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleRestartProject(projectName);
+        respondBlocking(req, res, [this, projectName]()
+        {
+            return admitted(AdmissionControl::PROJECTS_LANE, [&]() { return handleRestartProject(projectName); });
+        });
     });
 
     // List projects endpoint
-    CROW_ROUTE(app, "/api/projects").methods("GET"_method)([this]()
+    CROW_ROUTE(app, "/api/projects").methods("GET"_method)([this](const crow::request &req, crow::response &res)
     {
-        return handleListProjects();
+        projects_version_.serve(req, res, [this]() { return handleListProjects(); });
     });
 
     // Get project info endpoint
-    CROW_ROUTE(app, "/api/projects/<string>").methods("GET"_method)([this](const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>").methods("GET"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleGetProjectInfo(projectName);
+        projects_version_.serve(req, res, [this, projectName]() { return handleGetProjectInfo(projectName); });
     });
 
     // Get project services endpoint
-    CROW_ROUTE(app, "/api/projects/<string>/services").methods("GET"_method)([this](const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>/services").methods("GET"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleGetProjectServices(projectName);
+        respondBlocking(req, res, [this, projectName]()
+        {
+            return handleGetProjectServices(projectName);
+        });
     });
 
     // Get project logs endpoint
-    CROW_ROUTE(app, "/api/projects/<string>/logs").methods("GET"_method)([this](const crow::request &req, const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>/logs").methods("GET"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleGetProjectLogs(projectName, req);
+        respondBlocking(req, res, [this, &req, projectName]()
+        {
+            return handleGetProjectLogs(projectName, req);
+        });
     });
 
     // Create project archive endpoint
-    CROW_ROUTE(app, "/api/projects/create-archive").methods("POST"_method)([this](const crow::request &req)
+    CROW_ROUTE(app, "/api/projects/create-archive").methods("POST"_method)([this](const crow::request &req, crow::response &res)
     {
-        return handleCreateProjectArchive(req);
+        respondBlocking(req, res, [this, &req]()
+        {
+            return handleCreateProjectArchive(req);
+        });
     });
 
     // Get project status endpoint
-    CROW_ROUTE(app, "/api/projects/<string>/status").methods("GET"_method)([this](const std::string &projectName)
+    CROW_ROUTE(app, "/api/projects/<string>/status").methods("GET"_method)([this](const crow::request &req, crow::response &res, const std::string &projectName)
     {
-        return handleGetProjectStatus(projectName);
+        respondBlocking(req, res, [this, projectName]()
+        {
+            return handleGetProjectStatus(projectName);
+        });
     });
 
     // Save browsing directory endpoint
-    CROW_ROUTE(app, "/api/settings/browsing-directory").methods("POST"_method)([this](const crow::request &req)
+    CROW_ROUTE(app, "/api/settings/browsing-directory").methods("POST"_method)([this](const crow::request &req, crow::response &res)
     {
-        return handleSaveBrowsingDirectory(req);
+        respondBlocking(req, res, [this, &req]()
+        {
+            return handleSaveBrowsingDirectory(req);
+        });
     });
 
     // Get browsing directory endpoint
-    CROW_ROUTE(app, "/api/settings/browsing-directory").methods("GET"_method)([this]()
+    CROW_ROUTE(app, "/api/settings/browsing-directory").methods("GET"_method)([this](const crow::request &req, crow::response &res)
     {
-        return handleGetBrowsingDirectory();
+        respondBlocking(req, res, [this]()
+        {
+            return handleGetBrowsingDirectory();
+        });
     });
 }
 
@@ -1900,9 +3421,20 @@ crow::response ProjectManager::handleAnalyzeArchive(const crow::request &req)
 
         std::string archivePath = json["archive_path"].string_value();
         std::string password = json["password"].string_value();
+        bool verify = json["verify"].is_bool() ? json["verify"].bool_value() : true;
 
-        ProjectArchiveInfo info = analyzeArchive(archivePath, password);
+        ProjectArchiveInfo info = analyzeArchive(archivePath, password, verify);
 
+        json11::Json::array services;
+        for (const auto &service : info.services)
+        {
+            services.push_back(json11::Json::object{
+                {"name", service.name},
+                {"image", service.image},
+                {"image_present", service.image_present},
+                {"ports", json11::Json::array(service.ports.begin(), service.ports.end())},
+                {"depends_on", json11::Json::array(service.depends_on.begin(), service.depends_on.end())}});
+        }
         json11::Json response = json11::Json::object{
             {"success", info.error_message.empty()},
             {"archive_path", info.archive_path},
@@ -1910,6 +3442,10 @@ crow::response ProjectManager::handleAnalyzeArchive(const crow::request &req)
             {"integrity_verified", info.integrity_verified},
             {"contained_files", json11::Json::array(info.contained_files.begin(), info.contained_files.end())},
             {"docker_images", json11::Json::array(info.docker_images.begin(), info.docker_images.end())},
+            {"compose_file", info.compose_file},
+            {"services", services},
+            {"missing_images", json11::Json::array(info.missing_images.begin(), info.missing_images.end())},
+            {"compose_error", info.compose_error},
             {"error_message", info.error_message}};
 
         crow::response res(200, response.dump());
@@ -1951,10 +3487,16 @@ crow::response ProjectManager::handleLoadProject(const crow::request &req)
             return res;
         }
 
+        std::string running;
+        auto operation = beginProjectOperation(projectName, "load", running);
+        if (!operation)
+        {
+            return projectBusyResponse(projectName, running);
+        }
         bool success = loadProject(archivePath, projectName, password,
-                                   [this](const ProjectOperationProgress &progress)
+                                   [this, projectName](const ProjectOperationProgress &progress)
                                    {
-                                       broadcastProgress(progress);
+                                       broadcastProgress(progress, projectName);
                                    });
 
         json11::Json response = json11::Json::object{
@@ -1980,6 +3522,12 @@ crow::response ProjectManager::handleUnloadProject(const std::string &projectNam
 {
     try
     {
+        std::string running;
+        auto operation = beginProjectOperation(projectName, "unload", running);
+        if (!operation)
+        {
+            return projectBusyResponse(projectName, running);
+        }
         bool success = unloadProject(projectName);
 
         json11::Json response = json11::Json::object{
@@ -2001,6 +3549,108 @@ crow::response ProjectManager::handleUnloadProject(const std::string &projectNam
     }
 }
 
+crow::response ProjectManager::handleReloadProject(const std::string &projectName, const crow::request &req)
+{
+    std::string parseError;
+    auto body = json11::Json::parse(req.body, parseError);
+    if (!body["archive_path"].is_string())
+    {
+        JsonWriter json;
+        json.beginObject().field("success", false).field("error", "Missing archive_path").endObject();
+        return json.response(400);
+    }
+    if (!hasProject(projectName))
+    {
+        JsonWriter json;
+        json.beginObject().field("success", false).field("error", "Project not found: " + projectName).endObject();
+        return json.response(404);
+    }
+
+    std::string running;
+    auto operation = beginProjectOperation(projectName, "reload", running);
+    if (!operation)
+    {
+        return projectBusyResponse(projectName, running);
+    }
+    ProjectReloadResult result = reloadProject(projectName, body["archive_path"].string_value(), body["password"].string_value(),
+                                               [this, projectName](const ProjectOperationProgress &progress)
+                                               {
+                                                   broadcastProgress(progress, projectName);
+                                               });
+
+    JsonWriter json;
+    json.beginObject()
+        .field("success", result.success)
+        .field("project_name", projectName);
+    if (!result.success)
+    {
+        json.field("error", result.error);
+    }
+    json.field("was_running", result.was_running)
+        .field("rolled_back", result.rolled_back)
+        .field("loaded_images", result.loaded_images)
+        .field("carried_over", result.carried_over)
+        .field("prepare_ms", result.prepare_ms)
+        .field("switch_ms", result.switch_ms)
+        .field("elapsed_ms", result.elapsed_ms)
+        .endObject();
+    return json.response(result.success ? 200 : 500);
+}
+
+crow::response ProjectManager::handleUpdateProject(const std::string &projectName, const crow::request &req)
+{
+    std::string parseError;
+    auto body = json11::Json::parse(req.body, parseError);
+    if (!body["archive_path"].is_string())
+    {
+        JsonWriter json;
+        json.beginObject().field("success", false).field("error", "Missing archive_path").endObject();
+        return json.response(400);
+    }
+    if (!hasProject(projectName))
+    {
+        JsonWriter json;
+        json.beginObject().field("success", false).field("error", "Project not found: " + projectName).endObject();
+        return json.response(404);
+    }
+
+    std::string running;
+    auto operation = beginProjectOperation(projectName, "update", running);
+    if (!operation)
+    {
+        return projectBusyResponse(projectName, running);
+    }
+    ProjectUpdateResult result = updateProject(projectName, body["archive_path"].string_value(), body["password"].string_value(),
+                                               [this, projectName](const ProjectOperationProgress &progress)
+                                               {
+                                                   broadcastProgress(progress, projectName);
+                                               });
+
+    JsonWriter json;
+    json.beginObject()
+        .field("success", result.success)
+        .field("project_name", projectName);
+    if (!result.success)
+    {
+        json.field("error", result.error)
+            .field("rolled_back", result.rolled_back)
+            .endObject();
+        return json.response(500);
+    }
+    json.field("had_manifest", result.had_manifest)
+        .field("added", result.added)
+        .field("changed", result.changed)
+        .field("removed", result.removed)
+        .field("unchanged", result.unchanged)
+        .field("loaded_images", result.loaded_images)
+        .field("recreated_services", result.recreated_services)
+        .field("removed_services", result.removed_services)
+        .field("compose_applied", result.compose_applied)
+        .field("elapsed_ms", result.elapsed_ms)
+        .endObject();
+    return json.response(200);
+}
+
 crow::response ProjectManager::handleRemoveProject(const std::string &projectName, const crow::request &req)
 {
     try
@@ -2009,6 +3659,12 @@ crow::response ProjectManager::handleRemoveProject(const std::string &projectNam
         auto json = json11::Json::parse(req.body, parseError);
         bool removeFiles = json["remove_files"].bool_value();
 
+        std::string running;
+        auto operation = beginProjectOperation(projectName, "remove", running);
+        if (!operation)
+        {
+            return projectBusyResponse(projectName, running);
+        }
         bool success = removeProject(projectName, removeFiles);
 
         json11::Json response = json11::Json::object{
@@ -2111,30 +3767,26 @@ crow::response ProjectManager::handleListProjects()
     {
         std::vector<ProjectInfo> projects = listProjects();
 
-        json11::Json::array projectsJson;
+        JsonWriter json(256 + projects.size() * 1024);
+        json.beginObject().field("success", true).key("projects").beginArray();
         for (const auto &project : projects)
         {
-            projectsJson.push_back(json11::Json::object{
-                {"name", project.name},
-                {"archive_path", project.archive_path},
-                {"extracted_path", project.extracted_path},
-                {"compose_file_path", project.compose_file_path},
-                {"is_loaded", project.is_loaded},
-                {"is_running", project.is_running},
-                {"status_message", project.status_message},
-                {"created_time", project.created_time},
-                {"last_modified", project.last_modified},
-                {"required_images", json11::Json::array(project.required_images.begin(), project.required_images.end())},
-                {"dependent_files", json11::Json::array(project.dependent_files.begin(), project.dependent_files.end())}});
+            json.beginObject()
+                .field("name", project.name)
+                .field("archive_path", project.archive_path)
+                .field("extracted_path", project.extracted_path)
+                .field("compose_file_path", project.compose_file_path)
+                .field("is_loaded", project.is_loaded)
+                .field("is_running", project.is_running)
+                .field("status_message", project.status_message)
+                .field("created_time", project.created_time)
+                .field("last_modified", project.last_modified)
+                .field("required_images", project.required_images)
+                .field("dependent_files", project.dependent_files)
+                .endObject();
         }
-
-        json11::Json response = json11::Json::object{
-            {"success", true},
-            {"projects", projectsJson}};
-
-        crow::response res(200, response.dump());
-        res.set_header("Content-Type", "application/json");
-        return res;
+        json.endArray().endObject();
+        return json.response(200);
     }
     catch (const std::exception &e)
     {
@@ -2224,13 +3876,82 @@ crow::response ProjectManager::handleGetProjectLogs(const std::string &projectNa
     try
     {
         std::string serviceName = req.url_params.get("service") ? req.url_params.get("service") : "";
-        std::string logs = getProjectLogs(projectName, serviceName);
 
+        const char *since = req.url_params.get("since");
+        const char *until = req.url_params.get("until");
+        const char *cursor = req.url_params.get("cursor");
+        const char *limit = req.url_params.get("limit");
+        const char *direction = req.url_params.get("direction");
+        if (!since && !until && !cursor && !limit && !direction)
+        {
+            std::string logs = getProjectLogs(projectName, serviceName);
+
+            json11::Json response = json11::Json::object{
+                {"success", true},
+                {"project_name", projectName},
+                {"service_name", serviceName},
+                {"logs", logs}};
+
+            crow::response res(200, response.dump());
+            res.set_header("Content-Type", "application/json");
+            return res;
+        }
+
+        // paged query: lines with since/until bounds, continued through cursors
+        LogQuery query;
+        query.service = serviceName;
+        std::string error;
+        if (since && (query.since.seconds = parseLogTimestamp(since, &query.since.nanos)) < 0)
+        {
+            error = "invalid since: " + std::string(since);
+        }
+        if (until && (query.until.seconds = parseLogTimestamp(until, &query.until.nanos)) < 0)
+        {
+            error = "invalid until: " + std::string(until);
+        }
+        if (cursor && !LogPosition::fromCursor(cursor, query.cursor))
+        {
+            error = "invalid cursor: " + std::string(cursor);
+        }
+        if (limit)
+        {
+            int value = std::atoi(limit);
+            if (value <= 0 || value > 5000)
+            {
+                error = "limit must be between 1 and 5000";
+            }
+            query.limit = static_cast<size_t>(std::max(value, 1));
+        }
+        if (direction && std::string(direction) != "forward" && std::string(direction) != "backward")
+        {
+            error = "direction must be forward or backward";
+        }
+        if (!error.empty())
+        {
+            json11::Json response = json11::Json::object{{"success", false}, {"error", error}};
+            crow::response res(400, response.dump());
+            res.set_header("Content-Type", "application/json");
+            return res;
+        }
+        // without a direction: continue forward from a cursor or since, otherwise the newest lines
+        query.backward = direction ? std::string(direction) == "backward" : !(query.cursor.valid() || query.since.valid());
+
+        LogPage page = queryProjectLogs(projectName, query);
+
+        json11::Json::array lines;
+        for (const auto &line : page.lines)
+        {
+            lines.push_back(line.toJson());
+        }
         json11::Json response = json11::Json::object{
             {"success", true},
             {"project_name", projectName},
             {"service_name", serviceName},
-            {"logs", logs}};
+            {"direction", query.backward ? "backward" : "forward"},
+            {"lines", lines},
+            {"has_more", page.has_more},
+            {"prev_cursor", page.before.valid() ? page.before.cursor() : ""},
+            {"next_cursor", page.after.valid() ? page.after.cursor() : ""}};
 
         crow::response res(200, response.dump());
         res.set_header("Content-Type", "application/json");
@@ -2264,15 +3985,50 @@ crow::response ProjectManager::handleCreateProjectArchive(const crow::request &r
         std::string archivePath = json["archive_path"].string_value();
         std::string password = json["password"].string_value();
 
+        ProjectArchiveOptions options;
+        if (json["mode"].is_string())
+        {
+            options.mode = json["mode"].string_value();
+        }
+        if (json["image_compression"].is_string())
+        {
+            options.image_compression = json["image_compression"].string_value();
+        }
+        options.measure_load = json["measure_load"].bool_value();
+        bool knownCompression = false;
+        ImageArchive::fromName(options.image_compression, &knownCompression);
+        if ((options.mode != "max" && options.mode != "fast") || !knownCompression)
+        {
+            crow::response res(400, "mode must be max or fast, image_compression zstd, gzip or xz");
+            res.set_header("Content-Type", "application/json");
+            return res;
+        }
+
+        ProjectArchiveReport report;
         bool success = createProjectArchive(projectPath, archivePath, password,
                                             [this](const ProjectOperationProgress &progress)
                                             {
                                                 broadcastProgress(progress);
-                                            });
-
+                                            },
+                                            options, &report);
+
+        json11::Json::object reportJson{
+            {"mode", report.mode},
+            {"image_compression", report.image_compression},
+            {"images_compressed", static_cast<int>(report.images_compressed)},
+            {"source_bytes", static_cast<double>(report.source_bytes)},
+            {"archive_bytes", static_cast<double>(report.archive_bytes)},
+            {"compress_images_ms", static_cast<double>(report.compress_images_ms)},
+            {"build_ms", static_cast<double>(report.build_ms)}};
+        if (options.measure_load)
+        {
+            reportJson["extract_ms"] = static_cast<double>(report.extract_ms);
+            reportJson["decode_ms"] = static_cast<double>(report.decode_ms);
+        }
         json11::Json response = json11::Json::object{
             {"success", success},
-            {"archive_path", archivePath}};
+            {"archive_path", archivePath},
+            {"report", reportJson}};
 
         crow::response res(success ? 200 : 500, response.dump());
         res.set_header("Content-Type", "application/json");
@@ -2386,3 +4142,67 @@ crow::response ProjectManager::handleGetBrowsingDirectory()
         return res;
     }
 }
+
+crow::response ProjectManager::handleGetContentStore()
+{
+    JsonWriter json;
+    json.beginObject()
+        .field("success", true)
+        .field("enabled", content_store_ != nullptr);
+    if (content_store_)
+    {
+        const ContentStore::Stats stats = content_store_->stats();
+        json.field("root", content_store_->root())
+            .field("min_size", content_store_->minSize())
+            .field("blobs", stats.blobs)
+            .field("bytes", stats.bytes)
+            .field("referenced_bytes", stats.referenced_bytes)
+            .field("saved_bytes", stats.referenced_bytes - std::min(stats.bytes, stats.referenced_bytes));
+    }
+    json.endObject();
+    return json.response(200);
+}
+
+crow::response ProjectManager::handleGetUnreferencedImages()
+{
+    try
+    {
+        std::vector<std::string> referencedImages;
+        for (const auto &[name, project] : projectsSnapshot())
+        {
+            // the compose file may have been edited since the project was loaded
+            auto model = getComposeModel(name);
+            const auto images = model->valid ? model->images() : project.required_images;
+            referencedImages.insert(referencedImages.end(), images.begin(), images.end());
+        }
+
+        json11::Json::array images;
+        for (const auto &image : image_index_->unreferenced(referencedImages))
+        {
+            images.push_back(json11::Json::object{
+                {"id", image.id},
+                {"repository", image.repository.empty() ? "<none>" : image.repository},
+                {"tag", image.tag.empty() ? "<none>" : image.tag},
+                {"size", image.size},
+                {"created", image.created},
+                {"canonical", image.canonical}});
+        }
+
+        json11::Json response = json11::Json::object{
+            {"success", true},
+            {"images", images}};
+
+        crow::response res(200, response.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+    catch (const std::exception &e)
+    {
+        json11::Json error = json11::Json::object{
+            {"success", false},
+            {"error", std::string(e.what())}};
+        crow::response res(500, error.dump());
+        res.set_header("Content-Type", "application/json");
+        return res;
+    }
+}
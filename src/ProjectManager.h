@@ -6,9 +6,19 @@
 #include <map>
 #include <memory>
 #include <functional>
+#include <shared_mutex>
 #include <crow.h>
 #include "ProcessManager.h"
 #include "MetaDatabase.h"
+#include "ComposeModel.h"
+#include "ImageIndex.h"
+#include "VersionedResource.h"
+#include "LogHub.h"
+#include "AdmissionControl.h"
+#include "BlockingExecutor.h"
+#include "ContainerLog.h"
+#include "ContentStore.h"
+#include "TrashReaper.h"
 #include "types.hpp"
 
 
@@ -21,7 +31,11 @@ public:
     ~ProjectManager();
 
     // Archive operations
-    ProjectArchiveInfo analyzeArchive(const std::string& archivePath, const std::string& password = "");
+    /**
+     * @brief lists an archive and reads its compose file (and `.env`) without extracting anything else
+     * @param verify test every entry of the archive first, which decompresses all of it
+     */
+    ProjectArchiveInfo analyzeArchive(const std::string& archivePath, const std::string& password = "", bool verify = true);
     // bool validateArchiveIntegrity(const std::string& archivePath, const std::string& password = "");
     bool extractArchive(const std::string& archivePath, const std::string& extractPath, 
                        const std::string& password = "", 
@@ -33,6 +47,32 @@ public:
                     std::function<void(const ProjectOperationProgress&)> progressCallback = nullptr);
     bool unloadProject(const std::string& projectName);
     bool removeProject(const std::string& projectName, bool removeFiles = false);
+    /**
+     * @brief replaces a loaded project's files with those of a newer archive, touching only what differs
+     *
+     * The archive's listing (sizes and CRCs) is compared with the manifest kept from the previous
+     * load or update: only added and changed entries are extracted, removed ones are deleted, only
+     * image tars that changed are loaded again and, if the project is running, compose recreates only
+     * the services whose definition, image or files changed. Nothing is touched when the new compose
+     * file is invalid. Files replaced or removed are kept in a backup directory next to the project
+     * until compose accepted the result; any failure after they were moved puts them back.
+     */
+    ProjectUpdateResult updateProject(const std::string& projectName, const std::string& archivePath,
+                                      const std::string& password = "",
+                                      std::function<void(const ProjectOperationProgress&)> progressCallback = nullptr);
+    /**
+     * @brief replaces a loaded project by a newer archive while the current version keeps running
+     *
+     * The archive is extracted into a sibling staging directory, its compose file validated and its
+     * changed image tars loaded while the current version keeps running. Only then are the services
+     * stopped, the files the project created itself moved (renamed, whoever owns them) into the new
+     * version, the two directories exchanged (renameat2 RENAME_EXCHANGE) and the services started
+     * again, so downtime is the containers' restart. Any failure moves those files back and restarts
+     * the current version; the previous tree is only deleted once the new version runs.
+     */
+    ProjectReloadResult reloadProject(const std::string& projectName, const std::string& archivePath,
+                                      const std::string& password = "",
+                                      std::function<void(const ProjectOperationProgress&)> progressCallback = nullptr);
     
     // Project operations
     bool startProject(const std::string& projectName);
@@ -43,8 +83,19 @@ public:
     // Information methods
     std::vector<ProjectInfo> listProjects();
     ProjectInfo getProjectInfo(const std::string& projectName);
+    std::vector<std::string> getProjectNames();
+    /**
+     * @brief containers of a project as `docker compose ps` reports them (running ones only)
+     * @throws std::runtime_error if the project is unknown or docker fails
+     */
+    std::vector<ProjectContainer> getProjectContainers(const std::string& projectName);
     std::vector<std::string> getProjectServices(const std::string& projectName);
     std::string getProjectLogs(const std::string& projectName, const std::string& serviceName = "");
+    /**
+     * @brief returns one page of a project's container logs, see LogQuery
+     * @throws std::runtime_error if the project is unknown or docker fails
+     */
+    LogPage queryProjectLogs(const std::string& projectName, const LogQuery& query);
 
     // Docker image management
     bool loadDockerImagesFromProject(const std::string& projectPath);
@@ -54,16 +105,38 @@ public:
     // Archive creation (for creating project archives)
     bool createProjectArchive(const std::string& projectPath, const std::string& archivePath, 
                              const std::string& password = "",
-                             std::function<void(const ProjectOperationProgress&)> progressCallback = nullptr);
+                             std::function<void(const ProjectOperationProgress&)> progressCallback = nullptr,
+                             const ProjectArchiveOptions& options = {}, ProjectArchiveReport* report = nullptr);
 
     // REST API registration
     void registerRestEndpoints(crow::SimpleApp& app);
 
     // WebSocket support
-    void setWebSocketConnections(std::vector<crow::websocket::connection*>* log_connections, 
-                                std::vector<crow::websocket::connection*>* progress_connections);
-    void broadcastLog(const std::string& operation, const std::string& message, const std::string& level = "info");
-    void broadcastProgress(const ProjectOperationProgress& progress);
+    void setWebSocketConnections(LogHub* log_hub, 
+                                LogHub* progress_hub);
+    /**
+     * @brief publishes a log line under topic `project:<projectName>`, or `project` when no project is given
+     */
+    void broadcastLog(const std::string& operation, const std::string& message, const std::string& level = "info",
+                      const std::string& projectName = "");
+    /**
+     * @brief publishes a progress update under the same topic as broadcastLog
+     */
+    void broadcastProgress(const ProjectOperationProgress& progress, const std::string& projectName = "");
+
+    // Shared local image index (see ImageIndex)
+    void setImageIndex(std::shared_ptr<ImageIndex> image_index);
+
+    // Concurrency limits of the slow endpoints (see AdmissionControl), none if not set
+    void setAdmissionControl(std::shared_ptr<AdmissionControl> admission);
+
+    // Threads the blocking endpoints run on instead of crow's io threads (see BlockingExecutor)
+    void setBlockingExecutor(std::shared_ptr<BlockingExecutor> blocking);
+
+    // Store sharing large files between projects (see ContentStore), files are extracted as they are if not set
+    void setContentStore(std::shared_ptr<ContentStore> content_store);
+    // Deletes removed project directories in the background (see TrashReaper), they are deleted in place if not set
+    void setTrashReaper(std::shared_ptr<TrashReaper> trash);
 
     // Configuration
     void setProjectsDirectory(const std::string& directory);
@@ -73,21 +146,77 @@ private:
     // Helper methods
     bool extract7zArchive(const std::string& archivePath, const std::string& extractPath, 
                          const std::string& password = "");
+    /**
+     * @param level 7z compression level, 0 stores the files as they are
+     */
     bool create7zArchive(const std::string& sourcePath, const std::string& archivePath, 
-                        const std::string& password = "");
+                        const std::string& password = "", int level = 9);
     bool test7zArchive(const std::string& archivePath, const std::string& password = "");
     std::vector<std::string> list7zContents(const std::string& archivePath, const std::string& password = "");
+    /**
+     * @brief sizes and CRCs of every entry, from `7z l -slt`
+     * @param ok set to false if 7z failed
+     */
+    ArchiveManifest list7zManifest(const std::string& archivePath, const std::string& password = "", bool* ok = nullptr);
+    /**
+     * @brief extracts only the given entries, keeping their paths
+     */
+    bool extract7zFiles(const std::string& archivePath, const std::string& extractPath, const std::string& password,
+                        const std::vector<std::string>& files);
+    /**
+     * @brief content of one entry, decompressed to memory with `7z e -so`
+     * @param ok set to false if 7z failed
+     */
+    std::string read7zFile(const std::string& archivePath, const std::string& password, const std::string& file, bool* ok = nullptr);
+    /**
+     * @brief SHA-256 of one entry, streamed out of `7z e -so` without keeping or writing it
+     * @return hex digest, empty if 7z failed
+     */
+    std::string hash7zFile(const std::string& archivePath, const std::string& password, const std::string& file);
     
     // Docker Compose analysis
     // std::vector<std::string> parseDockerComposeImages(const std::string& composeContent);
-    std::vector<std::string> parseDockerComposeDependentFiles(const std::string& composeContent, 
-                                                              const std::string& basePath);
-    std::tuple<bool, std::vector<std::string>> validateDockerComposeFile(const std::string& composeFilePath, std::vector<std::string>& _list_images);
+    std::tuple<bool, std::vector<std::string>> validateDockerComposeFile(const ComposeModel& composeModel, std::vector<std::string>& _list_images);
+    /**
+     * @brief returns the compiled compose model of a project, re-parsing only if the file changed on disk
+     * @param projectName name of project
+     * @param composeFilePath compose file, defaults to the project's compose_file_path
+     */
+    std::shared_ptr<const ComposeModel> getComposeModel(const std::string& projectName, const std::string& composeFilePath = "");
     
     // Project directory management
     std::string createProjectDirectory(const std::string& projectName);
     bool cleanupProjectDirectory(const std::string& projectName);
+    // removes a directory containers may have written root owned files to
+    bool removeDirectory(const std::string& path);
     std::string getProjectPath(const std::string& projectName);
+
+    // Access to projects_ under projects_mutex_. Entries are copied out so that no lock or
+    // iterator is held while docker or 7z runs.
+    bool findProject(const std::string& projectName, ProjectInfo& project) const;
+    bool hasProject(const std::string& projectName) const;
+    std::map<std::string, ProjectInfo> projectsSnapshot() const;
+    /**
+     * @brief runs update on the project's entry under the exclusive lock
+     * @return false if the project is unknown
+     */
+    bool modifyProject(const std::string& projectName, const std::function<void(ProjectInfo&)>& update);
+    void putProject(const ProjectInfo& project);
+    bool eraseProject(const std::string& projectName);
+    bool saveProjects();
+
+    /**
+     * @brief marks a project busy while load, unload, remove, reload or update runs on it; these
+     * share staging paths and rewrite the project's files, so a second one is rejected
+     * @param running set to the operation already running when the project is busy
+     * @return handle (holding the project name) ending the operation when released, null if the project is busy
+     */
+    std::shared_ptr<const std::string> beginProjectOperation(const std::string& projectName, const std::string& operation, std::string& running);
+    crow::response projectBusyResponse(const std::string& projectName, const std::string& running);
+
+    // runs `docker compose logs --timestamps` with extraArgs and parses its lines
+    std::vector<LogLine> fetchProjectLogLines(const ProjectInfo& project, const std::string& serviceName,
+                                              const std::vector<std::string>& extraArgs);
     
     // Progress tracking
     void updateProgress(const std::string& projectName, ProjectStatus status, int percentage, 
@@ -99,10 +228,14 @@ private:
     crow::response handleLoadProject(const crow::request& req);
     crow::response handleUnloadProject(const std::string& projectName);
     crow::response handleRemoveProject(const std::string& projectName, const crow::request& req);
+    crow::response handleUpdateProject(const std::string& projectName, const crow::request& req);
+    crow::response handleReloadProject(const std::string& projectName, const crow::request& req);
     crow::response handleStartProject(const std::string& projectName);
     crow::response handleStopProject(const std::string& projectName);
     crow::response handleRestartProject(const std::string& projectName);
     crow::response handleListProjects();
+    crow::response admitted(const char *lane, const std::function<crow::response()> &handler);
+    void respondBlocking(const crow::request &req, crow::response &res, std::function<crow::response()> render);
     crow::response handleGetProjectInfo(const std::string& projectName);
     crow::response handleGetProjectServices(const std::string& projectName);
     crow::response handleGetProjectLogs(const std::string& projectName, const crow::request& req);
@@ -110,36 +243,60 @@ private:
     crow::response handleGetProjectStatus(const std::string& projectName);
     crow::response handleSaveBrowsingDirectory(const crow::request& req);
     crow::response handleGetBrowsingDirectory();
+    crow::response handleGetUnreferencedImages();
+    crow::response handleGetContentStore();
     
     std::unique_ptr<ProcessManager> process_manager_;
     std::unique_ptr<MetaDatabase> database_;
+    ComposeModelCache compose_models_;
+    std::shared_ptr<ImageIndex> image_index_;
+    std::shared_ptr<AdmissionControl> admission_;
+    std::shared_ptr<BlockingExecutor> blocking_;
+    std::shared_ptr<ContentStore> content_store_;
+    std::shared_ptr<TrashReaper> trash_;
     
     // Member variables
+    // read by the REST handlers, the projects_version_ probe and the resource monitor's sampling
+    // thread; guarded by projects_mutex_, use the accessors above
     std::map<std::string, ProjectInfo> projects_;
+    mutable std::shared_mutex projects_mutex_;
+    std::map<std::string, std::string> project_operations_;    // project -> operation running on it
+    std::mutex project_operations_mutex_;
     std::map<std::string, ProjectOperationProgress> project_progress_;
     std::string projects_directory_;
     // std::string temp_directory_;
     
     // WebSocket connections
-    std::vector<crow::websocket::connection*>* log_connections_{nullptr};
-    std::vector<crow::websocket::connection*>* progress_connections_{nullptr};
+    LogHub* log_hub_{nullptr};
+    LogHub* progress_hub_{nullptr};
+
+    // Version of the project list/details, for ETag and long-poll GETs. Declared last so its
+    // watcher thread is stopped before the members its probe reads are destroyed.
+    VersionedResource projects_version_;
     
     // Docker methods
-    bool loadImageFromFile(const std::string& filePath);
+    /**
+     * @param loadedImages if given, receives the references `docker load` reports
+     */
+    bool loadImageFromFile(const std::string& filePath, std::vector<std::string>* loadedImages = nullptr);
     // bool loadComposeFile(const std::string& composeFilePath, const std::string& projectName, const std::string& workingDir);
     // bool removeComposeProject(const std::string& projectName);
     /**
      * @brief starts project
      * @param projectName name of project
-     * @param detached indicated to use '-d' in commandline
+     * @param extraArgs appended after `up -d`, e.g. options and service names
      * @return a tuple of bool and std::string containing success of running project and output string of docker compose command
      */
-    std::tuple<bool, std::string> composeUp(const std::string& projectName);
+    std::tuple<bool, std::string> composeUp(const std::string& projectName, const std::vector<std::string>& extraArgs = {});
     std::tuple<bool, std::string> composeDown(const std::string& projectName, bool removeVolumes = false);
     std::tuple<bool, std::string> composeRestart(const std::string& projectName);
     std::tuple<bool, std::string> composeSatus(const std::string& projectName);
     std::tuple<bool, std::string, std::vector<std::string>> composeServices(const std::string& projectName);
-    std::vector<std::string> listImages();
+    /**
+     * @brief running and total containers of every project, used to notice containers started/stopped
+     * outside MetaInstaller; one `docker ps` for all projects
+     */
+    std::string projectsFingerprint();
     
     // Utility methods
     static std::string projectStatusToString(ProjectStatus status);
@@ -0,0 +1,259 @@
+#include "ResourceMonitor.h"
+#include "ProjectManager.h"
+#include <set>
+
+namespace {
+
+int64_t nowMilliseconds()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+crow::response jsonResponse(int code, const json11::Json& body)
+{
+    crow::response res(code, body.dump());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+} // namespace
+
+ResourceMonitor::ResourceMonitor(ProjectManager& projects, std::chrono::milliseconds interval, const std::string& cgroupRoot)
+    : projects_(projects)
+    , interval_(interval)
+    , sampler_(cgroupRoot)
+{
+    if (interval_.count() > 0) {
+        sampler_thread_ = std::thread(&ResourceMonitor::sampleLoop, this);
+    }
+}
+
+ResourceMonitor::~ResourceMonitor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (sampler_thread_.joinable()) {
+        sampler_thread_.join();
+    }
+}
+
+void ResourceMonitor::setLogHub(LogHub* log_hub)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_hub_ = log_hub;
+}
+
+void ResourceMonitor::setMetricsStore(MetricsStore* metrics)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_ = metrics;
+}
+
+void ResourceMonitor::registerRestEndpoints(crow::SimpleApp& app)
+{
+    CROW_ROUTE(app, "/api/resources").methods("GET"_method)([this]()
+    {
+        return handleGetResources();
+    });
+
+    CROW_ROUTE(app, "/api/projects/<string>/resources").methods("GET"_method)([this](const std::string &projectName)
+    {
+        return handleGetProjectResources(projectName);
+    });
+}
+
+void ResourceMonitor::refresh(const std::string& projectName, Tracked& tracked)
+{
+    for (const auto& [service, id] : tracked.containers) {
+        sampler_.untrack(id);
+    }
+    tracked.containers.clear();
+    tracked.missing = 0;
+    tracked.samples_since_refresh = 0;
+    tracked.stale = false;
+
+    for (const auto& container : projects_.getProjectContainers(projectName)) {
+        if (container.state != "running") {
+            continue;
+        }
+        const std::string path = sampler_.findContainerCgroup(container.id);
+        if (path.empty() || !sampler_.track(container.id, path)) {
+            tracked.missing++;
+            continue;
+        }
+        tracked.containers.emplace_back(container.service, container.id);
+    }
+}
+
+void ResourceMonitor::sampleNow()
+{
+    std::lock_guard<std::mutex> sample_lock(sample_mutex_);
+
+    const std::vector<std::string> names = projects_.getProjectNames();
+    const std::set<std::string> loaded(names.begin(), names.end());
+    for (auto it = tracked_.begin(); it != tracked_.end(); ) {
+        if (loaded.count(it->first)) {
+            ++it;
+            continue;
+        }
+        for (const auto& [service, id] : it->second.containers) {
+            sampler_.untrack(id);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            latest_.erase(it->first);
+            if (metrics_) {
+                metrics_->removeProject(it->first);
+            }
+        }
+        it = tracked_.erase(it);
+    }
+
+    for (const std::string& name : names) {
+        Tracked& tracked = tracked_[name];
+        try {
+            if (tracked.stale || ++tracked.samples_since_refresh >= REFRESH_SAMPLES) {
+                refresh(name, tracked);
+            }
+        } catch (const std::exception& e) {
+            crow::logger(crow::LogLevel::Debug) << "Resource monitor could not list containers of " << name << ": " << e.what();
+            tracked.stale = true;
+            continue;
+        }
+
+        std::vector<ContainerSample> containers;
+        for (const auto& [service, id] : tracked.containers) {
+            ContainerSample sample{service, id, {}};
+            if (sampler_.read(id, sample.usage)) {
+                containers.push_back(sample);
+            } else {
+                // the container stopped or was recreated, find the project's containers again next time
+                tracked.stale = true;
+            }
+        }
+
+        json11::Json summary = summarize(name, containers, tracked.missing);
+        LogHub* log_hub = nullptr;
+        MetricsStore* metrics = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            latest_[name] = summary;
+            log_hub = log_hub_;
+            metrics = metrics_;
+        }
+        if (metrics) {
+            recordMetrics(*metrics, summary, static_cast<int64_t>(summary["timestamp"].number_value() / 1000));
+        }
+        if (log_hub) {
+            log_hub->publish("resources:" + name, "resource_usage", summary.dump(), "info");
+        }
+    }
+}
+
+json11::Json ResourceMonitor::summarize(const std::string& projectName, const std::vector<ContainerSample>& containers,
+                                        size_t missing)
+{
+    CgroupUsage total;
+    std::map<std::string, CgroupUsage> services;
+    std::map<std::string, int> service_containers;
+    json11::Json::array container_list;
+    for (const auto& sample : containers) {
+        total.add(sample.usage);
+        services[sample.service].add(sample.usage);
+        service_containers[sample.service]++;
+        json11::Json::object entry = sample.usage.toJson().object_items();
+        entry["service"] = sample.service;
+        entry["container_id"] = sample.container.substr(0, 12);
+        container_list.push_back(entry);
+    }
+
+    json11::Json::object service_list;
+    for (const auto& [service, usage] : services) {
+        json11::Json::object entry = usage.toJson().object_items();
+        entry["containers"] = service_containers[service];
+        service_list[service] = entry;
+    }
+
+    return json11::Json::object{
+        {"project_name", projectName},
+        {"timestamp", static_cast<double>(nowMilliseconds())},
+        {"running_containers", static_cast<int>(containers.size() + missing)},
+        {"unavailable_containers", static_cast<int>(missing)},
+        {"total", total.toJson()},
+        {"services", service_list},
+        {"containers", container_list}};
+}
+
+void ResourceMonitor::recordMetrics(MetricsStore& metrics, const json11::Json& summary, int64_t timestamp)
+{
+    static const char* const METRICS[] = {"cpu_percent", "memory_bytes", "io_read_bytes_per_sec", "io_write_bytes_per_sec"};
+    const std::string project = summary["project_name"].string_value();
+    for (const char* metric : METRICS) {
+        metrics.record(project, "", metric, timestamp, summary["total"][metric].number_value());
+    }
+    metrics.record(project, "", "containers", timestamp, summary["running_containers"].number_value());
+    for (const auto& [service, usage] : summary["services"].object_items()) {
+        for (const char* metric : METRICS) {
+            metrics.record(project, service, metric, timestamp, usage[metric].number_value());
+        }
+        metrics.record(project, service, "containers", timestamp, usage["containers"].number_value());
+    }
+}
+
+json11::Json ResourceMonitor::latest(const std::string& projectName)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = latest_.find(projectName);
+    return it != latest_.end() ? it->second : json11::Json();
+}
+
+void ResourceMonitor::sampleLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        lock.unlock();
+        try {
+            sampleNow();
+        } catch (const std::exception& e) {
+            crow::logger(crow::LogLevel::Warning) << "Resource sampling failed: " << e.what();
+        }
+        lock.lock();
+        cv_.wait_for(lock, interval_, [this]() { return stopping_; });
+    }
+}
+
+crow::response ResourceMonitor::handleGetProjectResources(const std::string& projectName)
+{
+    if (projects_.getProjectInfo(projectName).compose_file_path.empty()) {
+        return jsonResponse(404, json11::Json::object{
+            {"success", false},
+            {"error", "Project not found: " + projectName}});
+    }
+    json11::Json sample = latest(projectName);
+    return jsonResponse(200, json11::Json::object{
+        {"success", true},
+        {"project_name", projectName},
+        {"interval_ms", static_cast<double>(interval_.count())},
+        {"sampled", !sample.is_null()},
+        {"resources", sample}});
+}
+
+crow::response ResourceMonitor::handleGetResources()
+{
+    json11::Json::object projects;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [name, sample] : latest_) {
+            projects[name] = sample;
+        }
+    }
+    return jsonResponse(200, json11::Json::object{
+        {"success", true},
+        {"interval_ms", static_cast<double>(interval_.count())},
+        {"projects", projects}});
+}
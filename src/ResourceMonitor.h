@@ -0,0 +1,102 @@
+#ifndef RESOURCEMONITOR_H
+#define RESOURCEMONITOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <crow.h>
+#include "CgroupSampler.h"
+#include "LogHub.h"
+#include "MetricsStore.h"
+#include "json11.hpp"
+
+class ProjectManager;
+
+/**
+ * @brief Samples CPU, memory and I/O usage of every loaded project's containers from their cgroups.
+ *
+ * Every interval the containers of each project are read through a CgroupSampler and summed per
+ * service and per project. Which containers a project has (`docker compose ps`) is only asked again
+ * every REFRESH_SAMPLES samples, or sooner when a container's cgroup went away. The latest sample of
+ * each project is served at GET /api/projects/<name>/resources and GET /api/resources, and
+ * published on the log hub under topic `resources:<name>` as a `resource_usage` line whose message
+ * is the sample's JSON. Those topics are opt-in: only connections subscribed to them receive them.
+ * With a MetricsStore set, each sample is also recorded as history (see recordMetrics).
+ */
+class ResourceMonitor {
+public:
+    static constexpr size_t REFRESH_SAMPLES = 12;
+
+    struct ContainerSample {
+        std::string service;
+        std::string container;
+        CgroupUsage usage;
+    };
+
+    /**
+     * @param interval time between samples, 0 to only sample on sampleNow()
+     * @param cgroupRoot mount point of the cgroup v2 hierarchy
+     */
+    ResourceMonitor(ProjectManager& projects, std::chrono::milliseconds interval,
+                    const std::string& cgroupRoot = "/sys/fs/cgroup");
+    ~ResourceMonitor();
+
+    void setLogHub(LogHub* log_hub);
+    void setMetricsStore(MetricsStore* metrics);
+    void registerRestEndpoints(crow::SimpleApp& app);
+
+    /**
+     * @brief samples every loaded project once
+     */
+    void sampleNow();
+
+    /**
+     * @brief latest sample of a project, null if it was not sampled yet
+     */
+    json11::Json latest(const std::string& projectName);
+
+    /**
+     * @brief sums container samples into the per service and per project totals of one sample
+     */
+    static json11::Json summarize(const std::string& projectName, const std::vector<ContainerSample>& containers,
+                                  size_t missing);
+
+    /**
+     * @brief records a summary as cpu_percent, memory_bytes, io_read_bytes_per_sec,
+     * io_write_bytes_per_sec and containers, per service and for the project (empty service)
+     */
+    static void recordMetrics(MetricsStore& metrics, const json11::Json& summary, int64_t timestamp);
+
+private:
+    struct Tracked {
+        std::vector<std::pair<std::string, std::string>> containers;   // (service, container id)
+        size_t missing = 0;                                             // running containers without a cgroup
+        size_t samples_since_refresh = 0;
+        bool stale = true;
+    };
+
+    void refresh(const std::string& projectName, Tracked& tracked);
+    void sampleLoop();
+    crow::response handleGetProjectResources(const std::string& projectName);
+    crow::response handleGetResources();
+
+    ProjectManager& projects_;
+    std::chrono::milliseconds interval_;
+    CgroupSampler sampler_;
+    std::map<std::string, Tracked> tracked_;     // only touched by the sampling pass
+    std::mutex sample_mutex_;                    // one sampling pass at a time
+
+    std::mutex mutex_;
+    std::map<std::string, json11::Json> latest_;
+    LogHub* log_hub_{nullptr};
+    MetricsStore* metrics_{nullptr};
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread sampler_thread_;
+};
+
+#endif // RESOURCEMONITOR_H
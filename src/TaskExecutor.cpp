@@ -0,0 +1,71 @@
+#include "TaskExecutor.h"
+#include <crow.h>
+
+TaskExecutor::TaskExecutor(const std::string& name, size_t workers, size_t maxQueued)
+    : name_(name)
+    , max_queued_(maxQueued)
+{
+    if (workers == 0) {
+        workers = 1;
+    }
+    for (size_t i = 0; i < workers; i++) {
+        threads_.emplace_back(&TaskExecutor::work, this);
+    }
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        // queued tasks are dropped, their futures report broken_promise
+        queue_.clear();
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+bool TaskExecutor::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || (max_queued_ > 0 && queue_.size() >= max_queued_)) {
+            return false;
+        }
+        queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+    return true;
+}
+
+size_t TaskExecutor::queued()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void TaskExecutor::work()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        try {
+            task();
+        } catch (const std::exception& e) {
+            // packaged_task stores exceptions in the future, this only catches bugs in the executor itself
+            crow::logger(crow::LogLevel::Error) << "executor '" << name_ << "' task failed: " << e.what();
+        }
+    }
+}
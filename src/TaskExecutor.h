@@ -0,0 +1,68 @@
+#ifndef TASKEXECUTOR_H
+#define TASKEXECUTOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed size thread pool with a bounded queue.
+ *
+ * Used to run slow, mostly subprocess bound work (docker/systemctl queries) concurrently without
+ * letting the number of threads or queued tasks grow with the number of requests.
+ */
+class TaskExecutor {
+public:
+    /**
+     * @param name used in log lines
+     * @param workers number of worker threads
+     * @param maxQueued tasks waiting for a worker before submit() refuses new ones, 0 for unbounded
+     */
+    TaskExecutor(const std::string& name, size_t workers, size_t maxQueued = 0);
+    ~TaskExecutor();
+
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    /**
+     * @brief queues fn and returns a future of its result
+     * @throws std::runtime_error if the queue is full or the executor is stopping
+     */
+    template <typename F>
+    auto submit(F&& fn) -> std::future<typename std::invoke_result<F>::type>
+    {
+        using Result = typename std::invoke_result<F>::type;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+        std::future<Result> future = task->get_future();
+        if (!enqueue([task]() { (*task)(); })) {
+            throw std::runtime_error("executor '" + name_ + "' is full or stopping");
+        }
+        return future;
+    }
+
+    size_t workers() const { return threads_.size(); }
+    size_t queued();
+
+private:
+    bool enqueue(std::function<void()> task);
+    void work();
+
+    std::string name_;
+    size_t max_queued_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    bool stopping_{false};
+    std::vector<std::thread> threads_;
+};
+
+#endif // TASKEXECUTOR_H
@@ -0,0 +1,276 @@
+#include "TrashReaper.h"
+#include "JsonWriter.h"
+#include "ProcessManager.h"
+#include "dotenv.hpp"
+#include "utils.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// deletion only gets the disk when nothing else wants it (see ioprio_set(2))
+void setIdleIoPriority()
+{
+#ifdef SYS_ioprio_set
+    constexpr int IOPRIO_WHO_PROCESS = 1;
+    constexpr int IOPRIO_CLASS_IDLE = 3;
+    constexpr int IOPRIO_CLASS_SHIFT = 13;
+    ::syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+#endif
+}
+
+long long millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+TrashReaper::TrashReaper(const std::string& trashDirectory, size_t workers)
+    : trash_directory_(trashDirectory)
+    , workers_(std::max<size_t>(workers, 1))
+{
+    std::error_code ec;
+    fs::create_directories(trash_directory_, ec);
+    for (const auto& entry : fs::directory_iterator(trash_directory_, ec)) {
+        auto item = std::make_shared<Item>();
+        item->name = entry.path().filename().string();
+        item->queued_at = std::chrono::steady_clock::now();
+        queue_.push_back(item);
+    }
+    if (!queue_.empty()) {
+        crow::logger(crow::LogLevel::Info) << "Trash: " << queue_.size() << " trees left from a previous run, deleting them";
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+TrashReaper::~TrashReaper()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool TrashReaper::discard(const std::string& path)
+{
+    const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    auto item = std::make_shared<Item>();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        item->name = fs::path(path).filename().string() + "." + std::to_string(now) + "." + std::to_string(counter_++);
+    }
+    item->original_path = path;
+    const std::string target = Utils::path_join_multiple({trash_directory_, item->name});
+    if (::rename(path.c_str(), target.c_str()) != 0) {
+        if (errno != ENOENT) {
+            crow::logger(crow::LogLevel::Warning) << "Trash: cannot move " << path << " to " << target << ": " << std::strerror(errno);
+        }
+        return false;
+    }
+    item->queued_at = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(item);
+    }
+    cv_.notify_all();
+    return true;
+}
+
+bool TrashReaper::waitIdle(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return idle_cv_.wait_for(lock, timeout, [this]() { return queue_.empty(); });
+}
+
+void TrashReaper::run()
+{
+    setIdleIoPriority();
+    for (;;) {
+        std::shared_ptr<Item> item;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            item = queue_.front();
+            item->deleting = true;
+        }
+
+        const auto started = std::chrono::steady_clock::now();
+        const std::string path = Utils::path_join_multiple({trash_directory_, item->name});
+        bool done = reap(*item);
+        if (stopping_) {
+            return;     // the rest is deleted on the next start
+        }
+        if (!done) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                item->privileged = true;
+            }
+            done = reapPrivileged(path);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.pop_front();
+        if (done) {
+            reaped_++;
+            crow::logger(crow::LogLevel::Info) << "Trash: deleted " << (item->original_path.empty() ? item->name : item->original_path)
+                                               << " (" << item->files_removed << " files, " << item->directories_removed
+                                               << " directories) in " << millisecondsSince(started) << " ms";
+        } else {
+            failed_++;
+            crow::logger(crow::LogLevel::Warning) << "Trash: failed to delete " << path << ", retried on next start";
+        }
+        idle_cv_.notify_all();
+    }
+}
+
+bool TrashReaper::reap(Item& item)
+{
+    const std::string root = Utils::path_join_multiple({trash_directory_, item.name});
+    struct stat st;
+    if (::lstat(root.c_str(), &st) != 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        return ::unlink(root.c_str()) == 0;
+    }
+
+    // directories still to be read, shared by the workers; all directories seen, removed at the end
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> pending{root};
+    std::vector<std::string> directories{root};
+    size_t busy = 0;
+
+    auto work = [&]() {
+        setIdleIoPriority();
+        for (;;) {
+            std::string directory;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return !pending.empty() || busy == 0 || stopping_; });
+                if (pending.empty() || stopping_) {
+                    cv.notify_all();
+                    return;
+                }
+                directory = std::move(pending.front());
+                pending.pop_front();
+                busy++;
+            }
+
+            std::vector<std::string> subdirectories;
+            const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            DIR* dir = fd < 0 ? nullptr : ::fdopendir(fd);
+            if (dir) {
+                while (struct dirent* entry = ::readdir(dir)) {
+                    const char* name = entry->d_name;
+                    if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0) {
+                        continue;
+                    }
+                    bool is_directory = entry->d_type == DT_DIR;
+                    if (entry->d_type == DT_UNKNOWN) {
+                        struct stat entry_stat;
+                        is_directory = ::fstatat(fd, name, &entry_stat, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(entry_stat.st_mode);
+                    }
+                    if (is_directory) {
+                        subdirectories.push_back(directory + "/" + name);
+                    } else if (::unlinkat(fd, name, 0) == 0) {
+                        item.files_removed++;
+                    }
+                }
+                ::closedir(dir);
+            } else if (fd >= 0) {
+                ::close(fd);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& subdirectory : subdirectories) {
+                directories.push_back(subdirectory);
+                pending.push_back(std::move(subdirectory));
+            }
+            busy--;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers_; i++) {
+        threads.emplace_back(work);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (stopping_) {
+        return false;
+    }
+
+    // a directory's path is longer than its parent's, so this removes children first
+    std::sort(directories.begin(), directories.end(), [](const std::string& a, const std::string& b) { return a.size() > b.size(); });
+    for (const auto& directory : directories) {
+        if (::rmdir(directory.c_str()) == 0) {
+            item.directories_removed++;
+        }
+    }
+    return ::access(root.c_str(), F_OK) != 0;
+}
+
+bool TrashReaper::reapPrivileged(const std::string& path)
+{
+    crow::logger(crow::LogLevel::Info) << "Trash: " << path << " holds files the server may not delete, using sudo rm";
+    EnvParser _env;
+    _env.load_env_file(CONST_FILE_ENV_SECRET_PRIVATE);
+    auto _password = _env.get(CONST_KEY_SUDO_PSWD);
+    ProcessManager _pm;
+    const auto [_pid, _status] = _pm.startProcessBlockingAsRoot("rm", {"-rf", path}, {}, _password);
+    return _status == 0 && ::access(path.c_str(), F_OK) != 0;
+}
+
+void TrashReaper::registerRestEndpoints(crow::SimpleApp& app)
+{
+    CROW_ROUTE(app, "/api/trash").methods("GET"_method)([this]()
+    {
+        return handleGetTrash();
+    });
+}
+
+crow::response TrashReaper::handleGetTrash()
+{
+    JsonWriter json;
+    std::lock_guard<std::mutex> lock(mutex_);
+    json.beginObject()
+        .field("success", true)
+        .field("trash_directory", trash_directory_)
+        .field("workers", workers_)
+        .field("pending", queue_.size())
+        .field("reaped", reaped_)
+        .field("failed", failed_)
+        .key("items").beginArray();
+    for (const auto& item : queue_) {
+        json.beginObject()
+            .field("name", item->name)
+            .field("original_path", item->original_path)
+            .field("state", !item->deleting ? "queued" : item->privileged ? "deleting_privileged" : "deleting")
+            .field("files_removed", item->files_removed.load())
+            .field("directories_removed", item->directories_removed.load())
+            .field("age_ms", millisecondsSince(item->queued_at))
+            .endObject();
+    }
+    json.endArray().endObject();
+    return json.response(200);
+}
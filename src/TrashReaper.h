@@ -0,0 +1,87 @@
+#ifndef TRASHREAPER_H
+#define TRASHREAPER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <crow.h>
+
+/**
+ * @brief Deletes directory trees in the background, so removing a project returns right away.
+ *
+ * discard() renames a directory into the trash directory, which has to be on the same filesystem,
+ * and queues it. A background thread then deletes one queued tree at a time with `workers`
+ * threads, each taking a directory, unlinking its files with unlinkat() and handing its
+ * subdirectories to the others; empty directories are removed deepest first. The threads run at
+ * idle I/O priority. Whatever the server may not delete (files containers created as root) is left
+ * to `sudo rm -rf`.
+ *
+ * Trees still in the trash directory when the server starts, from a run that stopped before they
+ * were deleted, are queued again. GET /api/trash reports the queue:
+ *
+ *     {"success": true, "workers": 4, "pending": 1, "reaped": 12, "failed": 0, "items": [
+ *         {"name": "app.1760000000000.3", "original_path": "/home/u/.metainstaller/projects/app",
+ *          "state": "deleting", "files_removed": 120345, "directories_removed": 5120, "age_ms": 5230}]}
+ */
+class TrashReaper {
+public:
+    TrashReaper(const std::string& trashDirectory, size_t workers);
+    ~TrashReaper();
+
+    TrashReaper(const TrashReaper&) = delete;
+    TrashReaper& operator=(const TrashReaper&) = delete;
+
+    /**
+     * @brief moves path into the trash and queues it for deletion
+     * @return false if it cannot be moved there (e.g. another filesystem); path is left as it was
+     */
+    bool discard(const std::string& path);
+
+    /**
+     * @brief blocks until the queue is empty or timeout passes
+     * @return true if the queue is empty
+     */
+    bool waitIdle(std::chrono::milliseconds timeout);
+
+    const std::string& trashDirectory() const { return trash_directory_; }
+
+    void registerRestEndpoints(crow::SimpleApp& app);
+
+private:
+    struct Item {
+        std::string name;                   // in the trash directory
+        std::string original_path;          // empty for trees found at start
+        std::chrono::steady_clock::time_point queued_at;
+        bool deleting = false;
+        bool privileged = false;            // left to sudo rm
+        std::atomic<uint64_t> files_removed{0};
+        std::atomic<uint64_t> directories_removed{0};
+    };
+
+    void run();
+    // unlinks the tree with the worker threads, returns false if something was left
+    bool reap(Item& item);
+    bool reapPrivileged(const std::string& path);
+    crow::response handleGetTrash();
+
+    const std::string trash_directory_;
+    const size_t workers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    std::deque<std::shared_ptr<Item>> queue_;       // the front one is being deleted
+    uint64_t counter_ = 0;
+    uint64_t reaped_ = 0;
+    uint64_t failed_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
+
+#endif // TRASHREAPER_H
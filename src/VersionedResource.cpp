@@ -0,0 +1,219 @@
+#include "VersionedResource.h"
+#include "BlockingExecutor.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+VersionedResource::VersionedResource(const std::string& name, Probe probe, std::chrono::milliseconds probeInterval)
+    : name_(name)
+    , probe_(std::move(probe))
+    , probe_interval_(probeInterval)
+{
+}
+
+VersionedResource::~VersionedResource()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        waiters_.clear();
+    }
+    cv_.notify_all();
+    if (watcher_.joinable()) {
+        watcher_.join();
+    }
+}
+
+uint64_t VersionedResource::version()
+{
+    runProbe();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
+
+uint64_t VersionedResource::bump()
+{
+    uint64_t version;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        version = ++version_;
+    }
+    cv_.notify_all();
+    return version;
+}
+
+std::string VersionedResource::etag(uint64_t version) const
+{
+    return "\"" + name_ + "-" + std::to_string(version) + "\"";
+}
+
+bool VersionedResource::matches(const std::string& ifNoneMatch, uint64_t version) const
+{
+    if (ifNoneMatch.empty()) {
+        return false;
+    }
+    const std::string current = etag(version);
+    std::istringstream iss(ifNoneMatch);
+    std::string tag;
+    while (std::getline(iss, tag, ',')) {
+        tag.erase(0, tag.find_first_not_of(" \t"));
+        tag.erase(tag.find_last_not_of(" \t") + 1);
+        if (tag.compare(0, 2, "W/") == 0) {
+            tag = tag.substr(2);
+        }
+        if (tag == current || tag == "*") {
+            return true;
+        }
+    }
+    return false;
+}
+
+void VersionedResource::runProbe()
+{
+    if (!probe_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(probe_mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    const bool first = probed_at_ == std::chrono::steady_clock::time_point{};
+    if (!first && now - probed_at_ < probe_interval_) {
+        return;
+    }
+    std::string fingerprint = probe_();
+    probed_at_ = std::chrono::steady_clock::now();
+    if (!first && fingerprint != fingerprint_) {
+        bump();
+    }
+    fingerprint_ = fingerprint;
+}
+
+void VersionedResource::waitForChange(uint64_t knownVersion, std::chrono::milliseconds timeout, WaitCallback callback)
+{
+    uint64_t current;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current = version_;
+        if (current <= knownVersion) {
+            waiters_.push_back({knownVersion, std::chrono::steady_clock::now() + timeout, std::move(callback)});
+            if (!watcher_.joinable()) {
+                watcher_ = std::thread(&VersionedResource::watch, this);
+            }
+        }
+    }
+    if (current > knownVersion) {
+        callback(current);
+        return;
+    }
+    cv_.notify_all();
+}
+
+void VersionedResource::watch()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (waiters_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+
+        auto wake_at = waiters_.front().deadline;
+        for (const auto& waiter : waiters_) {
+            wake_at = std::min(wake_at, waiter.deadline);
+        }
+        if (probe_) {
+            wake_at = std::min(wake_at, std::chrono::steady_clock::now() + probe_interval_);
+        }
+        cv_.wait_until(lock, wake_at);
+        if (stopping_) {
+            break;
+        }
+
+        lock.unlock();
+        runProbe();
+        lock.lock();
+
+        const auto now = std::chrono::steady_clock::now();
+        std::vector<Waiter> ready;
+        auto it = std::partition(waiters_.begin(), waiters_.end(), [this, now](const Waiter& waiter) {
+            return waiter.known_version >= version_ && now < waiter.deadline;
+        });
+        std::move(it, waiters_.end(), std::back_inserter(ready));
+        waiters_.erase(it, waiters_.end());
+        const uint64_t version = version_;
+
+        lock.unlock();
+        for (auto& waiter : ready) {
+            waiter.callback(version);
+        }
+        lock.lock();
+    }
+}
+
+crow::response VersionedResource::rendered(uint64_t version, const std::function<crow::response()>& render)
+{
+    crow::response res = render();
+    res.set_header("ETag", etag(version));
+    res.set_header("X-Resource-Version", std::to_string(version));
+    // let browsers keep the body but revalidate with If-None-Match on every poll
+    res.set_header("Cache-Control", "no-cache");
+    return res;
+}
+
+crow::response VersionedResource::notModified(uint64_t version)
+{
+    crow::response res(304);
+    res.set_header("ETag", etag(version));
+    res.set_header("X-Resource-Version", std::to_string(version));
+    return res;
+}
+
+void VersionedResource::setExecutor(BlockingExecutor* executor)
+{
+    executor_ = executor;
+}
+
+void VersionedResource::serve(const crow::request& req, crow::response& res, std::function<crow::response()> render)
+{
+    const char* wait = req.url_params.get("wait");
+    if (wait) {
+        const uint64_t known = std::strtoull(wait, nullptr, 10);
+        long timeout_seconds = 25;
+        if (const char* timeout = req.url_params.get("timeout")) {
+            timeout_seconds = std::clamp(std::atol(timeout), 0L, 60L);
+        }
+        if (!executor_ || !executor_->dispatch([this]() { runProbe(); })) {
+            runProbe();
+        }
+        // the answer is written from the connection's own io thread, crow connections are not thread safe
+        asio::io_context* io_context = req.io_context;
+        waitForChange(known, std::chrono::seconds(timeout_seconds), [this, io_context, &res, render, known](uint64_t version) {
+            if (version > known && executor_) {
+                executor_->respond(io_context, res, [this, version, render]() { return rendered(version, render); });
+                return;
+            }
+            asio::post(*io_context, [this, &res, render, known, version]() {
+                res = version <= known ? notModified(version) : rendered(version, render);
+                res.end();
+            });
+        });
+        return;
+    }
+
+    const std::string if_none_match = req.get_header_value("If-None-Match");
+    auto answer = [this, if_none_match, render]() {
+        const uint64_t current = version();
+        return matches(if_none_match, current) ? notModified(current) : rendered(current, render);
+    };
+    if (executor_) {
+        executor_->respond(req, res, answer);
+        return;
+    }
+    res = answer();
+    res.end();
+}
+
+size_t VersionedResource::waiting()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiters_.size();
+}
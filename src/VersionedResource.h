@@ -0,0 +1,105 @@
+#ifndef VERSIONEDRESOURCE_H
+#define VERSIONEDRESOURCE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <crow.h>
+
+class BlockingExecutor;
+
+/**
+ * @brief Monotonic version of a family of REST resources (e.g. all projects), used for
+ * ETag conditional GETs and long-poll "wait for change" requests.
+ *
+ * Changes made through MetaInstaller call bump(). Changes made behind our back (a container
+ * exiting, dockerd stopped from a shell) are picked up by the optional probe: a cheap fingerprint
+ * of the externally observable state, evaluated at most once per probe interval no matter how many
+ * clients ask, and bumping the version when the fingerprint differs from the last one.
+ *
+ * Long-poll waiters do not hold a server thread: they are parked as callbacks and answered from
+ * one watcher thread per resource when the version advances or their timeout expires.
+ */
+class VersionedResource {
+public:
+    using Probe = std::function<std::string()>;
+    using WaitCallback = std::function<void(uint64_t version)>;
+
+    explicit VersionedResource(const std::string& name, Probe probe = nullptr,
+                               std::chrono::milliseconds probeInterval = std::chrono::milliseconds(2000));
+    ~VersionedResource();
+
+    VersionedResource(const VersionedResource&) = delete;
+    VersionedResource& operator=(const VersionedResource&) = delete;
+
+    /**
+     * @brief current version, after running the probe if the last run is older than the probe interval
+     */
+    uint64_t version();
+    uint64_t bump();
+    std::string etag(uint64_t version) const;
+
+    /**
+     * @brief true if the If-None-Match header value names the given version
+     */
+    bool matches(const std::string& ifNoneMatch, uint64_t version) const;
+
+    /**
+     * @brief calls callback once the version is newer than knownVersion, or after timeout with the current version.
+     * Called right away if the version already moved on.
+     */
+    void waitForChange(uint64_t knownVersion, std::chrono::milliseconds timeout, WaitCallback callback);
+
+    /**
+     * @brief serves a GET for this resource family on an asynchronous crow handler.
+     *
+     * - `?wait=<version>[&timeout=<seconds>]` parks the request until the version is newer than
+     *   <version> (timeout defaults to 25s, at most 60s); answers 304 if nothing changed.
+     * - `If-None-Match` with the current ETag answers 304 without calling render.
+     * - otherwise the response of render, with ETag and X-Resource-Version headers.
+     */
+    void serve(const crow::request& req, crow::response& res, std::function<crow::response()> render);
+
+    /**
+     * @brief runs the probe and render of serve() on executor instead of the connection's io thread
+     */
+    void setExecutor(BlockingExecutor* executor);
+
+    size_t waiting();
+
+private:
+    struct Waiter {
+        uint64_t known_version;
+        std::chrono::steady_clock::time_point deadline;
+        WaitCallback callback;
+    };
+
+    void runProbe();
+    void watch();
+    crow::response rendered(uint64_t version, const std::function<crow::response()>& render);
+    crow::response notModified(uint64_t version);
+
+    std::string name_;
+    Probe probe_;
+    std::chrono::milliseconds probe_interval_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint64_t version_{1};
+    std::vector<Waiter> waiters_;
+    std::thread watcher_;
+    bool stopping_{false};
+
+    std::mutex probe_mutex_;
+    std::string fingerprint_;
+    std::chrono::steady_clock::time_point probed_at_{};
+
+    BlockingExecutor* executor_{nullptr};
+};
+
+#endif // VERSIONEDRESOURCE_H
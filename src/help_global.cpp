@@ -2,6 +2,7 @@
 #include "EnvConfig.hpp"
 #include "argument_handler.h"
 #include "test.h"
+#include "LoadTest.h"
 
 std::string HelpGlobal::help_global() {
     std::string help_str = "Container Installer REST - Comprehensive Docker Management System\n";
@@ -19,6 +20,7 @@ std::string HelpGlobal::help_global() {
     help_str += "    - Use 'all' to run all available tests\n";
     help_str += "    - Use a single test name to run one test (e.g., 'sudo')\n";
     help_str += "    - Use comma-separated names to run multiple tests (e.g., 'sudo,docker_install')\n";
+    help_str += LoadTest::help();
     help_str += "  --help                 : Show this help message\n\n";
     
     // Available Tests
@@ -110,6 +112,8 @@ std::string HelpGlobal::help_global() {
     help_str += "  ./MetaInstaller --test all\n\n";
     help_str += "  # Run specific test\n";
     help_str += "  ./MetaInstaller --test sudo,docker_install\n\n";
+    help_str += "  # Load test this instance for 60s with 16 /api/projects workers and 32 log subscribers\n";
+    help_str += "  ./MetaInstaller --loadtest projects=16,ws=32 --loadtest_duration 60\n\n";
     help_str += "  # Show help\n";
     help_str += "  ./MetaInstaller --help\n\n";
     
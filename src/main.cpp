@@ -14,8 +14,18 @@
 #include "BrowserManager.hpp"
 #include "argument_handler.h"
 #include "test.h"
+#include "LoadTest.h"
 #include "help_global.h"
 #include "SELinuxManager.h"
+#include "OverviewManager.h"
+#include "BatchManager.h"
+#include "LogStreamManager.h"
+#include "ResourceMonitor.h"
+#include "MetricsStore.h"
+#include "MetaDatabase.h"
+#include "AdmissionControl.h"
+#include "BlockingExecutor.h"
+#include "LocalSocketListener.h"
 
 // Hardcoded version constant
 // const std::string VERSION = "1404.06.11";
@@ -36,10 +46,22 @@ int main(int argc, char** argv) {
     _handler.addStringArgument("test", "run specified tests as a list separated by comma. use 'all' to run all tests", "", false);
     _handler.addBooleanArgument("help", "shows help string", false, false);
     _handler.addBooleanArgument("version", "shows version string", false, false);
+    _handler.addStringArgument("loadtest", "run the load generator with a mix like 'projects=4,ws=8'. use 'default' for the built-in mix", "", false);
+    _handler.addIntegerArgument("loadtest_duration", "load test duration in seconds", 30, false);
+    _handler.addStringArgument("loadtest_url", "run the load test against an already running server", "", false);
+    _handler.addIntegerArgument("loadtest_pid", "pid of the server whose RSS is sampled during the load test", 0, false);
+    _handler.addStringArgument("loadtest_project", "project used by the 'cycle' load test scenario", "test_project_1", false);
     _handler.parseArguments(argc, argv);
     auto _test_arg = std::get<std::string>(_handler.getArgumentValue("test"));
     auto _help = std::get<bool>(_handler.getArgumentValue("help"));
     auto _version = std::get<bool>(_handler.getArgumentValue("version"));
+    auto _loadtest_arg = std::get<std::string>(_handler.getArgumentValue("loadtest"));
+    LoadTest::Options _loadtest_options;
+    _loadtest_options.mix = _loadtest_arg;
+    _loadtest_options.duration_seconds = std::get<int>(_handler.getArgumentValue("loadtest_duration"));
+    _loadtest_options.base_url = std::get<std::string>(_handler.getArgumentValue("loadtest_url"));
+    _loadtest_options.server_pid = std::get<int>(_handler.getArgumentValue("loadtest_pid"));
+    _loadtest_options.project_name = std::get<std::string>(_handler.getArgumentValue("loadtest_project"));
     if(_version)
     {
         std::cout << "MetaInstaller version: " << APP_VERSION << "\n";
@@ -51,6 +73,13 @@ int main(int argc, char** argv) {
         std::exit(EXIT_SUCCESS);
     }
 
+    // Load test against an external server: no need to boot our own
+    if(!_loadtest_arg.empty() && !_loadtest_options.base_url.empty())
+    {
+        LoadTest _lt(_loadtest_options);
+        std::exit(_lt.run() ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
     system("killall midori");
     sleep(1);
 
@@ -66,6 +95,23 @@ int main(int argc, char** argv) {
         }).detach();
     }
 
+    // If invoked with --loadtest, drive load against this process and exit.
+    if(_loadtest_arg.size() > 0)
+    {
+        std::thread([_loadtest_options]() mutable {
+            // wait for REST service to boot.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+            _loadtest_options.base_url = "http://127.0.0.1:" + std::to_string(EnvConfig::get_int_value(EnvKey::REST_PORT));
+            if(_loadtest_options.server_pid <= 0)
+            {
+                _loadtest_options.server_pid = getpid();
+            }
+            LoadTest _lt(_loadtest_options);
+            bool _ret = _lt.run();
+            std::exit(_ret ? EXIT_SUCCESS : EXIT_FAILURE);
+        }).detach();
+    }
+
     {
         // Utils::test_7z();
         // return EXIT_SUCCESS;
@@ -74,22 +120,75 @@ int main(int argc, char** argv) {
     crow::SimpleApp app;
     app.loglevel(crow::LogLevel::Info);
     
+    // Local image index shared by Docker and Project managers
+    auto imageIndex = std::make_shared<ImageIndex>();
+
+    // Concurrency limits of slow endpoints, with handler threads left for the quick ones
+    int _reserved_threads = EnvConfig::get_int_value(EnvKey::RESERVED_THREADS);
+    if (_reserved_threads <= 0) {
+        _reserved_threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    }
+    auto admission = std::make_shared<AdmissionControl>(static_cast<size_t>(_reserved_threads));
+    admission->addLane(AdmissionControl::HEAVY_LANE, std::max(1, EnvConfig::get_int_value(EnvKey::HEAVY_CONCURRENCY)),
+                       std::max(0, EnvConfig::get_int_value(EnvKey::HEAVY_QUEUE)));
+    admission->addLane(AdmissionControl::PROJECTS_LANE, std::max(1, EnvConfig::get_int_value(EnvKey::PROJECT_CONCURRENCY)),
+                       std::max(0, EnvConfig::get_int_value(EnvKey::PROJECT_QUEUE)));
+    admission->registerRestEndpoints(app);
+
+    // Handlers that run subprocesses, SQLite or filesystem walks run here, not on crow's io threads
+    auto blocking = std::make_shared<BlockingExecutor>(admission->workerThreads(),
+                                                       static_cast<size_t>(std::max(1, EnvConfig::get_int_value(EnvKey::BLOCKING_QUEUE))));
+
     // Initialize Docker Manager and register REST endpoints
     DockerManager dockerManager;
+    dockerManager.setImageIndex(imageIndex);
+    dockerManager.setAdmissionControl(admission);
+    dockerManager.setBlockingExecutor(blocking);
     dockerManager.registerRestEndpoints(app);
 
     // Initialize Project Manager and register REST endpoints
     ProjectManager projectManager;
+    projectManager.setImageIndex(imageIndex);
+    projectManager.setAdmissionControl(admission);
+    projectManager.setBlockingExecutor(blocking);
+    const int _content_store_min_size = EnvConfig::get_int_value(EnvKey::CONTENT_STORE_MIN_SIZE);
+    if (_content_store_min_size >= 0) {
+        projectManager.setContentStore(std::make_shared<ContentStore>(
+            Utils::path_join_multiple({Utils::get_metainstaller_home_dir(), "store"}),
+            static_cast<uint64_t>(_content_store_min_size)));
+    }
+    auto trashReaper = std::make_shared<TrashReaper>(
+        Utils::path_join_multiple({projectManager.getProjectsDirectory(), ".trash"}),
+        static_cast<size_t>(std::max(1, EnvConfig::get_int_value(EnvKey::TRASH_WORKERS))));
+    projectManager.setTrashReaper(trashReaper);
+    trashReaper->registerRestEndpoints(app);
     projectManager.registerRestEndpoints(app);
 
     // Initialize File Manager and register REST endpoints
     FileManager fileManager;
+    fileManager.setBlockingExecutor(blocking);
     fileManager.registerRestEndpoints(app);
 
     // Initialize SELinux Manager and register REST endpoints
     SELinuxManager selinuxManager;
     selinuxManager.registerRestEndpoints(app);
 
+    // Dashboard overview: the status endpoints above gathered concurrently in one request
+    OverviewManager overviewManager(app);
+    overviewManager.setBlockingExecutor(blocking);
+    overviewManager.addSection("docker_info", "/api/docker/info");
+    overviewManager.addSection("docker_compose_info", "/api/docker-compose/info");
+    overviewManager.addSection("docker_service", "/api/docker/service/status");
+    overviewManager.addSection("selinux", "/api/selinux/status");
+    overviewManager.addSection("disk_usage", "/api/docker/system/df", std::chrono::milliseconds(5000));
+    overviewManager.addSection("projects", "/api/projects");
+    overviewManager.registerRestEndpoints(app);
+
+    // Batch endpoint: many API requests dispatched through the router in one round trip
+    BatchManager batchManager(app, static_cast<size_t>(std::max(1, EnvConfig::get_int_value(EnvKey::BATCH_CONCURRENCY))),
+                              static_cast<size_t>(std::max(1, EnvConfig::get_int_value(EnvKey::BATCH_MAX_REQUESTS))));
+    batchManager.registerRestEndpoints(app);
+
     // Route for root (/) - Serve React app
     // CROW_ROUTE(app, "/")([] (const crow::request& req, crow::response& res) {
     //     std::ifstream file("./docker-manager-ui/build/index.html", std::ios::binary);
@@ -151,10 +250,10 @@ int main(int argc, char** argv) {
     // std::vector<crow::websocket::connection*> connections;
     
     // WebSocket connections for operation logs
-    std::vector<crow::websocket::connection*> log_connections;
+    LogHub logHub;
     
     // WebSocket connections for installation progress
-    std::vector<crow::websocket::connection*> progress_connections;
+    LogHub progressHub;
 
     // Define the WebSocket route at "/ws"
     // CROW_WEBSOCKET_ROUTE(app, "/ws")
@@ -186,19 +285,24 @@ int main(int argc, char** argv) {
 
     // WebSocket endpoint for operation logs: /ws/logs
     CROW_WEBSOCKET_ROUTE(app, "/ws/logs")
-        .onopen([&log_connections, &dockerManager](crow::websocket::connection& conn) {
-            log_connections.push_back(&conn);
+        .subprotocols({LogHub::BINARY_SUBPROTOCOL})
+        .onopen([&logHub, &dockerManager](crow::websocket::connection& conn) {
+            logHub.add(&conn);
             // conn.send_text("{\"type\":\"connected\",\"message\":\"Connected to operation logs stream\"}");
             dockerManager.broadcastLog("connection", "Connected to operation logs stream", "info");
             crow::logger(crow::LogLevel::Info) << "New log connection established\n";
         })
-        .onclose([&log_connections](crow::websocket::connection& conn, const std::string& reason, short unsigned int _opcode) {
-            log_connections.erase(std::remove(log_connections.begin(), log_connections.end(), &conn), log_connections.end());
+        .onclose([&logHub](crow::websocket::connection& conn, const std::string& reason, short unsigned int /*opcode*/) {
+            logHub.remove(&conn);
             crow::logger(crow::LogLevel::Info) << "Log connection closed: " << reason << "\n";
         })
-        .onmessage([&dockerManager](crow::websocket::connection& conn, const std::string& data, bool is_binary) {
+        .onmessage([&logHub, &dockerManager](crow::websocket::connection& conn, const std::string& data, bool is_binary) {
             if (!is_binary) {
                 crow::logger(crow::LogLevel::Info) << "Log websocket received: " << data << "\n";
+                // subscribe/unsubscribe control messages narrow what this connection receives
+                if (logHub.handleControlMessage(conn, data)) {
+                    return;
+                }
                 // Logs are one-way from server to client, so we just acknowledge
                 // conn.send_text("{\"type\":\"ack\",\"message\":\"Message received\"}");
                 dockerManager.broadcastLog("on_message", data, "info");
@@ -210,18 +314,22 @@ int main(int argc, char** argv) {
 
     // WebSocket endpoint for installation progress: /ws/progress
     CROW_WEBSOCKET_ROUTE(app, "/ws/progress")
-        .onopen([&progress_connections](crow::websocket::connection& conn) {
-            progress_connections.push_back(&conn);
+        .subprotocols({LogHub::BINARY_SUBPROTOCOL})
+        .onopen([&progressHub](crow::websocket::connection& conn) {
+            progressHub.add(&conn);
             conn.send_text("{\"type\":\"connected\",\"message\":\"Connected to installation progress stream\"}");
             crow::logger(crow::LogLevel::Info) << "New progress connection established\n";
         })
-        .onclose([&progress_connections](crow::websocket::connection& conn, const std::string& reason, short unsigned int _opcode) {
-            progress_connections.erase(std::remove(progress_connections.begin(), progress_connections.end(), &conn), progress_connections.end());
+        .onclose([&progressHub](crow::websocket::connection& conn, const std::string& reason, short unsigned int /*opcode*/) {
+            progressHub.remove(&conn);
             crow::logger(crow::LogLevel::Info) << "Progress connection closed: " << reason << "\n";
         })
-        .onmessage([](crow::websocket::connection& conn, const std::string& data, bool is_binary) {
+        .onmessage([&progressHub](crow::websocket::connection& conn, const std::string& data, bool is_binary) {
             if (!is_binary) {
                 crow::logger(crow::LogLevel::Info) << "Progress websocket received: " << data << "\n";
+                if (progressHub.handleControlMessage(conn, data)) {
+                    return;
+                }
                 // Progress is one-way from server to client, so we just acknowledge
                 conn.send_text("{\"type\":\"ack\",\"message\":\"Message received\"}");
             }
@@ -230,14 +338,36 @@ int main(int argc, char** argv) {
             std::cerr << "Progress WebSocket error: " << error_message << "\n";
         });
 
+    // WebSocket endpoint for live container logs: /ws/projects/<name>/logs
+    LogStreamManager logStreams(projectManager);
+    logStreams.registerWebSocketEndpoints(app);
+
+    // History of project metrics at several resolutions, saved to the settings database
+    MetricsStore metricsStore;
+    {
+        auto _metrics_database = std::make_shared<MetaDatabase>();
+        if (_metrics_database->initDatabase()) {
+            metricsStore.enableSnapshots(_metrics_database, std::chrono::seconds(EnvConfig::get_int_value(EnvKey::METRICS_SNAPSHOT_INTERVAL_S)));
+        }
+    }
+    metricsStore.registerRestEndpoints(app);
+
+    // Per-project CPU, memory and I/O usage read from cgroups, published on /ws/logs as resources:<name>
+    ResourceMonitor resourceMonitor(projectManager,
+                                    std::chrono::milliseconds(EnvConfig::get_int_value(EnvKey::RESOURCE_SAMPLE_INTERVAL_MS)),
+                                    EnvConfig::get_value(EnvKey::CGROUP_ROOT));
+    resourceMonitor.registerRestEndpoints(app);
+    resourceMonitor.setLogHub(&logHub);
+    resourceMonitor.setMetricsStore(&metricsStore);
+
     // Set websocket connection references in DockerManager and ProjectManager for broadcasting
-    dockerManager.setWebSocketConnections(&log_connections, &progress_connections);
-    projectManager.setWebSocketConnections(&log_connections, &progress_connections);
+    dockerManager.setWebSocketConnections(&logHub, &progressHub);
+    projectManager.setWebSocketConnections(&logHub, &progressHub);
     int rest_port = EnvConfig::get_int_value(EnvKey::REST_PORT);
 
     BrowserManager _bm;
     _bm.register_endpoints(app);
-    if(_test_arg.empty())
+    if(_test_arg.empty() && _loadtest_arg.empty())
     {
         std::thread([rest_port, &_bm, &app](){
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
@@ -289,12 +419,41 @@ int main(int argc, char** argv) {
         res.end();
     });
     
+    // Optional unix socket for scripts on this host, serving the same routes once the TCP server validated them
+    std::unique_ptr<LocalSocketListener> localSocket;
+    const std::string _local_socket_path = EnvConfig::get_value(EnvKey::LOCAL_SOCKET_PATH);
+    if (!_local_socket_path.empty()) {
+        mode_t _local_socket_mode = 0660;
+        try {
+            _local_socket_mode = static_cast<mode_t>(std::stoul(EnvConfig::get_value(EnvKey::LOCAL_SOCKET_MODE), nullptr, 8));
+        } catch (const std::exception&) {
+            crow::logger(crow::LogLevel::Warning) << "Invalid LOCAL_SOCKET_MODE, using 660";
+        }
+        localSocket = std::make_unique<LocalSocketListener>(app, _local_socket_path, _local_socket_mode,
+                                                            EnvConfig::get_value(EnvKey::LOCAL_SOCKET_GROUP),
+                                                            static_cast<uint16_t>(std::max(2u, std::thread::hardware_concurrency() / 2 + 1)));
+    }
+
     // Start server in a separate thread
-    app.port(rest_port).multithreaded().run();
+    auto _server = app.port(rest_port).multithreaded().run_async();
+    if (localSocket && app.wait_for_server_start() == std::cv_status::no_timeout) {
+        localSocket->start();
+    }
+    int _exit_code = 0;
+    try {
+        // get() rethrows what ended the server, e.g. a port that cannot be bound
+        _server.get();
+    } catch (const std::exception& e) {
+        crow::logger(crow::LogLevel::Critical) << "Server stopped: " << e.what();
+        _exit_code = 1;
+    }
+    if (localSocket) {
+        localSocket->stop();
+    }
     
-    if(_test_arg.empty())
+    if(_test_arg.empty() && _loadtest_arg.empty())
     {
         _bm.close();
     }
-    return 0;
+    return _exit_code;
 }
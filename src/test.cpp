@@ -9,8 +9,35 @@
 #include "json11.hpp"
 #include "dotenv.hpp"
 #include "EnvConfig.hpp"
+#include "ComposeModel.h"
+#include "ImageIndex.h"
+#include "CoalescingCache.h"
+#include "TaskExecutor.h"
+#include "LogHub.h"
+#include "MsgPack.h"
+#include "ContainerLog.h"
+#include "CgroupSampler.h"
+#include "ResourceMonitor.h"
+#include "MetricsStore.h"
+#include "JsonLines.h"
+#include "JsonWriter.h"
+#include "AdmissionControl.h"
+#include "BlockingExecutor.h"
+#include "BatchManager.h"
+#include "InProcessRequest.h"
+#include "LocalSocketListener.h"
+#include "ArchiveManifest.h"
+#include "ContentStore.h"
+#include "TrashReaper.h"
+#include "ImageArchive.h"
+#include <sys/stat.h>
 #include <chrono>
 #include <fstream>
+#include <thread>
+#include <atomic>
+#include <ctime>
+#include <map>
+#include <mutex>
 
 
 /*
@@ -46,6 +73,32 @@ Test::Test() {
     tests.push_back({"project_stop", [this]() { return this->REST_test_project_stop(); }});
     tests.push_back({"project_restart", [this]() { return this->REST_test_project_restart(); }});
     tests.push_back({"project_services", [this]() { return this->REST_test_project_services(); }});
+    tests.push_back({"project_logs", [this]() { return this->REST_test_project_logs(); }});
+    tests.push_back({"compose_model", [this]() { return this->UNIT_test_compose_model(); }});
+    tests.push_back({"image_index", [this]() { return this->UNIT_test_image_index(); }});
+    tests.push_back({"coalescing_cache", [this]() { return this->UNIT_test_coalescing_cache(); }});
+    tests.push_back({"task_executor", [this]() { return this->UNIT_test_task_executor(); }});
+    tests.push_back({"log_hub", [this]() { return this->UNIT_test_log_hub(); }});
+    tests.push_back({"binary_log_frames", [this]() { return this->UNIT_test_binary_log_frames(); }});
+    tests.push_back({"log_stream_since", [this]() { return this->UNIT_test_log_stream_since(); }});
+    tests.push_back({"log_query_pages", [this]() { return this->UNIT_test_log_query_pages(); }});
+    tests.push_back({"cgroup_sampler", [this]() { return this->UNIT_test_cgroup_sampler(); }});
+    tests.push_back({"metrics_store", [this]() { return this->UNIT_test_metrics_store(); }});
+    tests.push_back({"json_line_scanner", [this]() { return this->UNIT_test_json_line_scanner(); }});
+    tests.push_back({"json_writer", [this]() { return this->UNIT_test_json_writer(); }});
+    tests.push_back({"admission_control", [this]() { return this->UNIT_test_admission_control(); }});
+    tests.push_back({"blocking_executor", [this]() { return this->UNIT_test_blocking_executor(); }});
+    tests.push_back({"batch_requests", [this]() { return this->UNIT_test_batch_requests(); }});
+    tests.push_back({"local_socket", [this]() { return this->UNIT_test_local_socket(); }});
+    tests.push_back({"archive_manifest", [this]() { return this->UNIT_test_archive_manifest(); }});
+    tests.push_back({"content_store", [this]() { return this->UNIT_test_content_store(); }});
+    tests.push_back({"project_reload", [this]() { return this->REST_test_project_reload(); }});
+    tests.push_back({"trash_reaper", [this]() { return this->UNIT_test_trash_reaper(); }});
+    tests.push_back({"image_archive", [this]() { return this->UNIT_test_image_archive(); }});
+    tests.push_back({"compose_interpolation", [this]() { return this->UNIT_test_compose_interpolation(); }});
+    tests.push_back({"project_analyze", [this]() { return this->REST_test_project_analyze(); }});
+    tests.push_back({"project_update", [this]() { return this->REST_test_project_update(); }});
+    tests.push_back({"versioned_resource", [this]() { return this->REST_test_versioned_resource(); }});
 
     EnvConfig::ensure_env_file_exists(".env");
     EnvParser parser;
@@ -712,6 +765,80 @@ bool Test::REST_test_project_services() {
     }
 }
 
+bool Test::REST_test_project_logs() {
+    assertm(!base_url.empty(), "Base URL is empty");
+
+    httplib::Client client(base_url.c_str());
+    client.set_connection_timeout(5); // 5 seconds
+    client.set_read_timeout(30);
+
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string project_name = "test_project_logs_" + std::to_string(now);
+
+    std::string archive_path = "../example_project.7z";
+    if(!std::filesystem::exists(archive_path))
+    {
+        archive_path = "example_project.7z";
+    }
+
+    json11::Json json_data_load = json11::Json::object{
+        {"archive_path", archive_path},
+        {"project_name", project_name},
+        {"password", "secret"}
+    };
+    auto res_load = client.Post("/api/projects/load", json_data_load.dump(), "application/json");
+    if (!res_load || res_load->status < 200 || res_load->status >= 300) {
+        crow::logger(crow::LogLevel::ERROR) << "Failed to load project for logs test";
+        return false;
+    }
+
+    // scroll from the newest lines back to the start, then poll forward from the newest cursor
+    const std::string logs_path = "/api/projects/" + project_name + "/logs";
+    std::vector<std::string> lines;
+    std::string newest_cursor;
+    std::string cursor;
+    bool ok = true;
+    for (int page = 0; page < 50; page++) {
+        std::string path = logs_path + "?direction=backward&limit=75" + (cursor.empty() ? "" : "&cursor=" + cursor);
+        auto res = client.Get(path.c_str());
+        if (!res || res->status != 200) {
+            crow::logger(crow::LogLevel::ERROR) << "Logs page request failed: " << (res ? res->body : httplib::to_string(res.error()));
+            ok = false;
+            break;
+        }
+        std::string parse_error;
+        json11::Json json = json11::Json::parse(res->body, parse_error);
+        if (newest_cursor.empty()) {
+            newest_cursor = json["next_cursor"].string_value();
+        }
+        std::vector<std::string> page_lines;
+        for (const auto& line : json["lines"].array_items()) {
+            page_lines.push_back(line["timestamp"].string_value() + " " + line["container"].string_value() + " " + line["message"].string_value());
+        }
+        lines.insert(lines.begin(), page_lines.begin(), page_lines.end());
+        cursor = json["prev_cursor"].string_value();
+        if (!json["has_more"].bool_value()) {
+            break;
+        }
+    }
+    std::set<std::string> unique(lines.begin(), lines.end());
+    crow::logger(crow::LogLevel::Info) << "Project logs test: " << lines.size() << " lines, " << unique.size() << " unique";
+    ok = ok && !lines.empty() && unique.size() == lines.size() && std::is_sorted(lines.begin(), lines.end());
+
+    // nothing was logged since the newest page
+    auto res_poll = client.Get((logs_path + "?cursor=" + newest_cursor).c_str());
+    std::string poll_error;
+    ok = ok && res_poll && res_poll->status == 200
+        && json11::Json::parse(res_poll->body, poll_error)["lines"].array_items().empty();
+
+    auto res_bad = client.Get((logs_path + "?cursor=garbage").c_str());
+    ok = ok && res_bad && res_bad->status == 400;
+
+    client.Post(("/api/projects/" + project_name + "/unload").c_str());
+    return ok;
+}
+
 // Test method for /api/projects/load REST endpoint
 bool Test::REST_test_project_load() {
     assertm(!base_url.empty(), "Base URL is empty");
@@ -780,3 +907,1433 @@ bool Test::REST_test_project_load() {
         return false;
     }
 }
+
+// Compose model parsing and mtime/hash based cache invalidation (no server needed)
+bool Test::UNIT_test_compose_model() {
+    const auto _dir = Utils::create_temp_path("/tmp");
+    const auto _path = Utils::path_join_multiple({_dir, "docker-compose.yml"});
+    auto write_file = [&_path](const std::string& _content) {
+        std::ofstream _out(_path, std::ios::trunc);
+        _out << _content;
+    };
+
+    write_file(
+        "services:\n"
+        "  web:\n"
+        "    image: nginx:alpine\n"
+        "    env_file: web.env\n"
+        "    volumes:\n"
+        "      - ./html:/usr/share/nginx/html:ro\n"
+        "    depends_on:\n"
+        "      db:\n"
+        "        condition: service_healthy\n"
+        "  db:\n"
+        "    image: postgres:16\n"
+        "    build:\n"
+        "      context: ./db\n"
+        "      dockerfile: Dockerfile.db\n"
+        "    healthcheck:\n"
+        "      test: [\"CMD\", \"pg_isready\"]\n");
+
+    ComposeModelCache _cache;
+    bool _changed = false;
+    auto _model = _cache.get("unit", _path, &_changed);
+    bool ok = _model->valid && _changed;
+    ok = ok && _model->serviceNames() == std::vector<std::string>({"db", "web"});
+    ok = ok && _model->images() == std::vector<std::string>({"postgres:16", "nginx:alpine"});
+    ok = ok && _model->services[1].depends_on == std::vector<std::string>({"db"});
+    ok = ok && _model->services[0].has_healthcheck && _model->services[0].healthcheck_test == "CMD pg_isready";
+    ok = ok && _model->dependentFiles() == std::vector<std::string>({"./db", "Dockerfile.db", "web.env", "./html"});
+    crow::logger(crow::LogLevel::Info) << "compose model: " << _model->toJson();
+
+    // unchanged file -> same compiled model, no re-read
+    auto _again = _cache.get("unit", _path, &_changed);
+    ok = ok && (_again == _model) && !_changed;
+
+    // rewritten with identical content -> new stamp, model kept
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::ifstream _in(_path);
+    std::string _content((std::istreambuf_iterator<char>(_in)), std::istreambuf_iterator<char>());
+    _in.close();
+    write_file(_content);
+    auto _touched = _cache.get("unit", _path, &_changed);
+    ok = ok && _touched->content_hash == _model->content_hash && _touched->services.size() == 2;
+
+    // edited file -> rebuilt
+    write_file("services:\n  only:\n    image: busybox\n");
+    auto _rebuilt = _cache.get("unit", _path, &_changed);
+    ok = ok && _changed && _rebuilt->content_hash != _model->content_hash && _rebuilt->serviceNames() == std::vector<std::string>({"only"});
+
+    // json round trip used by MetaDatabase
+    auto _restored = ComposeModel::fromJson(_model->toJson());
+    ok = ok && _restored.valid && _restored.dependentFiles() == _model->dependentFiles() && _restored.mtime_ns == _model->mtime_ns;
+
+    // invalid compose file
+    ok = ok && !ComposeModel::parse("version: '3'\n").valid;
+
+    std::filesystem::remove_all(_dir);
+    return ok;
+}
+
+bool Test::UNIT_test_image_index() {
+    // canonical references
+    bool ok = ImageReference::parse("nginx").canonical() == "docker.io/library/nginx:latest";
+    ok = ok && ImageReference::parse("library/nginx:latest").canonical() == "docker.io/library/nginx:latest";
+    ok = ok && ImageReference::parse("docker.io/library/nginx").canonical() == "docker.io/library/nginx:latest";
+    ok = ok && ImageReference::parse("index.docker.io/nginx:1.25").canonical() == "docker.io/library/nginx:1.25";
+    ok = ok && ImageReference::parse("localhost:5000/app").canonical() == "localhost:5000/app:latest";
+    ok = ok && ImageReference::parse("ghcr.io/org/app:v1").canonical() == "ghcr.io/org/app:v1";
+    ok = ok && ImageReference::parse("redis@sha256:abc").canonical() == "docker.io/library/redis@sha256:abc";
+
+    // incremental updates on top of whatever `docker images` reports
+    ImageIndex _index;
+    _index.refresh();
+    const auto _base = _index.list().size();
+    _index.addFromLoadOutput("Loaded image: metainstaller-unit/app:1.0\nLoaded image: metainstaller-unit/db\n");
+    ok = ok && _index.contains("docker.io/metainstaller-unit/app:1.0");
+    ok = ok && _index.contains("metainstaller-unit/db:latest");
+    ok = ok && _index.missing({"metainstaller-unit/app:1.0", "metainstaller-unit/app:2.0"}) == std::vector<std::string>({"metainstaller-unit/app:2.0"});
+    ok = ok && _index.list().size() == _base + 2;
+
+    auto _unreferenced = _index.unreferenced({"metainstaller-unit/app:1.0"});
+    bool _db_unreferenced = false;
+    for (const auto& _image : _unreferenced) {
+        ok = ok && _image.canonical != "docker.io/metainstaller-unit/app:1.0";
+        _db_unreferenced = _db_unreferenced || _image.canonical == "docker.io/metainstaller-unit/db:latest";
+    }
+    ok = ok && _db_unreferenced;
+
+    _index.remove("metainstaller-unit/app:1.0");
+    _index.remove("metainstaller-unit/db");
+    ok = ok && !_index.contains("metainstaller-unit/app:1.0") && _index.list().size() == _base;
+    crow::logger(crow::LogLevel::Info) << "image index: " << _base << " local images, generation " << _index.generation();
+    return ok;
+}
+
+bool Test::UNIT_test_coalescing_cache() {
+    CoalescingCache<std::string> _cache;
+    std::atomic<int> _loads{0};
+    auto _slow_loader = [&_loads]() {
+        _loads++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return std::string("value");
+    };
+
+    // concurrent callers share one execution
+    std::vector<std::thread> _threads;
+    std::atomic<int> _matches{0};
+    for (int i = 0; i < 8; i++) {
+        _threads.emplace_back([&]() {
+            if (_cache.get("key", std::chrono::seconds(10), _slow_loader) == "value") {
+                _matches++;
+            }
+        });
+    }
+    for (auto& _thread : _threads) {
+        _thread.join();
+    }
+    bool ok = _loads == 1 && _matches == 8;
+
+    // served from cache until invalidated
+    _cache.get("key", std::chrono::seconds(10), _slow_loader);
+    ok = ok && _loads == 1;
+    _cache.invalidate("key");
+    _cache.get("key", std::chrono::seconds(10), _slow_loader);
+    ok = ok && _loads == 2;
+
+    // expired entries are reloaded
+    _cache.get("short", std::chrono::milliseconds(1), _slow_loader);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    _cache.get("short", std::chrono::milliseconds(1), _slow_loader);
+    ok = ok && _loads == 4;
+
+    // failures are not cached
+    bool _thrown = false;
+    try {
+        _cache.get("error", std::chrono::seconds(10), []() -> std::string { throw std::runtime_error("failed"); });
+    } catch (const std::runtime_error&) {
+        _thrown = true;
+    }
+    ok = ok && _thrown && _cache.get("error", std::chrono::seconds(10), _slow_loader) == "value";
+
+    auto _stats = _cache.stats();
+    crow::logger(crow::LogLevel::Info) << "coalescing cache: hits " << _stats.hits << ", misses " << _stats.misses
+                                       << ", coalesced " << _stats.coalesced << ", invalidations " << _stats.invalidations;
+    ok = ok && _stats.coalesced == 7 && _stats.hits == 1 && _stats.misses == 6 && _stats.invalidations == 1;
+    return ok;
+}
+
+bool Test::UNIT_test_task_executor() {
+    TaskExecutor _executor("unit", 2, 2);
+    std::atomic<int> _running{0};
+    std::atomic<int> _max_running{0};
+    auto _task = [&]() {
+        int _now = ++_running;
+        int _max = _max_running;
+        while (_now > _max && !_max_running.compare_exchange_weak(_max, _now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        _running--;
+        return _now;
+    };
+
+    // two run, two wait in the queue, the fifth is refused
+    std::vector<std::future<int>> _futures;
+    bool _refused = false;
+    for (int i = 0; i < 5; i++) {
+        try {
+            _futures.push_back(_executor.submit(_task));
+        } catch (const std::runtime_error&) {
+            _refused = true;
+        }
+        // let the workers pick up the first tasks before queueing more
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto& _future : _futures) {
+        _future.get();
+    }
+    bool ok = _refused && _futures.size() == 4 && _max_running == 2;
+
+    // exceptions travel through the future
+    auto _failing = _executor.submit([]() -> int { throw std::runtime_error("failed"); });
+    try {
+        _failing.get();
+        ok = false;
+    } catch (const std::runtime_error&) {
+    }
+    ok = ok && _executor.submit([]() { return 42; }).get() == 42;
+    return ok;
+}
+
+bool Test::UNIT_test_log_hub() {
+    bool ok = LogHub::topicForOperation("docker_install") == "docker:install"
+        && LogHub::topicForOperation("IMAGE_PULL") == "image:pull"
+        && LogHub::topicForOperation("service_start_all") == "service:start_all"
+        && LogHub::topicForOperation("connection") == "connection";
+    ok = ok && LogHub::levelRank("debug") < LogHub::levelRank("info")
+        && LogHub::levelRank("info") < LogHub::levelRank("success")
+        && LogHub::levelRank("success") < LogHub::levelRank("warning")
+        && LogHub::levelRank("warn") == LogHub::levelRank("warning")
+        && LogHub::levelRank("warning") < LogHub::levelRank("error");
+
+    // without subscribers nothing is serialized or sent
+    LogHub _hub;
+    _hub.publish("project:demo", "loadProject", "unit", "info");
+    ok = ok && _hub.connectionCount() == 0 && _hub.droppedCount() == 1 && _hub.publishedCount() == 0;
+    return ok;
+}
+
+namespace {
+
+// records what LogHub sends instead of writing to a socket
+struct RecordingConnection : crow::websocket::connection {
+    explicit RecordingConnection(const std::string& subprotocol) : subprotocol_(subprotocol) {}
+    void send_binary(std::string msg) override { std::lock_guard<std::mutex> lock(mutex); unread += msg.size(); binary.push_back(msg); }
+    void send_text(std::string msg) override { std::lock_guard<std::mutex> lock(mutex); unread += msg.size(); text.push_back(msg); }
+    void send_ping(std::string) override {}
+    void send_pong(std::string) override {}
+    void close(std::string const&, uint16_t) override { closed = true; }
+    std::string get_remote_ip() override { return "127.0.0.1"; }
+    std::string get_subprotocol() const override { return subprotocol_; }
+    // the test client never reads
+    size_t pending_bytes() const override { return unread; }
+
+    std::mutex mutex;
+    std::atomic<size_t> unread{0};
+    std::vector<std::string> text;
+    std::vector<std::string> binary;
+    std::string subprotocol_;
+    bool closed = false;
+};
+
+} // namespace
+
+bool Test::UNIT_test_binary_log_frames() {
+    MsgPackWriter _writer;
+    _writer.array(3);
+    _writer.integer(-1);
+    _writer.integer(300);
+    _writer.string("ok");
+    bool ok = _writer.data() == std::string("\x93\xff\xcd\x01\x2c\xa2ok", 8);
+
+    const int _events = 20000;
+    const std::string _message = "Loaded image layer sha256:5f70bf18a086007016e948b04aed3b82103a36bea41755b6cddfaf10ace3c6ef";
+
+    // one hub per encoding, so each measurement only pays for its own path
+    auto _measure = [&](const std::string& subprotocol, RecordingConnection& conn) {
+        LogHub _hub;
+        _hub.add(&conn);
+        const std::clock_t _cpu_started = std::clock();
+        for (int i = 0; i < _events; i++) {
+            _hub.publish("image:load", "image_load", _message, i % 10 == 0 ? "warning" : "info");
+        }
+        const double _cpu_ns = 1e9 * (std::clock() - _cpu_started) / CLOCKS_PER_SEC / _events;
+        std::this_thread::sleep_for(LogHub::BATCH_WINDOW * 4);
+        const double _bytes = static_cast<double>(_hub.bytesSent()) / _events;
+        crow::logger(crow::LogLevel::Info) << (subprotocol.empty() ? "json" : subprotocol) << ": " << _bytes
+                                           << " bytes/event, " << _cpu_ns << " ns cpu/event, " << _hub.framesSent() << " frames";
+        _hub.remove(&conn);
+        return _bytes;
+    };
+
+    RecordingConnection _text_conn("");
+    RecordingConnection _binary_conn(LogHub::BINARY_SUBPROTOCOL);
+    const double _text_bytes = _measure("", _text_conn);
+    const double _binary_bytes = _measure(LogHub::BINARY_SUBPROTOCOL, _binary_conn);
+    ok = ok && _text_conn.text.size() == static_cast<size_t>(_events) && _binary_conn.text.empty();
+    ok = ok && _binary_bytes < _text_bytes && _binary_conn.binary.size() < static_cast<size_t>(_events) / 10;
+
+    // decode the batches: interned strings first, then every event referring to them
+    size_t _decoded = 0;
+    std::map<int, std::string> _interned;
+    for (const auto& _frame : _binary_conn.binary) {
+        std::string _error;
+        json11::Json _batch = MsgPackReader::decode(_frame, _error);
+        ok = ok && _error.empty() && _batch.is_array();
+        for (const auto& _event : _batch.array_items()) {
+            if (_event[0].int_value() == 0) {
+                _interned[_event[1].int_value()] = _event[2].string_value();
+            } else {
+                ok = ok && _event[0].int_value() == 1 && _interned[_event[2].int_value()] == "image:load"
+                    && _interned[_event[3].int_value()] == "image_load" && _event[5].string_value() == _message;
+                _decoded++;
+            }
+        }
+    }
+    ok = ok && _decoded == static_cast<size_t>(_events);
+
+    // min_level is applied to binary connections as well
+    LogHub _hub;
+    RecordingConnection _filtered(LogHub::BINARY_SUBPROTOCOL);
+    _hub.add(&_filtered);
+    ok = ok && _hub.handleControlMessage(_filtered, "{\"type\":\"subscribe\",\"topics\":[\"image:*\"],\"min_level\":\"warning\"}");
+    _hub.publish("image:load", "image_load", "skipped", "info");
+    _hub.publish("docker:install", "docker_install", "skipped", "error");
+    _hub.publish("image:load", "image_load", "kept", "error");
+    std::this_thread::sleep_for(LogHub::BATCH_WINDOW * 4);
+    ok = ok && _hub.droppedCount() == 2 && _filtered.binary.size() == 1;
+    _hub.remove(&_filtered);
+
+    // a client sent more than it can have read is closed instead of piling frames up in crow
+    LogHub _burst_hub;
+    RecordingConnection _stalled("");
+    _burst_hub.add(&_stalled);
+    const std::string _large(64 * 1024, 'x');
+    for (size_t i = 0; i < 2 * LogHub::MAX_BACKLOG_BYTES / _large.size(); i++) {
+        _burst_hub.publish("image:load", "image_load", _large, "info");
+    }
+    ok = ok && _stalled.closed && _burst_hub.disconnectedCount() == 1 && _burst_hub.connectionCount() == 0
+        && _stalled.text.size() * _large.size() <= LogHub::MAX_BACKLOG_BYTES + _large.size();
+    return ok;
+}
+
+bool Test::UNIT_test_log_stream_since() {
+    bool ok = parseLogTimestamp("2025-07-10T09:03:00Z") == 1752138180
+        && parseLogTimestamp("2025-07-10T09:03:00.123456789Z") == 1752138180
+        && parseLogTimestamp("2025-07-10T11:03:00+02:00") == 1752138180
+        && parseLogTimestamp("1752138180") == 1752138180;
+    ok = ok && parseLogTimestamp("") == -1
+        && parseLogTimestamp("yesterday") == -1
+        && parseLogTimestamp("2025-07-10") == -1
+        && parseLogTimestamp("2025-07-10T09:03:00 garbage") == -1;
+    return ok;
+}
+
+bool Test::UNIT_test_log_query_pages() {
+    // two containers logging at the same instants, one line without a timestamp
+    std::vector<LogLine> _lines;
+    for (int i = 0; i < 10; i++) {
+        char _raw[128];
+        snprintf(_raw, sizeof(_raw), "demo-web-1  | 2025-07-10T09:00:%02d.000000000Z web %d", i, i);
+        _lines.push_back(LogLine::parse(_raw));
+        snprintf(_raw, sizeof(_raw), "demo-db-1  | 2025-07-10T09:00:%02d.000000000Z db %d", i, i);
+        _lines.push_back(LogLine::parse(_raw));
+    }
+    _lines.push_back(LogLine::parse("demo-web-1  | no timestamp"));
+    bool ok = _lines[0].container == "demo-web-1" && _lines[0].message == "web 0" && _lines[0].seconds == 1752138000;
+
+    // backward from the end in pages of 3, then forward from the start in pages of 7
+    LogQuery _query;
+    _query.limit = 3;
+    _query.backward = true;
+    std::vector<std::string> _backward;
+    for (int i = 0; i < 20; i++) {
+        LogPage _page = selectLogPage(_lines, _query);
+        for (auto it = _page.lines.rbegin(); it != _page.lines.rend(); ++it) {
+            _backward.insert(_backward.begin(), it->message);
+        }
+        ok = ok && LogPosition::fromCursor(_page.before.cursor(), _query.cursor);
+        if (!_page.has_more) {
+            break;
+        }
+    }
+    ok = ok && _backward.size() == 20 && _backward.front() == "db 0" && _backward[1] == "web 0" && _backward.back() == "web 9";
+
+    LogQuery _forward;
+    _forward.limit = 7;
+    std::vector<std::string> _collected;
+    for (int i = 0; i < 20; i++) {
+        LogPage _page = selectLogPage(_lines, _forward);
+        for (const auto& _line : _page.lines) {
+            _collected.push_back(_line.message);
+        }
+        _forward.cursor = _page.after;
+        if (_page.lines.empty()) {
+            break;
+        }
+    }
+    ok = ok && _collected == _backward;
+
+    // since/until bound the range, inclusive of their second
+    LogQuery _range;
+    ok = ok && (_range.since.seconds = parseLogTimestamp("2025-07-10T09:00:03Z")) > 0;
+    ok = ok && (_range.until.seconds = parseLogTimestamp("2025-07-10T09:00:04Z")) > 0;
+    LogPage _page = selectLogPage(_lines, _range);
+    ok = ok && _page.lines.size() == 4 && _page.lines.front().message == "db 3" && _page.lines.back().message == "web 4";
+    return ok;
+}
+
+bool Test::UNIT_test_cgroup_sampler() {
+    // a fake cgroup v2 tree with a container in each layout docker uses
+    const std::filesystem::path _root = std::filesystem::temp_directory_path() / ("metainstaller_cgroup_" + std::to_string(getpid()));
+    const std::string _web1(64, 'a'), _web2(64, 'b'), _db(64, 'c');
+    auto _write = [&](const std::string& dir, const std::string& file, const std::string& content) {
+        std::filesystem::create_directories(_root / dir);
+        std::ofstream(_root / dir / file) << content;
+    };
+    auto _container = [&](const std::string& dir, uint64_t cpu_usec, uint64_t memory, bool io) {
+        _write(dir, "cpu.stat", "usage_usec " + std::to_string(cpu_usec) + "\nuser_usec " + std::to_string(cpu_usec / 2)
+               + "\nsystem_usec " + std::to_string(cpu_usec / 2) + "\nnr_periods 0\n");
+        _write(dir, "memory.current", std::to_string(memory) + "\n");
+        _write(dir, "memory.stat", "anon " + std::to_string(memory / 4) + "\nfile " + std::to_string(memory / 2) + "\nkernel 4096\n");
+        if (io) {
+            _write(dir, "io.stat", "8:0 rbytes=1000 wbytes=2000 rios=10 wios=20 dbytes=0 dios=0\n"
+                                   "8:16 rbytes=500 wbytes=0 rios=5 wios=0 dbytes=0 dios=0\n");
+        }
+    };
+    const std::string _web1_dir = "system.slice/docker-" + _web1 + ".scope";
+    const std::string _web2_dir = "docker/" + _web2;
+    const std::string _db_dir = "user.slice/user-1000.slice/user@1000.service/app.slice/docker-" + _db + ".scope";
+    _container(_web1_dir, 1000000, 64 << 20, true);
+    _container(_web2_dir, 2000000, 32 << 20, true);
+    _container(_db_dir, 500000, 128 << 20, false);
+
+    bool ok = true;
+    {
+        CgroupSampler _sampler(_root.string());
+        ok = ok && _sampler.findContainerCgroup(_web1) == _web1_dir && _sampler.findContainerCgroup(_web2) == _web2_dir
+            && _sampler.findContainerCgroup(_db) == _db_dir && _sampler.findContainerCgroup(std::string(64, 'd')).empty();
+        ok = ok && _sampler.track(_web1, _web1_dir) && _sampler.track(_web2, _web2_dir) && _sampler.track(_db, _db_dir)
+            && !_sampler.track("gone", "docker/gone") && _sampler.trackedCount() == 3;
+
+        CgroupUsage _usage;
+        ok = ok && _sampler.read(_web1, _usage) && _usage.cpu_usage_usec == 1000000 && _usage.cpu_user_usec == 500000
+            && _usage.memory_current == (64 << 20) && _usage.memory_anon == (16 << 20) && _usage.memory_file == (32 << 20)
+            && _usage.io_read_bytes == 1500 && _usage.io_write_bytes == 2000 && _usage.io_read_ops == 15
+            && _usage.io_write_ops == 20 && _usage.cpu_percent == 0;
+        ok = ok && _sampler.read(_db, _usage) && _usage.io_read_bytes == 0 && _usage.memory_current == (128 << 20);
+
+        // rates come from the previous read: half a second of cpu in about 100ms is about five cores
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        _container(_web1_dir, 1500000, 64 << 20, true);
+        ok = ok && _sampler.read(_web1, _usage) && _usage.cpu_percent > 100 && _usage.cpu_percent <= 500;
+        crow::logger(crow::LogLevel::Info) << "cgroup sampler: web1 at " << _usage.cpu_percent << "% cpu";
+
+        std::vector<ResourceMonitor::ContainerSample> _samples;
+        for (const auto& [service, id] : std::vector<std::pair<std::string, std::string>>{{"web", _web1}, {"web", _web2}, {"db", _db}}) {
+            ResourceMonitor::ContainerSample _sample{service, id, {}};
+            ok = ok && _sampler.read(id, _sample.usage);
+            _samples.push_back(_sample);
+        }
+        json11::Json _summary = ResourceMonitor::summarize("demo", _samples, 1);
+        ok = ok && _summary["running_containers"].int_value() == 4 && _summary["unavailable_containers"].int_value() == 1
+            && _summary["services"]["web"]["containers"].int_value() == 2
+            && _summary["services"]["web"]["memory_bytes"].number_value() == (96 << 20)
+            && _summary["total"]["memory_bytes"].number_value() == (224 << 20)
+            && _summary["total"]["cpu_usage_usec"].number_value() == 4000000
+            && _summary["containers"].array_items().size() == 3;
+        _sampler.untrack(_web2);
+        ok = ok && !_sampler.read(_web2, _usage) && _sampler.trackedCount() == 2;
+    }
+    std::filesystem::remove_all(_root);
+
+    // resource topics only reach connections that asked for them
+    LogHub _hub;
+    RecordingConnection _conn("");
+    _hub.add(&_conn);
+    _hub.publish("resources:demo", "resource_usage", "{}", "info");
+    ok = ok && _hub.handleControlMessage(_conn, "{\"type\":\"subscribe\",\"topics\":[\"resources:*\"]}");
+    _hub.publish("resources:demo", "resource_usage", "{}", "info");
+    std::this_thread::sleep_for(LogHub::BATCH_WINDOW * 4);
+    ok = ok && _hub.publishedCount() == 1 && _conn.text.size() == 2;
+    _hub.remove(&_conn);
+    return ok;
+}
+
+bool Test::UNIT_test_metrics_store() {
+    // 1 s buckets for a minute, 10 s buckets for ten minutes, at most 4 series
+    MetricsStore _store({{1, 60}, {10, 60}}, 4);
+    const int64_t _now = time(nullptr);
+    const int64_t _start = _now - _now % 30 - 300;
+    for (int64_t t = _start; t <= _start + 300; t++) {
+        _store.record("demo", "web", "cpu_percent", t, static_cast<double>(t - _start));
+    }
+    _store.record("demo", "", "containers", _start, 2);
+    _store.record("other", "db", "cpu_percent", _start, 1);
+    bool ok = _store.record("other", "db", "memory_bytes", _start, 1);
+    ok = ok && !_store.record("other", "db", "io_read_bytes_per_sec", _start, 1) && _store.seriesCount() == 4;
+
+    // the last 30 s are still in the 1 s tier
+    const std::string _demo = "demo", _web = "web", _cpu = "cpu_percent";
+    auto _fine = _store.query(&_demo, &_web, &_cpu, _start + 271, _start + 300, 300);
+    ok = ok && _fine.step == 1 && _fine.series.size() == 1 && _fine.series[0].timestamps.size() == 30
+        && _fine.series[0].avg.front() == 271 && _fine.series[0].max.back() == 300;
+
+    // five minutes back only the 10 s tier reaches, merged into 30 s points
+    auto _coarse = _store.query(&_demo, &_web, &_cpu, _start, _start + 299, 10);
+    ok = ok && _coarse.step == 30 && _coarse.series.size() == 1 && _coarse.series[0].timestamps.size() == 10
+        && _coarse.series[0].timestamps[0] == _start && _coarse.series[0].avg[0] == 14.5 && _coarse.series[0].max[0] == 29
+        && _coarse.series[0].avg[9] == 284.5;
+
+    // filters: a project's series, the project wide series, everything
+    const std::string _empty;
+    ok = ok && _store.query(&_demo, nullptr, nullptr, _start, _now).series.size() == 2
+        && _store.query(&_demo, &_empty, nullptr, _start, _now).series.size() == 1
+        && _store.query(nullptr, nullptr, &_cpu, _start, _now).series.size() == 2;
+
+    // buckets older than a ring reaches are gone, not misread as newer ones
+    auto _old = _store.query(&_demo, &_web, &_cpu, _start - 1200, _start - 600, 300);
+    ok = ok && _old.series.size() == 1 && _old.series[0].timestamps.empty();
+
+    // coarse buckets survive an export/import round trip, later exports only carry changed buckets
+    std::vector<MetricPoint> _points = _store.exportPoints(10);
+    MetricsStore _restored({{1, 60}, {10, 60}}, 4);
+    _restored.importPoints(_points);
+    auto _again = _restored.query(&_demo, &_web, &_cpu, _start, _start + 299, 10);
+    ok = ok && !_points.empty() && _again.series.size() == 1 && _again.series[0].avg == _coarse.series[0].avg
+        && _again.series[0].max == _coarse.series[0].max;
+    ok = ok && _store.exportPoints(10).size() < _points.size();
+
+    _store.removeProject("demo");
+    ok = ok && _store.seriesCount() == 2;
+    // a day of minute samples for 120 services, then one chart query over all of them
+    MetricsStore _large;
+    const char* _metrics[] = {"cpu_percent", "memory_bytes", "io_read_bytes_per_sec", "io_write_bytes_per_sec", "containers"};
+    std::vector<std::string> _services;
+    for (int i = 0; i < 120; i++) {
+        _services.push_back("service_" + std::to_string(i));
+    }
+    for (int64_t t = _now - 86400; t <= _now; t += 60) {
+        for (size_t i = 0; i < _services.size(); i++) {
+            for (const char* _metric : _metrics) {
+                _large.record("large", _services[i], _metric, t, static_cast<double>(i));
+            }
+        }
+    }
+    const std::string _large_project = "large";
+    const int64_t _day_end = time(nullptr);
+    const auto _query_started = std::chrono::steady_clock::now();
+    auto _day = _large.query(&_large_project, nullptr, nullptr, _day_end - 86000, _day_end, 300);
+    const double _query_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _query_started).count();
+    ok = ok && _day.series.size() == 600 && _day.step == 300 && _day.series[0].timestamps.size() >= 280;
+    crow::logger(crow::LogLevel::Info) << "metrics store: " << _large.memoryBytes() / _large.seriesCount()
+                                       << " bytes per series, day query over " << _day.series.size() << " series took " << _query_ms << " ms";
+    return ok;
+}
+
+bool Test::UNIT_test_json_line_scanner() {
+    const std::string _output =
+        "{\"ID\":\"abc\",\"Labels\":{\"a\":\"}\",\"b\":[1,{\"c\":\"]\"}]},\"Names\":\"web\\\"1\\u00e9\\ud83d\\ude00\",\"Size\":12.5,\"Ok\":true}\r\n"
+        "\n"
+        "  { \"State\" : \"running\" , \"Names\" : \"db\" }  \n"
+        "not json\n"
+        "{\"ID\":\"broken\n"
+        "{\"Names\":\"last\"}";
+
+    JsonLineScanner _scanner(_output);
+    JsonField _fields[4];
+    bool ok = _scanner.next() && _scanner.valid()
+        && _scanner.fields({"ID", "Names", "Size", "Missing"}, _fields);
+    // nested values are skipped, escapes resolved, numbers and missing keys reported as such
+    ok = ok && _fields[0].str() == "abc" && !_fields[0].escaped
+        && _fields[1].escaped && _fields[1].str() == "web\"1\xc3\xa9\xf0\x9f\x98\x80"
+        && !_fields[2].is_string && _fields[2].number() == 12.5 && !_fields[3].found;
+    ok = ok && _scanner.fields({"Labels", "Ok"}, _fields) && _fields[0].raw == "{\"a\":\"}\",\"b\":[1,{\"c\":\"]\"}]}"
+        && _fields[1].raw == "true";
+
+    ok = ok && _scanner.next() && _scanner.valid() && _scanner.fields({"State", "Names"}, _fields)
+        && _fields[0].str() == "running" && _fields[1].str() == "db";
+    // a cut off line is reported, blank and non-object lines are passed over
+    ok = ok && _scanner.next() && !_scanner.valid() && !_scanner.fields({"Names"}, _fields);
+    ok = ok && _scanner.next() && _scanner.fields({"Names"}, _fields) && _fields[0].str() == "last";
+    ok = ok && !_scanner.next();
+
+    // long strings cross the 16 byte blocks of the vector search at every offset
+    for (size_t _length = 0; _length < 40 && ok; _length++) {
+        const std::string _value(_length, 'x');
+        const std::string _line = "{\"k\":\"" + _value + "\\\\" + _value + "\",\"v\":\"" + _value + "\"}";
+        JsonLineScanner _long(_line);
+        ok = _long.next() && _long.fields({"k", "v"}, _fields)
+            && _fields[0].str() == _value + "\\" + _value && _fields[1].str() == _value;
+    }
+
+    // same fields as a full json11 parse, on docker ps sized lines
+    std::string _ps;
+    for (int i = 0; i < 20000; i++) {
+        _ps += "{\"Command\":\"\\\"docker-entrypoint.sh postgres\\\"\",\"CreatedAt\":\"2024-05-01 10:00:00 +0000 UTC\","
+               "\"ID\":\"" + std::to_string(100000 + i) + "\",\"Image\":\"postgres:16\",\"Labels\":\"com.docker.compose.project=demo,"
+               "com.docker.compose.service=db,com.docker.compose.version=2.24.0\",\"LocalVolumes\":\"1\",\"Mounts\":\"demo_data\","
+               "\"Names\":\"demo-db-" + std::to_string(i) + "\",\"Networks\":\"demo_default\",\"Ports\":\"5432/tcp\","
+               "\"RunningFor\":\"2 hours ago\",\"Size\":\"0B\",\"State\":\"running\",\"Status\":\"Up 2 hours\"}\n";
+    }
+    auto _started = std::chrono::steady_clock::now();
+    size_t _dom_hits = 0;
+    std::istringstream _iss(_ps);
+    std::string _line;
+    while (std::getline(_iss, _line)) {
+        std::string _error;
+        json11::Json _json = json11::Json::parse(_line, _error);
+        _dom_hits += _json["State"].string_value() == "running" && !_json["ID"].string_value().empty();
+    }
+    const double _dom_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _started).count();
+
+    _started = std::chrono::steady_clock::now();
+    size_t _scan_hits = 0;
+    JsonLineScanner _ps_scanner(_ps);
+    while (_ps_scanner.next()) {
+        _scan_hits += _ps_scanner.fields({"ID", "State"}, _fields) && _fields[1].raw == "running" && !_fields[0].raw.empty();
+    }
+    const double _scan_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _started).count();
+    ok = ok && _dom_hits == 20000 && _scan_hits == 20000;
+    crow::logger(crow::LogLevel::Info) << "json line scanner: 20000 lines in " << _scan_ms << " ms, json11 took " << _dom_ms << " ms";
+    return ok;
+}
+
+bool Test::UNIT_test_json_writer() {
+    const std::string _text = std::string("quote \" slash \\ tab \t nl \n ctl \x01 e\xc3\xa9 ls \xe2\x80\xa8 euro \xe2\x82\xac");
+    JsonWriter _json;
+    _json.beginObject()
+        .field("text", _text)
+        .field("flag", false)
+        .field("count", static_cast<size_t>(5000000000ULL))
+        .field("delta", -3)
+        .field("ratio", 0.25)
+        .field("nan", std::nan(""))
+        .field("list", std::vector<std::string>{"a", "b"})
+        .key("empty").beginObject().endObject()
+        .key("nested").beginArray().beginArray().value(1).endArray().null().raw("{\"x\":1}").endArray()
+        .endObject();
+
+    std::string _error;
+    json11::Json _parsed = json11::Json::parse(_json.str(), _error);
+    const json11::Json _expected = json11::Json::object{
+        {"text", _text}, {"flag", false}, {"count", 5000000000.0}, {"delta", -3}, {"ratio", 0.25}, {"nan", nullptr},
+        {"list", json11::Json::array{"a", "b"}}, {"empty", json11::Json::object{}},
+        {"nested", json11::Json::array{json11::Json::array{1}, nullptr, json11::Json::object{{"x", 1}}}}};
+    bool ok = _error.empty() && _parsed == _expected
+        && _json.str().find("\\u2028") != std::string::npos && _json.str().find("\xe2\x82\xac") != std::string::npos;
+    if (!ok) {
+        crow::logger(crow::LogLevel::Error) << "json writer output: " << _json.str() << " " << _error;
+    }
+
+    // a project list, built as a json11 DOM and dumped versus written directly
+    std::vector<ProjectInfo> _projects(20000);
+    for (size_t i = 0; i < _projects.size(); i++) {
+        ProjectInfo& _project = _projects[i];
+        _project.name = "project_" + std::to_string(i);
+        _project.archive_path = "/home/user/archives/" + _project.name + ".7z";
+        _project.extracted_path = "/home/user/.metainstaller/projects/" + _project.name;
+        _project.compose_file_path = _project.extracted_path + "/docker-compose.yml";
+        _project.status_message = "Project loaded \"ok\"";
+        _project.created_time = "2024-05-01 10:00:00";
+        _project.last_modified = "2024-05-01 10:00:00";
+        _project.required_images = {"postgres:16", "redis:7", "nginx:1.25"};
+        _project.dependent_files = {"images/postgres.tar", "images/redis.tar"};
+    }
+    auto _started = std::chrono::steady_clock::now();
+    json11::Json::array _dom;
+    for (const auto& _project : _projects) {
+        _dom.push_back(json11::Json::object{
+            {"name", _project.name}, {"archive_path", _project.archive_path}, {"extracted_path", _project.extracted_path},
+            {"compose_file_path", _project.compose_file_path}, {"is_loaded", _project.is_loaded}, {"is_running", _project.is_running},
+            {"status_message", _project.status_message}, {"created_time", _project.created_time}, {"last_modified", _project.last_modified},
+            {"required_images", json11::Json::array(_project.required_images.begin(), _project.required_images.end())},
+            {"dependent_files", json11::Json::array(_project.dependent_files.begin(), _project.dependent_files.end())}});
+    }
+    const std::string _dom_text = json11::Json(json11::Json::object{{"success", true}, {"projects", _dom}}).dump();
+    const double _dom_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _started).count();
+
+    _started = std::chrono::steady_clock::now();
+    JsonWriter _list(256 + _projects.size() * 1024);
+    _list.beginObject().field("success", true).key("projects").beginArray();
+    for (const auto& _project : _projects) {
+        _list.beginObject()
+            .field("name", _project.name).field("archive_path", _project.archive_path).field("extracted_path", _project.extracted_path)
+            .field("compose_file_path", _project.compose_file_path).field("is_loaded", _project.is_loaded).field("is_running", _project.is_running)
+            .field("status_message", _project.status_message).field("created_time", _project.created_time).field("last_modified", _project.last_modified)
+            .field("required_images", _project.required_images).field("dependent_files", _project.dependent_files)
+            .endObject();
+    }
+    _list.endArray().endObject();
+    crow::response _list_response = _list.response(200);
+    const double _writer_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _started).count();
+
+    _parsed = json11::Json::parse(_list_response.body, _error);
+    ok = ok && _error.empty() && _parsed == json11::Json::parse(_dom_text, _error) && _list.str().empty()
+        && _list_response.get_header_value("Content-Type") == "application/json";
+    crow::logger(crow::LogLevel::Info) << "json writer: 20000 projects in " << _writer_ms << " ms (" << _list_response.body.size()
+                                       << " bytes), json11 DOM and dump took " << _dom_ms << " ms (" << _dom_text.size() << " bytes)";
+    return ok;
+}
+
+bool Test::UNIT_test_admission_control() {
+    AdmissionControl _admission(3);
+    _admission.addLane("slow", 1, 1);
+    bool ok = _admission.workerThreads() == 5;
+
+    std::promise<void> _release;
+    std::shared_future<void> _released = _release.get_future().share();
+    std::atomic<int> _order{0};
+    std::atomic<int> _first_done{-1};
+    std::atomic<int> _second_done{-1};
+    auto _slow = [&](std::atomic<int>& _done) {
+        return [&]() {
+            _released.wait();
+            _done = _order++;
+            return crow::response(200);
+        };
+    };
+
+    // one running, one queued, the third is turned away
+    std::thread _first([&]() { _admission.run("slow", _slow(_first_done)); });
+    auto _wait_for = [&](size_t _active, size_t _queued) {
+        for (int i = 0; i < 200; i++) {
+            auto _stats = _admission.stats();
+            if (_stats[0].active == _active && _stats[0].queued == _queued) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    };
+    ok = ok && _wait_for(1, 0);
+    std::thread _second([&]() { _admission.run("slow", _slow(_second_done)); });
+    ok = ok && _wait_for(1, 1);
+    crow::response _rejected = _admission.run("slow", []() { return crow::response(200); });
+    ok = ok && _rejected.code == 429 && std::stoi(_rejected.get_header_value("Retry-After")) >= 1;
+
+    // other lanes and unknown lanes are not held up
+    ok = ok && _admission.run("quick", []() { return crow::response(204); }).code == 204;
+
+    _release.set_value();
+    _first.join();
+    _second.join();
+    auto _stats = _admission.stats();
+    ok = ok && _first_done == 0 && _second_done == 1 && _stats[0].active == 0 && _stats[0].queued == 0
+        && _stats[0].admitted == 2 && _stats[0].rejected == 1 && _stats[0].max_wait_ms > 0;
+
+    // a handler that throws gives its slot back
+    try {
+        _admission.run("slow", []() -> crow::response { throw std::runtime_error("failed"); });
+        ok = false;
+    } catch (const std::runtime_error&) {
+    }
+    ok = ok && _admission.stats()[0].active == 0 && _admission.run("slow", []() { return crow::response(200); }).code == 200;
+    return ok;
+}
+
+bool Test::UNIT_test_blocking_executor() {
+    BlockingExecutor _executor(1, 1);
+    asio::io_context _io;
+    auto _guard = asio::make_work_guard(_io);
+    const std::thread::id _io_thread = std::this_thread::get_id();
+
+    std::promise<void> _release;
+    std::shared_future<void> _released = _release.get_future().share();
+    std::atomic<bool> _rendered_off_io{false};
+    crow::response _first, _second, _third, _failed;
+    _executor.respond(&_io, _first, [&]() {
+        _rendered_off_io = std::this_thread::get_id() != _io_thread;
+        _released.wait();
+        return crow::response(200, "first");
+    });
+    // wait until the worker took the first one, then fill the queue
+    for (int i = 0; i < 200 && _executor.queued() > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    _executor.respond(&_io, _second, []() { return crow::response(200, "second"); });
+    _executor.respond(&_io, _third, []() { return crow::response(200, "third"); });
+    bool ok = _third.is_completed() && _third.code == 503 && _third.get_header_value("Retry-After") == "1"
+        && !_first.is_completed() && !_second.is_completed();
+
+    // responses are only ended by the io thread
+    _release.set_value();
+    for (int i = 0; i < 200 && !(_first.is_completed() && _second.is_completed()); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ok = ok && !_first.is_completed();
+        _io.poll();
+    }
+    ok = ok && _rendered_off_io && _first.is_completed() && _first.body == "first" && _second.body == "second";
+
+    _executor.respond(&_io, _failed, []() -> crow::response { throw std::runtime_error("docker not found"); });
+    for (int i = 0; i < 200 && !_failed.is_completed(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        _io.poll();
+    }
+    ok = ok && _failed.code == 500 && _failed.body.find("docker not found") != std::string::npos;
+    return ok;
+}
+
+bool Test::UNIT_test_batch_requests() {
+    crow::SimpleApp _app;
+    CROW_ROUTE(_app, "/api/slow")([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        crow::response res(200, "{\"slow\":true}");
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+    CROW_ROUTE(_app, "/api/echo").methods("POST"_method)([](const crow::request& req) {
+        return crow::response(200, req.body + " " + req.url_params.get("suffix"));
+    });
+    // ended later from the request's io_context, like the BlockingExecutor routes
+    CROW_ROUTE(_app, "/api/later")([](const crow::request& req, crow::response& res) {
+        asio::post(*req.io_context, [&res]() { res.code = 202; res.end(); });
+    });
+    CROW_ROUTE(_app, "/api/broken")([]() {
+        crow::response res(200, "{\"truncated\": [1, 2");
+        res.set_header("Content-Type", "application/json");
+        return res;
+    });
+    BatchManager _batch(_app, 4, 10);
+    _batch.registerRestEndpoints(_app);
+    _app.validate();
+
+    auto _post = [&_app](const json11::Json& body, json11::Json& json) {
+        InProcessResponse res = dispatchInProcess(_app, crow::HTTPMethod::Post, "/api/batch", body.dump());
+        std::string parse_error;
+        json = json11::Json::parse(res.body, parse_error);
+        return res.code;
+    };
+
+    json11::Json::array _requests;
+    for (int i = 0; i < 4; i++) {
+        _requests.push_back(json11::Json::object{{"path", "/api/slow"}});
+    }
+    _requests.push_back(json11::Json::object{{"method", "post"}, {"path", "/api/echo?suffix=world"}, {"body", "hello"}});
+    _requests.push_back(json11::Json::object{{"path", "/api/later"}});
+    _requests.push_back(json11::Json::object{{"path", "/etc/passwd"}});
+    _requests.push_back(json11::Json::object{{"method", "POST"}, {"path", "/api/batch"}});
+    _requests.push_back(json11::Json::object{{"path", "/api/missing"}});
+    _requests.push_back(json11::Json::object{{"path", "/api/broken"}});
+
+    json11::Json _json;
+    auto _started = std::chrono::steady_clock::now();
+    int _code = _post(json11::Json::object{{"concurrency", 4}, {"requests", _requests}}, _json);
+    auto _parallel_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _started).count();
+    const auto& _results = _json["results"].array_items();
+    bool ok = _code == 200 && _results.size() == _requests.size() && _parallel_ms < 700;
+    for (size_t i = 0; ok && i < 4; i++) {
+        ok = _results[i]["index"].int_value() == static_cast<int>(i) && _results[i]["status"].int_value() == 200
+            && _results[i]["body"]["slow"].bool_value() && _results[i]["elapsed_ms"].number_value() >= 150;
+    }
+    ok = ok && _results[4]["method"].string_value() == "POST" && _results[4]["body"].string_value() == "hello world";
+    ok = ok && _results[5]["status"].int_value() == 202 && _results[5]["body"].is_null();
+    ok = ok && _results[6]["status"].int_value() == 400 && !_results[6]["ok"].bool_value();
+    ok = ok && _results[7]["status"].int_value() == 400 && _results[7]["body"]["error"].string_value() == "Batches cannot be nested";
+    ok = ok && _results[8]["status"].int_value() == 404;
+    // a body that is not the JSON its content type claims comes back as a string, the batch stays valid
+    ok = ok && _results[9]["status"].int_value() == 200 && _results[9]["body"].string_value() == "{\"truncated\": [1, 2";
+
+    // one at a time when asked to
+    _started = std::chrono::steady_clock::now();
+    _code = _post(json11::Json::object{{"concurrency", 1}, {"requests", json11::Json::array(_requests.begin(), _requests.begin() + 3)}}, _json);
+    auto _sequential_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _started).count();
+    ok = ok && _code == 200 && _json["concurrency"].int_value() == 1 && _sequential_ms >= 600;
+
+    ok = ok && _post(json11::Json::array(11, json11::Json::object{{"path", "/api/slow"}}), _json) == 400;
+    ok = ok && _post(json11::Json::array{}, _json) == 400;
+    crow::logger(crow::LogLevel::Info) << "Batch of 4 slow requests: " << _parallel_ms << " ms in parallel, 3 sequential: " << _sequential_ms << " ms";
+    return ok;
+}
+
+bool Test::UNIT_test_local_socket() {
+    crow::SimpleApp _app;
+    CROW_ROUTE(_app, "/api/ping")([](const crow::request& req) {
+        return crow::response(200, "pong from " + req.remote_ip_address);
+    });
+    auto _server = _app.port(0).concurrency(2).run_async();
+    if (_app.wait_for_server_start() != std::cv_status::no_timeout) {
+        return false;
+    }
+
+    const std::string _path = "/tmp/metainstaller_test_" + std::to_string(getpid()) + ".sock";
+    {
+        // a regular file in the way is not replaced
+        std::ofstream(_path) << "not a socket";
+        LocalSocketListener _blocked(_app, _path, 0600, "");
+        bool ok = !_blocked.start();
+        std::filesystem::remove(_path);
+        if (!ok) {
+            _app.stop();
+            return false;
+        }
+    }
+    LocalSocketListener _listener(_app, _path, 0660, "");
+    struct stat _st;
+    bool ok = _listener.start() && stat(_path.c_str(), &_st) == 0 && S_ISSOCK(_st.st_mode) && (_st.st_mode & 0777) == 0660;
+
+    // median and 99th percentile of sequential small GETs, in microseconds
+    auto _measure = [](httplib::Client& client, int count, bool& all_ok) {
+        std::vector<double> samples;
+        for (int i = 0; i < count; i++) {
+            auto started = std::chrono::steady_clock::now();
+            auto res = client.Get("/api/ping");
+            samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count());
+            all_ok = all_ok && res && res->status == 200 && res->body.rfind("pong", 0) == 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        return std::make_pair(samples[samples.size() / 2], samples[samples.size() * 99 / 100]);
+    };
+    for (bool keep_alive : {true, false}) {
+        const int count = keep_alive ? 2000 : 300;
+        httplib::Client _tcp("127.0.0.1", _app.port());
+        httplib::Client _unix(_path, 80);
+        _unix.set_address_family(AF_UNIX);
+        _tcp.set_keep_alive(keep_alive);
+        _unix.set_keep_alive(keep_alive);
+        auto [tcp_p50, tcp_p99] = _measure(_tcp, count, ok);
+        auto [unix_p50, unix_p99] = _measure(_unix, count, ok);
+        crow::logger(crow::LogLevel::Info) << (keep_alive ? "keep-alive" : "connection per request") << ", " << count
+            << " GETs: loopback TCP p50 " << tcp_p50 << " us, p99 " << tcp_p99 << " us; unix socket p50 " << unix_p50 << " us, p99 " << unix_p99 << " us";
+    }
+    {
+        httplib::Client _unix(_path, 80);
+        _unix.set_address_family(AF_UNIX);
+        auto res = _unix.Get("/api/ping");
+        ok = ok && res && res->body == "pong from " + _path;
+    }
+
+    // a second listener does not take over a socket that is in use
+    LocalSocketListener _second(_app, _path, 0660, "");
+    ok = ok && !_second.start() && std::filesystem::exists(_path);
+
+    _listener.stop();
+    ok = ok && !std::filesystem::exists(_path);
+    _app.stop();
+    _server.wait();
+    return ok;
+}
+
+bool Test::UNIT_test_archive_manifest() {
+    const char _digits[] = "123456789";
+    bool ok = ArchiveManifest::formatCrc(ArchiveManifest::crc32(_digits, 9)) == "CBF43926";
+    // the CRC can be carried over chunks
+    ok = ok && ArchiveManifest::crc32(_digits + 4, 5, ArchiveManifest::crc32(_digits, 4)) == ArchiveManifest::crc32(_digits, 9);
+
+    const std::string _listing =
+        "Listing archive: project.7z\n\n--\nPath = project.7z\nType = 7z\n\n----------\n"
+        "Path = html\nSize = 0\nFolder = +\nCRC = \n\n"
+        "Path = html/index.html\nSize = 12\nFolder = -\nCRC = 0A1B2C3D\n\n"
+        "Path = ./docker-compose.yml\r\nSize = 120\r\nAttributes = A -rw-r--r--\r\nCRC = 11111111\r\n\r\n"
+        "Path = images/web.tar\nSize = 2048\nFolder = -\nCRC = 22222222\nEncrypted = +\n\n"
+        "Path = old/notes.txt\nSize = 3\nFolder = -\nCRC = 33333333\n";
+    ArchiveManifest _before = ArchiveManifest::parseSltListing(_listing);
+    ok = ok && _before.entries.size() == 5 && _before.contains("docker-compose.yml") && !_before.contains("project.7z")
+        && _before.entries["html"].is_directory && _before.entries["images/web.tar"].size == 2048
+        && _before.entries["html/index.html"].crc == "0A1B2C3D"
+        && _before.entries["images/web.tar"].encrypted && !_before.entries["html/index.html"].encrypted;
+    ok = ok && ArchiveManifest::fromJson(_before.toJson()).toJson() == _before.toJson();
+
+    ArchiveManifest _after = _before;
+    _after.entries.erase("old/notes.txt");
+    _after.entries["images/web.tar"].crc = "44444444";
+    _after.entries["html/app.js"] = {"html/app.js", 7, "55555555", false};
+    ManifestDiff _diff = _before.diff(_after);
+    ok = ok && _diff.added == std::vector<std::string>{"html/app.js"}
+        && _diff.changed == std::vector<std::string>{"images/web.tar"}
+        && _diff.removed == std::vector<std::string>{"old/notes.txt"} && _diff.unchanged == 2;
+    ok = ok && _diff.touches("./html") && _diff.touches("images/web.tar") && !_diff.touches("htm") && !_diff.touches("docker-compose.yml");
+    ok = ok && _before.diff(_before).empty();
+
+    // projects extracted before manifests were kept are compared with their files
+    const std::string _root = Utils::path_join_multiple({std::filesystem::temp_directory_path().string(), "mi_manifest_test"});
+    std::filesystem::remove_all(_root);
+    std::filesystem::create_directories(_root + "/html");
+    std::ofstream(_root + "/html/index.html") << "123456789";
+    std::ofstream(_root + "/local.txt") << "not from the archive";
+    ArchiveManifest _listed;
+    _listed.entries["html/index.html"] = {"html/index.html", 9, "CBF43926", false};
+    _listed.entries["html/new.css"] = {"html/new.css", 1, "00000001", false};
+    ArchiveManifest _disk = ArchiveManifest::fromDirectory(_root, _listed);
+    ok = ok && _disk.entries.size() == 1 && _disk.entries["html/index.html"].crc == "CBF43926";
+    ok = ok && _disk.diff(_listed).added == std::vector<std::string>{"html/new.css"} && _disk.diff(_listed).unchanged == 1;
+    std::filesystem::remove_all(_root);
+
+    // only the edited service gets a new definition hash
+    const std::string _web = "name: demo\nservices:\n  web:\n    image: nginx:alpine\n    volumes:\n      - ./html:/usr/share/nginx/html\n";
+    ComposeModel _old = ComposeModel::parse(_web + "  cache:\n    image: redis:alpine\n", "/tmp/docker-compose.yml");
+    ComposeModel _new = ComposeModel::parse(_web + "  cache:\n    image: redis:7\n", "/tmp/docker-compose.yml");
+    ok = ok && _old.valid && _new.valid && _old.service("web") && _new.service("cache") && !_old.service("db")
+        && _old.service("web")->definition_hash == _new.service("web")->definition_hash
+        && _old.service("cache")->definition_hash != _new.service("cache")->definition_hash
+        && _old.shared_hash == _new.shared_hash;
+
+    ok = ok && ImageIndex::loadedImages("Loaded image: nginx:alpine\r\nLoaded image ID: sha256:abc\nLoaded image: redis:7\n")
+        == std::vector<std::string>{"nginx:alpine", "redis:7"};
+    return ok;
+}
+
+bool Test::UNIT_test_content_store() {
+    bool ok = ContentStore::sha256("abc", 3) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+    const std::string _long(1000000, 'a');
+    ok = ok && ContentStore::sha256(_long.data(), _long.size()) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+
+    MetaDatabase _database;
+    ok = ok && _database.initDatabase();
+    const std::string _root = Utils::path_join_multiple({std::filesystem::temp_directory_path().string(), "mi_content_store_test"});
+    std::filesystem::remove_all(_root);
+    ContentStore _store(_root + "/store", 16);
+
+    // two projects with the same image tar, the same other large file and a small one each
+    const std::string _content = "layers of an image that several projects ship";
+    const std::string _weights = "weights of a model that several projects ship";
+    ArchiveManifest _manifest;
+    _manifest.entries["images/web.tar"] = {"images/web.tar", _content.size(),
+                                          ArchiveManifest::formatCrc(ArchiveManifest::crc32(_content.data(), _content.size())), false};
+    _manifest.entries["model/weights.bin"] = {"model/weights.bin", _weights.size(),
+                                             ArchiveManifest::formatCrc(ArchiveManifest::crc32(_weights.data(), _weights.size())), false};
+    _manifest.entries["small.txt"] = {"small.txt", 2, "12345678", false};
+    std::filesystem::create_directories(_root + "/a/images");
+    std::filesystem::create_directories(_root + "/a/model");
+    std::ofstream(_root + "/a/images/web.tar") << _content;
+    std::ofstream(_root + "/a/model/weights.bin") << _weights;
+    std::ofstream(_root + "/a/small.txt") << "hi";
+
+    // stands in for hashing the archive entry, whose content is what project a extracted
+    auto _archive_hash = [&_root](const std::string& path) { return ContentStore::sha256File(_root + "/a/" + path); };
+    auto _blob_of = [&_root](const std::string& content) {
+        const std::string _hash = ContentStore::sha256(content.data(), content.size());
+        return _root + "/store/blobs/" + _hash.substr(0, 2) + "/" + _hash;
+    };
+
+    const auto _before = _store.stats();
+    ok = ok && _store.linkKnown("ut_store_a", _manifest, _root + "/a", _archive_hash).empty();
+    _store.ingest("ut_store_a", _manifest, _root + "/a");
+    const std::string _blob = _blob_of(_content);
+    // any other file is only stored where it can be a reflink: a copy would take the space it saves
+    const std::string _weights_blob = _blob_of(_weights);
+    const bool _reflinks = std::filesystem::exists(_weights_blob);
+    const size_t _stored = _reflinks ? 2 : 1;
+    const uint64_t _stored_bytes = _content.size() + (_reflinks ? _weights.size() : 0);
+    ok = ok && std::filesystem::exists(_blob) && _store.stats().blobs == _before.blobs + _stored
+        && _store.stats().referenced_bytes == _before.referenced_bytes + _stored_bytes;
+
+    // the second project gets the files without extracting them, the small one is left to extraction
+    // an entry whose size and CRC match but whose content differs is extracted, not linked
+    ok = ok && _store.linkKnown("ut_store_c", _manifest, _root + "/c",
+                                [](const std::string& path) { return ContentStore::sha256(path.data(), path.size()); }).empty()
+        && !std::filesystem::exists(_root + "/c/images/web.tar");
+    std::set<std::string> _linked = _store.linkKnown("ut_store_b", _manifest, _root + "/b", _archive_hash);
+    std::ifstream _linked_file(_root + "/b/images/web.tar");
+    std::string _read((std::istreambuf_iterator<char>(_linked_file)), std::istreambuf_iterator<char>());
+    std::set<std::string> _expected{"images/web.tar"};
+    if (_reflinks) {
+        _expected.insert("model/weights.bin");
+    }
+    ok = ok && _linked == _expected && _read == _content
+        && _store.stats().referenced_bytes == _before.referenced_bytes + 2 * _stored_bytes;
+    // only image archives may share the blob's inode, a write to any other file stays in its project
+    struct stat _blob_stat, _file_stat;
+    ok = ok && (!_reflinks || (::stat(_weights_blob.c_str(), &_blob_stat) == 0
+                               && ::stat((_root + "/b/model/weights.bin").c_str(), &_file_stat) == 0
+                               && _blob_stat.st_ino != _file_stat.st_ino));
+    // without reflinks the project's own file is neither copied into the store nor counted twice
+    ok = ok && (_reflinks || !std::filesystem::exists(_root + "/b/model/weights.bin"));
+
+    // the blob stays until the last project lets go of it
+    _store.release("ut_store_a");
+    ok = ok && std::filesystem::exists(_blob);
+    _store.release("ut_store_b", {"images/web.tar", "model/weights.bin"});
+    ok = ok && !std::filesystem::exists(_blob) && !std::filesystem::exists(_weights_blob) && _store.stats().blobs == _before.blobs;
+    // the projects' files do not depend on the blob
+    std::ifstream _kept(_root + "/b/images/web.tar");
+    std::string _kept_content((std::istreambuf_iterator<char>(_kept)), std::istreambuf_iterator<char>());
+    ok = ok && _kept_content == _content;
+    std::filesystem::remove_all(_root);
+    return ok;
+}
+
+bool Test::REST_test_project_reload() {
+    assertm(!base_url.empty(), "Base URL is empty");
+
+    httplib::Client client(base_url.c_str());
+    client.set_connection_timeout(5);
+    client.set_read_timeout(60);
+
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string project_name = "test_project_reload_" + std::to_string(now);
+    std::string archive_path = "../example_project.7z";
+    if(!std::filesystem::exists(archive_path))
+    {
+        archive_path = "example_project.7z";
+    }
+    archive_path = std::filesystem::absolute(archive_path).string();
+
+    json11::Json json_data_load = json11::Json::object{
+        {"archive_path", archive_path},
+        {"project_name", project_name},
+        {"password", "secret"}
+    };
+    auto res_load = client.Post("/api/projects/load", json_data_load.dump(), "application/json");
+    if (!res_load || res_load->status != 200) {
+        crow::logger(crow::LogLevel::ERROR) << "Failed to load project for reload test";
+        return false;
+    }
+    auto res_start = client.Post(("/api/projects/" + project_name + "/start").c_str());
+
+    // a file the project wrote itself survives the reload
+    const std::string project_path = Utils::path_join_multiple({Utils::get_metainstaller_home_dir(), "projects", project_name});
+    std::filesystem::create_directories(project_path + "/data");
+    std::ofstream(project_path + "/data/state") << "kept";
+
+    json11::Json json_data_reload = json11::Json::object{
+        {"archive_path", archive_path},
+        {"password", "secret"}
+    };
+    auto res = client.Post(("/api/projects/" + project_name + "/reload").c_str(), json_data_reload.dump(), "application/json");
+    bool success = false;
+    if (res) {
+        crow::logger(crow::LogLevel::Info) << "Project Reload Test Status: " << res->status;
+        crow::logger(crow::LogLevel::Info) << "Project Reload Test Response: " << res->body;
+        std::string parse_error;
+        auto body = json11::Json::parse(res->body, parse_error);
+        success = res->status == 200 && body["success"].bool_value()
+            && body["was_running"].bool_value() == (res_start && res_start->status == 200)
+            && body["carried_over"].int_value() == 1
+            && std::filesystem::exists(project_path + "/data/state")
+            && std::filesystem::exists(project_path + "/docker-compose.yml")
+            && !std::filesystem::exists(Utils::path_join_multiple({Utils::get_metainstaller_home_dir(), "projects", "." + project_name + ".stage"}));
+    } else {
+        crow::logger(crow::LogLevel::ERROR) << "Error: " << httplib::to_string(res.error());
+    }
+
+    client.Post(("/api/projects/" + project_name + "/stop").c_str());
+    client.Delete(("/api/projects/" + project_name + "/remove?remove_files=true").c_str());
+    return success;
+}
+
+bool Test::UNIT_test_trash_reaper() {
+    const std::string _root = Utils::path_join_multiple({std::filesystem::temp_directory_path().string(), "mi_trash_reaper_test"});
+    std::filesystem::remove_all(_root);
+    // a tree left over from a previous run
+    std::filesystem::create_directories(_root + "/trash/old.1.0/sub");
+    std::ofstream(_root + "/trash/old.1.0/sub/file") << "x";
+
+    // a project-like tree: nested directories, files and a symlink pointing out of it
+    const std::string _tree = _root + "/project";
+    const std::string _outside = _root + "/outside.txt";
+    std::ofstream(_outside) << "must survive";
+    size_t _files = 0;
+    for (int d = 0; d < 20; d++) {
+        const std::string _dir = _tree + "/dir" + std::to_string(d) + "/nested/deeper";
+        std::filesystem::create_directories(_dir);
+        for (int f = 0; f < 50; f++) {
+            std::ofstream(_dir + "/file" + std::to_string(f)) << f;
+            _files++;
+        }
+    }
+    std::filesystem::create_symlink(_outside, _tree + "/link");
+
+    bool ok = true;
+    {
+        TrashReaper _trash(_root + "/trash", 4);
+        ok = ok && _trash.discard(_tree) && !std::filesystem::exists(_tree);
+        // a missing path cannot be discarded
+        ok = ok && !_trash.discard(_root + "/missing");
+        ok = ok && _trash.waitIdle(std::chrono::seconds(30));
+        ok = ok && std::filesystem::is_empty(_root + "/trash") && std::filesystem::exists(_outside);
+    }
+    std::filesystem::remove_all(_root);
+    return ok && _files == 1000;
+}
+
+bool Test::UNIT_test_image_archive() {
+    using Compression = ImageArchive::Compression;
+    bool ok = ImageArchive::isImage("images/web.tar") && ImageArchive::isImage("images/web.tar.gz")
+        && ImageArchive::isImage("web.tgz") && ImageArchive::isImage("web.tar.zst") && ImageArchive::isImage("web.tar.xz")
+        && !ImageArchive::isImage("web.gz") && !ImageArchive::isImage("docker-compose.yml");
+    ok = ok && ImageArchive::compressionOf("web.tar") == Compression::None
+        && ImageArchive::compressionOf("web.tgz") == Compression::Gzip
+        && ImageArchive::compressionOf("web.tar.zst") == Compression::Zstd
+        && ImageArchive::compressionOf("web.tar.xz") == Compression::Xz;
+    bool _known = true;
+    ok = ok && ImageArchive::fromName("ZSTD") == Compression::Zstd && ImageArchive::name(Compression::Gzip) == "gzip"
+        && ImageArchive::suffix(Compression::Zstd) == ".zst";
+    ImageArchive::fromName("brotli", &_known);
+    ok = ok && !_known;
+
+    // round trip through every encoder installed here
+    const std::string _root = Utils::path_join_multiple({std::filesystem::temp_directory_path().string(), "mi_image_archive_test"});
+    std::filesystem::remove_all(_root);
+    std::filesystem::create_directories(_root);
+    std::string _content;
+    for (int i = 0; i < 100000; i++) {
+        _content += "layer " + std::to_string(i % 97) + "\n";
+    }
+    std::ofstream(_root + "/web.tar") << _content;
+    for (Compression _compression : {Compression::Gzip, Compression::Zstd, Compression::Xz}) {
+        if (!ImageArchive::canCompress(_compression)) {
+            continue;
+        }
+        const std::string _packed = _root + "/web.tar" + ImageArchive::suffix(_compression);
+        std::string _output;
+        ok = ok && ImageArchive::compress(_root + "/web.tar", _packed, _compression, _output)
+            && std::filesystem::file_size(_packed) < _content.size()
+            && ImageArchive::decode(_packed, _output);
+        const auto _decoder = ImageArchive::decoderCommand(_packed);
+        ok = ok && !_decoder.empty() && _decoder.back() == _packed;
+    }
+    // a corrupt image fails to decode
+    std::ofstream(_root + "/bad.tar.gz") << "not gzip";
+    std::string _output;
+    ok = ok && (ImageArchive::decoderCommand(_root + "/bad.tar.gz").empty() || !ImageArchive::decode(_root + "/bad.tar.gz", _output));
+    std::filesystem::remove_all(_root);
+    return ok;
+}
+
+bool Test::UNIT_test_compose_interpolation() {
+    const auto _variables = ComposeModel::parseDotEnv(
+        "# registry settings\n"
+        "REGISTRY=registry.example.com\n"
+        "export TAG=\"1.2.3\"\n"
+        "WEB_PORT=8080 # published port\n"
+        "EMPTY=\n"
+        "not a variable\n");
+    bool ok = _variables.size() == 4 && _variables.at("REGISTRY") == "registry.example.com"
+        && _variables.at("TAG") == "1.2.3" && _variables.at("WEB_PORT") == "8080" && _variables.at("EMPTY").empty();
+
+    ok = ok && ComposeModel::interpolate("$REGISTRY/web:${TAG}", _variables) == "registry.example.com/web:1.2.3"
+        && ComposeModel::interpolate("${MISSING:-8443}:${WEB_PORT-80}", _variables) == "8443:8080"
+        && ComposeModel::interpolate("${EMPTY:-x}${EMPTY-y}${TAG:+set}${MISSING+unset}", _variables) == "xset"
+        && ComposeModel::interpolate("echo $$HOME ${MISSING}", _variables) == "echo $HOME ";
+
+    const std::string _compose =
+        "services:\n"
+        "  web:\n"
+        "    image: ${REGISTRY}/web:${TAG}\n"
+        "    ports:\n"
+        "      - \"${WEB_PORT}:80\"\n"
+        "      - target: 443\n"
+        "        published: 8443\n"
+        "        protocol: tcp\n"
+        "  worker:\n"
+        "    image: worker:${TAG:-latest}\n";
+    const ComposeModel _model = ComposeModel::parse(ComposeModel::interpolate(_compose, _variables));
+    ok = ok && _model.valid && _model.services.size() == 2
+        && _model.services[0].image == "registry.example.com/web:1.2.3"
+        && _model.services[0].ports == std::vector<std::string>{"8080:80", "8443:443/tcp"}
+        && _model.services[1].image == "worker:1.2.3" && _model.services[1].ports.empty();
+    // ports survive the cached form
+    ok = ok && ComposeModel::fromJson(_model.toJson()).services[0].ports == _model.services[0].ports;
+    return ok;
+}
+
+bool Test::REST_test_project_analyze() {
+    assertm(!base_url.empty(), "Base URL is empty");
+
+    httplib::Client client(base_url.c_str());
+    client.set_connection_timeout(5);
+    client.set_read_timeout(60);
+
+    std::string archive_path = "../example_project.7z";
+    if(!std::filesystem::exists(archive_path))
+    {
+        archive_path = "example_project.7z";
+    }
+    archive_path = std::filesystem::absolute(archive_path).string();
+
+    // without verify only the listing and the compose file are decompressed
+    json11::Json json_data = json11::Json::object{
+        {"archive_path", archive_path},
+        {"password", "secret"},
+        {"verify", false}
+    };
+    auto res_analyze = client.Post("/api/projects/analyze", json_data.dump(), "application/json");
+    if (!res_analyze || res_analyze->status != 200) {
+        crow::logger(crow::LogLevel::ERROR) << "Failed to analyze archive";
+        return false;
+    }
+    std::string parse_error;
+    auto json_analyze = json11::Json::parse(res_analyze->body, parse_error);
+    bool success = json_analyze["success"].bool_value() && !json_analyze["integrity_verified"].bool_value()
+        && json_analyze["is_encrypted"].bool_value()
+        && json_analyze["compose_file"].string_value() == "docker-compose.yml"
+        && json_analyze["compose_error"].string_value().empty()
+        && !json_analyze["services"].array_items().empty();
+    for (const auto& service : json_analyze["services"].array_items()) {
+        success = success && !service["name"].string_value().empty() && !service["image"].string_value().empty()
+            && service["image_present"].is_bool();
+    }
+    if (!success) {
+        crow::logger(crow::LogLevel::ERROR) << "Unexpected analysis: " << res_analyze->body;
+        return false;
+    }
+
+    // a wrong password is found out by the listing or by reading the compose file
+    json11::Json json_wrong = json11::Json::object{
+        {"archive_path", archive_path},
+        {"password", "wrong"},
+        {"verify", false}
+    };
+    auto res_wrong = client.Post("/api/projects/analyze", json_wrong.dump(), "application/json");
+    auto json_wrong_res = json11::Json::parse(res_wrong ? res_wrong->body : "", parse_error);
+    success = res_wrong && (!json_wrong_res["success"].bool_value() || !json_wrong_res["compose_error"].string_value().empty());
+    return success;
+}
+
+bool Test::REST_test_project_update() {
+    assertm(!base_url.empty(), "Base URL is empty");
+
+    httplib::Client client(base_url.c_str());
+    client.set_connection_timeout(5);
+    client.set_read_timeout(60);
+
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string project_name = "test_project_update_" + std::to_string(now);
+    std::string archive_path = "../example_project.7z";
+    if(!std::filesystem::exists(archive_path))
+    {
+        archive_path = "example_project.7z";
+    }
+    archive_path = std::filesystem::absolute(archive_path).string();
+
+    json11::Json json_data_load = json11::Json::object{
+        {"archive_path", archive_path},
+        {"project_name", project_name},
+        {"password", "secret"}
+    };
+    auto res_load = client.Post("/api/projects/load", json_data_load.dump(), "application/json");
+    if (!res_load || res_load->status != 200) {
+        crow::logger(crow::LogLevel::ERROR) << "Failed to load project for update test";
+        return false;
+    }
+    auto res_start = client.Post(("/api/projects/" + project_name + "/start").c_str());
+
+    // two versions of the project that differ in the variables of their .env only
+    const std::string project_path = Utils::path_join_multiple({Utils::get_metainstaller_home_dir(), "projects", project_name});
+    const std::string work = Utils::path_join_multiple({std::filesystem::temp_directory_path().string(), project_name});
+    bool success = res_start && res_start->status == 200;
+    for (const std::string version : {"one", "two"}) {
+        const std::string source = work + "/" + version;
+        std::filesystem::create_directories(source);
+        std::filesystem::copy(project_path, source, std::filesystem::copy_options::recursive);
+        std::ofstream(source + "/.env") << "GREETING=" << version << "\n";
+        json11::Json json_archive = json11::Json::object{
+            {"project_path", source},
+            {"archive_path", work + "/" + version + ".7z"},
+            {"password", "secret"}
+        };
+        auto res_archive = client.Post("/api/projects/create-archive", json_archive.dump(), "application/json");
+        success = success && res_archive && res_archive->status == 200;
+    }
+
+    json11::Json json_update_one = json11::Json::object{{"archive_path", work + "/one.7z"}, {"password", "secret"}};
+    auto res_one = client.Post(("/api/projects/" + project_name + "/update").c_str(), json_update_one.dump(), "application/json");
+    success = success && res_one && res_one->status == 200;
+
+    // compose substitutes .env into the services, a change there alone recreates them
+    json11::Json json_update_two = json11::Json::object{{"archive_path", work + "/two.7z"}, {"password", "secret"}};
+    auto res = client.Post(("/api/projects/" + project_name + "/update").c_str(), json_update_two.dump(), "application/json");
+    if (success && res) {
+        crow::logger(crow::LogLevel::Info) << "Project Update Test Response: " << res->body;
+        std::string parse_error;
+        auto body = json11::Json::parse(res->body, parse_error);
+        std::ifstream env_file(project_path + "/.env");
+        std::string env((std::istreambuf_iterator<char>(env_file)), std::istreambuf_iterator<char>());
+        success = res->status == 200 && body["success"].bool_value() && env == "GREETING=two\n"
+            && !body["recreated_services"].array_items().empty() && body["compose_applied"].bool_value();
+    } else {
+        success = false;
+    }
+
+    client.Post(("/api/projects/" + project_name + "/stop").c_str());
+    client.Delete(("/api/projects/" + project_name + "/remove?remove_files=true").c_str());
+    std::filesystem::remove_all(work);
+    return success;
+}
+
+bool Test::REST_test_versioned_resource() {
+    assertm(!base_url.empty(), "Base URL is empty");
+
+    httplib::Client client(base_url.c_str());
+    client.set_connection_timeout(5);
+    client.set_read_timeout(60);
+
+    auto res_list = client.Get("/api/projects");
+    if (!res_list || res_list->status != 200 || !res_list->has_header("ETag")) {
+        crow::logger(crow::LogLevel::ERROR) << "Project list has no ETag";
+        return false;
+    }
+    const std::string etag = res_list->get_header_value("ETag");
+    const std::string version = res_list->get_header_value("X-Resource-Version");
+    bool success = !version.empty() && etag.find(version) != std::string::npos;
+
+    // the current ETag, also weak, in a list or as a wildcard, answers 304 without a body
+    for (const std::string& if_none_match : std::vector<std::string>{etag, "W/" + etag, "\"other\", " + etag, "*"}) {
+        auto res = client.Get("/api/projects", {{"If-None-Match", if_none_match}});
+        success = success && res && res->status == 304 && res->body.empty() && res->get_header_value("ETag") == etag;
+    }
+    auto res_stale = client.Get("/api/projects", {{"If-None-Match", "\"projects-0\""}});
+    success = success && res_stale && res_stale->status == 200 && res_stale->get_header_value("ETag") == etag;
+
+    // nothing changes: the parked request is answered 304 once its timeout expires
+    const auto parked_at = std::chrono::steady_clock::now();
+    auto res_timeout = client.Get(("/api/projects?wait=" + version + "&timeout=1").c_str());
+    success = success && res_timeout && res_timeout->status == 304
+        && std::chrono::steady_clock::now() - parked_at >= std::chrono::milliseconds(900);
+
+    // loading a project bumps the version and answers the request parked on the old one
+    std::atomic<bool> answered{false};
+    httplib::Result res_wait;
+    std::thread waiter([&]() {
+        httplib::Client wait_client(base_url.c_str());
+        wait_client.set_read_timeout(60);
+        res_wait = wait_client.Get(("/api/projects?wait=" + version + "&timeout=30").c_str());
+        answered = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    success = success && !answered;
+
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string project_name = "test_versioned_resource_" + std::to_string(now);
+    std::string archive_path = "../example_project.7z";
+    if(!std::filesystem::exists(archive_path))
+    {
+        archive_path = "example_project.7z";
+    }
+    archive_path = std::filesystem::absolute(archive_path).string();
+    json11::Json json_data_load = json11::Json::object{
+        {"archive_path", archive_path},
+        {"project_name", project_name},
+        {"password", "secret"}
+    };
+    auto res_load = client.Post("/api/projects/load", json_data_load.dump(), "application/json");
+    waiter.join();
+    success = success && res_load && res_load->status == 200 && res_wait && res_wait->status == 200
+        && std::stoull(res_wait->get_header_value("X-Resource-Version", "0")) > std::stoull(version)
+        && res_wait->body.find(project_name) != std::string::npos;
+    if (res_wait) {
+        crow::logger(crow::LogLevel::Info) << "Versioned Resource Test: version " << version << " -> "
+                                           << res_wait->get_header_value("X-Resource-Version");
+    }
+
+    // the old ETag no longer matches
+    auto res_changed = client.Get("/api/projects", {{"If-None-Match", etag}});
+    success = success && res_changed && res_changed->status == 200 && res_changed->get_header_value("ETag") != etag;
+
+    client.Delete(("/api/projects/" + project_name + "/remove?remove_files=true").c_str());
+    return success;
+}
@@ -46,6 +46,32 @@ private:
     bool REST_test_project_stop();
     bool REST_test_project_restart();
     bool REST_test_project_services();
+    bool REST_test_project_logs();
+    bool UNIT_test_compose_model();
+    bool UNIT_test_image_index();
+    bool UNIT_test_coalescing_cache();
+    bool UNIT_test_task_executor();
+    bool UNIT_test_log_hub();
+    bool UNIT_test_binary_log_frames();
+    bool UNIT_test_log_stream_since();
+    bool UNIT_test_log_query_pages();
+    bool UNIT_test_cgroup_sampler();
+    bool UNIT_test_metrics_store();
+    bool UNIT_test_json_line_scanner();
+    bool UNIT_test_json_writer();
+    bool UNIT_test_admission_control();
+    bool UNIT_test_blocking_executor();
+    bool UNIT_test_batch_requests();
+    bool UNIT_test_local_socket();
+    bool UNIT_test_archive_manifest();
+    bool UNIT_test_content_store();
+    bool REST_test_project_reload();
+    bool UNIT_test_trash_reaper();
+    bool UNIT_test_image_archive();
+    bool UNIT_test_compose_interpolation();
+    bool REST_test_project_analyze();
+    bool REST_test_project_update();
+    bool REST_test_versioned_resource();
     bool run_test(const std::string& _test_name);
     bool run_all();
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
@@ -21,16 +22,125 @@ struct ProjectInfo {
     std::string last_modified;
 };
 
+struct ProjectContainer {
+    std::string id;
+    std::string name;
+    std::string service;
+    std::string state;      // lower case, e.g. "running"
+};
+
+// one bucket of a MetricsStore tier, as saved in the database
+struct MetricPoint {
+    std::string project;
+    std::string service;
+    std::string metric;
+    int64_t resolution = 0;     // seconds per bucket
+    int64_t bucket = 0;         // timestamp / resolution
+    uint32_t count = 0;
+    double sum = 0;
+    double max = 0;
+};
+
+// a service of an archive's compose file, read without extracting the archive
+struct ProjectArchiveService {
+    std::string name;
+    std::string image;
+    bool image_present = false;                     // already in the local docker
+    std::vector<std::string> ports;
+    std::vector<std::string> depends_on;
+};
+
 struct ProjectArchiveInfo {
     std::string archive_path;
     bool is_encrypted = false;
     bool integrity_verified = false;
     std::vector<std::string> contained_files;
     std::vector<std::string> docker_images;
+    std::string compose_file;                       // name in the archive
     std::string compose_file_content;
+    std::vector<ProjectArchiveService> services;
+    std::vector<std::string> missing_images;        // images of the services not present locally
+    std::string compose_error;                      // compose file unreadable or invalid
     std::string error_message;
 };
 
+/**
+ * @brief outcome of replacing a loaded project's files with a newer archive, see ProjectManager::updateProject
+ */
+struct ProjectUpdateResult {
+    bool success = false;
+    std::string error;
+    bool had_manifest = false;                      // false: compared with the extracted files instead
+    std::vector<std::string> added;
+    std::vector<std::string> changed;
+    std::vector<std::string> removed;
+    size_t unchanged = 0;
+    std::vector<std::string> loaded_images;         // references loaded from added or changed image tars
+    std::vector<std::string> recreated_services;
+    std::vector<std::string> removed_services;
+    bool compose_applied = false;                   // the project was running and compose was re-run
+    bool rolled_back = false;                       // a step after the files were replaced failed, the previous files were put back (and brought up again if compose had run)
+    long long elapsed_ms = 0;
+};
+
+/**
+ * @brief outcome of replacing a loaded project by a newer archive as a whole, see ProjectManager::reloadProject
+ */
+struct ProjectReloadResult {
+    bool success = false;
+    std::string error;
+    bool was_running = false;
+    bool rolled_back = false;                       // compose failed on the new version, the old one was put back
+    std::vector<std::string> loaded_images;
+    size_t carried_over = 0;                        // files the project created itself, moved into the new version
+    long long prepare_ms = 0;                       // extraction, validation and image loads, the old version still runs
+    long long switch_ms = 0;                        // directory exchange and compose recreate
+    long long elapsed_ms = 0;
+};
+
+/**
+ * @brief how ProjectManager::createProjectArchive packs a project
+ */
+struct ProjectArchiveOptions {
+    std::string mode = "max";                       // "max": 7z LZMA at -mx=9 over everything; "fast": see ProjectArchiveReport
+    std::string image_compression = "zstd";         // "fast" only: zstd, gzip or xz, gzip if its encoder is missing
+    bool measure_load = false;                      // time testing the archive and decoding its images once built
+};
+
+/**
+ * @brief what an archive cost to build and will cost to load
+ *
+ * In "fast" mode image tars are compressed on their own with a multi-threaded encoder and the archive
+ * stores everything as it is; loading then decodes the images while piping them into `docker load`.
+ */
+struct ProjectArchiveReport {
+    std::string mode;
+    std::string image_compression = "none";
+    size_t images_compressed = 0;
+    uint64_t source_bytes = 0;
+    uint64_t archive_bytes = 0;
+    long long compress_images_ms = 0;
+    long long build_ms = 0;                         // including compress_images_ms
+    long long extract_ms = -1;                      // `7z t` of the archive, with measure_load
+    long long decode_ms = -1;                       // decoding the compressed images, with measure_load
+};
+
+// a file kept once in the content store (see ContentStore), named by its SHA-256
+struct ContentBlob {
+    std::string hash;
+    uint64_t size = 0;
+    std::string crc;            // as 7z lists it, to find the blob of an archive entry before extracting it
+    int64_t refs = 0;           // project files linked to it
+};
+
+// a project file linked to a blob
+struct ContentRef {
+    std::string path;           // relative to the project directory
+    std::string hash;
+    uint64_t size = 0;
+    std::string crc;
+};
+
 enum class ProjectStatus {
     NOT_LOADED,
     EXTRACTING,
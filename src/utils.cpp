@@ -93,6 +93,14 @@ std::string Utils::get_7z_executable_path()
 {
     static std::string _path_extract{"/tmp/metainstaller_7z"};
     static std::string _path_7z;
+
+    // An explicit executable (e.g. the offline stand-in from test_fakes/) overrides the embedded one
+    const auto _str_override = EnvConfig::get_value(EnvKey::SEVEN_ZIP_PATH);
+    if(!_str_override.empty())
+    {
+        return _str_override;
+    }
+
     if(_path_7z.empty())
     {
         // Ensure the directory exists
@@ -0,0 +1,76 @@
+#!/bin/bash
+
+# Shared helpers for the fake docker / 7zzs / sudo stand-ins.
+#
+# Knobs (all optional):
+#   FAKE_STATE_DIR      directory holding loaded images, compose state and call counters
+#                       (default: /tmp/fake_docker_state)
+#   FAKE_LATENCY_MS     delay added to every invocation (default: 0)
+#   FAKE_JITTER_MS      extra delay, deterministic per call number, in [0, FAKE_JITTER_MS) (default: 0)
+#   FAKE_FAIL_RATE      percentage (0-100) of invocations that exit non-zero (default: 0)
+#   FAKE_SCALE          number of synthetic containers / images reported (default: 20)
+#   FAKE_LOG_LINES      number of lines emitted by `logs` (default: 200)
+#   FAKE_LOG_FOLLOW_MS  interval between lines of `compose logs --follow` while the project is up (default: 200)
+#
+# Per-tool overrides take precedence, e.g. FAKE_DOCKER_LATENCY_MS or FAKE_7Z_FAIL_RATE.
+# Failures are spread evenly over the call sequence (call n fails when floor(n*rate/100)
+# advances), so a given rate always fails the same calls and runs are reproducible.
+
+FAKE_ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+FAKE_FIXTURES="${FAKE_ROOT}/fixtures"
+FAKE_STATE_DIR="${FAKE_STATE_DIR:-/tmp/fake_docker_state}"
+mkdir -p "${FAKE_STATE_DIR}"
+
+# fake_knob <TOOL> <NAME> <default>
+fake_knob() {
+    local tool_var="FAKE_${1}_${2}"
+    local global_var="FAKE_${2}"
+    if [ -n "${!tool_var}" ]; then
+        echo "${!tool_var}"
+    elif [ -n "${!global_var}" ]; then
+        echo "${!global_var}"
+    else
+        echo "$3"
+    fi
+}
+
+# fake_next_call <TOOL> -> prints the 1-based call number for this tool
+fake_next_call() {
+    local counter="${FAKE_STATE_DIR}/calls_$1"
+    local n
+    exec 9>>"${counter}.lock"
+    flock 9
+    n=$(( $(cat "${counter}" 2>/dev/null || echo 0) + 1 ))
+    echo "${n}" > "${counter}"
+    flock -u 9
+    exec 9>&-
+    echo "${n}"
+}
+
+# fake_begin <TOOL> : applies latency and failure injection for this invocation
+fake_begin() {
+    local tool="$1"
+    local latency jitter rate n delay
+    latency=$(fake_knob "${tool}" LATENCY_MS 0)
+    jitter=$(fake_knob "${tool}" JITTER_MS 0)
+    rate=$(fake_knob "${tool}" FAIL_RATE 0)
+    n=$(fake_next_call "${tool}")
+
+    delay=${latency}
+    if [ "${jitter}" -gt 0 ]; then
+        delay=$(( delay + (n * 7919) % jitter ))
+    fi
+    if [ "${delay}" -gt 0 ]; then
+        sleep "$(printf '%d.%03d' $(( delay / 1000 )) $(( delay % 1000 )))"
+    fi
+
+    if [ "${rate}" -gt 0 ] && [ $(( n * rate / 100 )) -ne $(( (n - 1) * rate / 100 )) ]; then
+        echo "fake ${tool,,}: injected failure on call ${n}" >&2
+        exit 1
+    fi
+}
+
+# fake_hex <seed> <len> : deterministic hex id
+fake_hex() {
+    printf '%s' "$1" | sha256sum | cut -c1-"$2"
+}
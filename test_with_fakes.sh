@@ -0,0 +1,80 @@
+#!/bin/bash
+
+# Run MetaInstaller (or any command) against the fake docker / 7zzs / sudo stand-ins
+# from test_fakes/, so throughput and concurrency can be measured without a daemon.
+#
+# Usage:
+#   ./test_with_fakes.sh <command> [args...]
+#   e.g. ./test_with_fakes.sh ./build/MetaInstaller --test project_load
+#
+# Tunables are passed through from the environment, see test_fakes/lib/common.sh
+# (FAKE_LATENCY_MS, FAKE_JITTER_MS, FAKE_FAIL_RATE, FAKE_SCALE, FAKE_LOG_LINES, ...).
+
+set -e  # Exit on any error
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+FAKES_DIR="${SCRIPT_DIR}/test_fakes"
+
+# Colors for output
+BLUE='\033[0;34m'
+RED='\033[0;31m'
+NC='\033[0m' # No Color
+
+log_info() {
+    echo -e "${BLUE}[INFO]${NC} $1" >&2
+}
+
+log_error() {
+    echo -e "${RED}[ERROR]${NC} $1" >&2
+}
+
+if [ $# -eq 0 ]; then
+    log_error "usage: $0 <command> [args...]"
+    exit 1
+fi
+
+export FAKE_STATE_DIR="${FAKE_STATE_DIR:-/tmp/fake_docker_state}"
+export FAKE_7Z_PASSWORD="${FAKE_7Z_PASSWORD-secret}"
+export PATH="${FAKES_DIR}/bin:${PATH}"
+
+# MetaInstaller loads ./.env over the process environment, so the 7z override and
+# sudo password have to be written there rather than exported.
+set_env_value() {
+    touch .env
+    if grep -q "^$1=" .env; then
+        sed -i "s|^$1=.*|$1=$2|" .env
+    else
+        echo "$1=$2" >> .env
+    fi
+}
+set_env_value SEVEN_ZIP_PATH "${FAKES_DIR}/bin/7zzs"
+if ! grep -q "^SUDO_PASSWORD=." .env; then
+    set_env_value SUDO_PASSWORD fake
+fi
+
+# Start every run from the same state so results are reproducible
+if [ -z "${FAKE_KEEP_STATE}" ]; then
+    rm -rf "${FAKE_STATE_DIR}"
+fi
+mkdir -p "${FAKE_STATE_DIR}"
+
+# Build the fake project archive used by the project tests (a tar the fake 7zzs understands),
+# bundling one `docker save`-style tarball per image so `docker load` reports real tags.
+ARCHIVE_PATH="${FAKE_ARCHIVE_PATH:-example_project.7z}"
+if [ ! -e "${ARCHIVE_PATH}" ] || [ -n "${FAKE_REBUILD_ARCHIVE}" ]; then
+    STAGING="$(mktemp -d /tmp/fake_project_XXXXXX)"
+    cp -r "${SCRIPT_DIR}/example_project/." "${STAGING}/"
+    mkdir -p "${STAGING}/images"
+    for image in $(awk '/^    image:/ { print $2 }' "${STAGING}/docker-compose.yml"); do
+        image_dir="$(mktemp -d "${STAGING}/image_XXXXXX")"
+        echo "[{\"Config\":\"config.json\",\"RepoTags\":[\"${image}\"],\"Layers\":[]}]" > "${image_dir}/manifest.json"
+        tar -cf "${STAGING}/images/${image//[:\/]/_}.tar" -C "${image_dir}" manifest.json
+        rm -rf "${image_dir}"
+    done
+    tar -cf "${ARCHIVE_PATH}" -C "${STAGING}" .
+    rm -rf "${STAGING}"
+    log_info "Fake project archive written to ${ARCHIVE_PATH}"
+fi
+
+log_info "docker -> $(command -v docker), 7zzs -> ${FAKES_DIR}/bin/7zzs, state -> ${FAKE_STATE_DIR}"
+exec "$@"